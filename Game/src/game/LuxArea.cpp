@@ -167,6 +167,7 @@ void iLuxArea::AttachToBody(const tString& asPropName, int alBodyId)
 				mlBodyId = alBodyId;
 				mpParentBody = pPropBody;
 				mvRelativeOffset = mpBody->GetWorldPosition() - mpParentBody->GetWorldPosition();
+				WakeTick();
 
 				return;
 			}
@@ -201,6 +202,13 @@ void iLuxArea::OnSetActive(bool abX)
 
 //-----------------------------------------------------------------------
 
+bool iLuxArea::IsTickIdle()
+{
+	return super_class::IsTickIdle() && mpParentBody==NULL;
+}
+
+//-----------------------------------------------------------------------
+
 void iLuxArea::OnUpdate(float afTimeStep)
 {
 	// Not currently being visited by LuxArea_Liquid due to having their own OnUpdate function?
@@ -89,6 +89,8 @@ public:
 
 	virtual iEntity3D* GetAttachEntity();
 
+	bool IsTickIdle();
+
 	//////////////////////
 	//Save data stuff
 	virtual void SaveToSaveData(iLuxEntity_SaveData* apSaveData);
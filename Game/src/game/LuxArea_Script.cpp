@@ -81,6 +81,9 @@ void cLuxAreaLoader_Script::SetupArea(iLuxArea *apArea, cWorld *apWorld)
 cLuxArea_Script::cLuxArea_Script(const tString &asName, int alID, cLuxMap *apMap)  : iLuxArea(asName,alID,apMap, eLuxAreaType_Script)
 {
 	mfMaxFocusDistance = gpBase->mpGameCfg->GetFloat("Player_Interaction","ScriptArea_MaxFocusDist",0);
+
+	//Script areas only do something when they have callbacks or are attached to a body
+	SetTickRate(eLuxEntityTickRate_OnWake);
 }
 
 //-----------------------------------------------------------------------
@@ -42,6 +42,7 @@
 //#include "LuxInsanityHandler.h"
 #include "LuxInfectionHandler.h"
 #include "LuxProgressLogHandler.h"
+#include "LuxBenchmark.h"
 #include "LuxLoadScreenHandler.h"
 
 #include "LuxInventory.h"
@@ -395,6 +396,7 @@ cLuxBase::cLuxBase()
 	///////////////////////////////
 	// Init variables
 	mbPTestActivated = false;
+	mlExitCode = 0;
 }
 
 //-----------------------------------------------------------------------
@@ -446,9 +448,26 @@ bool cLuxBase::Init(const tString &asCommandline)
 	if(InitGame()==false) return false;
 
 
+	//////////////////////////
+	// Start benchmark directly on its map
+	if(msBenchmarkConfigFile != _W(""))
+	{
+		if(mpBenchmark->Setup(msBenchmarkConfigFile)==false)
+		{
+			msErrorMessage = _W("Could not set up benchmark: ") + msBenchmarkConfigFile;
+			return false;
+		}
+
+		CreateProfile(msDefaultProfileName);
+		SetProfile(msDefaultProfileName);
+
+		if(InitUserConfig()==false) return false;
+
+		StartGame(mpBenchmark->GetMapFile(), mpBenchmark->GetMapFolder(), mpBenchmark->GetStartPos());
+	}
 	//////////////////////////
 	// Start premenu
-	if(mbShowPreMenu && mbShowMenu)
+	else if(mbShowPreMenu && mbShowMenu)
 	{
 		mpEngine->GetUpdater()->SetContainer("PreMenu");
 	}
@@ -682,6 +701,16 @@ bool cLuxBase::ParseCommandLine(const tString &asCommandline)
 		return true;
 	}
 
+	//////////////////////////////////
+	//Benchmark, "-benchmark <config file>"
+	if(cString::Sub(asCommandline, 0, 11) == "-benchmark ")
+	{
+		msBenchmarkConfigFile = cString::To16Char(cString::Sub(asCommandline, 11));
+		if(msInitConfigFile==_W("")) msInitConfigFile = _W("config/main_init.cfg");
+
+		return true;
+	}
+
 	//////////////////////////////////
 	//Main Init config file
 	// TODO: Parse the command line better?
@@ -1118,6 +1147,11 @@ bool cLuxBase::InitEngine()
 	vars.mSound.mlStreamBufferCount = mpConfigHandler->mlSoundStreamBuffers;
 	vars.mSound.mlStreamBufferSize = mpConfigHandler->mlSoundStreamBufferSize;
 
+	vars.mPhysics.mlWorldThreadNum = mpConfigHandler->mlPhysicsThreads;
+
+	if(msBenchmarkConfigFile != _W(""))
+		cLuxBenchmark::SetupEngineVars(msBenchmarkConfigFile, &vars);
+
 	// Sound device filter set here (if needed)
 #if defined(WIN32)
 	iLowLevelSound::SetSoundDeviceNameFilter("software");
@@ -1166,9 +1200,23 @@ bool cLuxBase::InitEngine()
 	pMatMgr->SetTextureSizeDownScaleLevel(mpConfigHandler->mlTextureQuality);
 	pMatMgr->SetTextureFilter((eTextureFilter)mpConfigHandler->mlTextureFilter);
 	pMatMgr->SetTextureAnisotropy(mpConfigHandler->mfTextureAnisotropy);
+
+	//Budget is in bytes as an int, so cap below 2GB
+	int lTextureBudgetMB = cMath::Min(mpConfigHandler->mlTextureMemoryBudget, 2047);
+	if(lTextureBudgetMB != mpConfigHandler->mlTextureMemoryBudget)
+		Warning("TextureMemoryBudget %d MB is too large, using %d MB\n", mpConfigHandler->mlTextureMemoryBudget, lTextureBudgetMB);
+	mpEngine->GetResources()->GetTextureManager()->SetMemoryBudget(lTextureBudgetMB * 1024 * 1024);
+
+	//For meshes not already optimized by mshconverter
+	mpEngine->GetResources()->GetMeshManager()->SetOptimizeVertexCache(mpConfigHandler->mbOptimizeMeshesOnLoad);
+	mpEngine->GetResources()->GetMeshManager()->SetCompactVertexFormat(mpConfigHandler->mbCompactVertexFormat);
+	cAnimationClip::SetQuantizeRotations(mpConfigHandler->mbQuantizeAnimationRotations);
+	if(mpConfigHandler->mbShaderSourceCache)
+		mpEngine->GetResources()->GetGpuShaderManager()->SetParsedSourceCacheDir(msBaseSavePath + _W("shader_cache"));
 	
 	cSound *pSound = mpEngine->GetSound();
 	pSound->GetLowLevel()->SetVolume(mpMainConfig->GetFloat("Sound","Volume",1.0f));
+	pSound->GetSoundHandler()->SetAsyncLoadMaxDelay(mpConfigHandler->mfSoundAsyncLoadMaxDelay);
 
 	/////////////////////////
 	//Load configurations
@@ -1281,6 +1329,7 @@ bool cLuxBase::InitGame()
 	mpHintHandler = CreateModule( cLuxHintHandler, "Default"); 
 	mpPostEffectHandler = CreateModule( cLuxPostEffectHandler, "Default");
 	mpAchievementHandler = CreateModule( iLuxAchievementHandler, "Default");
+	mpBenchmark = CreateModule( cLuxBenchmark, "Default"); //Last, so the camera is placed before and recorded after all other updates
 
 	InitAchievements();
 
@@ -52,6 +52,7 @@ class cLuxPostEffectHandler;
 //class cLuxInsanityHandler;
 class cLuxInfectionHandler;
 class cLuxProgressLogHandler;
+class cLuxBenchmark;
 class cLuxLoadScreenHandler;
 
 class cLuxInventory;
@@ -242,6 +243,7 @@ public:
 	//cLuxInsanityHandler *mpInsanityHandler;
 	cLuxInfectionHandler *mpInfectionHandler;
 	cLuxProgressLogHandler *mpProgressLogHandler;
+	cLuxBenchmark *mpBenchmark;
 	cLuxLoadScreenHandler *mpLoadScreenHandler;
 	cLuxCredits *mpCredits;
 	cLuxDemoEnd* mpDemoEnd;
@@ -249,11 +251,13 @@ public:
 
 	tString msGameName;
 	tWString msErrorMessage;
+	int mlExitCode;
 
 	bool mbShowPreMenu;
 	bool mbShowMenu;
 
 	tString msCommandLineMapFile;
+	tWString msBenchmarkConfigFile;
 	tString msStartMapFile;
 	tString msStartMapFolder;
 	tString msStartMapPos;
@@ -0,0 +1,676 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LuxBenchmark.h"
+
+#include "LuxPlayer.h"
+#include "LuxMapHandler.h"
+#include "LuxMap.h"
+
+#include "impl/XmlDocumentTiny.h"
+#include "scene/RenderableContainer_BoxTree.h"
+#include "impl/VideoStreamTheora.h"
+#include "system/Timer.h"
+
+#include <algorithm>
+#include <string.h>
+
+//-----------------------------------------------------------------------
+
+//Player actions stored in the track, one bit each
+static const int glFirstTrackAction = eLuxAction_Forward;
+static const int glLastTrackAction = eLuxAction_Crouch;
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// HELPERS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+static cXmlElement* GetNextElement(cXmlNodeListIterator &aIt)
+{
+	while(aIt.HasNext())
+	{
+		cXmlElement *pElement = aIt.Next()->ToElement();
+		if(pElement) return pElement;
+	}
+	return NULL;
+}
+
+//-----------------------------------------------------------------------
+
+static bool XmlElementsAreEqual(cXmlElement *apA, cXmlElement *apB)
+{
+	if(apA->GetValue() != apB->GetValue()) return false;
+
+	if(apA->GetAttributeNum() != apB->GetAttributeNum()) return false;
+	for(int i=0; i<apA->GetAttributeNum(); ++i)
+	{
+		const char* pValueB = apB->GetAttribute(apA->GetAttributeName(i));
+		if(pValueB==NULL || strcmp(apA->GetAttributeValue(i), pValueB)!=0) return false;
+	}
+
+	//Only elements, the TinyXML path does not copy anything else
+	cXmlNodeListIterator itA = apA->GetChildIterator();
+	cXmlNodeListIterator itB = apB->GetChildIterator();
+	while(true)
+	{
+		cXmlElement *pChildA = GetNextElement(itA);
+		cXmlElement *pChildB = GetNextElement(itB);
+		if(pChildA==NULL || pChildB==NULL) return pChildA==pChildB;
+
+		if(XmlElementsAreEqual(pChildA, pChildB)==false) return false;
+	}
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// SUB ACTION
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+bool cLuxBenchmarkSubAction::IsTriggerd()
+{
+	return mpBenchmark->IsActionReplayed(mlAction);
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// CONSTRUCTORS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+cLuxBenchmark::cLuxBenchmark() : iLuxUpdateable("LuxBenchmark")
+{
+	mbActive = false;
+	mbRecord = false;
+	mbRunning = false;
+	mbFinished = false;
+
+	mlWarmupFrames = 0;
+	mlRecordFrames = 0;
+	mbOcclusionCulling = true;
+	mbFlatContainerTrees = true;
+	mlParseRuns = 0;
+	mlConvertFrames = 0;
+	mvConvertSize = 0;
+	mlMaxConvertDiff = 0;
+	mbPassed = true;
+	mlFrame = 0;
+	mlReplayActions = 0;
+}
+
+//-----------------------------------------------------------------------
+
+cLuxBenchmark::~cLuxBenchmark()
+{
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+bool cLuxBenchmark::Setup(const tWString& asConfigFile)
+{
+	cConfigFile *pConfig = hplNew(cConfigFile, (asConfigFile));
+	if(pConfig->Load()==false)
+	{
+		Error("Could not load benchmark config '%s'!\n", cString::To8Char(asConfigFile).c_str());
+		hplDelete(pConfig);
+		return false;
+	}
+
+	msMapFile = pConfig->GetString("Map", "File", "");
+	msMapFolder = pConfig->GetString("Map", "Folder", "");
+	msStartPos = pConfig->GetString("Map", "StartPos", "");
+
+	msTrackFile = pConfig->GetStringW("Track", "File", _W("benchmark_track.txt"));
+	mbRecord = pConfig->GetBool("Track", "Record", false);
+	mlRecordFrames = pConfig->GetInt("Track", "RecordFrames", 3600);
+
+	mlWarmupFrames = pConfig->GetInt("Run", "WarmupFrames", 60);
+	msOutputFile = pConfig->GetStringW("Run", "OutputFile", _W("benchmark_result.json"));
+	mbOcclusionCulling = pConfig->GetBool("Run", "OcclusionCulling", true);
+	mbFlatContainerTrees = pConfig->GetBool("Run", "FlatContainerTrees", true);
+
+	mlParseRuns = pConfig->GetInt("Parse", "Runs", 5);
+	tString sSep = ";";
+	mvParseFiles.clear();
+	cString::GetStringVec(pConfig->GetString("Parse", "Files", ""), mvParseFiles, &sSep);
+
+	mlConvertFrames = pConfig->GetInt("Video", "ConvertFrames", 100);
+	mvConvertSize.x = pConfig->GetInt("Video", "ConvertWidth", 1920);
+	mvConvertSize.y = pConfig->GetInt("Video", "ConvertHeight", 1080);
+	mlMaxConvertDiff = pConfig->GetInt("Video", "MaxConvertDiff", 1);
+
+	hplDelete(pConfig);
+
+	if(msMapFile == "")
+	{
+		Error("No map set in benchmark config '%s'!\n", cString::To8Char(asConfigFile).c_str());
+		return false;
+	}
+
+	/////////////////////////
+	// Replaying needs the track and runs one logic update per frame, so every run does the same work
+	if(mbRecord==false)
+	{
+		if(LoadTrack()==false) return false;
+		
+		gpBase->mpEngine->SetFixedStepMode(true);
+		iRenderer::SetUseFlatContainerTrees(mbFlatContainerTrees);
+	}
+
+	mbActive = true;
+
+	Log("Benchmark %s '%s' on map '%s'\n", mbRecord ? "recording" : "replaying", cString::To8Char(msTrackFile).c_str(), msMapFile.c_str());
+
+	return true;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::SetupEngineVars(const tWString& asConfigFile, cEngineInitVars *apVars)
+{
+	cConfigFile *pConfig = hplNew(cConfigFile, (asConfigFile));
+	if(pConfig->Load())
+	{
+		apVars->mGraphics.mbNullDevice = pConfig->GetBool("Run", "NullGraphics", false);
+		apVars->mSound.mbNullDevice = pConfig->GetBool("Run", "NullSound", false);
+	}
+	hplDelete(pConfig);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::OnGameStart()
+{
+	if(mbActive==false) return;
+
+	mlFrame = 0;
+	mvFrameTimes.clear();
+	mvFrameTimes.reserve(mvTrack.size());
+	mvContainerCullTimes.clear();
+	mvContainerCullTimes.reserve(mvTrack.size());
+	mlReplayActions = 0;
+	if(mbRecord)
+	{
+		mvTrack.clear();
+	}
+	else
+	{
+		AddReplaySubActions();
+		gpBase->mpMapHandler->GetViewport()->GetRenderSettings()->mbUseOcclusionCulling = mbOcclusionCulling;
+	}
+
+	mbRunning = true;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::PreUpdate(float afTimeStep)
+{
+	if(mbRunning==false || mbRecord) return;
+
+	////////////////////////
+	// Stay at the start of the track while warming up, then follow it
+	int lTrackFrame = mlFrame - mlWarmupFrames;
+	if(lTrackFrame >= (int)mvTrack.size())
+	{
+		Finish();
+		return;
+	}
+
+	PlaceCamera(mvTrack[lTrackFrame < 0 ? 0 : lTrackFrame]);
+
+	//Input is updated after this, so the actions are triggered in this logic update
+	mlReplayActions = lTrackFrame < 0 ? 0 : mvTrack[lTrackFrame].mlActions;
+
+	++mlFrame;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::PostUpdate(float afTimeStep)
+{
+	if(mbRunning==false || mbRecord==false) return;
+
+	cLuxPlayer *pPlayer = gpBase->mpPlayer;
+
+	cLuxBenchmarkTrackFrame frame;
+	frame.mvFeetPos = pPlayer->GetCharacterBody()->GetFeetPosition();
+	frame.mfYaw = pPlayer->GetCamera()->GetYaw();
+	frame.mfPitch = pPlayer->GetCamera()->GetPitch();
+	frame.mlActions = GetTriggeredActions();
+	mvTrack.push_back(frame);
+
+	if((int)mvTrack.size() >= mlRecordFrames) Finish();
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::OnPostBufferSwap()
+{
+	if(mbRunning==false || mbRecord) return;
+
+	//Frames rendered during warm up are not counted
+	if(mlFrame <= mlWarmupFrames) return;
+
+	mvFrameTimes.push_back(gpBase->mpEngine->GetLastFrameTimes());
+	mvContainerCullTimes.push_back(iRenderer::GetContainerCullTime());
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::OnExit()
+{
+	//Save what has been recorded if the game is quit before the track is done
+	if(mbRunning && mbRecord) Finish();
+}
+
+//-----------------------------------------------------------------------
+
+bool cLuxBenchmark::IsActionReplayed(int alAction)
+{
+	return (mlReplayActions & (1 << (alAction - glFirstTrackAction))) != 0;
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+bool cLuxBenchmark::LoadTrack()
+{
+	mvTrack.clear();
+
+#ifdef WIN32
+	FILE *pFile = _wfopen(msTrackFile.c_str(),_W("r"));
+#else
+	FILE *pFile = fopen(cString::To8Char(msTrackFile).c_str(),"r");
+#endif
+	if(pFile==NULL)
+	{
+		Error("Could not open benchmark track '%s'!\n", cString::To8Char(msTrackFile).c_str());
+		return false;
+	}
+
+	//Tracks recorded before the actions were saved have 5 columns, these replay without any input
+	char sLine[256];
+	while(fgets(sLine, sizeof(sLine), pFile))
+	{
+		cLuxBenchmarkTrackFrame frame;
+		frame.mlActions = 0;
+		int lNum = sscanf(sLine, "%f %f %f %f %f %d", &frame.mvFeetPos.x, &frame.mvFeetPos.y, &frame.mvFeetPos.z,
+														&frame.mfYaw, &frame.mfPitch, &frame.mlActions);
+		if(lNum < 5) break;
+
+		mvTrack.push_back(frame);
+	}
+	fclose(pFile);
+
+	if(mvTrack.empty())
+	{
+		Error("Benchmark track '%s' has no frames!\n", cString::To8Char(msTrackFile).c_str());
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::SaveTrack()
+{
+#ifdef WIN32
+	FILE *pFile = _wfopen(msTrackFile.c_str(),_W("w"));
+#else
+	FILE *pFile = fopen(cString::To8Char(msTrackFile).c_str(),"w");
+#endif
+	if(pFile==NULL)
+	{
+		Error("Could not save benchmark track '%s'!\n", cString::To8Char(msTrackFile).c_str());
+		return;
+	}
+
+	//One line per logic update: feet position, yaw, pitch and the triggered actions
+	for(size_t i=0; i<mvTrack.size(); ++i)
+	{
+		const cLuxBenchmarkTrackFrame& frame = mvTrack[i];
+		fprintf(pFile, "%.4f %.4f %.4f %.5f %.5f %d\n", frame.mvFeetPos.x, frame.mvFeetPos.y, frame.mvFeetPos.z,
+														frame.mfYaw, frame.mfPitch, frame.mlActions);
+	}
+	fclose(pFile);
+
+	Log("Benchmark track with %d frames saved to '%s'\n", (int)mvTrack.size(), cString::To8Char(msTrackFile).c_str());
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::WriteResults()
+{
+#ifdef WIN32
+	FILE *pFile = _wfopen(msOutputFile.c_str(),_W("w"));
+#else
+	FILE *pFile = fopen(cString::To8Char(msOutputFile).c_str(),"w");
+#endif
+	if(pFile==NULL)
+	{
+		Error("Could not save benchmark results '%s'!\n", cString::To8Char(msOutputFile).c_str());
+		return;
+	}
+
+	/////////////////////////
+	// Get the times of each phase
+	const int lPhaseNum = 7;
+	const char* vPhaseNames[lPhaseNum] = { "logic", "draw", "render", "post_render", "flush", "swap", "total" };
+	tDoubleVec vPhaseTimes[lPhaseNum];
+
+	for(size_t i=0; i<mvFrameTimes.size(); ++i)
+	{
+		const cEngineFrameTimes& times = mvFrameTimes[i];
+		vPhaseTimes[0].push_back(times.mfLogic);
+		vPhaseTimes[1].push_back(times.mfDraw);
+		vPhaseTimes[2].push_back(times.mfRender);
+		vPhaseTimes[3].push_back(times.mfPostRender);
+		vPhaseTimes[4].push_back(times.mfFlush);
+		vPhaseTimes[5].push_back(times.mfSwap);
+		vPhaseTimes[6].push_back(times.mfLogic + times.mfDraw + times.mfRender + times.mfPostRender + times.mfFlush + times.mfSwap);
+	}
+
+	//Part of render, only measured when containers are culled brute force (no occlusion culling)
+	tDoubleVec vContainerCullTimes = mvContainerCullTimes;
+	std::sort(vContainerCullTimes.begin(), vContainerCullTimes.end());
+
+	/////////////////////////
+	// Summary
+	fprintf(pFile, "{\n");
+	fprintf(pFile, "\t\"map\": \"%s\",\n", msMapFile.c_str());
+	fprintf(pFile, "\t\"track\": \"%s\",\n", cString::To8Char(msTrackFile).c_str());
+	fprintf(pFile, "\t\"step_size\": %f,\n", gpBase->mpEngine->GetStepSize());
+	fprintf(pFile, "\t\"warmup_frames\": %d,\n", mlWarmupFrames);
+	fprintf(pFile, "\t\"frames\": %d,\n", (int)mvFrameTimes.size());
+	fprintf(pFile, "\t\"occlusion_culling\": %s,\n", mbOcclusionCulling ? "true" : "false");
+	fprintf(pFile, "\t\"flat_container_trees\": %s,\n", mbFlatContainerTrees ? "true" : "false");
+
+	WriteStaticTree(pFile);
+	if(mlConvertFrames > 0) WriteYuvConversion(pFile);
+
+	/////////////////////////
+	// XML parsing, the loaded map first
+	if(mlParseRuns > 0)
+	{
+		tStringVec vFiles;
+		vFiles.push_back(gpBase->mpMapHandler->GetCurrentMap()->GetFileName());
+		vFiles.insert(vFiles.end(), mvParseFiles.begin(), mvParseFiles.end());
+
+		fprintf(pFile, "\t\"xml_parse_runs\": %d,\n", mlParseRuns);
+		fprintf(pFile, "\t\"xml_parse\": [\n");
+		for(size_t i=0; i<vFiles.size(); ++i)
+		{
+			WriteXmlParse(pFile, vFiles[i], i+1 == vFiles.size());
+		}
+		fprintf(pFile, "\t],\n");
+	}
+
+	fprintf(pFile, "\t\"summary\": {\n");
+	for(int i=0; i<lPhaseNum; ++i)
+	{
+		std::sort(vPhaseTimes[i].begin(), vPhaseTimes[i].end());
+		WritePhaseSummary(pFile, vPhaseNames[i], vPhaseTimes[i], false);
+	}
+	WritePhaseSummary(pFile, "container_cull", vContainerCullTimes, true);
+	fprintf(pFile, "\t},\n");
+
+	/////////////////////////
+	// Frames, ms spent in each phase
+	fprintf(pFile, "\t\"frame_phases\": [\"logic\", \"draw\", \"render\", \"post_render\", \"flush\", \"swap\"],\n");
+	fprintf(pFile, "\t\"frame_times\": [\n");
+	for(size_t i=0; i<mvFrameTimes.size(); ++i)
+	{
+		const cEngineFrameTimes& times = mvFrameTimes[i];
+		fprintf(pFile, "\t\t[%.3f, %.3f, %.3f, %.3f, %.3f, %.3f]%s\n", times.mfLogic, times.mfDraw, times.mfRender,
+															times.mfPostRender, times.mfFlush, times.mfSwap,
+															i+1 < mvFrameTimes.size() ? "," : "");
+	}
+	fprintf(pFile, "\t],\n");
+
+	fprintf(pFile, "\t\"frame_container_cull\": [");
+	for(size_t i=0; i<mvContainerCullTimes.size(); ++i)
+	{
+		fprintf(pFile, "%s%.3f", i==0 ? "" : ", ", mvContainerCullTimes[i]);
+	}
+	fprintf(pFile, "],\n");
+
+	fprintf(pFile, "\t\"passed\": %s\n", mbPassed ? "true" : "false");
+	fprintf(pFile, "}\n");
+
+	fclose(pFile);
+
+	Log("Benchmark results for %d frames saved to '%s'\n", (int)mvFrameTimes.size(), cString::To8Char(msOutputFile).c_str());
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::Finish()
+{
+	if(mbFinished) return;
+	mbFinished = true;
+	mbRunning = false;
+
+	if(mbRecord)	SaveTrack();
+	else			WriteResults();
+
+	if(mbPassed==false)
+	{
+		Error("Benchmark checks failed, see '%s'\n", cString::To8Char(msOutputFile).c_str());
+		gpBase->mlExitCode = 1;
+	}
+
+	gpBase->mpEngine->Exit();
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::PlaceCamera(const cLuxBenchmarkTrackFrame& aFrame)
+{
+	cLuxPlayer *pPlayer = gpBase->mpPlayer;
+
+	pPlayer->GetCharacterBody()->SetFeetPosition(aFrame.mvFeetPos);
+	pPlayer->GetCharacterBody()->SetYaw(aFrame.mfYaw);
+	pPlayer->GetCamera()->SetYaw(aFrame.mfYaw);
+	pPlayer->GetCamera()->SetPitch(aFrame.mfPitch);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::AddReplaySubActions()
+{
+	cInput *pInput = gpBase->mpEngine->GetInput();
+
+	//The actions own the sub actions and delete them
+	for(int i=glFirstTrackAction; i<=glLastTrackAction; ++i)
+	{
+		cAction *pAction = pInput->GetAction(i);
+		if(pAction) pAction->AddSubAction(hplNew(cLuxBenchmarkSubAction, (this, i)));
+	}
+}
+
+//-----------------------------------------------------------------------
+
+int cLuxBenchmark::GetTriggeredActions()
+{
+	cInput *pInput = gpBase->mpEngine->GetInput();
+
+	int lActions = 0;
+	for(int i=glFirstTrackAction; i<=glLastTrackAction; ++i)
+	{
+		if(pInput->IsTriggerd(i)) lActions |= 1 << (i - glFirstTrackAction);
+	}
+
+	return lActions;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::WritePhaseSummary(FILE *apFile, const char* apName, const tDoubleVec& avTimes, bool abLast)
+{
+	double fSum = 0;
+	for(size_t i=0; i<avTimes.size(); ++i) fSum += avTimes[i];
+	double fMean = avTimes.empty() ? 0 : fSum / (double)avTimes.size();
+
+	fprintf(apFile, "\t\t\"%s\": { \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f }%s\n",
+					apName, fMean,
+					GetPercentile(avTimes, 50), GetPercentile(avTimes, 90), GetPercentile(avTimes, 95), GetPercentile(avTimes, 99),
+					avTimes.empty() ? 0 : avTimes.back(),
+					abLast ? "" : ",");
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::WriteStaticTree(FILE *apFile)
+{
+	cWorld *pWorld = gpBase->mpMapHandler->GetCurrentMap()->GetWorld();
+	cRenderableContainer_BoxTree *pTree = static_cast<cRenderableContainer_BoxTree*>(pWorld->GetRenderableContainer(eWorldContainerType_Static));
+
+	if(pTree->GetTreeObjectNum() != pTree->GetObjectNum())
+	{
+		Error("Static box tree has %d objects in nodes, but %d were added!\n", pTree->GetTreeObjectNum(), pTree->GetObjectNum());
+		mbPassed = false;
+	}
+
+	fprintf(apFile, "\t\"static_tree\": { \"build\": \"%s\", \"objects\": %d, \"tree_objects\": %d, \"nodes\": %d, \"leaves\": %d, "
+					"\"sah_cost\": %.3f, \"compile_ms\": %d },\n",
+					pTree->GetUseSAHBuild() ? "sah" : "legacy", pTree->GetObjectNum(), pTree->GetTreeObjectNum(),
+					pTree->GetNodeNum(), pTree->GetLeafNum(), pTree->GetSAHCost(), pTree->GetCompileTime());
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxBenchmark::WriteYuvConversion(FILE *apFile)
+{
+	double fTableFps, fSimdFps;
+	int lMaxDiff;
+	cVideoStreamTheora::MeasureYuvConversion(mvConvertSize, mlConvertFrames, &fTableFps, &fSimdFps, &lMaxDiff);
+
+	if(lMaxDiff > mlMaxConvertDiff)
+	{
+		Error("YUV conversion with SSE2 differs by %d from the tables, max is %d!\n", lMaxDiff, mlMaxConvertDiff);
+		mbPassed = false;
+	}
+
+	fprintf(apFile, "\t\"yuv_convert\": { \"width\": %d, \"height\": %d, \"frames\": %d, \"simd_supported\": %s, "
+					"\"table_fps\": %.1f, \"simd_fps\": %.1f, \"max_diff\": %d },\n",
+					mvConvertSize.x, mvConvertSize.y, mlConvertFrames, cVideoStreamTheora::SimdYuvConversionSupported() ? "true" : "false",
+					fTableFps, fSimdFps, lMaxDiff);
+}
+
+//-----------------------------------------------------------------------
+
+/**
+ * Parses the file with both parsers and writes the times. The results of the two must be the same.
+ */
+void cLuxBenchmark::WriteXmlParse(FILE *apFile, const tString& asFile, bool abLast)
+{
+	tWString sPath = gpBase->mpEngine->GetResources()->GetFileSearcher()->GetFilePath(asFile);
+	if(sPath == _W(""))
+	{
+		Error("Could not find '%s' to parse in benchmark!\n", asFile.c_str());
+		fprintf(apFile, "\t\t{ \"file\": \"%s\", \"same_result\": false }%s\n", asFile.c_str(), abLast ? "" : ",");
+		mbPassed = false;
+		return;
+	}
+
+	iTimer *pTimer = cPlatform::CreateTimer();
+
+	tDoubleVec vTinyXmlTimes;
+	tDoubleVec vOnePassTimes;
+	bool bSameResult = true;
+	size_t lMemorySize = 0;
+
+	for(int i=0; i<mlParseRuns; ++i)
+	{
+		cXmlDocumentTiny *pTinyXmlDoc = hplNew( cXmlDocumentTiny, ("") );
+		pTimer->Start();
+		bool bTinyXmlOk = pTinyXmlDoc->CreateFromFileWithTinyXML(sPath);
+		pTimer->Stop();
+		vTinyXmlTimes.push_back(pTimer->GetTimeInMilliSec());
+
+		cXmlDocumentTiny *pOnePassDoc = hplNew( cXmlDocumentTiny, ("") );
+		pTimer->Start();
+		bool bOnePassOk = pOnePassDoc->CreateFromFile(sPath);
+		pTimer->Stop();
+		vOnePassTimes.push_back(pTimer->GetTimeInMilliSec());
+
+		if(i==0)
+		{
+			bSameResult = bTinyXmlOk && bOnePassOk && XmlElementsAreEqual(pTinyXmlDoc, pOnePassDoc);
+			lMemorySize = pOnePassDoc->GetMemorySize();
+		}
+
+		hplDelete(pTinyXmlDoc);
+		hplDelete(pOnePassDoc);
+	}
+
+	hplDelete(pTimer);
+
+	if(bSameResult==false)
+	{
+		Error("Parsing '%s' gives different results with TinyXML and the one pass parser!\n", asFile.c_str());
+		mbPassed = false;
+	}
+
+	std::sort(vTinyXmlTimes.begin(), vTinyXmlTimes.end());
+	std::sort(vOnePassTimes.begin(), vOnePassTimes.end());
+
+	fprintf(apFile, "\t\t{ \"file\": \"%s\", \"kb\": %d, \"memory_kb\": %d, \"same_result\": %s, "
+					"\"tinyxml_copy\": { \"p50\": %.3f, \"min\": %.3f }, \"one_pass\": { \"p50\": %.3f, \"min\": %.3f } }%s\n",
+					asFile.c_str(), (int)(cPlatform::GetFileSize(sPath)/1024), (int)(lMemorySize/1024), bSameResult ? "true" : "false",
+					GetPercentile(vTinyXmlTimes, 50), vTinyXmlTimes.front(), GetPercentile(vOnePassTimes, 50), vOnePassTimes.front(),
+					abLast ? "" : ",");
+}
+
+//-----------------------------------------------------------------------
+
+double cLuxBenchmark::GetPercentile(const tDoubleVec& avSortedTimes, double afPercent)
+{
+	if(avSortedTimes.empty()) return 0;
+
+	//Nearest rank
+	int lIdx = (int)ceil(afPercent / 100.0 * (double)avSortedTimes.size()) - 1;
+	if(lIdx < 0) lIdx = 0;
+	if(lIdx >= (int)avSortedTimes.size()) lIdx = (int)avSortedTimes.size()-1;
+
+	return avSortedTimes[lIdx];
+}
+
+//-----------------------------------------------------------------------
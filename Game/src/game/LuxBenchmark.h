@@ -0,0 +1,163 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LUX_BENCHMARK_H
+#define LUX_BENCHMARK_H
+
+//----------------------------------------------
+
+#include "LuxBase.h"
+
+//----------------------------------------
+
+class cLuxBenchmarkTrackFrame
+{
+public:
+	cVector3f mvFeetPos;
+	float mfYaw;
+	float mfPitch;
+	int mlActions;
+};
+
+typedef std::vector<cLuxBenchmarkTrackFrame> tLuxBenchmarkTrackFrameVec;
+
+//----------------------------------------
+
+class cLuxBenchmark;
+
+/**
+ * Added to the player actions when replaying, triggers them as they were when the track was recorded.
+ */
+class cLuxBenchmarkSubAction : public iSubAction
+{
+public:	
+	cLuxBenchmarkSubAction(cLuxBenchmark *apBenchmark, int alAction) : mpBenchmark(apBenchmark), mlAction(alAction){}
+
+	bool IsTriggerd();
+	float GetValue(){ return IsTriggerd() ? 1.0f : 0.0f;}
+
+	tString GetInputName(){ return "Benchmark";}
+	tString GetInputType(){ return "Benchmark";}
+
+private:
+	cLuxBenchmark *mpBenchmark;
+	int mlAction;
+};
+
+//----------------------------------------
+
+/**
+ * Started with "-benchmark <config file>". Loads a map and either records the path of the player to a
+ * track file, or replays a track with the engine in fixed step mode. The track holds the position, the
+ * camera angles and the triggered player actions (move, interact, lantern, etc) of each logic update.
+ * Mouse look is not replayed as input, the camera angles are set directly instead.
+ * When replaying, the times of every frame are saved and the results are written as JSON when the
+ * track is done, after which the game exits.
+ * Setting NullGraphics / NullSound in the Run section runs without a GPU or sound device (eg on CI).
+ * To compare flat tree culling with the old node path, replay with OcclusionCulling=false (only the
+ * brute force path uses the containers) once with FlatContainerTrees=true and once with false.
+ * After the track, the map (and the files in Parse/Files) are parsed with the old TinyXML path and the
+ * one pass parser. The results must be the same. The stats of the static box tree are saved too, and
+ * it must hold all static objects. Video YUV to RGBA conversion is timed with the tables and SSE2, which
+ * must not differ by more than Video/MaxConvertDiff. If any check fails "passed" is false and the exit code is 1.
+ */
+class cLuxBenchmark : public iLuxUpdateable
+{
+public:	
+	cLuxBenchmark();
+	~cLuxBenchmark();
+
+	bool Setup(const tWString& asConfigFile);
+
+	/**
+	 * Called before the engine is created, selects the null devices if the config asks for them.
+	 */
+	static void SetupEngineVars(const tWString& asConfigFile, cEngineInitVars *apVars);
+
+	bool IsActive(){ return mbActive;}
+
+	const tString& GetMapFile(){ return msMapFile;}
+	const tString& GetMapFolder(){ return msMapFolder;}
+	const tString& GetStartPos(){ return msStartPos;}
+
+	void OnGameStart();
+
+	void PreUpdate(float afTimeStep);
+	void PostUpdate(float afTimeStep);
+	void OnPostBufferSwap();
+
+	void OnExit();
+
+	bool IsActionReplayed(int alAction);
+	
+private:
+	bool LoadTrack();
+	void SaveTrack();
+	void WriteResults();
+	void Finish();
+
+	void PlaceCamera(const cLuxBenchmarkTrackFrame& aFrame);
+
+	void AddReplaySubActions();
+	int GetTriggeredActions();
+
+	void WritePhaseSummary(FILE *apFile, const char* apName, const tDoubleVec& avTimes, bool abLast);
+	void WriteXmlParse(FILE *apFile, const tString& asFile, bool abLast);
+	void WriteStaticTree(FILE *apFile);
+	void WriteYuvConversion(FILE *apFile);
+	double GetPercentile(const tDoubleVec& avSortedTimes, double afPercent);
+
+	bool mbActive;
+	bool mbRecord;
+	bool mbRunning;
+	bool mbFinished;
+
+	tString msMapFile;
+	tString msMapFolder;
+	tString msStartPos;
+	tWString msTrackFile;
+	tWString msOutputFile;
+
+	int mlWarmupFrames;
+	int mlRecordFrames;
+
+	bool mbOcclusionCulling;
+	bool mbFlatContainerTrees;
+
+	int mlParseRuns;
+	tStringVec mvParseFiles;
+
+	int mlConvertFrames;
+	cVector2l mvConvertSize;
+	int mlMaxConvertDiff;
+
+	bool mbPassed;
+
+	int mlFrame;
+	tLuxBenchmarkTrackFrameVec mvTrack;
+	int mlReplayActions;
+
+	std::vector<cEngineFrameTimes> mvFrameTimes;
+	tDoubleVec mvContainerCullTimes;
+};
+
+//----------------------------------------------
+
+
+#endif // LUX_BENCHMARK_H
@@ -86,6 +86,8 @@ void cLuxConfigHandler::LoadMainConfig()
 	mbFastStaticLoad=	gpBase->mpMainConfig->GetBool("MapLoad","FastStaticLoad", false);
 	mbFastEntityLoad =	gpBase->mpMainConfig->GetBool("MapLoad","FastEntityLoad", false);
 
+	mlPhysicsThreads =	gpBase->mpMainConfig->GetInt("Physics","Threads", 1);
+
 	/////////////////////
 	// Graphics variables
 
@@ -115,6 +117,11 @@ void cLuxConfigHandler::LoadMainConfig()
 	mlTextureQuality =	gpBase->mpMainConfig->GetInt("Graphics", "TextureQuality", 0);
 	mlTextureFilter =	gpBase->mpMainConfig->GetInt("Graphics", "TextureFilter", eTextureFilter_Bilinear);
 	mfTextureAnisotropy = gpBase->mpMainConfig->GetFloat("Graphics", "TextureAnisotropy", 1.0f);
+	mlTextureMemoryBudget = gpBase->mpMainConfig->GetInt("Graphics", "TextureMemoryBudget", 0);
+	mbOptimizeMeshesOnLoad = gpBase->mpMainConfig->GetBool("Graphics", "OptimizeMeshesOnLoad", false);
+	mbCompactVertexFormat = gpBase->mpMainConfig->GetBool("Graphics", "CompactVertexFormat", false);
+	mbQuantizeAnimationRotations = gpBase->mpMainConfig->GetBool("Graphics", "QuantizeAnimationRotations", false);
+	mbShaderSourceCache = gpBase->mpMainConfig->GetBool("Graphics", "ShaderSourceCache", true);
 
 	mbForceShaderModel3And4Off = gpBase->mpMainConfig->GetBool("Graphics", "ForceShaderModel3And4Off", false);
 
@@ -124,6 +131,7 @@ void cLuxConfigHandler::LoadMainConfig()
 	mlMaxSoundChannels = gpBase->mpMainConfig->GetInt("Sound", "MaxChannels", 64);
 	mlSoundStreamBuffers = gpBase->mpMainConfig->GetInt("Sound", "StreamBuffers", 8);
 	mlSoundStreamBufferSize = gpBase->mpMainConfig->GetInt("Sound", "StreamBufferSize", 262144);
+	mfSoundAsyncLoadMaxDelay = gpBase->mpMainConfig->GetFloat("Sound", "AsyncLoadMaxDelay", 0.1f);
 
 	///////////////
 	// Engine
@@ -160,6 +168,8 @@ void cLuxConfigHandler::SaveMainConfig()
 	gpBase->mpMainConfig->SetBool("MapLoad","FastStaticLoad", mbFastStaticLoad);
 	gpBase->mpMainConfig->SetBool("MapLoad","FastEntityLoad", mbFastEntityLoad);
 
+	gpBase->mpMainConfig->SetInt("Physics","Threads", mlPhysicsThreads);
+
 	/////////////////////
 	// Graphics variables
 	cMaterialManager* pMatMgr = gpBase->mpEngine->GetResources()->GetMaterialManager();
@@ -174,6 +184,11 @@ void cLuxConfigHandler::SaveMainConfig()
 	gpBase->mpMainConfig->SetInt("Graphics","TextureQuality", mlTextureQuality);
 	gpBase->mpMainConfig->SetInt("Graphics","TextureFilter", mlTextureFilter);
 	gpBase->mpMainConfig->SetFloat("Graphics","TextureAnisotropy", mfTextureAnisotropy);
+	gpBase->mpMainConfig->SetInt("Graphics","TextureMemoryBudget", mlTextureMemoryBudget);
+	gpBase->mpMainConfig->SetBool("Graphics","OptimizeMeshesOnLoad", mbOptimizeMeshesOnLoad);
+	gpBase->mpMainConfig->SetBool("Graphics","CompactVertexFormat", mbCompactVertexFormat);
+	gpBase->mpMainConfig->SetBool("Graphics","QuantizeAnimationRotations", mbQuantizeAnimationRotations);
+	gpBase->mpMainConfig->SetBool("Graphics","ShaderSourceCache", mbShaderSourceCache);
 
 	gpBase->mpMainConfig->SetBool("Graphics","SSAOActive",mbSSAOActive);
 	gpBase->mpMainConfig->SetInt("Graphics","SSAOResolution",mlSSAOResolution);
@@ -201,6 +216,7 @@ void cLuxConfigHandler::SaveMainConfig()
 	gpBase->mpMainConfig->SetInt("Sound", "MaxChannels", mlMaxSoundChannels);
 	gpBase->mpMainConfig->SetInt("Sound", "StreamBuffers", mlSoundStreamBuffers);
 	gpBase->mpMainConfig->SetInt("Sound", "StreamBufferSize", mlSoundStreamBufferSize);
+	gpBase->mpMainConfig->SetFloat("Sound", "AsyncLoadMaxDelay", mfSoundAsyncLoadMaxDelay);
 
 	/////////////////////
 	// Engine properties
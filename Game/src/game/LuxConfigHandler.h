@@ -57,6 +57,11 @@ public:
 	int mlTextureQuality;
 	int mlTextureFilter;
 	float mfTextureAnisotropy;
+	int mlTextureMemoryBudget; //In MB, 0 = no budget
+	bool mbOptimizeMeshesOnLoad;
+	bool mbCompactVertexFormat;
+	bool mbQuantizeAnimationRotations;
+	bool mbShaderSourceCache;
 	int mlShadowQuality;
 	int mlShadowRes;
 
@@ -83,10 +88,13 @@ public:
 	bool mbFastStaticLoad;
 	bool mbFastEntityLoad;
 
+	int mlPhysicsThreads;
+
 	int mlSoundDevID;
 	int mlMaxSoundChannels;
 	int mlSoundStreamBuffers;
 	int mlSoundStreamBufferSize;
+	float mfSoundAsyncLoadMaxDelay;
 
 	
 private:
@@ -107,6 +107,8 @@ void cLuxDebugHandler::LoadUserConfig()
 	mbDrawPhysics = gpBase->mpUserConfig->GetBool("Debug", "DrawPhysics", false);
     mbShowGbufferContent = gpBase->mpUserConfig->GetBool("Debug", "ShowGbufferContent", false);
     mbShowAILog = gpBase->mpUserConfig->GetBool("Debug", "ShowAILog", false);
+	mbShowMemoryInfo = gpBase->mpUserConfig->GetBool("Debug", "ShowMemoryInfo", false);
+	cMemoryTracker::SetSampleRate(gpBase->mpUserConfig->GetInt("Debug", "MemorySampleRate", 0));
     cRendererDeferred::SetDebugRenderFrameBuffers(mbShowGbufferContent);
     
     /*mbRenderLightBuffer = false;
@@ -147,6 +149,7 @@ void cLuxDebugHandler::LoadUserConfig()
             mbModulateFog = false;
             mbEnableFog = true;*/
             mbShowAILog = false;
+            mbShowMemoryInfo = false;
             mbPositionAttachedProps = false;
 		#endif
 	}
@@ -169,6 +172,8 @@ void cLuxDebugHandler::SaveUserConfig()
 	 gpBase->mpUserConfig->SetBool("Debug", "DrawPhysics", mbDrawPhysics);
 	 gpBase->mpUserConfig->SetBool("Debug", "ShowGbufferContent", mbShowGbufferContent);
 	 gpBase->mpUserConfig->SetBool("Debug", "ShowAILog", mbShowAILog);
+	 gpBase->mpUserConfig->SetBool("Debug", "ShowMemoryInfo", mbShowMemoryInfo);
+	 gpBase->mpUserConfig->SetInt("Debug", "MemorySampleRate", cMemoryTracker::GetSampleRate());
      
 	 gpBase->mpUserConfig->SetBool("Debug", "ReloadFromCurrentPosition", mbReloadFromCurrentPosition);
 
@@ -444,6 +449,46 @@ void cLuxDebugHandler::OnDraw(float afFrameTime)
 		gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
 			_W("Max GameLogic: %05.2fms Max RenderingLogic: %05.2fms\n"), gpBase->mpEngine->GetMaxGameLogic(), gpBase->mpEngine->GetMaxRenderLogic());
 		fY+=13.0f;
+
+		cLuxMap *pMap = gpBase->mpMapHandler->GetCurrentMap();
+		if(pMap && pMap->GetPhysicsWorld())
+		{
+			iPhysicsWorld *pPhysicsWorld = pMap->GetPhysicsWorld();
+			gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
+				_W("Shape collision pairs: %d (AABB culled: %d)\n"), pPhysicsWorld->GetShapeCollisionPairCount(), pPhysicsWorld->GetShapeCollisionPairCulledCount());
+			fY+=13.0f;
+
+			const cPhysicsWorldStats& physicsStats = pPhysicsWorld->GetStats();
+			gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
+				_W("Physics: %d bodies, %d active, %d contacts, %d substeps, %.2fms per substep (%d threads)\n"), 
+				physicsStats.mlBodyNum, physicsStats.mlActiveBodyNum, physicsStats.mlContactNum,
+				physicsStats.mlSubStepNum, physicsStats.mfSubStepTime, pPhysicsWorld->GetNumberOfThreads());
+			fY+=13.0f;
+		}
+
+		if(pMap && pMap->GetWorld())
+		{
+			cRenderableContainer_DynBoxTree* pBoxTree = static_cast<cRenderableContainer_DynBoxTree*>(pMap->GetWorld()->GetRenderableContainer(eWorldContainerType_Dynamic));
+			gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
+				_W("Dynamic container: %d objects, %d reinserts, %d rotations, %d rebuilds\n"), 
+				pBoxTree->GetLeafNum(), pBoxTree->GetFrameReinsertCount(), pBoxTree->GetFrameRotationCount(), pBoxTree->GetFrameRebuildCount());
+			fY+=13.0f;
+		}
+
+		if(pMap)
+		{
+			cLuxEntityTickScheduler* pTickScheduler = pMap->GetTickScheduler();
+			gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
+				_W("Entity ticks: %d of %d entities, %d sleeping\n"), 
+				pTickScheduler->GetTickedNum(), pTickScheduler->GetEntityNum(), pTickScheduler->GetSleepingNum());
+			fY+=13.0f;
+
+			cLuxContactPairCache* pContactPairs = pMap->GetContactPairCache();
+			gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
+				_W("Contact pairs: %d cached, %d shape tested\n"), 
+				pContactPairs->GetPairNum(), pContactPairs->GetShapeTestNum());
+			fY+=13.0f;
+		}
 	}
 
 	if(mbShowGbufferContent)
@@ -454,6 +499,35 @@ void cLuxDebugHandler::OnDraw(float afFrameTime)
 	
 	}
 
+	if(mbShowMemoryInfo)
+	{
+		cTextureManager *pTextureManager = gpBase->mpEngine->GetResources()->GetTextureManager();
+		gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
+			_W("Textures: %.1fMB Budget: %.1fMB Reduced: %d (%.1fMB saved) Reloads: %d"), 
+			(float)pTextureManager->GetMemoryUsage() / (1024.0f*1024.0f),
+			(float)pTextureManager->GetMemoryBudget() / (1024.0f*1024.0f),
+			pTextureManager->GetReducedTextureNum(),
+			(float)pTextureManager->GetReducedMemorySaved() / (1024.0f*1024.0f),
+			pTextureManager->GetBudgetReloadCount());
+		fY+=13.0f;
+
+		if(cMemoryTracker::IsActive())
+		{
+			for(int i=0; i<eMemoryTag_LastEnum; ++i)
+			{
+				cMemoryTagStats stats;
+				cMemoryTracker::GetTagStats((eMemoryTag)i, stats);
+				gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
+					_W("%ls: %.1fMB (peak %.1fMB) Live: %d Allocs: %d"),
+					cString::To16Char(cMemoryTracker::GetTagName((eMemoryTag)i)).c_str(),
+					(float)stats.mlLiveBytes / (1024.0f*1024.0f),
+					(float)stats.mlPeakBytes / (1024.0f*1024.0f),
+					(int)stats.mlLiveNum, (int)stats.mlAllocNum);
+				fY+=13.0f;
+			}
+		}
+	}
+
 	if(cRendererDeferred::GetDebugRenderLightComplexity())
 	{
 		gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont,cVector3f(5,fY,0),14,cColor(1,1),_W("Lights Visible: %d"), mvLightComplexity.size());
@@ -641,6 +715,8 @@ void cLuxDebugHandler::OnDraw(float afFrameTime)
 		for(tSoundEntryListIt it = pEntryList->begin(); it != pEntryList->end();++it)
 		{
 			cSoundEntry *pEntry = *it;
+			if(pEntry->IsLoading()) continue; //No data until loaded
+
 			iSoundChannel *pSound = pEntry->GetChannel();
 			vSoundNames.push_back(pSound->GetData()->GetName());
 			vEntries.push_back(pEntry);
@@ -1029,7 +1105,7 @@ void cLuxDebugHandler::CreateGuiWindow()
 
 	///////////////////////////
 	//Window
-	cVector2f vSize = cVector2f(250, 740);
+	cVector2f vSize = cVector2f(250, 762);
 	vGroupSize.x = vSize.x - 20;
 	cVector3f vPos = cVector3f(mpGuiSet->GetVirtualSize().x - vSize.x - 10, 10, 0);
 	mpDebugWindow = mpGuiSet->CreateWidgetWindow(0,vPos,vSize,_W("Debug Toolbar") );
@@ -1080,6 +1156,12 @@ void cLuxDebugHandler::CreateGuiWindow()
 		pCheckBox->AddCallback(eGuiMessage_CheckChange,this, kGuiCallback(ChangeDebugText));
 		vGroupPos.y += 22;
 		
+		pCheckBox = mpGuiSet->CreateWidgetCheckBox(vGroupPos,vSize,_W("Show memory info"),pGroup);
+		pCheckBox->SetChecked(mbShowMemoryInfo);
+		pCheckBox->SetUserValue(32);
+		pCheckBox->AddCallback(eGuiMessage_CheckChange,this, kGuiCallback(ChangeDebugText));
+		vGroupPos.y += 22;
+		
 		pCheckBox = mpGuiSet->CreateWidgetCheckBox(vGroupPos,vSize,_W("Debug light complexity"),pGroup);
 		pCheckBox->SetChecked(false);
 		pCheckBox->SetUserValue(30);
@@ -1208,6 +1290,11 @@ void cLuxDebugHandler::CreateGuiWindow()
 		pButton->AddCallback(eGuiMessage_ButtonPressed,this, kGuiCallback(PressRebuildDynCont));
 		vGroupPos.y += 22;
 
+		//Memory report
+		pButton = mpGuiSet->CreateWidgetButton(vGroupPos,vSize,_W("Save Memory Report"),pGroup);
+		pButton->AddCallback(eGuiMessage_ButtonPressed,this, kGuiCallback(PressSaveMemoryReport));
+		vGroupPos.y += 22;
+
 		//Group end
 		vGroupSize.y = vGroupPos.y + 15;
 		pGroup->SetSize(vGroupSize);
@@ -1720,6 +1807,7 @@ bool cLuxDebugHandler::ChangeDebugText(iWidget* apWidget, const cGuiMessageData&
     }
 	else if(lNum == 30) cRendererDeferred::SetDebugRenderLightComplexity(bActive);
 	else if(lNum == 31) cRendererDeferred::SetDebugRenderOverdraw(bActive);
+	else if(lNum == 32) mbShowMemoryInfo = bActive;
     /*else if(lNum == 26) 
     {
         mbRenderLightBuffer = bActive;
@@ -1787,6 +1875,19 @@ bool cLuxDebugHandler::PressRebuildDynCont(iWidget* apWidget, const cGuiMessageD
 }
 kGuiCallbackDeclaredFuncEnd(cLuxDebugHandler, PressRebuildDynCont);
 
+bool cLuxDebugHandler::PressSaveMemoryReport(iWidget* apWidget, const cGuiMessageData& aData)
+{
+	tWString sFile = gpBase->msBaseSavePath + _W("memory_report.json");
+	cMemoryTracker::LogReport();
+	if(cMemoryTracker::SaveReport(sFile))
+	{
+		AddMessage(_W("Saved memory report to ")+sFile, false);
+	}
+
+	return true;
+}
+kGuiCallbackDeclaredFuncEnd(cLuxDebugHandler, PressSaveMemoryReport);
+
 
 //-----------------------------------------------------------------------
 
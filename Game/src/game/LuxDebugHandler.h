@@ -120,6 +120,9 @@ private:
 	bool PressRebuildDynCont(iWidget* apWidget,const cGuiMessageData& aData);
 	kGuiCallbackDeclarationEnd(PressRebuildDynCont);
 
+	bool PressSaveMemoryReport(iWidget* apWidget,const cGuiMessageData& aData);
+	kGuiCallbackDeclarationEnd(PressSaveMemoryReport);
+
 	bool PressLevelReload(iWidget* apWidget, const cGuiMessageData& aData);
 	kGuiCallbackDeclarationEnd(PressLevelReload);
 
@@ -183,6 +186,7 @@ private:
 	bool mbInspectionMode;
 	bool mbDrawPhysics;
 	bool mbShowGbufferContent;
+	bool mbShowMemoryInfo;
 	//bool mbRenderLightBuffer;
 
     bool mbShowAILog;
@@ -59,6 +59,14 @@ iLuxEntity::iLuxEntity(const tString &asName, int alID, cLuxMap *apMap, eLuxEnti
 	mbIsLookedAt = false;
 
 	mbInteractionDisabled = false;
+
+	mTickRate = eLuxEntityTickRate_EveryFrame;
+	mlTickInterval = 1;
+	mbTickScheduled = false;
+	mlTickBucket = -1;
+	mlTickBucketIndex = -1;
+	mfLastTickTime = 0;
+	mfTickWakeCount = 0;
 }
 
 //-----------------------------------------------------------------------
@@ -80,6 +88,10 @@ iLuxEntity::~iLuxEntity()
 	STLDeleteAll(mvConnections);
 
 	DestroyCollideCallbacks();
+
+	//The map clears all pairs itself when destroying all entities
+	if(mpMap && mpMap->IsDeletingAllWorldEntities()==false)
+		mpMap->GetContactPairCache()->RemovePairs(this);
 }
 
 //-----------------------------------------------------------------------
@@ -149,6 +161,8 @@ void iLuxEntity::SetActive(bool abX)
 	mbActive = abX;
 
     OnSetActive(abX);
+
+	if(mbActive) WakeTick();
 }
 
 //-----------------------------------------------------------------------
@@ -162,6 +176,22 @@ void iLuxEntity::SetStartsActive(bool abX)
 
 //-----------------------------------------------------------------------
 
+void iLuxEntity::WakeTick()
+{
+	if(mbTickScheduled==false || mpMap->IsDeletingAllWorldEntities()) return;
+
+	mpMap->GetTickScheduler()->Wake(this);
+}
+
+//-----------------------------------------------------------------------
+
+bool iLuxEntity::IsTickIdle()
+{
+	return HasCollideCallbacks()==false && msLookAtCallback == "";
+}
+
+//-----------------------------------------------------------------------
+
 void iLuxEntity::AddCollideCallbackParent(iLuxCollideCallbackContainer* apCallback)
 {
 	mlstCollideCallbackParents.push_back(apCallback);
@@ -186,6 +216,8 @@ void iLuxEntity::SetPlayerLookAtCallback(const tString &asCallbackFunc, bool abR
 {
 	msLookAtCallback = asCallbackFunc;
 	mbLookAtCallbackRemove = abRemoveWhenLookedAt;
+
+	WakeTick();
 }
 
 //-----------------------------------------------------------------------
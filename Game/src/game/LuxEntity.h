@@ -121,6 +121,7 @@ class cLuxMap;
 class iLuxEntity : public iLuxCollideCallbackContainer
 {
 friend class cLuxMap;
+friend class cLuxEntityTickScheduler;
 friend class cLuxSavedGameEntity;
 friend class cLuxSavedGameMap;
 public:	
@@ -195,6 +196,24 @@ public:
 
 	void AddCollideCallbackParent(iLuxCollideCallbackContainer* apCallback);
 	void RemoveCollideCallbackParent(iLuxCollideCallbackContainer* apCallback);
+
+	//////////////////
+	// Tick scheduling
+	/**
+	 * How often UpdateLogic is called when the entity is idle. Interval is in frames and rounded to a power of two.
+	 */
+	void SetTickRate(eLuxEntityTickRate aRate, int alInterval=1){ mTickRate = aRate; mlTickInterval = alInterval;}
+	eLuxEntityTickRate GetTickRate(){ return mTickRate;}
+
+	/**
+	 * Makes the entity update every frame for a little while. Called when scripts, the player or timers touch the entity, and while its bodies are awake.
+	 */
+	void WakeTick();
+	
+	/**
+	 * If false the entity is updated every frame no matter the tick rate.
+	 */
+	virtual bool IsTickIdle();
 	
 	//////////////////
 	// Connection
@@ -273,6 +292,14 @@ protected:
 private:
 	eLuxEntityType mEntityType;
 
+	eLuxEntityTickRate mTickRate;
+	int mlTickInterval;
+	bool mbTickScheduled;
+	int mlTickBucket;
+	int mlTickBucketIndex;
+	double mfLastTickTime;
+	float mfTickWakeCount;
+
 	void DestroyMe(){ mbDestroyMe = true;}
 };
 
@@ -42,6 +42,8 @@
 #include "LuxProp_Lamp.h"
 #include "LuxArea_Sticky.h"
 
+#include <algorithm>
+
 
 //////////////////////////////////////////////////////////////////////////
 // DISSOLVE ENTITIES
@@ -61,6 +63,696 @@ cLuxDissolveEntity::~cLuxDissolveEntity()
 
 //-----------------------------------------------------------------------
 
+//////////////////////////////////////////////////////////////////////////
+// ENTITY TICK SCHEDULER
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+cLuxEntityTickScheduler::cLuxEntityTickScheduler()
+{
+	mfTime =0;
+	mlFrameCount =0;
+
+	mlEntityNum =0;
+	mlTickedNum =0;
+
+	mfWakeTime = 1.0f;			//Time an entity is updated every frame after it has been woken up.
+	mfMaxTickTimeStep = 1.0f;	//The max time step an entity gets when it has not been updated for a while.
+	mfFullRateDistance = 20.0f;	//Distance scaled entities closer than this are updated every frame, the interval is then doubled with the distance.
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxEntityTickScheduler::Add(iLuxEntity *apEntity)
+{
+	if(apEntity->mbTickScheduled) return;
+
+	apEntity->mbTickScheduled = true;
+	apEntity->mfLastTickTime = mfTime;
+	
+	//Update all new entities every frame for a while, so callbacks and such set up at load are noticed.
+	apEntity->mfTickWakeCount = mfWakeTime;
+	AddToBucket(apEntity, 0);
+
+	++mlEntityNum;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxEntityTickScheduler::Remove(iLuxEntity *apEntity)
+{
+	if(apEntity->mbTickScheduled==false) return;
+
+	RemoveFromBucket(apEntity);
+	apEntity->mbTickScheduled = false;
+
+	--mlEntityNum;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxEntityTickScheduler::Clear()
+{
+	for(int i=0; i<kLuxEntityTickBucketNum; ++i) mvBuckets[i].clear();
+	mvTickList.clear();
+	mlEntityNum =0;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxEntityTickScheduler::Wake(iLuxEntity *apEntity)
+{
+	if(apEntity->mbTickScheduled==false) return;
+
+	//A sleeping entity has not missed any updates, so do not give it a large time step.
+	if(apEntity->mlTickBucket < 0) apEntity->mfLastTickTime = mfTime;
+
+	apEntity->mfTickWakeCount = mfWakeTime;
+
+	if(apEntity->mlTickBucket != 0)
+	{
+		RemoveFromBucket(apEntity);
+		AddToBucket(apEntity, 0);
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxEntityTickScheduler::Update(float afTimeStep)
+{
+	mfTime += afTimeStep;
+	++mlFrameCount;
+
+	////////////////////////////////////
+	// Gather the entities to update, bucket N updates every 2^N frames starting at different indices each frame
+	mvTickList.clear();
+	for(int lBucket=0; lBucket<kLuxEntityTickBucketNum; ++lBucket)
+	{
+		std::vector<iLuxEntity*>& vBucket = mvBuckets[lBucket];
+		size_t lInterval = (size_t)1 << lBucket;
+		
+		for(size_t i= (size_t)mlFrameCount & (lInterval-1); i<vBucket.size(); i += lInterval)
+		{
+			mvTickList.push_back(vBucket[i]);
+		}
+	}
+
+	////////////////////////////////////
+	// Update entities with the time passed since their last update
+	mlTickedNum =0;
+	for(size_t i=0; i<mvTickList.size(); ++i)
+	{
+		iLuxEntity *pEntity = mvTickList[i];
+
+		float fTimeStep = (float)(mfTime - pEntity->mfLastTickTime);
+		if(fTimeStep > mfMaxTickTimeStep) fTimeStep = mfMaxTickTimeStep;
+		pEntity->mfLastTickTime = mfTime;
+
+		if(pEntity->IsActive())
+		{
+			pEntity->UpdateLogic(fTimeStep);
+			++mlTickedNum;
+		}
+
+		if(pEntity->mfTickWakeCount > 0) pEntity->mfTickWakeCount -= fTimeStep;
+
+		PlaceEntity(pEntity);
+	}
+}
+
+//-----------------------------------------------------------------------
+
+int cLuxEntityTickScheduler::GetSleepingNum()
+{
+	int lNum = mlEntityNum;
+	for(int i=0; i<kLuxEntityTickBucketNum; ++i) lNum -= (int)mvBuckets[i].size();
+
+	return lNum;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxEntityTickScheduler::PlaceEntity(iLuxEntity *apEntity)
+{
+	if(apEntity->mbTickScheduled==false) return;
+
+	///////////////////////
+	// Get the bucket, -1 means sleeping
+	int lBucket = 0;
+	if(apEntity->IsActive()==false)
+	{
+		//Woken by SetActive
+		lBucket = -1;
+	}
+	else if(apEntity->mTickRate != eLuxEntityTickRate_EveryFrame && apEntity->mfTickWakeCount <= 0 && apEntity->IsTickIdle())
+	{
+		switch(apEntity->mTickRate)
+		{
+		case eLuxEntityTickRate_Interval:	lBucket = GetIntervalBucket(apEntity->mlTickInterval); break;
+		case eLuxEntityTickRate_Distance:	lBucket = GetDistanceBucket(apEntity); break;
+		case eLuxEntityTickRate_OnWake:		lBucket = -1; break;
+		default:							lBucket = 0; break;
+		}
+	}
+
+	if(lBucket == apEntity->mlTickBucket) return;
+
+	///////////////////////
+	// Move to new bucket
+	RemoveFromBucket(apEntity);
+	if(lBucket >= 0) AddToBucket(apEntity, lBucket);
+}
+
+//-----------------------------------------------------------------------
+
+int cLuxEntityTickScheduler::GetIntervalBucket(int alInterval)
+{
+	int lBucket = 0;
+	while(lBucket < kLuxEntityTickBucketNum-1 && (1 << (lBucket+1)) <= alInterval) ++lBucket;
+
+	return lBucket;
+}
+
+//-----------------------------------------------------------------------
+
+int cLuxEntityTickScheduler::GetDistanceBucket(iLuxEntity *apEntity)
+{
+	iEntity3D *pAttachEntity = apEntity->GetAttachEntity();
+	if(pAttachEntity==NULL) return 0;
+
+	float fDistSqr = cMath::Vector3DistSqr(pAttachEntity->GetWorldPosition(), gpBase->mpPlayer->GetCamera()->GetPosition());
+	float fMaxDist = mfFullRateDistance;
+
+	int lBucket = 0;
+	while(lBucket < kLuxEntityTickBucketNum-1 && fDistSqr >= fMaxDist*fMaxDist)
+	{
+		++lBucket;
+		fMaxDist *= 2;
+	}
+
+	return lBucket;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxEntityTickScheduler::AddToBucket(iLuxEntity *apEntity, int alBucket)
+{
+	apEntity->mlTickBucket = alBucket;
+	apEntity->mlTickBucketIndex = (int)mvBuckets[alBucket].size();
+	mvBuckets[alBucket].push_back(apEntity);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxEntityTickScheduler::RemoveFromBucket(iLuxEntity *apEntity)
+{
+	if(apEntity->mlTickBucket < 0) return;
+
+	//Swap with last so the bucket stays dense
+	std::vector<iLuxEntity*>& vBucket = mvBuckets[apEntity->mlTickBucket];
+	iLuxEntity *pLast = vBucket.back();
+	vBucket[apEntity->mlTickBucketIndex] = pLast;
+	pLast->mlTickBucketIndex = apEntity->mlTickBucketIndex;
+	vBucket.pop_back();
+
+	apEntity->mlTickBucket = -1;
+	apEntity->mlTickBucketIndex = -1;
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// CONTACT PAIR CACHE
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+cLuxContactPairCache::cLuxContactPairCache()
+{
+	mpPhysicsWorld = NULL;
+	mlShapeTestNum =0;
+}
+
+//-----------------------------------------------------------------------
+
+eLuxContactEvent cLuxContactPairCache::UpdatePair(iLuxCollideCallbackContainer *apCollider1, iLuxCollideCallbackContainer *apCollider2, bool abWasColliding)
+{
+	bool bColliding = CheckPair(apCollider1, apCollider2);
+
+	if(bColliding)	return abWasColliding ? eLuxContactEvent_Stay : eLuxContactEvent_Enter;
+	else			return abWasColliding ? eLuxContactEvent_Leave : eLuxContactEvent_None;
+}
+
+//-----------------------------------------------------------------------
+
+bool cLuxContactPairCache::CheckPair(iLuxCollideCallbackContainer *apCollider1, iLuxCollideCallbackContainer *apCollider2)
+{
+	//The collision is the same both ways, so keep one entry per pair
+	if(apCollider2 < apCollider1) std::swap(apCollider1, apCollider2);
+
+	size_t lKey1 = apCollider1->GetBodyStateKey();
+	size_t lKey2 = apCollider2->GetBodyStateKey();
+	tLuxContactPairId pairId(apCollider1, apCollider2);
+
+	////////////////////////
+	// No body has moved since the last test
+	tLuxContactPairMapIt it = m_mapPairs.find(pairId);
+	if(it != m_mapPairs.end() && it->second.mlBodyStateKey1 == lKey1 && it->second.mlBodyStateKey2 == lKey2)
+	{
+		return it->second.mbColliding;
+	}
+
+	////////////////////////
+	// Test and store the new state
+	bool bColliding = TestCollision(apCollider1, apCollider2);
+
+	if(it == m_mapPairs.end())
+		it = m_mapPairs.insert(tLuxContactPairMap::value_type(pairId, cLuxContactPair())).first;
+	
+	it->second.mlBodyStateKey1 = lKey1;
+	it->second.mlBodyStateKey2 = lKey2;
+	it->second.mbColliding = bColliding;
+
+	return bColliding;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxContactPairCache::RemovePairs(iLuxCollideCallbackContainer *apCollider)
+{
+	for(tLuxContactPairMapIt it = m_mapPairs.begin(); it != m_mapPairs.end(); )
+	{
+		if(it->first.first == apCollider || it->first.second == apCollider)
+			m_mapPairs.erase(it++);
+		else
+			++it;
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxContactPairCache::Clear()
+{
+	m_mapPairs.clear();
+	mlShapeTestNum =0;
+}
+
+//-----------------------------------------------------------------------
+
+bool cLuxContactPairCache::TestCollision(iLuxCollideCallbackContainer *apCollider1, iLuxCollideCallbackContainer *apCollider2)
+{
+	++mlShapeTestNum;
+
+	cCollideData collideData;
+	collideData.SetMaxSize(1);
+
+	for(int body1=0; body1<apCollider1->GetBodyNum(); ++body1)
+	for(int body2=0; body2<apCollider2->GetBodyNum(); ++body2)
+	{
+		iPhysicsBody *pBody1 = apCollider1->GetBody(body1);
+		iPhysicsBody *pBody2 = apCollider2->GetBody(body2);
+
+		if(cMath::CheckBVIntersection(*pBody1->GetBoundingVolume(), *pBody2->GetBoundingVolume())==false)
+		{
+			continue;
+		}
+
+		if(mpPhysicsWorld->CheckShapeCollision(pBody1->GetShape(), pBody1->GetLocalMatrix(), 
+											pBody2->GetShape(), pBody2->GetLocalMatrix(),
+											collideData,1,false))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// TIMER WHEEL
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+static bool SortTimerNodesByID(cLuxTimerWheelNode *apNodeA, cLuxTimerWheelNode *apNodeB)
+{
+	return apNodeA->mlID < apNodeB->mlID;
+}
+
+static int GetTimerWheelTick(double afTime)
+{
+	double fTick = floor(afTime * kLuxTimerWheelTicksPerSecond);
+	if(fTick > 1000000000.0) fTick = 1000000000.0; //Keep very long timers from overflowing
+	return (int)fTick;
+}
+
+//-----------------------------------------------------------------------
+
+cLuxTimerWheel::cLuxTimerWheel()
+{
+	for(int i=0;i<kLuxTimerWheelLevelNum;++i)
+		for(int j=0;j<kLuxTimerWheelSlotNum;++j)
+			mvSlots[i][j] = NULL;
+
+	mpFreeNodes = NULL;
+
+	mfTime = 0;
+	mlCurrentTick = 0;
+	mlNextID = 0;
+	mlTimerNum = 0;
+}
+
+cLuxTimerWheel::~cLuxTimerWheel()
+{
+	for(size_t i=0;i<mvBlocks.size();++i)
+	{
+		hplDeleteArray(mvBlocks[i]);
+	}
+}
+
+//-----------------------------------------------------------------------
+
+cLuxEventTimer* cLuxTimerWheel::Add(const tString& asName, float afTime, const tString& asFunction)
+{
+	cLuxTimerWheelNode *pNode = CreateNode();
+	pNode->mTimer.msName = asName;
+	pNode->mTimer.msFunction = asFunction;
+	pNode->mTimer.mfCount = afTime;
+	pNode->mTimer.mbDestroyMe = false;
+
+	pNode->mfDueTime = mfTime + afTime;
+	pNode->mlDueTick = GetTimerWheelTick(pNode->mfDueTime);
+	pNode->mlID = mlNextID++;
+
+	AddToWheel(pNode);
+	AddToNameChain(pNode);
+
+	return &pNode->mTimer;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::Remove(const tString& asName)
+{
+	tLuxTimerWheelNameMapIt it = m_mapNameChains.find(asName);
+	if(it == m_mapNameChains.end()) return;
+
+	cLuxTimerWheelNode *pNode = it->second.mpFirst;
+	while(pNode)
+	{
+		cLuxTimerWheelNode *pNext = pNode->mpNameNext;
+
+		RemoveFromNameChain(pNode);
+		pNode->mTimer.mbDestroyMe = true;
+
+		//Due timers are released once all callbacks have been run
+		if(pNode->mbDue==false)
+		{
+			RemoveFromWheel(pNode);
+			DestroyNode(pNode);
+		}
+
+		pNode = pNext;
+	}
+}
+
+//-----------------------------------------------------------------------
+
+cLuxEventTimer* cLuxTimerWheel::Get(const tString& asName)
+{
+	tLuxTimerWheelNameMapIt it = m_mapNameChains.find(asName);
+	if(it == m_mapNameChains.end() || it->second.mpFirst==NULL) return NULL;
+
+	cLuxTimerWheelNode *pNode = it->second.mpFirst;
+	pNode->mTimer.mfCount = (float)(pNode->mfDueTime - mfTime);
+
+	return &pNode->mTimer;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::Clear()
+{
+	for(int i=0;i<kLuxTimerWheelLevelNum;++i)
+	{
+		for(int j=0;j<kLuxTimerWheelSlotNum;++j)
+		{
+			cLuxTimerWheelNode *pNode = mvSlots[i][j];
+			while(pNode)
+			{
+				cLuxTimerWheelNode *pNext = pNode->mpSlotNext;
+				DestroyNode(pNode);
+				pNode = pNext;
+			}
+			mvSlots[i][j] = NULL;
+		}
+	}
+
+	for(size_t i=0;i<mvDueNodes.size();++i)
+		DestroyNode(mvDueNodes[i]);
+	mvDueNodes.clear();
+
+	m_mapNameChains.clear();
+
+	mfTime = 0;
+	mlCurrentTick = 0;
+	mlNextID = 0;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::Update(float afTimeStep)
+{
+	mfTime += afTimeStep;
+	int lNewTick = GetTimerWheelTick(mfTime);
+
+	////////////////////////////
+	// All timers in passed slots are due
+	while(mlCurrentTick < lNewTick)
+	{
+		CollectSlot(mlCurrentTick & (kLuxTimerWheelSlotNum-1), false);
+		++mlCurrentTick;
+
+		//When a level has gone a full turn, move the next slot of the level above down
+		int lTick = mlCurrentTick;
+		for(int lLevel=1; lLevel<kLuxTimerWheelLevelNum; ++lLevel)
+		{
+			if((lTick & (kLuxTimerWheelSlotNum-1)) != 0) break;
+
+			lTick = lTick >> kLuxTimerWheelSlotBits;
+			CascadeSlot(lLevel, lTick & (kLuxTimerWheelSlotNum-1));
+		}
+	}
+
+	////////////////////////////
+	// The current slot can hold timers that are due later in the tick
+	CollectSlot(mlCurrentTick & (kLuxTimerWheelSlotNum-1), true);
+
+	std::sort(mvDueNodes.begin(), mvDueNodes.end(), SortTimerNodesByID);
+}
+
+//-----------------------------------------------------------------------
+
+cLuxEventTimer* cLuxTimerWheel::GetDueTimer(int alIdx)
+{
+	cLuxTimerWheelNode *pNode = mvDueNodes[alIdx];
+	if(pNode->mTimer.mbDestroyMe) return NULL;
+
+	//Once a timer is fired it can no longer be found by name
+	RemoveFromNameChain(pNode);
+	pNode->mTimer.mfCount = (float)(pNode->mfDueTime - mfTime);
+
+	return &pNode->mTimer;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::ReleaseDueTimers()
+{
+	for(size_t i=0;i<mvDueNodes.size();++i)
+	{
+		cLuxTimerWheelNode *pNode = mvDueNodes[i];
+		RemoveFromNameChain(pNode);
+		DestroyNode(pNode);
+	}
+	mvDueNodes.clear();
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::GetTimers(std::vector<cLuxEventTimer*>& avTimers)
+{
+	std::vector<cLuxTimerWheelNode*> vNodes;
+	for(tLuxTimerWheelNameMapIt it = m_mapNameChains.begin(); it != m_mapNameChains.end(); ++it)
+	{
+		for(cLuxTimerWheelNode *pNode = it->second.mpFirst; pNode; pNode = pNode->mpNameNext)
+			vNodes.push_back(pNode);
+	}
+	std::sort(vNodes.begin(), vNodes.end(), SortTimerNodesByID);
+
+	for(size_t i=0;i<vNodes.size();++i)
+	{
+		cLuxTimerWheelNode *pNode = vNodes[i];
+		pNode->mTimer.mfCount = (float)(pNode->mfDueTime - mfTime);
+		avTimers.push_back(&pNode->mTimer);
+	}
+}
+
+//-----------------------------------------------------------------------
+
+cLuxTimerWheelNode* cLuxTimerWheel::CreateNode()
+{
+	if(mpFreeNodes==NULL)
+	{
+		cLuxTimerWheelNode *pBlock = hplNewArray(cLuxTimerWheelNode, kLuxTimerWheelBlockSize);
+		mvBlocks.push_back(pBlock);
+		for(int i=0;i<kLuxTimerWheelBlockSize;++i)
+		{
+			pBlock[i].mpSlotNext = mpFreeNodes;
+			mpFreeNodes = &pBlock[i];
+		}
+	}
+
+	cLuxTimerWheelNode *pNode = mpFreeNodes;
+	mpFreeNodes = pNode->mpSlotNext;
+
+	pNode->mbDue = false;
+	pNode->mpSlotPrev = NULL;
+	pNode->mpSlotNext = NULL;
+	pNode->mpSlot = NULL;
+	pNode->mpNamePrev = NULL;
+	pNode->mpNameNext = NULL;
+	pNode->mpNameChain = NULL;
+
+	++mlTimerNum;
+
+	return pNode;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::DestroyNode(cLuxTimerWheelNode *apNode)
+{
+	//The strings are kept so their memory can be reused
+	apNode->mpSlotNext = mpFreeNodes;
+	mpFreeNodes = apNode;
+
+	--mlTimerNum;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::AddToWheel(cLuxTimerWheelNode *apNode)
+{
+	int lTick = apNode->mlDueTick;
+	if(lTick < mlCurrentTick) lTick = mlCurrentTick;
+	int lDelta = lTick - mlCurrentTick;
+
+	int lLevel = 0;
+	while(lLevel < kLuxTimerWheelLevelNum-1 && lDelta >= (1 << (kLuxTimerWheelSlotBits*(lLevel+1))))
+		++lLevel;
+
+	//Timers further away than the last level can hold are put at its end and placed again when cascaded
+	int lMaxDelta = (1 << (kLuxTimerWheelSlotBits*kLuxTimerWheelLevelNum)) - 1;
+	if(lDelta > lMaxDelta) lTick = mlCurrentTick + lMaxDelta;
+
+	int lSlot = (lTick >> (kLuxTimerWheelSlotBits*lLevel)) & (kLuxTimerWheelSlotNum-1);
+
+	cLuxTimerWheelNode **pSlot = &mvSlots[lLevel][lSlot];
+	apNode->mpSlot = pSlot;
+	apNode->mpSlotPrev = NULL;
+	apNode->mpSlotNext = *pSlot;
+	if(*pSlot) (*pSlot)->mpSlotPrev = apNode;
+	*pSlot = apNode;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::RemoveFromWheel(cLuxTimerWheelNode *apNode)
+{
+	if(apNode->mpSlot==NULL) return;
+
+	if(apNode->mpSlotPrev)	apNode->mpSlotPrev->mpSlotNext = apNode->mpSlotNext;
+	else					*apNode->mpSlot = apNode->mpSlotNext;
+	if(apNode->mpSlotNext)	apNode->mpSlotNext->mpSlotPrev = apNode->mpSlotPrev;
+
+	apNode->mpSlot = NULL;
+	apNode->mpSlotPrev = NULL;
+	apNode->mpSlotNext = NULL;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::CascadeSlot(int alLevel, int alSlot)
+{
+	cLuxTimerWheelNode *pNode = mvSlots[alLevel][alSlot];
+	mvSlots[alLevel][alSlot] = NULL;
+
+	while(pNode)
+	{
+		cLuxTimerWheelNode *pNext = pNode->mpSlotNext;
+		AddToWheel(pNode);
+		pNode = pNext;
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::CollectSlot(int alSlot, bool abOnlyDue)
+{
+	cLuxTimerWheelNode *pNode = mvSlots[0][alSlot];
+	while(pNode)
+	{
+		cLuxTimerWheelNode *pNext = pNode->mpSlotNext;
+		if(abOnlyDue==false || pNode->mfDueTime <= mfTime)
+		{
+			RemoveFromWheel(pNode);
+			pNode->mbDue = true;
+			mvDueNodes.push_back(pNode);
+		}
+		pNode = pNext;
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::AddToNameChain(cLuxTimerWheelNode *apNode)
+{
+	cLuxTimerWheelNameChain *pChain = &m_mapNameChains[apNode->mTimer.msName];
+
+	apNode->mpNameChain = pChain;
+	apNode->mpNameNext = NULL;
+	apNode->mpNamePrev = pChain->mpLast;
+	if(pChain->mpLast)	pChain->mpLast->mpNameNext = apNode;
+	else				pChain->mpFirst = apNode;
+	pChain->mpLast = apNode;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxTimerWheel::RemoveFromNameChain(cLuxTimerWheelNode *apNode)
+{
+	cLuxTimerWheelNameChain *pChain = apNode->mpNameChain;
+	if(pChain==NULL) return;
+
+	if(apNode->mpNamePrev)	apNode->mpNamePrev->mpNameNext = apNode->mpNameNext;
+	else					pChain->mpFirst = apNode->mpNameNext;
+	if(apNode->mpNameNext)	apNode->mpNameNext->mpNamePrev = apNode->mpNamePrev;
+	else					pChain->mpLast = apNode->mpNamePrev;
+
+	apNode->mpNameChain = NULL;
+	apNode->mpNamePrev = NULL;
+	apNode->mpNameNext = NULL;
+
+	//Erase empty chains, scripts that make unique timer names would otherwise grow the map forever
+	if(pChain->mpFirst==NULL) m_mapNameChains.erase(apNode->mTimer.msName);
+}
+
+//-----------------------------------------------------------------------
+
 //////////////////////////////////////////////////////////////////////////
 // CONSTRUCTORS
 //////////////////////////////////////////////////////////////////////////
@@ -83,8 +775,6 @@ cLuxMap::cLuxMap(const tString& asName)
 	mlTotalCompletionAmount = 0;
 	mlCurrentCompletionAmount = 0;
 
-	mbUpdatingTimers = false;
-
 	mbDeletingAllWorldEntities = false;
 
     mfTimeToNexCriticalCheck = 30.0f;
@@ -94,8 +784,6 @@ cLuxMap::cLuxMap(const tString& asName)
 
 cLuxMap::~cLuxMap()
 {
-	STLDeleteAll(mlstTimers);
-	
 	STLDeleteAll(mlstLampLightConnections);
 
 
@@ -196,6 +884,7 @@ bool cLuxMap::LoadFromFile(const tString & asFile, bool abLoadEntities)
 		FatalError("Could not load world file '%s'\n", asFile.c_str());
 
 	mpPhysicsWorld = mpWorld->GetPhysicsWorld();
+	mContactPairCache.SetPhysicsWorld(mpPhysicsWorld);
 
 	if(abLoadEntities) AfterWorldLoadEntitySetup();
 
@@ -247,7 +936,10 @@ void cLuxMap::OnEnter(bool abRunScript, bool abFirstTime)
 			mpScript->Run("OnEnter()");
 		}
 	}
-	
+
+	///////////////
+	//Create sound data for everything preloaded by entities and scripts
+	mpEngine->GetResources()->GetSoundEntityManager()->FlushPreloads();
 }
 
 
@@ -265,21 +957,17 @@ void cLuxMap::OnLeave(bool abRunScript)
 
 void cLuxMap::Update(float afTimeStep)
 {
+	mContactPairCache.ResetShapeTestNum();
+
     UpdateDissolveEntities(afTimeStep);
 	UpdateTimers(afTimeStep);
 	
 	UpdateToBeDesotroyedEntities(true);	
 
 	////////////////////////////////////
-	// Iterate entities
-	tLuxEntityListIt entityIt = mlstEntities.begin();
-	for(; entityIt != mlstEntities.end(); ++entityIt)
-	{
-		iLuxEntity *pEntity = *entityIt;
-
-        if(pEntity->IsActive()) 
-			pEntity->UpdateLogic(afTimeStep);
-	}
+	// Update the entities that are scheduled this frame
+	WakeEntitiesWithAwakeBodies();
+	mTickScheduler.Update(afTimeStep);
 
 	UpdateToBeDesotroyedEntities(true);
 	
@@ -453,7 +1141,7 @@ void cLuxMap::CreateEntity(const tString& asName, const tString& asFile, const c
 
 void cLuxMap::DestroyAllEntities()
 {
-	STLDeleteAll(mlstTimers);
+	mTimerWheel.Clear();
 
 	STLDeleteAll(mlstLampLightConnections);//Since these depend on entities, destroy...
 
@@ -461,6 +1149,8 @@ void cLuxMap::DestroyAllEntities()
 	STLDeleteAll(mlstEntities);
 	mbDeletingAllWorldEntities = false;
 	
+	mTickScheduler.Clear();
+	mContactPairCache.Clear();
 	m_mapEntitiesByID.clear();
 	m_mapEntitiesByName.clear();
 	mlstToBeDestroyedEntities.clear();
@@ -473,9 +1163,10 @@ void cLuxMap::DestroyAllEntities()
 
 void cLuxMap::AddEntity(iLuxEntity *apEntity)
 {
-	m_mapEntitiesByName.insert(tLuxEntityNameMap::value_type(cString::ToLowerCase(apEntity->GetName()), apEntity));
+	m_mapEntitiesByName.insert(tLuxEntityNameMap::value_type(cNameTable::GetId(apEntity->GetName()), apEntity));
 	m_mapEntitiesByID.insert(tLuxEntityIDMap::value_type(apEntity->GetID(), apEntity));
 	mlstEntities.push_back(apEntity);
+	mTickScheduler.Add(apEntity);
 
 	mpLatestAddedEntity = apEntity;
 
@@ -508,7 +1199,12 @@ void cLuxMap::DestroyEntity(iLuxEntity *apEntity)
 
 iLuxEntity *cLuxMap::GetEntityByName(const tString& asName, eLuxEntityType aType, int alSubType)
 {
-	tLuxEntityNameMapIt it = m_mapEntitiesByName.find(cString::ToLowerCase(asName));
+	return GetEntityByNameId(cNameTable::FindId(asName), aType, alSubType);
+}
+
+iLuxEntity *cLuxMap::GetEntityByNameId(tNameId alNameId, eLuxEntityType aType, int alSubType)
+{
+	tLuxEntityNameMapIt it = m_mapEntitiesByName.find(alNameId);
 	if(it == m_mapEntitiesByName.end()) return NULL;
 
 	iLuxEntity *pEntity = it->second;
@@ -785,29 +1481,7 @@ iPhysicsBody* cLuxMap::GetBodyFromEntityBodyIdPair(const cLuxIdPair &aIdPair)
 
 bool cLuxMap::CheckCollision(iLuxCollideCallbackContainer *apCollider1, iLuxCollideCallbackContainer* apCollider2)
 {
-	cCollideData collideData;
-	collideData.SetMaxSize(1);
-
-	for(int body1=0; body1<apCollider1->GetBodyNum(); ++body1)
-	for(int body2=0; body2<apCollider2->GetBodyNum(); ++body2)
-	{
-		iPhysicsBody *pBody1 = apCollider1->GetBody(body1);
-		iPhysicsBody *pBody2 = apCollider2->GetBody(body2);
-
-		if(cMath::CheckBVIntersection(*pBody1->GetBoundingVolume(), *pBody2->GetBoundingVolume())==false)
-		{
-			continue;
-		}
-
-		if(mpPhysicsWorld->CheckShapeCollision(pBody1->GetShape(), pBody1->GetLocalMatrix(), 
-											pBody2->GetShape(), pBody2->GetLocalMatrix(),
-											collideData,1,false))
-		{
-			return true;
-		}
-	}
-
-	return false;
+	return mContactPairCache.CheckPair(apCollider1, apCollider2);
 }
 
 //-----------------------------------------------------------------------
@@ -936,58 +1610,21 @@ cLuxUseItemCallback* cLuxMap::GetUseItemCallback(const tString& asItem, const tS
 
 void cLuxMap::AddTimer(const tString& asName, float afTime, const tString& asFunction)
 {
-	cLuxEventTimer *pTimer = hplNew( cLuxEventTimer, ());
-	pTimer->msName = asName;
-	pTimer->mfCount = afTime > 0 ? afTime : 0.001f; //Not allow 0 or lower for time!
-	pTimer->msFunction = asFunction;
-	pTimer->mbDestroyMe = false;
-
-	mlstTimers.push_back(pTimer);
+	mTimerWheel.Add(asName, afTime > 0 ? afTime : 0.001f, asFunction); //Not allow 0 or lower for time!
 }
 
 //-----------------------------------------------------------------------
 
 void cLuxMap::RemoveTimer(const tString& asName)
 {
-	for(tLuxEventTimerListIt it= mlstTimers.begin(); it != mlstTimers.end(); )
-	{
-		cLuxEventTimer *pTimer = *it;
-		if(pTimer->msName == asName)
-		{
-			if(mbUpdatingTimers)
-			{
-				pTimer->mbDestroyMe = true;
-				++it;
-			}
-			else
-			{
-				it = mlstTimers.erase(it);
-				hplDelete(pTimer);
-				
-			}
-			
-		}
-		else
-		{
-			++it;
-		}
-	}
+	mTimerWheel.Remove(asName);
 }
 
 //-----------------------------------------------------------------------
 
 cLuxEventTimer* cLuxMap::GetTimer(const tString& asName)
 {
-	for(tLuxEventTimerListIt it= mlstTimers.begin(); it != mlstTimers.end();++it)
-	{
-		cLuxEventTimer *pTimer = *it;
-		if(pTimer->msName == asName)
-		{
-			return pTimer;
-		}
-	}
-
-	return NULL;
+	return mTimerWheel.Get(asName);
 }
 
 //-----------------------------------------------------------------------
@@ -1191,6 +1828,7 @@ void cLuxMap::UpdateToBeDesotroyedEntities(bool abUseCallbacks)
 		}
 		
 		STLFindAndRemove(mlstEntities, pEntity);
+		mTickScheduler.Remove(pEntity);
 		STLMapFindAndRemove(m_mapEntitiesByName, pEntity);
 		STLMapFindAndRemove(m_mapEntitiesByID, pEntity);
 
@@ -1220,51 +1858,25 @@ void cLuxMap::UpdateToBeDesotroyedEntities(bool abUseCallbacks)
 
 void cLuxMap::UpdateTimers(float afTimeStep)
 {
-	mbUpdatingTimers = true;
-
 	//////////////////////
-	// Update time (do this here so a timer callback is not called in the same loop as it is created)
-	for(tLuxEventTimerListIt it= mlstTimers.begin(); it != mlstTimers.end(); ++it)
-	{
-		cLuxEventTimer *pTimer = *it;
-		pTimer->mfCount -= afTimeStep;
-	}
+	// Update time and get all due timers (timers added by the callbacks are not due until the next update)
+	mTimerWheel.Update(afTimeStep);
 
 	//////////////////////
-	// See if any timers should be deleted / called
-	for(tLuxEventTimerListIt it= mlstTimers.begin(); it != mlstTimers.end(); )
+	// Call the due timers, timers removed by an earlier callback are returned as NULL
+	for(int i=0;i<mTimerWheel.GetDueNum();++i)
 	{
-		cLuxEventTimer *pTimer = *it;
-
-		if(pTimer->mfCount <=0 && pTimer->mbDestroyMe==false)
-		{
-			RunScript(pTimer->msFunction+"(\""+pTimer->msName+"\")");
-			it = mlstTimers.erase(it);
-			hplDelete(pTimer);
-			
-		}
-		else
-		{
-			++it;
-		}
-	}
-	
-	for(tLuxEventTimerListIt it= mlstTimers.begin(); it != mlstTimers.end(); )
-	{
-		cLuxEventTimer *pTimer = *it;
-		if(pTimer->mbDestroyMe)
-		{
-			it = mlstTimers.erase(it);
-			hplDelete(pTimer);
-			
-		}
-		else
-		{
-			++it;
-		}
+		cLuxEventTimer *pTimer = mTimerWheel.GetDueTimer(i);
+		if(pTimer==NULL) continue;
+
+		msTimerCommand = pTimer->msFunction;
+		msTimerCommand += "(\"";
+		msTimerCommand += pTimer->msName;
+		msTimerCommand += "\")";
+		RunScript(msTimerCommand);
 	}
 
-	mbUpdatingTimers = false;
+	mTimerWheel.ReleaseDueTimers();
 }
 
 //-----------------------------------------------------------------------
@@ -1292,6 +1904,26 @@ void cLuxMap::UpdateDissolveEntities(float afTimeStep)
 
 //-----------------------------------------------------------------------
 
+/**
+ * Entities with moving bodies are updated every frame. Only the physics world's awake bodies are visited,
+ * so sleeping and static props cost nothing here.
+ */
+void cLuxMap::WakeEntitiesWithAwakeBodies()
+{
+	if(mpPhysicsWorld==NULL) return;
+
+	for(int i=0; i<mpPhysicsWorld->GetUpdateBodyNum(); ++i)
+	{
+		iPhysicsBody *pBody = mpPhysicsWorld->GetUpdateBody(i);
+		iLuxEntity *pEntity = (iLuxEntity*)pBody->GetUserData();
+		if(pEntity==NULL) continue;
+
+		pEntity->WakeTick();
+	}
+}
+
+//-----------------------------------------------------------------------
+
 void cLuxMap::UpdateLampLightConnections(float afTimeStep)
 {
 	tLuxLampLightConnectionListIt it = mlstLampLightConnections.begin();
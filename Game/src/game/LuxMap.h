@@ -64,6 +64,211 @@ typedef tLuxDissolveEntityList::iterator tLuxDissolveEntityListIt;
 
 //----------------------------------------------
 
+#define kLuxEntityTickBucketNum 5
+
+/**
+ * Decides which entities get UpdateLogic called each frame. Entities are kept in dense buckets where bucket N
+ * is updated every 2^N frames (spread out over the frames), and sleeping entities are not in any bucket.
+ * An entity is placed in a bucket after each update based on its tick rate and if it is idle.
+ */
+class cLuxEntityTickScheduler
+{
+public:
+	cLuxEntityTickScheduler();
+
+	void Add(iLuxEntity *apEntity);
+	void Remove(iLuxEntity *apEntity);
+	void Clear();
+
+	void Wake(iLuxEntity *apEntity);
+
+	void Update(float afTimeStep);
+
+	int GetEntityNum(){ return mlEntityNum;}
+	int GetTickedNum(){ return mlTickedNum;}
+	int GetSleepingNum();
+
+private:
+	void PlaceEntity(iLuxEntity *apEntity);
+	int GetIntervalBucket(int alInterval);
+	int GetDistanceBucket(iLuxEntity *apEntity);
+
+	void AddToBucket(iLuxEntity *apEntity, int alBucket);
+	void RemoveFromBucket(iLuxEntity *apEntity);
+
+	std::vector<iLuxEntity*> mvBuckets[kLuxEntityTickBucketNum];
+	std::vector<iLuxEntity*> mvTickList;
+
+	double mfTime;
+	int mlFrameCount;
+
+	int mlEntityNum;
+	int mlTickedNum;
+
+	float mfWakeTime;
+	float mfMaxTickTimeStep;
+	float mfFullRateDistance;
+};
+
+//----------------------------------------------
+
+class cLuxContactPair
+{
+public:
+	size_t mlBodyStateKey1;
+	size_t mlBodyStateKey2;
+	bool mbColliding;
+};
+
+typedef std::pair<iLuxCollideCallbackContainer*, iLuxCollideCallbackContainer*> tLuxContactPairId;
+
+typedef std::map<tLuxContactPairId, cLuxContactPair> tLuxContactPairMap;
+typedef tLuxContactPairMap::iterator tLuxContactPairMapIt;
+
+/**
+ * Caches the collision state of collider pairs (script collide callbacks and CheckCollision).
+ * A pair is only shape tested again when the body state key of one side has changed, which happens
+ * when any of its bodies has moved. UpdatePair turns the state into enter, stay and leave events.
+ */
+class cLuxContactPairCache
+{
+public:
+	cLuxContactPairCache();
+
+	void SetPhysicsWorld(iPhysicsWorld *apPhysicsWorld){ mpPhysicsWorld = apPhysicsWorld;}
+
+	/**
+	 * abWasColliding is the state the caller last saw, so events stay correct for new callbacks and after loading.
+	 */
+	eLuxContactEvent UpdatePair(iLuxCollideCallbackContainer *apCollider1, iLuxCollideCallbackContainer *apCollider2, bool abWasColliding);
+	bool CheckPair(iLuxCollideCallbackContainer *apCollider1, iLuxCollideCallbackContainer *apCollider2);
+
+	/**
+	 * Must be called when a collider is destroyed, so a new one at the same address does not get its pairs.
+	 */
+	void RemovePairs(iLuxCollideCallbackContainer *apCollider);
+	void Clear();
+
+	int GetPairNum(){ return (int)m_mapPairs.size();}
+	int GetShapeTestNum(){ return mlShapeTestNum;}
+	void ResetShapeTestNum(){ mlShapeTestNum =0;}
+
+private:
+	bool TestCollision(iLuxCollideCallbackContainer *apCollider1, iLuxCollideCallbackContainer *apCollider2);
+
+	iPhysicsWorld *mpPhysicsWorld;
+	tLuxContactPairMap m_mapPairs;
+
+	int mlShapeTestNum;
+};
+
+//----------------------------------------------
+
+#define kLuxTimerWheelLevelNum 4
+#define kLuxTimerWheelSlotBits 6
+#define kLuxTimerWheelSlotNum (1<<kLuxTimerWheelSlotBits)
+#define kLuxTimerWheelTicksPerSecond 60.0
+#define kLuxTimerWheelBlockSize 64
+
+class cLuxTimerWheelNameChain;
+
+class cLuxTimerWheelNode
+{
+public:
+	cLuxEventTimer mTimer;
+
+	double mfDueTime;
+	int mlDueTick;
+	int mlID;
+	bool mbDue;
+
+	cLuxTimerWheelNode *mpSlotPrev;
+	cLuxTimerWheelNode *mpSlotNext;	//Also used for the free list
+	cLuxTimerWheelNode **mpSlot;
+
+	cLuxTimerWheelNode *mpNamePrev;
+	cLuxTimerWheelNode *mpNameNext;
+	cLuxTimerWheelNameChain *mpNameChain;
+};
+
+class cLuxTimerWheelNameChain
+{
+public:
+	cLuxTimerWheelNameChain() : mpFirst(NULL), mpLast(NULL){}
+
+	cLuxTimerWheelNode *mpFirst;
+	cLuxTimerWheelNode *mpLast;
+};
+
+typedef std::map<tString, cLuxTimerWheelNameChain> tLuxTimerWheelNameMap;
+typedef tLuxTimerWheelNameMap::iterator tLuxTimerWheelNameMapIt;
+
+/**
+ * Keeps the script timers of a map in a hierarchical timing wheel. Each level has 64 slots and every level
+ * covers 64 times the time of the one below, the lowest level having a slot per 1/60 s. Timers are moved down
+ * a level when their slot comes up, so adding and removing is O(1) and an update only looks at due slots.
+ * Timers with the same name are kept in a chain so they can be found without a scan, and the
+ * nodes are taken from a pool, so no memory is allocated once a map has warmed up.
+ */
+class cLuxTimerWheel
+{
+public:
+	cLuxTimerWheel();
+	~cLuxTimerWheel();
+
+	cLuxEventTimer* Add(const tString& asName, float afTime, const tString& asFunction);
+	void Remove(const tString& asName);
+	cLuxEventTimer* Get(const tString& asName);
+	void Clear();
+
+	/**
+	 * Advances the time and collects all timers that are due, in the order they were added.
+	 */
+	void Update(float afTimeStep);
+
+	int GetDueNum(){ return (int)mvDueNodes.size();}
+	/**
+	 * Returns NULL if the timer has been removed after it was collected.
+	 */
+	cLuxEventTimer* GetDueTimer(int alIdx);
+	void ReleaseDueTimers();
+
+	/**
+	 * Gets all active timers in the order they were added, with the time left updated.
+	 */
+	void GetTimers(std::vector<cLuxEventTimer*>& avTimers);
+
+	int GetTimerNum(){ return mlTimerNum;}
+
+private:
+	cLuxTimerWheelNode* CreateNode();
+	void DestroyNode(cLuxTimerWheelNode *apNode);
+
+	void AddToWheel(cLuxTimerWheelNode *apNode);
+	void RemoveFromWheel(cLuxTimerWheelNode *apNode);
+	void CascadeSlot(int alLevel, int alSlot);
+	void CollectSlot(int alSlot, bool abOnlyDue);
+
+	void AddToNameChain(cLuxTimerWheelNode *apNode);
+	void RemoveFromNameChain(cLuxTimerWheelNode *apNode);
+
+	cLuxTimerWheelNode *mvSlots[kLuxTimerWheelLevelNum][kLuxTimerWheelSlotNum];
+
+	tLuxTimerWheelNameMap m_mapNameChains;
+
+	std::vector<cLuxTimerWheelNode*> mvBlocks;
+	cLuxTimerWheelNode *mpFreeNodes;
+
+	std::vector<cLuxTimerWheelNode*> mvDueNodes;
+
+	double mfTime;
+	int mlCurrentTick;
+	int mlNextID;
+	int mlTimerNum;
+};
+
+//----------------------------------------------
+
 class cLuxMap
 {
 friend class cLuxDissolveEntity;
@@ -107,11 +312,15 @@ public:
 
 	void AddEntity(iLuxEntity *apEntity);
 
+	cLuxEntityTickScheduler* GetTickScheduler(){ return &mTickScheduler;}
+	cLuxContactPairCache* GetContactPairCache(){ return &mContactPairCache;}
+
 	/**
 	 * Do not call this when IsDeletingAllWorldEntities is true!
 	 */
 	void DestroyEntity(iLuxEntity *apEntity);
 	iLuxEntity *GetEntityByName(const tString& asName, eLuxEntityType aType=eLuxEntityType_LastEnum, int alSubType=-1);
+	iLuxEntity *GetEntityByNameId(tNameId alNameId, eLuxEntityType aType=eLuxEntityType_LastEnum, int alSubType=-1);
 	iLuxEntity *GetEntityByID(int alID, eLuxEntityType aType=eLuxEntityType_LastEnum, int alSubType=-1);
 	iLuxEntity *GetLatestEntity(){ return mpLatestAddedEntity;}
 	void ResetLatestEntity(){ mpLatestAddedEntity=NULL;}
@@ -170,6 +379,7 @@ public:
 	void AddTimer(const tString& asName, float afTime, const tString& asFunction);
 	void RemoveTimer(const tString& asName);
 	cLuxEventTimer* GetTimer(const tString& asName);
+	cLuxTimerWheel* GetTimerWheel(){ return &mTimerWheel;}
 	
 	void AddDissolveEntity(cMeshEntity *apMeshEntity, float afTime);
 
@@ -199,6 +409,7 @@ private:
 
 	void UpdateToBeDesotroyedEntities(bool abUseCallbacks);
 	void UpdateTimers(float afTimeStep);
+	void WakeEntitiesWithAwakeBodies();
 	void UpdateDissolveEntities(float afTimeStep);
 	void UpdateLampLightConnections(float afTimeStep);
 
@@ -208,8 +419,6 @@ private:
 
 	tString msDisplayNameEntry;
 
-	bool mbUpdatingTimers;
-
 	bool mbDeletingAllWorldEntities;
 	
 	cEngine *mpEngine;
@@ -233,13 +442,16 @@ private:
 	bool mbCheckPointMusicResume;
 	float mfCheckPointMusicVolume;
 
-	tLuxEventTimerList mlstTimers;
+	cLuxTimerWheel mTimerWheel;
+	tString msTimerCommand;
 
 	tLuxScriptVarMap m_mapVars;
 	
 	tLuxEntityNameMap m_mapEntitiesByName;
 	tLuxEntityIDMap m_mapEntitiesByID;
 	tLuxEntityList mlstEntities;
+	cLuxEntityTickScheduler mTickScheduler;
+	cLuxContactPairCache mContactPairCache;
 	tLuxEnemyList mlstEnemies;
 	tLuxEntityList mlstToBeDestroyedEntities;
 	iLuxEntity *mpLatestAddedEntity;
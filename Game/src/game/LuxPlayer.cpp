@@ -522,6 +522,7 @@ void cLuxPlayer::OnMapLeave(cLuxMap *apMap)
 	////////////////////////
 	// Clear collide callbacks
 	DestroyCollideCallbacks();
+	apMap->GetContactPairCache()->RemovePairs(this);
 
 	////////////////////////
 	// Run Helper message
@@ -165,6 +165,7 @@ bool iLuxPlayerState_DefaultBase::OnDoAction(eLuxPlayerAction aAction,bool abPre
 		{
 			if(CanInteractWithEntity())
 			{
+				mpEntityInFocus->WakeTick();
 				mpEntityInFocus->OnInteract(mpBodyInFocus,mvFocusPos);
 				mpEntityInFocus->RunInteractCallbackFunc();
 			}
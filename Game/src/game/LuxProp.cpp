@@ -491,6 +491,21 @@ void iLuxProp::OnUpdate(float afTimeStep)
 
 //-----------------------------------------------------------------------
 
+bool iLuxProp::IsTickIdle()
+{
+	if(super_class::IsTickIdle()==false) return false;
+
+	if(mbMoving || mfMovingVolume > 0 || mfMoveStartCount > 0) return false;
+	if(mbCheckOutsidePlayer || mbEffectAlphaFading) return false;
+	if(mpMeshEntity && mfFadeInAlpha < 1) return false;
+	if(mlCurrentNonLoopAnimIndex >= 0 || mpParentBone) return false;
+	if(mlstAttachedProps.empty()==false || mvInteractConnections.empty()==false) return false;
+
+	return IsPropTickIdle();
+}
+
+//-----------------------------------------------------------------------
+
 void iLuxProp::FlashIfNearPlayer(float afTimeStep)
 {
     if ( !mbGlowEnabled ) return;
@@ -1367,7 +1382,7 @@ void iLuxProp::UpdateMeshFading(float afTimeStep)
 void iLuxProp::UpdateAttachedProps(float afTimeStep, bool abForceUpdate)
 {
 	if(mlstAttachedProps.empty()) return;
-	if(abForceUpdate==false && GetMainBody()->GetEnabled()==false) return;
+	if(abForceUpdate==false && GetMainBody()->IsInUpdateList()==false) return;
 
 	tLuxProp_AttachedPropListIt it = mlstAttachedProps.begin(); 
 	for(; it != mlstAttachedProps.end(); ++it)
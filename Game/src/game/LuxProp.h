@@ -313,6 +313,8 @@ public:
 	virtual iEntity3D* GetAttachEntity();
 
 	virtual bool ShowOutlinesOnConnectedBodies(){ return true;}
+
+	bool IsTickIdle();
 	
 	const cMatrixf& GetOnLoadTransform(){ return m_mtxOnLoadTransform; }
 
@@ -387,6 +389,7 @@ protected:
 	virtual void BeforePropDestruction(){}
 
 	virtual void OnStartMove(){}
+	virtual bool IsPropTickIdle(){ return true;}
 
 	void UpdateAttachedProps(float afTimeStep, bool abForceUpdate);
 
@@ -121,6 +121,8 @@ cLuxProp_Item::cLuxProp_Item(const tString &asName,int alID, cLuxMap *apMap) : i
 {
 	mfAmount = 1.0f;
 	mlSpawnContainerID =-1;
+
+	SetTickRate(eLuxEntityTickRate_Distance);
 }
 
 //-----------------------------------------------------------------------
@@ -195,6 +195,8 @@ cLuxProp_Lamp::cLuxProp_Lamp(const tString &asName,int alID, cLuxMap *apMap) : i
 	mpLightConnection1 = NULL;
 	mpLightConnection2 = NULL;
 	mbLightConnectionSetup = false;
+
+	SetTickRate(eLuxEntityTickRate_Distance);
 }
 
 //-----------------------------------------------------------------------
@@ -381,6 +383,13 @@ void cLuxProp_Lamp::FadeTo( float afR, float afG, float afB, float afA, float af
 
 //-----------------------------------------------------------------------
 
+bool cLuxProp_Lamp::IsPropTickIdle()
+{
+	return mbLightConnectionSetup && mbFlickerActive==false;
+}
+
+//-----------------------------------------------------------------------
+
 void cLuxProp_Lamp::BeforePropDestruction()
 {
 }
@@ -104,6 +104,7 @@ public:
 	void OnResetProperties();
 
 	void UpdatePropSpecific(float afTimeStep);
+	bool IsPropTickIdle();
 
 	void FadeTo(float afR, float afG, float afB, float afA, float afRadius, float afTime);
 	
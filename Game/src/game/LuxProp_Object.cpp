@@ -290,6 +290,8 @@ cLuxProp_Object::cLuxProp_Object(const tString &asName,int alID, cLuxMap *apMap)
 	mfVisionMinInfection = 0.0f;
 
 	mpBodyCallback = hplNew(cLuxProp_Object_BodyCallback, (this) );
+
+	SetTickRate(eLuxEntityTickRate_Distance);
 }
 
 //-----------------------------------------------------------------------
@@ -471,6 +473,13 @@ void cLuxProp_Object::UpdatePropSpecific(float afTimeStep)
 
 //-----------------------------------------------------------------------
 
+bool cLuxProp_Object::IsPropTickIdle()
+{
+	return mfLifeLength <= 0 && mbIsInsanityVision==false;
+}
+
+//-----------------------------------------------------------------------
+
 void cLuxProp_Object::BeforePropDestruction()
 {
 	//////////////////////////////
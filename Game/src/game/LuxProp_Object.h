@@ -103,6 +103,7 @@ public:
 	void OnResetProperties();
 
 	void UpdatePropSpecific(float afTimeStep);
+	bool IsPropTickIdle();
 	
 	void BeforePropDestruction();
 
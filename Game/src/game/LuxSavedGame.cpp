@@ -341,11 +341,11 @@ void cLuxSavedGameMap::FromMap(cLuxMap *apMap)
 	/////////////////////
 	//Timers
 	{
-		tLuxEventTimerListIt it = apMap->mlstTimers.begin();
-		for(; it != apMap->mlstTimers.end(); ++it)
+		std::vector<cLuxEventTimer*> vTimers;
+		apMap->mTimerWheel.GetTimers(vTimers);
+		for(size_t i=0; i<vTimers.size(); ++i)
 		{
-			cLuxEventTimer *pTimer = *it;
-			mlstTimers.Add(*pTimer);
+			mlstTimers.Add(*vTimers[i]);
 		}
 	}
 
@@ -660,16 +660,14 @@ void cLuxSavedGameMap::ToMap(cLuxMap *apMap)
 	/////////////////////
 	//Timers
 	{
-		STLDeleteAll(apMap->mlstTimers);
+		apMap->mTimerWheel.Clear();
 		cContainerListIterator<cLuxEventTimer> it = mlstTimers.GetIterator();
 		while(it.HasNext())
 		{
 			cLuxEventTimer& savedTimer = it.Next();
+			if(savedTimer.mbDestroyMe) continue;
 
-			cLuxEventTimer *pTimer = hplNew(cLuxEventTimer,());
-			*pTimer = savedTimer;
-
-			apMap->mlstTimers.push_back(pTimer);
+			apMap->mTimerWheel.Add(savedTimer.msName, savedTimer.mfCount, savedTimer.msFunction);
 		}
 
 	}
@@ -181,11 +181,11 @@ void cLuxSavedMap::FromMap(cLuxMap *apMap)
 	/////////////////////
 	//Timers
 	{
-		tLuxEventTimerListIt it = apMap->mlstTimers.begin();
-		for(; it != apMap->mlstTimers.end(); ++it)
+		std::vector<cLuxEventTimer*> vTimers;
+		apMap->mTimerWheel.GetTimers(vTimers);
+		for(size_t i=0; i<vTimers.size(); ++i)
 		{
-			cLuxEventTimer *pTimer = *it;
-			mlstTimers.Add(*pTimer);
+			mlstTimers.Add(*vTimers[i]);
 		}
 	}
 
@@ -382,16 +382,14 @@ void cLuxSavedMap::ToMap(cLuxMap *apMap)
 	/////////////////////
 	//Timers
 	{
-		STLDeleteAll(apMap->mlstTimers);
+		apMap->mTimerWheel.Clear();
 		cContainerListIterator<cLuxEventTimer> it = mlstTimers.GetIterator();
 		while(it.HasNext())
 		{
 			cLuxEventTimer& savedTimer = it.Next();
-			
-			cLuxEventTimer *pTimer = hplNew(cLuxEventTimer,());
-			*pTimer = savedTimer;
+			if(savedTimer.mbDestroyMe) continue;
 
-			apMap->mlstTimers.push_back(pTimer);
+			apMap->mTimerWheel.Add(savedTimer.msName, savedTimer.mfCount, savedTimer.msFunction);
 		}
 		
 	}
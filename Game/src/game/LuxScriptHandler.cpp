@@ -250,6 +250,7 @@ bool cLuxScriptHandler::GetEntities(const tString& asName,tLuxEntityList &alstEn
 			return false;
 		}
 		        
+		pEntity->WakeTick();
 		alstEntities.push_back(pEntity);
 	}
 	///////////////////
@@ -280,7 +281,11 @@ bool cLuxScriptHandler::GetEntities(const tString& asName,tLuxEntityList &alstEn
 					}
 				}
 
-				if(bContainsStrings) alstEntities.push_back(pEntity);	
+				if(bContainsStrings)
+				{
+					pEntity->WakeTick();
+					alstEntities.push_back(pEntity);
+				}
 			}
 		}
 
@@ -380,6 +385,9 @@ iLuxEntity* cLuxScriptHandler::GetEntity(const tString& asName, eLuxEntityType a
 		return NULL;
 	}
 
+	//Script changes might need updates for an entity that is currently sleeping
+	pEntity->WakeTick();
+
 	return pEntity;
 }
 
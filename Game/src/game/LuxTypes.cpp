@@ -152,27 +152,32 @@ void iLuxCollideCallbackContainer::DestroyCollideCallbacks()
 
 void iLuxCollideCallbackContainer::CheckCollisionCallback(const tString& asName, cLuxMap *apMap)
 {
+	if(mlstCollideCallbacks.empty()) return;
+
 	mbUpdatingCollideCallbacks = true;
 
+	cLuxContactPairCache *pContactPairs = apMap->GetContactPairCache();
+
 	/////////////////////
 	//Iterate the collide callbacks
 	for(tLuxCollideCallbackListIt it = mlstCollideCallbacks.begin(); it != mlstCollideCallbacks.end(); ++it)
 	{
 		cLuxCollideCallback *pCallback = *it;
 		iLuxEntity *pEntity = pCallback->mpCollideEntity;
-		bool bCollide=false;
 
 		if(pEntity==NULL) continue;
 		if(pEntity->IsActive()==false) continue;
 
-		bCollide = CheckEntityCollision(pEntity, apMap);
+		/////////////////////
+		//Get the event for the pair, the shapes are only tested if a body has moved
+		eLuxContactEvent event = pContactPairs->UpdatePair(this, pEntity, pCallback->mbColliding);
 
 		/////////////////////
-		//Handle collision
-		if( (bCollide && pCallback->mbColliding==false) || (bCollide==false && pCallback->mbColliding) )
+		//Handle enter and leave, stay and none need no script call
+		if(event == eLuxContactEvent_Enter || event == eLuxContactEvent_Leave)
 		{
-			int lState = bCollide ? 1 : -1;
-            pCallback->mbColliding = bCollide;
+			int lState = event == eLuxContactEvent_Enter ? 1 : -1;
+            pCallback->mbColliding = event == eLuxContactEvent_Enter;
 			if(lState == pCallback->mlStates || pCallback->mlStates==0)
 			{
 				tString sCommand = pCallback->msCallbackFunc+"(\"" + asName + "\", \""+ pEntity->GetName()+"\", "+cString::ToString(lState)+")" ;
@@ -223,31 +228,23 @@ void iLuxCollideCallbackContainer::CheckCollisionCallback(const tString& asName,
 
 bool iLuxCollideCallbackContainer::CheckEntityCollision(iLuxEntity*apEntity, cLuxMap *apMap)
 {
-	iPhysicsWorld *pPhysicsWorld =apMap->GetPhysicsWorld();
+	return apMap->CheckCollision(this, apEntity);
+}
 
-	cCollideData collideData;
-	collideData.SetMaxSize(1);
+//-----------------------------------------------------------------------
 
-    /////////////////////
-	//Iterate bodies and check for collision
+size_t iLuxCollideCallbackContainer::GetBodyStateKey()
+{
+	size_t lKey = (size_t)GetBodyNum();
 	for(int i=0; i<GetBodyNum(); ++i)
 	{
-		for(int j=0; j<apEntity->GetBodyNum(); ++j)
-		{
-			iPhysicsBody *pBodyA = GetBody(i);
-			iPhysicsBody *pBodyB = apEntity->GetBody(i);
+		iPhysicsBody *pBody = GetBody(i);
 
-			if(cMath::CheckBVIntersection(*pBodyA->GetBoundingVolume(), *pBodyB->GetBoundingVolume()))
-			{
-				bool bCollide = pPhysicsWorld->CheckShapeCollision(	pBodyA->GetShape(), pBodyA->GetLocalMatrix(), 
-																	pBodyB->GetShape(), pBodyB->GetLocalMatrix(),
-																	collideData,1,false);
-				if(bCollide) return true;
-			}
-		}
+		lKey = lKey*31 + (size_t)pBody;
+		lKey = lKey*31 + (size_t)pBody->GetTransformUpdateCount();
 	}
 
-	return false;
+	return lKey;
 }
 
 //-----------------------------------------------------------------------
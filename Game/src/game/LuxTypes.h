@@ -115,6 +115,26 @@ enum eLuxEntityType
 	eLuxEntityType_LastEnum
 };
 
+enum eLuxEntityTickRate
+{
+	eLuxEntityTickRate_EveryFrame,
+	eLuxEntityTickRate_Interval,
+	eLuxEntityTickRate_Distance,
+	eLuxEntityTickRate_OnWake,
+
+	eLuxEntityTickRate_LastEnum
+};
+
+enum eLuxContactEvent
+{
+	eLuxContactEvent_None,
+	eLuxContactEvent_Enter,
+	eLuxContactEvent_Stay,
+	eLuxContactEvent_Leave,
+
+	eLuxContactEvent_LastEnum
+};
+
 enum eLuxPropType
 {
 	eLuxPropType_Object,
@@ -516,7 +536,7 @@ enum eLuxProgressLogLevel
 
 class iLuxEntity;
 
-typedef std::multimap<tString,iLuxEntity*> tLuxEntityNameMap;
+typedef std::multimap<tNameId,iLuxEntity*> tLuxEntityNameMap;
 typedef tLuxEntityNameMap::iterator tLuxEntityNameMapIt;
 
 typedef std::multimap<int,iLuxEntity*> tLuxEntityIDMap;
@@ -682,6 +702,11 @@ public:
 	void CheckCollisionCallback(const tString& asName, cLuxMap *apMap);
 	bool CheckEntityCollision(iLuxEntity*apEntity, cLuxMap *apMap);
 
+	/**
+	 * Key built from the bodies and their transform update counts, changes as soon as any body has moved.
+	 */
+	size_t GetBodyStateKey();
+
 	bool HasCollideCallbacks(){ return mlstCollideCallbacks.empty() == false;}
 	tLuxCollideCallbackList* GetCollideCallbackList(){ return &mlstCollideCallbacks;}
 	void AddCollideCallback(iLuxEntity *apEntity, const tString& asCallbackFunc, bool abRemoveAtCollide, int alStates);
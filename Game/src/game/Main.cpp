@@ -61,6 +61,7 @@ int hplMain(const tString &asCommandline)
 		//No Exit, since it was not sure everything was created as it should.
 	}
 
+	int lExitCode = gpBase->mlExitCode;
 	hplDelete(gpBase);
 
 	cMemoryManager::LogResults();
@@ -71,5 +72,5 @@ int hplMain(const tString &asCommandline)
 			if(hBlackBoxLib) FreeLibrary(hBlackBoxLib);
 	#endif
 
-	return 0;
+	return lExitCode;
 }
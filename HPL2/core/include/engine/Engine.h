@@ -87,6 +87,26 @@ namespace hpl {
 		tString msBlank;
 	};
 
+	//---------------------------------------------------
+
+	/**
+	 * Time in ms spent in the parts of a frame. Logic is all updates run before the frame was rendered
+	 * and swap is the buffer swap presenting it.
+	 */
+	class cEngineFrameTimes
+	{
+	public:
+		cEngineFrameTimes() : mfLogic(0), mfDraw(0), mfRender(0), mfPostRender(0), mfFlush(0), mfSwap(0), mlLogicUpdates(0){}
+
+		double mfLogic;
+		double mfDraw;
+		double mfRender;
+		double mfPostRender;
+		double mfFlush;
+		double mfSwap;
+		int mlLogicUpdates;
+	};
+
 	//---------------------------------------------------
 	    
 	extern cEngine* CreateHPLEngine(eHplAPI aApi, tFlag alHplModuleFlags, cEngineInitVars *apVars);
@@ -162,6 +182,18 @@ namespace hpl {
 		void SetPaused(bool abPaused);
 		bool GetPaused();
 
+		/**
+		 * In fixed step mode every frame runs exactly one logic update and uses the step size as frame time,
+		 * without waiting for real time, frame limit or input focus. Used to get reproducible runs.
+		 */
+		void SetFixedStepMode(bool abX){ mbFixedStepMode = abX;}
+		bool GetFixedStepMode(){ return mbFixedStepMode;}
+
+		/**
+		 * Times for the latest frame that has been swapped, valid in OnPostBufferSwap.
+		 */
+		const cEngineFrameTimes& GetLastFrameTimes(){ return mLastFrameTimes;}
+
 		static void SetDeviceWasPlugged() { mbDevicePlugged = true; }
 		static void SetDeviceWasRemoved() { mbDeviceRemoved = true; }
 		
@@ -231,6 +263,13 @@ namespace hpl {
 		double mfLastFrameRender;
 		iTimer *mpFrameLimitTimer;
 
+		bool mbFixedStepMode;
+		iTimer *mpFramePartTimer;
+		double mfPendingLogicTime;
+		int mlPendingLogicUpdates;
+		cEngineFrameTimes mFrameTimes;
+		cEngineFrameTimes mLastFrameTimes;
+
 		tScriptVarMap m_mapLocalVars;
 		tScriptVarMap m_mapGlobalVars;
 
@@ -59,7 +59,8 @@ namespace hpl {
 				mlMultisampling(0),
 				msWindowCaption(""),
 				mvWindowPosition(-1),
-				mGpuProgramFormat(eGpuProgramFormat_LastEnum)
+				mGpuProgramFormat(eGpuProgramFormat_LastEnum),
+				mbNullDevice(false)
 			{}
 		
 			cVector2l mvScreenSize;
@@ -70,6 +71,7 @@ namespace hpl {
 			tString msWindowCaption;
 			cVector2l mvWindowPosition;
 			eGpuProgramFormat mGpuProgramFormat;
+			bool mbNullDevice;
 		};
 		cGraphicsVars mGraphics;
 		
@@ -89,7 +91,8 @@ namespace hpl {
 				mlMaxMonoChannelsHint(0),
 				mlMaxStereoChannelsHint(0),
 				mlStreamBufferSize(524288),
-				mlStreamBufferCount(2)
+				mlStreamBufferCount(2),
+				mbNullDevice(false)
 			{}
 				
 			int	mlSoundDeviceID;
@@ -103,9 +106,23 @@ namespace hpl {
 			int mlMaxStereoChannelsHint;
 			int mlStreamBufferSize;
 			int mlStreamBufferCount;
+			bool mbNullDevice;
 		};
 		cSoundVars mSound;			
 
+		////////////////////////////////
+		// Physics
+		class cPhysicsVars
+		{
+		public:
+			cPhysicsVars() :
+				mlWorldThreadNum(1)
+			{}
+
+			int mlWorldThreadNum;
+		};
+		cPhysicsVars mPhysics;
+
 	};
 
 	//---------------------------------------
@@ -28,6 +28,7 @@
 namespace hpl {
 
 	class cAnimationTrack;
+	class cAnimationClip;
 	
 	typedef std::vector<cAnimationTrack*> tAnimationTrackVec;
 	typedef tAnimationTrackVec::iterator tAnimationTrackVecIt;
@@ -49,6 +50,13 @@ namespace hpl {
 
 		void SmoothAllTracks(float afAmount, float afPow, int alSamples,bool abTranslation, bool abRotation);
 
+		/**
+		 * Gets the packed version of the tracks, it is created on first call.
+		 * DestroyClip must be called if the key frames are changed after that.
+		 */
+		cAnimationClip* GetClip();
+		void DestroyClip();
+
 		const char* GetAnimationName(){ return msAnimName.c_str();}
 		void SetAnimationName(const tString &asName){ msAnimName =asName;}
 		
@@ -66,6 +74,8 @@ namespace hpl {
 		float mfLength;
 		
 		tAnimationTrackVec mvTracks;
+
+		cAnimationClip *mpClip;
 	};
 
 };
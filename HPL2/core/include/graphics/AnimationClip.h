@@ -0,0 +1,142 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_ANIMATION_CLIP_H
+#define HPL_ANIMATION_CLIP_H
+
+#include "math/MathTypes.h"
+#include "graphics/GraphicsTypes.h"
+#include "system/SystemTypes.h"
+
+namespace hpl {
+
+	class cAnimation;
+	class cAnimationClip;
+
+	//-----------------------------------------------------------------------
+
+	typedef std::vector<cQuaternion> tQuaternionVec;
+	typedef tQuaternionVec::iterator tQuaternionVecIt;
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Local space transforms, one rotation and translation per track (or bone).
+	 */
+	class cAnimationPose
+	{
+	public:
+		void Resize(int alNum);
+		int GetSize(){ return (int)mvRotations.size();}
+
+		tQuaternionVec mvRotations;
+		tVector3fVec mvTranslations;
+	};
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Remembers the last key frame used by each track so that sequential playback
+	 * does not need to search for key frames.
+	 */
+	class cAnimationClipCursor
+	{
+	friend class cAnimationClip;
+	public:
+		cAnimationClipCursor() : mpClip(NULL) {}
+
+		void Reset(){ mpClip = NULL; mvKeyFrames.clear();}
+
+	private:
+		cAnimationClip *mpClip;
+		tIntVec mvKeyFrames;
+	};
+
+	//-----------------------------------------------------------------------
+
+	class cAnimationClipTrack
+	{
+	public:
+		int mlFirstKeyFrame;
+		int mlKeyFrameNum;
+	};
+
+	typedef std::vector<cAnimationClipTrack> tAnimationClipTrackVec;
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Packed version of the tracks in an animation, with all key frame data in
+	 * separate time, rotation and translation streams.
+	 */
+	class cAnimationClip
+	{
+	public:
+		cAnimationClip(cAnimation *apAnimation, bool abQuantizeRotations);
+		~cAnimationClip();
+
+		/**
+		 * Samples all tracks at a certain time. The pose has the same index as the tracks.
+		 * \param apCursor Cursor used to speed up the key frame search, can be NULL.
+		 */
+		void SamplePose(float afTime, bool abLoop, cAnimationClipCursor *apCursor, cAnimationPose *apPose);
+
+		/**
+		 * Samples a single track at a certain time.
+		 */
+		void SampleTrack(int alTrack, float afTime, bool abLoop, cAnimationClipCursor *apCursor,
+						cQuaternion& aqRotation, cVector3f& avTranslation);
+
+		int GetTrackNum(){ return (int)mvTracks.size();}
+		int GetKeyFrameNum(){ return (int)mvTimes.size();}
+		bool HasQuantizedRotations(){ return mbQuantizedRotations;}
+
+		/**
+		 * Size of the key frame data in bytes.
+		 */
+		size_t GetMemorySize();
+
+		static void SetQuantizeRotations(bool abX){ mbQuantizeRotations = abX;}
+		static bool GetQuantizeRotations(){ return mbQuantizeRotations;}
+
+	private:
+		float GetKeyFramesAtTime(const cAnimationClipTrack& aTrack, float afTime, bool abLoop, int *apCursorKey,
+								int &alKeyA, int &alKeyB);
+		void SampleTrackData(const cAnimationClipTrack& aTrack, float afTime, bool abLoop, int *apCursorKey,
+							cQuaternion& aqRotation, cVector3f& avTranslation);
+		void GetRotation(int alKey, cQuaternion& aqDest);
+		int *GetCursorKeys(cAnimationClipCursor *apCursor);
+
+		float mfLength;
+		bool mbQuantizedRotations;
+
+		tAnimationClipTrackVec mvTracks;
+
+		tFloatVec mvTimes;
+		tFloatVec mvRotations;
+		std::vector<short> mvQuantizedRotations;
+		tFloatVec mvTranslations;
+
+		static bool mbQuantizeRotations;
+	};
+
+	//-----------------------------------------------------------------------
+
+};
+#endif // HPL_ANIMATION_CLIP_H
@@ -88,6 +88,7 @@ namespace hpl {
 		bool AddPolygon(int alVertexCount, const cVector3f* apVertices, const cVector3f* apNormals, iVertexBuffer* apDecalVB, 
 						const cMatrixf& amtxWorldMatrix,const cMatrixf& amtxWorldNormalRot);
 		void ClipMesh(cSubMeshEntity* apMesh, iVertexBuffer* apDecalVB);
+		void GetLocalDecalBox(const cMatrixf& a_mtxInvWorld, cVector3f& avMin, cVector3f& avMax);
 		int ClipPolygon(int alVertexCount, const cVector3f* apVertices, const cVector3f* apNormals, 
 						cVector3f* apNewVertices, cVector3f* apNewNormals, const std::vector<cPlanef>& avPlanes);
 		int ClipPolygonAgainstPlane(const cPlanef& aPlane, int alVertexCount, 
@@ -124,6 +125,7 @@ namespace hpl {
 		int mlMaxDecalTriangleCount;
 
 		tPlanefVec mvClipPlanes;
+		tIntVec mvClipTriangles;
 
 		tString msMaterial;
 		cVector2l mvSubDiv;
@@ -257,6 +257,7 @@ namespace hpl {
 	{
 		eGraphicCaps_TextureTargetRectangle,
 		eGraphicCaps_VertexBufferObject,
+		eGraphicCaps_VertexHalfFloat,
 		eGraphicCaps_TwoSideStencil,
 
 		eGraphicCaps_MaxTextureImageUnits,
@@ -362,6 +363,8 @@ namespace hpl {
 		eVertexBufferElementFormat_Float,
 		eVertexBufferElementFormat_Int,
 		eVertexBufferElementFormat_Byte,
+		eVertexBufferElementFormat_Short,		//Signed normalized, -32767 - 32767 -> -1 - 1
+		eVertexBufferElementFormat_HalfFloat,
 		eVertexBufferElementFormat_LastEnum
 	};
 
@@ -901,6 +904,15 @@ namespace hpl {
 
 	extern tVertexElementFlag GetVertexElementFlagFromEnum(eVertexBufferElement aElement);
 	extern int GetVertexFormatByteSize(eVertexBufferElementFormat aFormat);
+	
+	/**
+	 * Converts alNum values between a vertex format and floats. Byte is treated as 0 - 255 -> 0 - 1.
+	 */
+	extern void VertexFormatToFloat(eVertexBufferElementFormat aFormat, const void *apSrc, float *apDest, size_t alNum);
+	extern void FloatToVertexFormat(eVertexBufferElementFormat aFormat, const float *apSrc, void *apDest, size_t alNum);
+	
+	extern unsigned short FloatToHalfFloat(float afX);
+	extern float HalfFloatToFloat(unsigned short alX);
 	extern int GetVertexElementTextureUnit(eVertexBufferElement aElement);
 	
 	extern int GetChannelsInPixelFormat(ePixelFormat aFormat);
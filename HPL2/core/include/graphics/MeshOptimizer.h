@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_MESH_OPTIMIZER_H
+#define HPL_MESH_OPTIMIZER_H
+
+#include "system/SystemTypes.h"
+#include "graphics/GraphicsTypes.h"
+
+namespace hpl {
+
+	class iVertexBuffer;
+	class cSubMesh;
+	class iLowLevelGraphics;
+
+	//--------------------------------------------------
+
+	/**
+	 * Lossless reordering of triangle lists for better post transform vertex cache use and vertex fetch.
+	 * CompactVertexFormat and the lod generation are the only lossy operations.
+	 */
+	class cMeshOptimizer
+	{
+	public:
+		/**
+		 * Reorders the triangles using Tom Forsyth's linear speed vertex cache optimization. Winding is kept.
+		 */
+		static void OptimizeVertexCache(unsigned int *apIndices, int alIndexNum, int alVertexNum, int alCacheSize=32);
+
+		/**
+		 * Creates a remap (old index -> new index) that orders vertices by first use. Unused vertices are put last.
+		 */
+		static void CreateVertexFetchRemap(const unsigned int *apIndices, int alIndexNum, int alVertexNum, tUIntVec& avRemap);
+
+		/**
+		 * Reorders all vertex arrays and the indices in a buffer according to a remap.
+		 */
+		static void RemapVertexBuffer(iVertexBuffer *apVtxBuffer, const tUIntVec& avRemap);
+        
+		/**
+		 * Runs both optimizations on a triangle buffer. Must be done before any shadow double is created.
+		 * \param apSubMesh if not NULL, the vertex-bone pairs and lod vertex remaps are updated as well.
+		 */
+		static void OptimizeVertexBuffer(iVertexBuffer *apVtxBuffer, cSubMesh *apSubMesh);
+
+		/**
+		 * Average cache miss ratio, vertex transforms per triangle for a FIFO cache of alCacheSize.
+		 */
+		static float CalcACMR(const unsigned int *apIndices, int alIndexNum, int alVertexNum, int alCacheSize=32);
+
+		/**
+		 * Stores normals as signed normalized shorts and, if abHalfFloat, tangents and small UVs as half floats.
+		 * Must be called before the buffer is compiled. Positions are always kept as floats. Returns bytes saved.
+		 */
+		static int CompactVertexFormat(iVertexBuffer *apVtxBuffer, bool abHalfFloat);
+
+		/**
+		 * Sets the formats of a loaded buffer that may have been saved compact. If abCompact is false, all elements
+		 * are expanded to floats, since code reading normals, tangents and UVs with GetFloatArray expects that.
+		 */
+		static void SetupLoadedVertexFormat(iVertexBuffer *apVtxBuffer, bool abCompact, bool abHalfFloat);
+
+		/**
+		 * Removes triangles using quadric error edge collapses onto existing vertices. Borders and vertices 
+		 * with several attribute sets (uv seams, hard edges) are never moved.
+		 * \param alPosStride floats per position.
+		 * \param alTargetIndexNum wanted number of indices, the result can have more.
+		 * \param afMaxError largest allowed error relative to the mesh size.
+		 * \return the largest error used, relative to the mesh size.
+		 */
+		static float SimplifyMesh(	const unsigned int *apIndices, int alIndexNum, const float *apPositions, int alPosStride, int alVertexNum,
+									int alTargetIndexNum, float afMaxError, tUIntVec& avDestIndices);
+
+		/**
+		 * Takes indices into a full vertex buffer and creates a remap (lod vertex -> source vertex) and indices for 
+		 * a buffer with only the used vertices. The triangles are optimized for the vertex cache.
+		 */
+		static void CreateLodIndices(const unsigned int *apIndices, int alIndexNum, int alVertexNum, tUIntVec& avVertexRemap, tUIntVec& avLodIndices);
+
+		/**
+		 * Creates a buffer with the vertices in avVertexRemap from the source buffer, in the same formats. Not compiled.
+		 */
+		static iVertexBuffer* CreateLodVertexBuffer(iLowLevelGraphics *apLowLevelGraphics, iVertexBuffer *apSrcBuffer, 
+													const tUIntVec& avVertexRemap, const unsigned int *apLodIndices, int alIndexNum);
+	};
+
+	//--------------------------------------------------
+
+};
+#endif // HPL_MESH_OPTIMIZER_H
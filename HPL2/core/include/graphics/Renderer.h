@@ -47,6 +47,8 @@ namespace hpl {
 	class iRenderableContainer;
 	class iRenderableContainerNode;
 	class cVisibleRCNodeTracker;
+	class cRenderableFlatTree;
+	class iTimer;
 
 	//---------------------------------------------
 
@@ -255,7 +257,7 @@ namespace hpl {
 		void Update(float afTimeStep);
 
 		inline static int GetRenderFrameCount()  { return mlRenderFrameCount;}
-		inline static void IncRenderFrameCount() { ++mlRenderFrameCount;}
+		inline static void IncRenderFrameCount() { ++mlRenderFrameCount; mfContainerCullTime = 0;}
 
 		float GetTimeCount(){ return mfTimeCount;}
 
@@ -305,6 +307,17 @@ namespace hpl {
 		static void SetRefractionEnabled(bool abX) { mbRefractionEnabled = abX;}
 		static bool GetRefractionEnabled(){ return mbRefractionEnabled;}
 
+		/**
+		 * If containers that have a flat tree should be culled using it (default true).
+		 */
+		static void SetUseFlatContainerTrees(bool abX) { mbUseFlatContainerTrees = abX;}
+		static bool GetUseFlatContainerTrees(){ return mbUseFlatContainerTrees;}
+
+		/**
+		 * Milliseconds spent checking containers for visible objects (brute force path) in the current frame.
+		 */
+		static double GetContainerCullTime(){ return mfContainerCullTime;}
+
 		static void IncDrawCalls() { mlDrawCalls++; }
 		static int GetDrawCalls() { return mlDrawCalls; }
 
@@ -339,6 +352,13 @@ namespace hpl {
 
 		void CheckNodesAndAddToListIterative(iRenderableContainerNode *apNode, tRenderableFlag alNeededFlags);
 
+		void CheckFlatTreeAndAddToList(cRenderableFlatTree *apTree, tRenderableFlag alNeededFlags);
+		void CheckFlatTreeNodesAndAddToList(cRenderableFlatTree *apTree, int alNode, int alPlaneMask, tRenderableFlag alNeededFlags);
+		void AddFlatTreeObjectsToList(cRenderableFlatTree *apTree, int alFirst, int alNum, bool abInside, tRenderableFlag alNeededFlags);
+
+		void AddVisibleObjectToList(iRenderable *apObject);
+		void CompareFlatTreeWithNodes(iRenderableContainer *apContainer, tRenderableFlag alNeededFlags);
+
 
 		/**
 		 * Uses a Coherent occlusion culling to get visible objects. No early Z needed after calling this
@@ -478,6 +498,12 @@ namespace hpl {
 		bool mbOcclusionPlanesActive;
 		tPlanefVec mvCurrentOcclusionPlanes;
 
+		tPlanefVec mvFlatTreeCullPlanes;
+		int mlFlatTreeFrustumPlaneMask;
+		tRenderableVec *mpCullCompareObjects;
+
+		iTimer *mpContainerCullTimer;
+
 		cRendererCallbackFunctions *mpCallbackFunctions;
 
 		int mlActiveOcclusionQueryNum;
@@ -495,6 +521,8 @@ namespace hpl {
 		static bool mbParallaxEnabled;
 		static int mlReflectionSizeDiv;
 		static bool mbRefractionEnabled;
+		static bool mbUseFlatContainerTrees;
+		static double mfContainerCullTime;
 		static int mlDrawCalls;
 	};
 
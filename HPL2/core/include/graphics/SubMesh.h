@@ -30,6 +30,7 @@ namespace hpl {
 
 	class cMaterial;
 	class iVertexBuffer;
+	class cTriangleBVH;
 
 	class cMesh;
 	class iPhysicsWorld;
@@ -55,6 +56,24 @@ namespace hpl {
 
 	//--------------------------------------------------
 
+	/**
+	 * A lower detail version of a sub mesh. The vertices are a subset of the sub mesh vertices.
+	 */
+	class cSubMeshLod
+	{
+	public:
+		cSubMeshLod() : mfMaxScreenSize(0), mpVtxBuffer(NULL) {}
+
+		float mfMaxScreenSize;	//Used when the mesh covers less than this part of the screen height.
+		tUIntVec mvVertexRemap; //Lod vertex -> sub mesh vertex, used to get the bone weights.
+		iVertexBuffer* mpVtxBuffer;
+	};
+
+	typedef std::vector<cSubMeshLod*> tSubMeshLodVec;
+	typedef tSubMeshLodVec::iterator tSubMeshLodVecIt;
+
+	//--------------------------------------------------
+
 	class cSubMesh
 	{
 	friend class cMesh;
@@ -70,6 +89,11 @@ namespace hpl {
 		cMaterial *GetMaterial();
 		iVertexBuffer* GetVertexBuffer();
 
+		/**
+		 * Triangle tree of the vertex buffer in mesh local space, built the first time it is requested.
+		 */
+		cTriangleBVH* GetTriangleBVH();
+
 		const tString& GetName(){ return msName;}
 
 		//Vertex-Bone pairs
@@ -80,6 +104,18 @@ namespace hpl {
 		void AddVertexBonePair(const cVertexBonePair &aPair);
 		void ClearVertexBonePairs();
 
+		/**
+		 * If set before Compile, the bone weights are kept as unorm8 instead of floats. Used with compact vertex buffers.
+		 */
+		void SetCompactBoneWeights(bool abX){ mbCompactBoneWeights = abX;}
+		bool GetCompactBoneWeights(){ return mbCompactBoneWeights;}
+
+		//Detail levels, level 0 is the sub mesh itself and the lods are levels 1 and up.
+		cSubMeshLod* AddLod(float afMaxScreenSize, iVertexBuffer *apVtxBuffer, const tUIntVec& avVertexRemap);
+		cSubMeshLod* GetLod(int alIdx){ return mvLods[alIdx];}
+		int GetLodNum(){ return (int)mvLods.size();}
+		void DestroyLods();
+
 		//Colliders
 		cMeshCollider* CreateCollider(eCollideShapeType aType);
 		cMeshCollider* GetCollider(int alIdx);
@@ -117,12 +153,28 @@ namespace hpl {
 	private:
 		void CheckOneSided();
 		void CompileBonePairs();
+		void PackBoneWeights();
+
+		inline void GetBoneWeights(int alVertex, float *apDest)
+		{
+			if(mpPackedVertexWeights)
+			{
+				const unsigned char *pPacked = &mpPackedVertexWeights[alVertex*4];
+				for(int i=0; i<4; ++i) apDest[i] = (float)pPacked[i] * (1.0f / 255.0f);
+			}
+			else
+			{
+				const float *pWeight = &mpVertexWeights[alVertex*4];
+				for(int i=0; i<4; ++i) apDest[i] = pWeight[i];
+			}
+		}
 
 		tString msName;
 		
 		tString msMaterialName;
 		cMaterial* mpMaterial;
 		iVertexBuffer* mpVtxBuffer;
+		cTriangleBVH* mpTriangleBVH;
 
 		cMatrixf m_mtxLocalTransform;
 
@@ -130,8 +182,12 @@ namespace hpl {
 
 		tMeshColliderVec mvColliders;
 
+		tSubMeshLodVec mvLods;
+
 		float *mpVertexWeights;
+		unsigned char *mpPackedVertexWeights;
 		unsigned char *mpVertexBones;
+		bool mbCompactBoneWeights;
 
 		tTriEdgeVec mvEdges;
 		tTriangleDataVec mvTriangles;
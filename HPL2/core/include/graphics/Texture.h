@@ -44,7 +44,8 @@ namespace hpl {
 				mfFrameTime(1), mAnimMode(eTextureAnimMode_Loop), mlSizeDownScaleLevel(0), mvMinDownScaleSize(16,16,16),
 				mfAnisotropyDegree(1.0f),mFilter(eTextureFilter_Bilinear),
 				mCompareMode(eTextureCompareMode_None),
-				mCompareFunc(eTextureCompareFunc_LessOrEqual)
+				mCompareFunc(eTextureCompareFunc_LessOrEqual),
+				mlRenderFrameCount(-1)
 		{}
 
 		virtual ~iTexture(){}
@@ -113,9 +114,16 @@ namespace hpl {
 		bool IsCompressed(){ return mbIsCompressed; }
 		
 		void SetSizeDownScaleLevel(unsigned int alLevel){mlSizeDownScaleLevel = alLevel;}
+		unsigned int GetSizeDownScaleLevel(){ return mlSizeDownScaleLevel;}
 		void SetMinLevelSize(const cVector2l& avSize){ mvMinDownScaleSize = avSize;}
 
 		eFrameBufferAttachment GetFrameBufferAttachmentType(){ return eFrameBufferAttachment_Texture;}
+
+		/**
+		 * The last renderer frame the texture was bound. Used by the texture manager to track what is in use.
+		 */
+		inline int GetRenderFrameCount() const { return mlRenderFrameCount;}
+		inline void SetRenderFrameCount(int alCount){ mlRenderFrameCount = alCount;}
 		
 		virtual bool HasAnimation()=0;
 		virtual void NextFrame()=0;
@@ -152,6 +160,8 @@ namespace hpl {
 		unsigned int mlSizeDownScaleLevel;
 		cVector3l mvMinDownScaleSize;
 
+		int mlRenderFrameCount;
+
 	};
 };
 #endif // HPL_TEXTURE_H
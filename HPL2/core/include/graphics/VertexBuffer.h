@@ -89,6 +89,20 @@ namespace hpl {
 		virtual float* GetFloatArray(eVertexBufferElement aElement)=0;
 		virtual int* GetIntArray(eVertexBufferElement aElement)=0;
 		virtual unsigned char* GetByteArray(eVertexBufferElement aElement)=0;
+		/**
+		 * Used for both the Short and HalfFloat formats.
+		 */
+		virtual unsigned short* GetShortArray(eVertexBufferElement aElement)=0;
+
+		/**
+		 * Gets the values of one vertex as floats no matter what format the element is in.
+		 */
+		void GetElementFloats(eVertexBufferElement aElement, int alVertex, float *apDest);
+
+		/**
+		 * Converts the data of an element to a new format. If the buffer is compiled, UpdateData must be called after.
+		 */
+		virtual bool ConvertElementFormat(eVertexBufferElement aElement, eVertexBufferElementFormat aFormat)=0;
 		
 		virtual unsigned int* GetIndices()=0;
 		
@@ -31,6 +31,9 @@
 #include "system/PreprocessParser.h"
 #include "system/Thread.h"
 #include "system/Mutex.h"
+#include "system/JobPool.h"
+#include "system/NameTable.h"
+#include "system/MemoryArena.h"
 #include "system/Platform.h"
 #include "system/SHA1.h"
 
@@ -63,6 +66,7 @@
 #include "graphics/GPUShader.h"
 #include "graphics/GPUProgram.h"
 #include "graphics/VertexBuffer.h"
+#include "graphics/MeshOptimizer.h"
 #include "graphics/Mesh.h"
 #include "graphics/SubMesh.h"
 #include "graphics/Skeleton.h"
@@ -70,6 +74,7 @@
 #include "graphics/BoneState.h"
 #include "graphics/Animation.h"
 #include "graphics/AnimationTrack.h"
+#include "graphics/AnimationClip.h"
 #include "graphics/OcclusionQuery.h"
 #include "graphics/VideoStream.h"
 #include "graphics/Bitmap.h"
@@ -94,6 +99,7 @@
 #include "math/Spring.h"
 #include "math/PidController.h"
 #include "math/CRC.h"
+#include "math/TriangleBVH.h"
 
 #include "resources/Resources.h"
 #include "resources/LowLevelResources.h"
@@ -130,6 +136,7 @@
 #include "scene/World.h"
 #include "scene/Camera.h"
 #include "scene/RenderableContainer.h"
+#include "scene/RenderableFlatTree.h"
 #include "scene/MeshEntity.h"
 #include "scene/LightPoint.h"
 #include "scene/LightSpot.h"
@@ -0,0 +1,220 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ *
+ * This file is part of Amnesia: A Machine For Pigs.
+ *
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_GRAPHICS_OBJECTS_NULL_H
+#define HPL_GRAPHICS_OBJECTS_NULL_H
+
+#include <map>
+
+#include "graphics/Texture.h"
+#include "graphics/GPUShader.h"
+#include "graphics/GPUProgram.h"
+#include "graphics/FrameBuffer.h"
+#include "graphics/OcclusionQuery.h"
+#include "impl/VertexBufferOpenGL.h"
+
+namespace hpl {
+
+	//-----------------------------------------------
+
+	/**
+	 * Only keeps the size, format and memory use of the data it is created from.
+	 */
+	class cTextureNull : public iTexture
+	{
+	public:
+		cTextureNull(const tString &asName, eTextureType aType, eTextureUsage aUsage, iLowLevelGraphics* apLowLevelGraphics);
+		~cTextureNull();
+
+		bool CreateFromBitmap(cBitmap* pBmp);
+		bool CreateAnimFromBitmapVec(std::vector<cBitmap*> *avBitmaps);
+		bool CreateCubeFromBitmapVec(std::vector<cBitmap*> *avBitmaps);
+		bool CreateFromRawData(const cVector3l &avSize,ePixelFormat aPixelFormat, unsigned char *apData);
+
+		void SetRawData(	int alLevel, const cVector3l& avOffset, const cVector3l& avSize,
+							ePixelFormat aPixelFormat, void *apData){}
+
+		void Update(float afTimeStep);
+
+		void SetFilter(eTextureFilter aFilter){ mFilter = aFilter;}
+		void SetAnisotropyDegree(float afX){ mfAnisotropyDegree = afX;}
+
+		void SetWrapS(eTextureWrap aMode){ mWrapS = aMode;}
+		void SetWrapT(eTextureWrap aMode){ mWrapT = aMode;}
+		void SetWrapR(eTextureWrap aMode){ mWrapR = aMode;}
+		void SetWrapSTR(eTextureWrap aMode){ mWrapS = aMode; mWrapT = aMode; mWrapR = aMode;}
+
+		void SetCompareMode(eTextureCompareMode aMode){ mCompareMode = aMode;}
+		void SetCompareFunc(eTextureCompareFunc aFunc){ mCompareFunc = aFunc;}
+
+		void AutoGenerateMipmaps(){}
+
+		bool HasAnimation(){ return mlFrameNum > 1;}
+		void NextFrame();
+		void PrevFrame();
+		float GetT();
+		float GetTimeCount(){ return mfTimeCount;}
+		void SetTimeCount(float afX){ mfTimeCount = afX;}
+		int GetCurrentLowlevelHandle(){ return 0;}
+
+	private:
+		void AddBitmap(cBitmap* apBmp);
+
+		int mlFrameNum;
+		float mfTimeCount;
+	};
+
+	//-----------------------------------------------
+
+	/**
+	 * Keeps the vertex data in system memory like the array buffer, but never draws it.
+	 */
+	class cVertexBufferNull : public iVertexBufferOpenGL
+	{
+	public:
+		cVertexBufferNull(	iLowLevelGraphics* apLowLevelGraphics, eVertexBufferType aType,
+							eVertexBufferDrawType aDrawType,eVertexBufferUsageType aUsageType,
+							int alReserveVtxSize,int alReserveIdxSize);
+		~cVertexBufferNull();
+
+		void UpdateData(tVertexElementFlag aTypes, bool abIndices){}
+
+		void Draw(eVertexBufferDrawType aDrawType);
+		void DrawIndices(unsigned int *apIndices, int alCount,
+						eVertexBufferDrawType aDrawType = eVertexBufferDrawType_LastEnum);
+
+		void Bind(){}
+		void UnBind(){}
+
+	private:
+		void CompileSpecific(){}
+		iVertexBufferOpenGL* CreateDataCopy(tVertexElementFlag aFlags, eVertexBufferDrawType aDrawType,
+											eVertexBufferUsageType aUsageType,
+											int alReserveVtxSize,int alReserveIdxSize);
+	};
+
+	//-----------------------------------------------
+
+	class cGpuShaderNull : public iGpuShader
+	{
+	public:
+		cGpuShaderNull(const tString& asName, eGpuShaderType aType);
+		~cGpuShaderNull();
+
+		bool Reload(){ return false;}
+		void Unload(){}
+		void Destroy(){}
+
+		bool SamplerNeedsTextureUnitSetup(){ return false;}
+
+		bool CreateFromFile(const tWString& asFile, const tString& asEntry="main", bool abPrintInfoIfFail=true);
+		bool CreateFromString(const char *apStringData, const tString& asEntry="main", bool abPrintInfoIfFail=true){ return true;}
+	};
+
+	//-----------------------------------------------
+
+	/**
+	 * Hands out a unique id for every variable name so the material setup runs as it would on a GPU.
+	 */
+	class cGpuProgramNull : public iGpuProgram
+	{
+	public:
+		cGpuProgramNull(const tString& asName);
+		~cGpuProgramNull();
+
+		bool Link(){ return true;}
+
+		void Bind(){}
+		void UnBind(){}
+
+		bool CanAccessAPIMatrix(){ return true;}
+
+		bool SetSamplerToUnit(const tString& asSamplerName, int alUnit){ return true;}
+
+		int GetVariableId(const tString& asName);
+		bool GetVariableAsId(const tString& asName, int alId){ return true;}
+
+		bool SetInt(int alVarId, int alX){ return true;}
+		bool SetFloat(int alVarId, float afX){ return true;}
+		bool SetVec2f(int alVarId, float afX,float afY){ return true;}
+		bool SetVec3f(int alVarId, float afX,float afY,float afZ){ return true;}
+		bool SetVec4f(int alVarId, float afX,float afY,float afZ, float afW){ return true;}
+		bool SetMatrixf(int alVarId, const cMatrixf& mMtx){ return true;}
+		bool SetMatrixf(int alVarId, eGpuShaderMatrix mType, eGpuShaderMatrixOp mOp){ return true;}
+
+	private:
+		std::map<tString, int> m_mapVariableIds;
+	};
+
+	//-----------------------------------------------
+
+	class cDepthStencilBufferNull : public iDepthStencilBuffer
+	{
+	public:
+		cDepthStencilBufferNull(const cVector2l& avSize, int alDepthBits, int alStencilBits)
+			: iDepthStencilBuffer(avSize, alDepthBits, alStencilBits){}
+		~cDepthStencilBufferNull(){}
+	};
+
+	//-----------------------------------------------
+
+	class cFrameBufferNull : public iFrameBuffer
+	{
+	public:
+		cFrameBufferNull(const tString& asName, iLowLevelGraphics* apLowLevelGraphics);
+		~cFrameBufferNull();
+
+		void SetTexture2D(int alColorIdx, iTexture *apTexture, int alMipmapLevel=0);
+		void SetTexture3D(int alColorIdx, iTexture *apTexture, int alZ, int alMipmapLevel=0);
+		void SetTextureCubeMap(int alColorIdx, iTexture *apTexture, int alFace, int alMipmapLevel=0);
+
+		void SetDepthTexture2D(iTexture *apTexture, int alMipmapLevel=0);
+		void SetDepthTextureCubeMap(iTexture *apTexture, int alFace, int alMipmapLevel=0);
+
+		void SetDepthStencilBuffer(iDepthStencilBuffer* apBuffer);
+
+		bool CompileAndValidate(){ return true;}
+
+		void PostBindUpdate(){}
+
+	private:
+		void SetFirstSize(const cVector2l &avSize);
+	};
+
+	//-----------------------------------------------
+
+	/**
+	 * Always reports samples passed, so occlusion culling never hides anything.
+	 */
+	class cOcclusionQueryNull : public iOcclusionQuery
+	{
+	public:
+		cOcclusionQueryNull(){}
+		~cOcclusionQueryNull(){}
+
+		void Begin(){}
+		void End(){}
+		bool FetchResults(){ return true;}
+		unsigned int GetSampleCount(){ return 0x7fff;}
+	};
+
+	//-----------------------------------------------
+
+};
+#endif // HPL_GRAPHICS_OBJECTS_NULL_H
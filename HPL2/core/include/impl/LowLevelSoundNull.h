@@ -0,0 +1,154 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ *
+ * This file is part of Amnesia: A Machine For Pigs.
+ *
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_LOWLEVELSOUND_NULL_H
+#define HPL_LOWLEVELSOUND_NULL_H
+
+#include "sound/LowLevelSound.h"
+#include "sound/SoundData.h"
+#include "sound/SoundChannel.h"
+
+namespace hpl
+{
+
+	//-----------------------------------------------
+
+	class cSoundDeviceIdentifierNull : public iSoundDeviceIdentifier
+	{
+	public:
+		cSoundDeviceIdentifierNull() : msName("Null"){}
+
+		int GetID() { return 0; }
+		const tString& GetName() { return msName; }
+		bool IsDefault() { return true; }
+	private:
+		tString msName;
+	};
+
+	//-----------------------------------------------
+
+	/**
+	 * Files are not decoded, the data only keeps its path.
+	 */
+	class cSoundDataNull : public iSoundData
+	{
+	public:
+		cSoundDataNull(const tString& asName, bool abStream);
+		~cSoundDataNull();
+
+		bool CreateFromFile(const tWString &asFile);
+
+		iSoundChannel* CreateChannel(int alPriority);
+
+		bool IsStereo(){ return false;}
+	};
+
+	//-----------------------------------------------
+
+	/**
+	 * A played channel that is not looping ends at once, a looping one plays until stopped.
+	 */
+	class cSoundChannelNull : public iSoundChannel
+	{
+	public:
+		cSoundChannelNull(iSoundData* apData, int alPriority, cSoundManager* apSoundManger);
+		~cSoundChannelNull();
+
+		void Play();
+		void Stop();
+
+		void SetPaused(bool abX){ mbPaused = abX;}
+		void SetSpeed(float afSpeed){ mfSpeed = afSpeed;}
+		void SetVolume (float afVolume){ mfVolume = afVolume;}
+		void SetLooping (bool abLoop){ mbLooping = abLoop;}
+		void SetPan (float afPan){ mfPan = afPan;}
+		void Set3D(bool ab3D){ mb3D = ab3D;}
+
+		void SetPriority(int alX){ mlPriority = alX;}
+		int GetPriority(){ return mlPriority;}
+
+		void SetPositionIsRelative(bool abRelative){ mbPositionRelative = abRelative;}
+		void SetPosition(const cVector3f &avPos){ mvPosition = avPos;}
+		void SetVelocity(const cVector3f &avVel){ mvVelocity = avVel;}
+
+		void SetMinDistance(float afMin){ mfMinDistance = afMin;}
+		void SetMaxDistance(float afMax){ mfMaxDistance = afMax;}
+
+		bool IsPlaying();
+
+		bool IsBufferUnderrun(){ return false;}
+		double GetElapsedTime(){ return 0;}
+		double GetTotalTime(){ return 0;}
+		void SetElapsedTime(double afTime){}
+
+		void SetFiltering ( bool abEnabled, int alFlags){}
+		void SetFilterGain(float afGain){}
+		void SetFilterGainHF(float afGainHF){}
+	};
+
+	//-----------------------------------------------
+
+	/**
+	 * Sound device that opens no output. Sounds are created and tracked by the sound handler as usual
+	 * but nothing is mixed, so the engine can run (eg benchmarks) on machines without audio.
+	 */
+	class cLowLevelSoundNull : public iLowLevelSound
+	{
+	public:
+		cLowLevelSoundNull();
+		~cLowLevelSoundNull();
+
+		void GetSupportedFormats(tStringList &alstFormats);
+
+		iSoundData* LoadSoundData(const tString& asName,const tWString& asFilePath,
+									const tString& asType, bool abStream,bool abLoopStream);
+
+		void UpdateSound(float afTimeStep){}
+
+		void SetListenerAttributes (const cVector3f &avPos,const cVector3f &avVel,
+								const cVector3f &avForward,const cVector3f &avUp);
+		void SetListenerPosition(const cVector3f &avPos){ mvListenerPosition = avPos;}
+
+		void SetSetRolloffFactor(float afFactor){}
+
+		void SetListenerAttenuation (bool abEnabled){ mbListenerAttenuation = abEnabled;}
+
+		void Init(int alSoundDeviceID, bool abUseEnvAudio,int alMaxChannels,
+					int alStreamUpdateFreq, bool abUseThreading, bool abUseVoiceManagement,
+					int alMaxMonoSourceHint, int alMaxStereoSourceHint,
+					int alStreamingBufferSize, int alStreamingBufferCount, bool abEnableLowLevelLog);
+
+		void SetVolume(float afVolume){ mfVolume = afVolume;}
+
+		void SetEnvVolume( float afEnvVolume ){ mfEnvVolume = afEnvVolume;}
+
+		iSoundEnvironment* LoadSoundEnvironment (const tString& asFilePath){ return NULL;}
+		void SetSoundEnvironment ( iSoundEnvironment* apSoundEnv ){}
+		void FadeSoundEnvironment( iSoundEnvironment* apSourceSoundEnv, iSoundEnvironment* apDestSoundEnv, float afT ){}
+
+		iSoundDeviceIdentifier* GetCurrentSoundDevice(){ return &mDevice;}
+
+	private:
+		cSoundDeviceIdentifierNull mDevice;
+	};
+
+	//-----------------------------------------------
+
+};
+#endif // HPL_LOWLEVELSOUND_NULL_H
@@ -36,7 +36,8 @@ namespace hpl {
 	//----------------------------------------------------------
 
 	#define MSH_FORMAT_MAGIC_NUMBER		0x76034569
-	#define MSH_FORMAT_VERSION			7
+	#define MSH_FORMAT_VERSION			8
+	#define MSH_FORMAT_MIN_VERSION		7 //Version 7 is the same except it has no lods
 
 	//----------------------------------------------------------
 	
@@ -64,6 +65,8 @@ namespace hpl {
 		void AddBoneToBuffer(cBone *apBone, cBinaryBuffer* apBuffer, int alLevel);
 		void GetBoneFromBuffer(cBone *apParentBone, cBinaryBuffer* apBuffer, int alLevel);
 
+		void SetupVertexFormat(iVertexBuffer *apVtxBuffer);
+
 		void* GetVertexBufferWithFormat(iVertexBuffer *apVtxBuffer, eVertexBufferElement aElement, eVertexBufferElementFormat aFormat);
 		void AddBinaryBufferDataWithFormat(cBinaryBuffer* apBuffer, void *apSrcData, size_t alSize, eVertexBufferElementFormat aFormat);
 		void GetBinaryBufferDataWithFormat(cBinaryBuffer* apBuffer, void *apDestData, size_t alSize, eVertexBufferElementFormat aFormat);
@@ -91,6 +91,7 @@ namespace hpl {
 		NewtonBody *GetNewtonBody(){ return mpNewtonBody;}
 
 		void ClearForces();
+		bool GetHasForces(){ return mbHasForces;}
 		
 		void DeleteLowLevel();
 
@@ -100,6 +101,8 @@ namespace hpl {
 		static void OnTransformCallback(const NewtonBody* apBody, const dFloat* apMatrix, int alThreadIndex);
 		static void OnUpdateCallback(const NewtonBody* apBody, dFloat afTimestep, int alThreadIndex);
 
+		void MarkHasForces();
+
 		NewtonBody *mpNewtonBody;
 		NewtonWorld *mpNewtonWorld;
 
@@ -121,6 +124,7 @@ namespace hpl {
 		// Forces that will be set and clear on update callback
 		cVector3f mvTotalForce;
 		cVector3f mvTotalTorque;
+		bool mbHasForces;
 	};
 };
 #endif // HPL_PHYSICS_BODY_NEWTON_H
@@ -28,6 +28,11 @@
 #include <Newton.h>
 
 namespace hpl {
+
+	class cCollideShapeNewton;
+	class cPhysicsBodyNewton;
+	class iTimer;
+
 	class cPhysicsWorldNewton : public iPhysicsWorld
 	{
 	public:
@@ -105,19 +110,39 @@ namespace hpl {
 		void RenderDebugGeometry(iLowLevelGraphics *apLowLevel, const cColor& aColor);
 
 		NewtonWorld* GetNewtonWorld(){ return mpNewtonWorld;}
+
+		/**
+		 * Bodies that have had forces added since the last Simulate. Only these get their forces cleared.
+		 */
+		void AddForceBody(cPhysicsBodyNewton *apBody);
+		void RemoveForceBody(cPhysicsBodyNewton *apBody);
 	private:
+		void SimulateSubStep(float afTimeStep);
+
+		void GetSubShapeWorldAABBs(cCollideShapeNewton *apShape, const cMatrixf& a_mtxTransform,
+									tVector3fVec& avMin, tVector3fVec& avMax);
+
 		NewtonWorld *mpNewtonWorld;
 
 		float* mpTempPoints;
 		float* mpTempNormals;
 		float* mpTempDepths;
 
+		tVector3fVec mvTempSubShapeMinA;
+		tVector3fVec mvTempSubShapeMaxA;
+		tVector3fVec mvTempSubShapeMinB;
+		tVector3fVec mvTempSubShapeMaxB;
+
 		cVector3f mvWorldSizeMin;
 		cVector3f mvWorldSizeMax;
 		cVector3f mvGravity;
 		float mfMaxTimeStep;
 
 		ePhysicsAccuracy mAccuracy;
+
+		std::vector<cPhysicsBodyNewton*> mvForceBodies;
+
+		iTimer *mpSubStepTimer;
 	};
 };
 #endif // HPL_PHYSICS_WORLD_NEWTON_H
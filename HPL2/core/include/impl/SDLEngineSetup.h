@@ -32,11 +32,12 @@ namespace hpl {
 	class iLowLevelSound;
 	class iLowLevelPhysics;
 	class iLowLevelHaptic;
+	class cEngineInitVars;
 
 	class cSDLEngineSetup : public iLowLevelEngineSetup
 	{
 	public:
-		cSDLEngineSetup(tFlag alHplSetupFlags);
+		cSDLEngineSetup(tFlag alHplSetupFlags, cEngineInitVars *apVars);
 		~cSDLEngineSetup();
 		
 		cInput* CreateInput(cGraphics* apGraphics);
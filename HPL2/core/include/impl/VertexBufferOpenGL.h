@@ -61,6 +61,7 @@ namespace hpl {
 		tByteVec* mpByteArray;
 		tIntVec* mpIntArray;
 		tFloatVec* mpFloatArray;
+		tUShortVec* mpShortArray;
 	};
 
 
@@ -104,6 +105,9 @@ namespace hpl {
 		float* GetFloatArray(eVertexBufferElement aElement);
 		int* GetIntArray(eVertexBufferElement aElement);
 		unsigned char* GetByteArray(eVertexBufferElement aElement);
+		unsigned short* GetShortArray(eVertexBufferElement aElement);
+
+		bool ConvertElementFormat(eVertexBufferElement aElement, eVertexBufferElementFormat aFormat);
 
 		unsigned int* GetIndices();
 
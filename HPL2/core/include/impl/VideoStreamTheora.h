@@ -22,15 +22,33 @@
 
 #include "graphics/VideoStream.h"
 #include "resources/VideoLoader.h"
+#include "system/Thread.h"
 
 #include <theora/theora.h>
 
 namespace hpl {
 
 	//-----------------------------------------
-	class  cVideoStreamTheora_Loader;
+	class cVideoStreamTheora_Loader;
+	class iMutex;
 
-	class cVideoStreamTheora : public iVideoStream
+	//-----------------------------------------
+
+	class cVideoStreamTheoraFrame
+	{
+	public:
+		unsigned char *mpData;
+		double mfTime;
+		int mlId;
+	};
+
+	//-----------------------------------------
+
+	/**
+	 * Frames are decoded and converted to RGBA on a separate thread, which keeps a small
+	 * ring of frames ahead of the playback time. The main thread only picks frames and uploads them.
+	 */
+	class cVideoStreamTheora : public iVideoStream, public iThreadClass
 	{
 	public:
 		cVideoStreamTheora(const tString& asName, cVideoStreamTheora_Loader* apLoader);
@@ -51,13 +69,34 @@ namespace hpl {
 
 		void CopyToTexture(iTexture *apTexture);
 
+		void UpdateThread();
+
+		/**
+		 * Converts the visible part of a decoded YUV 4:2:0 frame to RGBA.
+		 * \param abSimd Use SSE2 if supported by the build, else the lookup tables in the loader are used.
+		 */
+		static void ConvertYuvToRgba(const yuv_buffer& aYuv, const theora_info& aInfo, const cVector2l& avSize,
+									unsigned char *apDest, cVideoStreamTheora_Loader* apLoader, bool abSimd);
+		static bool SimdYuvConversionSupported();
+
+		/**
+		 * Converts a generated frame of the size alFrames times with the tables and with SSE2, for the game benchmark.
+		 * Gives the frames per second of each (SSE2 is 0 if not supported) and the largest difference in a channel.
+		 */
+		static void MeasureYuvConversion(const cVector2l& avSize, int alFrames, double *apTableFps, double *apSimdFps, int *apMaxDiff);
+
+		static void SetUseSimdYuvConversion(bool abX){ mbUseSimdYuvConversion = abX;}
+		static bool GetUseSimdYuvConversion(){ return mbUseSimdYuvConversion;}
+
 	private:
-		void DrawFrameToBuffer();
+		bool DecodeFrame();
 		int BufferData(FILE *pFile ,ogg_sync_state *apOggSynchState);
 		void QueuePage(ogg_page *apPage);
 		bool GetHeaders();
 		bool InitDecoders();
 		void ResetStreams();
+		void Rewind();
+		void StopDecodeThread();
 		
 		cVideoStreamTheora_Loader *mpLoader;
 
@@ -67,23 +106,34 @@ namespace hpl {
 		bool mbPaused;
 		bool mbPlaying;
 
-		float mfTime;
+		double mfTime;
 
-		unsigned char *mpFrameBuffer;
-		
 		ogg_sync_state   mOggSyncState;
 		ogg_stream_state mTheoraStreamState;
 		theora_info      mTheoraInfo;
 		theora_comment mTheoraComment;
 		theora_state	mTheoraState;
 
-		int          mlVideobufReady;
 		ogg_int64_t  mlVideobufGranulePos;
 		double       mfVideobufTime;
 
 		bool mbVideoLoaded;
 		bool mbVideoFrameReady;
 		int mlBufferSize;
+
+		//Decode thread data
+		iThread *mpDecodeThread;
+		iMutex *mpFrameMutex;
+		std::vector<cVideoStreamTheoraFrame> mvFrames;
+		int mlFirstFrame;
+		int mlFrameNum;
+		int mlNextFrameId;
+		int mlShownFrameId;
+		bool mbDecodeFinished;
+		double mfDecodeTimeOffset;
+		double mfLastFrameTime;
+
+		static bool mbUseSimdYuvConversion;
 	};
 
 	//-----------------------------------------
@@ -34,6 +34,12 @@ namespace hpl {
 
 		void SaveToString(tString *apDestData);
 		bool CreateFromString(const tString& asData);
+
+		/**
+		 * The loading used before the one pass parser: TinyXML parses the file and the result is copied
+		 * to the elements. Only kept for comparing parse times and results (see the game benchmark).
+		 */
+		bool CreateFromFileWithTinyXML(const tWString& asPath);
 		
 	private:
 		bool LoadDataFromFile(const tWString& asPath);
@@ -42,7 +48,6 @@ namespace hpl {
 		void LoadFromTinyXMLData(TiXmlElement* apTinyElem, cXmlElement *apDestElem);
 		void SaveToTinyXMLData(TiXmlElement* apTinyElem, cXmlElement *apSrcElem);
 
-		bool CreateTinyXMLFromFile(TiXmlDocument* pDoc,const tWString& asPath);
 		bool SaveTinyXMLToFile(TiXmlDocument* pDoc,const tWString& asPath);
 	};
 
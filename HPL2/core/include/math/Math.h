@@ -896,6 +896,15 @@ namespace hpl {
 		static cQuaternion QuaternionSlerp(float afT,const cQuaternion& aqA, const cQuaternion& aqB, 
 											bool abShortestPath);
 
+		/**
+		 * Normalized Linear Interpolation between quaternions A and B. Cheaper than slerp and
+		 * close to it when the quaternions are near each other.
+		 * \param afT The amount inbetween the quaternions. 0.0 is A and 1 is B.
+		 * \param abShortestPath Move the the shortest path.
+		 */
+		static cQuaternion QuaternionNlerp(float afT,const cQuaternion& aqA, const cQuaternion& aqB, 
+											bool abShortestPath);
+
 		static float QuaternionDot(const cQuaternion& aqA,const cQuaternion& aqB);
 
 		/**
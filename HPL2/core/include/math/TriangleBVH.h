@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_TRIANGLE_BVH_H
+#define HPL_TRIANGLE_BVH_H
+
+#include "math/MathTypes.h"
+#include "system/SystemTypes.h"
+
+namespace hpl {
+
+	//-------------------------------------------
+
+	class cTriangleBVHNode
+	{
+	public:
+		cVector3f mvMin;
+		cVector3f mvMax;
+
+		int mlFirst;	//Inner node: index of first child (second child is next). Leaf: first triangle.
+		int mlNum;		//Number of triangles, 0 for inner nodes.
+	};
+
+	typedef std::vector<cTriangleBVHNode> tTriangleBVHNodeVec;
+
+	//-------------------------------------------
+
+	/**
+	 * Bounding volume hierarchy over the triangles of an indexed mesh, in the local space of the mesh.
+	 * The positions are copied when building, so the tree must be rebuilt if the mesh changes.
+	 * Triangles are identified by the index of their first vertex index (same as CheckLineTriMeshIntersection).
+	 */
+	class cTriangleBVH
+	{
+	public:
+		cTriangleBVH();
+		~cTriangleBVH();
+
+		void Build(const unsigned int* apIndexArray, int alIndexNum, const float* apVertexArray, int alVtxStride);
+		void Clear();
+
+		/**
+		 * Gets the closest intersection along the line, apT is 0 at start and 1 at end. Same as cMath::CheckLineTriMeshIntersection
+		 * with the line already in local space, but only tests the triangles in nodes hit by the line.
+		 */
+		bool CheckLineIntersection(const cVector3f& avLineStart, const cVector3f& avLineEnd, float *apT, int *apTriIndex, bool abSkipBackfacing=true);
+
+		/**
+		 * Adds all triangles whose bounds intersect the AABB.
+		 */
+		void GetTrianglesInAABB(const cVector3f& avMin, const cVector3f& avMax, tIntVec& avTriIndices);
+
+		int GetNodeNum(){ return (int)mvNodes.size();}
+		int GetTriangleNum(){ return (int)mvTriIndices.size();}
+
+	private:
+		void BuildNode(int alNode, int alFirst, int alNum);
+
+		tTriangleBVHNodeVec mvNodes;
+
+		tIntVec mvTriIndices;		//Index array position of each triangle, in tree order.
+		tVector3fVec mvPositions;	//Three positions per triangle, in tree order.
+		tVector3fVec mvCentres;		//Only used when building.
+	};
+
+	//-------------------------------------------
+};
+#endif // HPL_TRIANGLE_BVH_H
@@ -94,6 +94,12 @@ namespace hpl {
 
 		void SetDebugLog(bool abX){ mbLog = abX;}
 		bool GetDebugLog(){ return mbLog;}
+
+		/**
+		 * Number of threads used by worlds created after this is set. 1 means simulation is run on the calling thread only.
+		 */
+		void SetWorldThreadNum(int alX){ mlWorldThreadNum = alX<1 ? 1 : alX;}
+		int GetWorldThreadNum(){ return mlWorldThreadNum;}
 	
 	private:
 		eHapticSurfaceType GetHapticSurface(const char *apName);
@@ -112,6 +118,7 @@ namespace hpl {
 		float mfImpactDuration;
 		int mlMaxImpacts;
 		bool mbLog;
+		int mlWorldThreadNum;
 	};
 
 };
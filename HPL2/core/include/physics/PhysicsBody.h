@@ -227,6 +227,7 @@ namespace hpl {
 		float GetBuoyancyLinearViscosity(){ return mBuoyancy.mfLinearViscosity;}
 		float GetBuoyancyAngularViscosity(){ return mBuoyancy.mfAngularViscosity;}
 		cPlanef SetBuoyancySurface(){ return mBuoyancy.mSurface;}
+		const cPlanef& GetBuoyancySurface(){ return mBuoyancy.mSurface;}
 
 		float GetBuoyancyDensityMul(){ return mfBuoyancyDensityMul;}
 		void SetBuoyancyDensityMul(float afX){ mfBuoyancyDensityMul = afX;}
@@ -244,8 +245,9 @@ namespace hpl {
 		void AddConnectedCharacter(iCharacterBody *apCharBody);
 		void RemoveConnectedCharacter(iCharacterBody *apCharBody);
 
-		bool IsInUpdateList(){ return mbInUpdateList;}
-		void SetInUpdateList(bool abX){ mbInUpdateList = abX;}
+		bool IsInUpdateList(){ return mlUpdateListIndex >= 0;}
+		int GetUpdateListIndex(){ return mlUpdateListIndex;}
+		void SetUpdateListIndex(int alX){ mlUpdateListIndex = alX;}
 
 		void AddAttachedVerletContainer(iVerletParticleContainer *apContainer);
 		void RemoveAttachedVerletContainer(iVerletParticleContainer *apContainer);
@@ -283,7 +285,7 @@ namespace hpl {
 		bool mbHasSlide;
 		int mlSlideCount;
 		int mlImpactCount;
-		bool mbInUpdateList;
+		int mlUpdateListIndex;
 
 		float mfBuoyancyDensityMul;
 
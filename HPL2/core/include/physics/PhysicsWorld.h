@@ -62,6 +62,9 @@ namespace hpl {
 	typedef std::set<iPhysicsBody*> tPhysicsBodySet;
 	typedef tPhysicsBodySet::iterator tPhysicsBodySetIt;
 
+	typedef std::vector<iPhysicsBody*> tPhysicsBodyVec;
+	typedef tPhysicsBodyVec::iterator tPhysicsBodyVecIt;
+
 	typedef std::list<iPhysicsJoint*> tPhysicsJointList;
 	typedef tPhysicsJointList::iterator tPhysicsJointListIt;
 
@@ -84,6 +87,25 @@ namespace hpl {
 
 	//----------------------------------------------------
 
+	/**
+	 * Statistics from the last Simulate call of a physics world.
+	 */
+	class cPhysicsWorldStats
+	{
+	public:
+		cPhysicsWorldStats() : mlBodyNum(0), mlActiveBodyNum(0), mlContactNum(0), 
+								mlSubStepNum(0), mfSubStepTime(0), mfSimulateTime(0) {}
+
+		int mlBodyNum;
+		int mlActiveBodyNum;
+		int mlContactNum;
+		int mlSubStepNum;
+		float mfSubStepTime;	//Average time in ms for one sub step.
+		float mfSimulateTime;	//Total time in ms for all sub steps.
+	};
+
+	//----------------------------------------------------
+
 	class iPhysicsWorld
 	{
 	public:
@@ -198,6 +220,14 @@ namespace hpl {
 		void AddBodyToUpdateList(iPhysicsBody *apBody);
 		void RemoveBodyFromUpdateList(iPhysicsBody *apBody, bool abDestroyingBody);
 
+		/**
+		 * Dense array of the bodies that are awake (or sliding / moved as static) and get updated each step.
+		 * Sleeping bodies are not in it, so loops that only care about moving bodies should use this.
+		 * Entries can be NULL when called from a body callback during Update.
+		 */
+		int GetUpdateBodyNum(){ return (int)mvUpdateBodies.size();}
+		iPhysicsBody* GetUpdateBody(int alIdx){ return mvUpdateBodies[alIdx];}
+
 
 		//! @}
 
@@ -261,12 +291,27 @@ namespace hpl {
 
 		cWorld* GetWorld(){ return mpWorld;}
 		void SetWorld(cWorld *apWorld){ mpWorld = apWorld;}
+
+		/**
+		 * Sub shape pairs tested by CheckShapeCollision since the last Update, and how many of
+		 * those were rejected by the AABB test before reaching the narrowphase.
+		 */
+		int GetShapeCollisionPairCount(){ return mlShapeCollisionPairCount;}
+		int GetShapeCollisionPairCulledCount(){ return mlShapeCollisionPairCulledCount;}
+
+		const cPhysicsWorldStats& GetStats(){ return mStats;}
+		/**
+		 * Called by the low level contact callbacks, must only be called with the world locked.
+		 */
+		void AddContactsToStats(int alNum){ mStats.mlContactNum += alNum;}
 		//! @}
 
 	protected:
+		void CompactUpdateBodies();
+
 		tCollideShapeList mlstShapes;
 		tPhysicsBodyList mlstBodies;
-		tPhysicsBodySet m_setUpdateBodies;
+		tPhysicsBodyVec mvUpdateBodies;
 		tCharacterBodyList mlstCharBodies;
 		tPhysicsMaterialMap m_mapMaterials;
 		tPhysicsJointList mlstJoints;
@@ -277,9 +322,15 @@ namespace hpl {
 		std::vector<iPhysicsBody*> mvTempBodies;
 
 		bool mbLogDebug;
+		bool mbIteratingUpdateBodies;
 
 		tCollidePointVec mvContactPoints;
 		bool mbSaveContactPoints;
+
+		int mlShapeCollisionPairCount;
+		int mlShapeCollisionPairCulledCount;
+
+		cPhysicsWorldStats mStats;
 	};
 };
 #endif // HPL_PHYSICS_WORLD_H
@@ -23,6 +23,7 @@
 #include <map>
 #include "resources/ResourcesTypes.h"
 #include "system/SystemTypes.h"
+#include "system/NameTable.h"
 
 namespace hpl {
 
@@ -41,7 +42,8 @@ namespace hpl {
 
 	//----------------------------------
 
-	typedef std::multimap<tString, cFileSearcherEntry> tFilePathMap;
+	//Key is the interned file name, so finding a file needs no lower case copy.
+	typedef std::multimap<tNameId, cFileSearcherEntry> tFilePathMap;
 	typedef tFilePathMap::iterator tFilePathMapIt;
 
 	//----------------------------------
@@ -34,6 +34,26 @@ namespace hpl {
 
 	//------------------------------------
 
+	/**
+	 * Output of the preprocess parser for a shader file and a set of variables.
+	 */
+	class cParsedShaderSource
+	{
+	public:
+		tString msOutput;
+		tStringVec mvSamplerNames;
+		tIntVec mvSamplerUnits;
+		tWStringVec mvIncludedFiles;
+	};
+
+	typedef std::map<tString, cParsedShaderSource*> tParsedShaderSourceMap;
+	typedef tParsedShaderSourceMap::iterator tParsedShaderSourceMapIt;
+
+	typedef std::map<tWString, tString> tShaderFileDataMap;
+	typedef tShaderFileDataMap::iterator tShaderFileDataMapIt;
+
+	//------------------------------------
+
 	class cGpuShaderManager : public iResourceManager
 	{
 	public:
@@ -54,12 +74,36 @@ namespace hpl {
 
 		void Destroy(iResourceBase* apResource);
 		void Unload(iResourceBase* apResource);
+
+		/**
+		 * Sets a folder where parsed shader sources are saved, so combos seen in earlier runs do not need
+		 * to be parsed again. Empty string (default) means only the cache in memory is used.
+		 */
+		void SetParsedSourceCacheDir(const tWString& asDir);
+		const tWString& GetParsedSourceCacheDir(){ return msParsedSourceCacheDir;}
+
+		/**
+		 * Removes all file data and parsed sources kept in memory.
+		 */
+		void ClearParsedSourceCache();
+
+		int GetParsedSourceNum(){ return (int)m_mapParsedSources.size();}
 	
 	private:
 		bool IsShaderSupported(const tString& asName, eGpuShaderType aType);
 
+		cParsedShaderSource* GetParsedSource(const tWString& asPath, cParserVarContainer *apVarContainer);
+		const tString& GetFileData(const tWString& asPath);
+		
+		bool LoadParsedSourceFromDisk(const tWString& asFile, const tString& asKey, cParsedShaderSource *apSource);
+		void SaveParsedSourceToDisk(const tWString& asFile, const tString& asKey, cParsedShaderSource *apSource);
+
 		iLowLevelGraphics *mpLowLevelGraphics;
 		cPreprocessParser* mpPreprocessParser;
+
+		tShaderFileDataMap m_mapFileData;
+		tParsedShaderSourceMap m_mapParsedSources;
+		tWString msParsedSourceCacheDir;
 	};
 
 };
@@ -52,12 +52,26 @@ namespace hpl {
 		const tString& GetFastloadMaterial(){ return msFastloadMaterial;}
 		bool GetUseFastloadMaterial(){ return mbUseFastloadMaterial;}
 
+		/**
+		 * If set, triangles and vertices of loaded meshes are reordered for better vertex cache use.
+		 */
+		void SetOptimizeVertexCache(bool abX){ mbOptimizeVertexCache = abX;}
+		bool GetOptimizeVertexCache(){ return mbOptimizeVertexCache;}
+
+		/**
+		 * If set, normals, tangents and UVs of loaded meshes are stored in smaller formats and bone weights as unorm8. Lossy.
+		 */
+		void SetCompactVertexFormat(bool abX){ mbCompactVertexFormat = abX;}
+		bool GetCompactVertexFormat(){ return mbCompactVertexFormat;}
+
 	private:
 		cGraphics* mpGraphics;
 		cResources* mpResources;
 
 		tString msFastloadMaterial;
 		bool mbUseFastloadMaterial;
+		bool mbOptimizeVertexCache;
+		bool mbCompactVertexFormat;
 	};
 
 };
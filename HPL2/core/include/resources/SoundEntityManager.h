@@ -34,7 +34,12 @@ namespace hpl {
 		cSoundEntityManager(cSound* apSound,cResources *apResources);
 		~cSoundEntityManager();
 
+		/**
+		 * Loads the entity and starts reading its sounds in the background. The sound data is created
+		 * for all preloads at once on the next FlushPreloads.
+		 */
 		void Preload(const tString& asFile);
+		void FlushPreloads();
 
 		cSoundEntityData* CreateSoundEntity(const tString& asName);
 		
@@ -44,6 +49,8 @@ namespace hpl {
 	private:
 		cSound* mpSound;
 		cResources* mpResources;
+
+		std::vector<cSoundEntityData*> mvPreloadQueue;
 	};
 
 };
@@ -27,10 +27,15 @@ namespace hpl {
 	class cSound;
 	class cResources;
 	class iSoundData;
+	class cJobPool;
+	class cJobBatch;
 
 	typedef std::list<iSoundData*> tSoundDataList;
 	typedef tSoundDataList::iterator tSoundDataListIt;
 
+	typedef std::map<tWString, cJobBatch*> tSoundPrefetchMap;
+	typedef tSoundPrefetchMap::iterator tSoundPrefetchMapIt;
+
 	class cSoundManager : public iResourceManager
 	{
 	public:
@@ -39,6 +44,15 @@ namespace hpl {
 
 		iSoundData* CreateSoundData(const tString& asName, bool abStream, bool abLoopStream=false);
 
+		/**
+		 * Starts reading the file of a (non stream) sample on a worker thread, so that a later CreateSoundData
+		 * does not have to wait for the disk. CreateSoundData waits for the read if it is not done.
+		 * \return true if the data is not loaded yet and the file is being read, false if the data is already
+		 * loaded or the file does not exist.
+		 */
+		bool PrefetchSoundData(const tString& asName);
+		bool IsPrefetchDone(const tString& asName);
+
 		void Destroy(iResourceBase* apResource);
 		void Unload(iResourceBase* apResource);
 
@@ -52,7 +66,11 @@ namespace hpl {
 
 		tSoundDataList mlstStreamData;
 
+		cJobPool *mpPrefetchJobPool;
+		tSoundPrefetchMap m_mapPrefetches;
+
 		iSoundData *FindSampleData(const tString &asName, tWString &asFilePath);
+		void WaitForPrefetch(const tWString &asFilePath);
 		void FindStreamPath(const tString &asName, tWString &asFilePath);
 
 	};
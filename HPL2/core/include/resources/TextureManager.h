@@ -34,6 +34,20 @@ namespace hpl {
 	
 	typedef std::map<tString, iTexture*> tTextureAttenuationMap;
 	typedef std::map<tString, iTexture*>::iterator tTextureAttenuationMapIt;
+
+	class cTextureResidency
+	{
+	public:
+		cTextureResidency() : mlBaseSizeLevel(0), mlBaseMemorySize(0) {}
+		cTextureResidency(unsigned int alBaseSizeLevel, int alBaseMemorySize) 
+			: mlBaseSizeLevel(alBaseSizeLevel), mlBaseMemorySize(alBaseMemorySize) {}
+
+		unsigned int mlBaseSizeLevel;
+		int mlBaseMemorySize;
+	};
+
+	typedef std::map<iTexture*, cTextureResidency> tTextureResidencyMap;
+	typedef tTextureResidencyMap::iterator tTextureResidencyMapIt;
 	
 	//------------------------------------------------------
 
@@ -73,6 +87,35 @@ namespace hpl {
 
 		int GetMemoryUsage(){ return mlMemoryUsage;}
 
+		/**
+		 * Sets the max number of bytes textures should use. When above it, textures not bound for a while are reloaded
+		 * with a lower mip level as top level. 0 = no budget.
+		 */
+		void SetMemoryBudget(int alBytes){ mlMemoryBudget = alBytes;}
+		int GetMemoryBudget(){ return mlMemoryBudget;}
+
+		/**
+		 * Number of renderer frames a texture must be unbound before it can be reduced.
+		 */
+		void SetReduceUnusedFrameLimit(int alFrames){ mlReduceUnusedFrameLimit = alFrames;}
+		int GetReduceUnusedFrameLimit(){ return mlReduceUnusedFrameLimit;}
+
+		/**
+		 * Max number of mip levels a texture can be reduced below the size level it was created with.
+		 */
+		void SetMaxReduceLevels(int alLevels){ mlMaxReduceLevels = alLevels;}
+		int GetMaxReduceLevels(){ return mlMaxReduceLevels;}
+
+		/**
+		 * Min number of updates between two budget reloads. Each reload loads and uploads a texture on the main thread.
+		 */
+		void SetBudgetReloadInterval(int alUpdates){ mlBudgetReloadInterval = alUpdates;}
+		int GetBudgetReloadInterval(){ return mlBudgetReloadInterval;}
+
+		int GetReducedTextureNum(){ return mlReducedTextureNum;}
+		int GetReducedMemorySaved(){ return mlReducedMemorySaved;}
+		int GetBudgetReloadCount(){ return mlBudgetReloadCount;}
+
 	private:
 		iTexture* CreateSimpleTexture(const tString& asName,bool abUseMipMaps, 
 									eTextureUsage aUsage, eTextureType aType, 
@@ -81,11 +124,25 @@ namespace hpl {
 
 		iTexture* FindTexture2D(const tString &asName, tWString &asFilePath);
 
+		void UpdateMemoryBudget();
+		bool ReloadWithSizeLevel(iTexture *apTexture, unsigned int alLevel);
+
 		tTextureAttenuationMap m_mapAttenuationTextures;
 		
 		tStringVec mvCubeSideSuffixes;
 
+		tTextureResidencyMap m_mapReducibleTextures;
+
 		int mlMemoryUsage;
+		int mlMemoryBudget;
+		int mlReduceUnusedFrameLimit;
+		int mlMaxReduceLevels;
+		int mlBudgetReloadInterval;
+		int mlUpdatesSinceBudgetReload;
+
+		int mlReducedTextureNum;
+		int mlReducedMemorySaved;
+		int mlBudgetReloadCount;
 
 		cGraphics* mpGraphics;
 		cResources* mpResources;
@@ -39,9 +39,35 @@ namespace hpl {
 	
 	class iXmlNode;
 	class cXmlElement;
+	class cMemoryArena;
 
-	typedef std::list<iXmlNode*> tXmlNodeList;
-	typedef tXmlNodeList::iterator tXmlNodeListIt;
+	/**
+	 * Array of child nodes. The memory comes from the arena of the document, and when growing the old
+	 * memory is just left in the arena. Iterators are plain pointers so it works with cSTLIterator.
+	 */
+	class cXmlNodeArray
+	{
+	public:
+		cXmlNodeArray() : mpNodes(NULL), mlSize(0), mlCapacity(0) {}
+
+		iXmlNode** begin(){ return mpNodes;}
+		iXmlNode** end(){ return mpNodes + mlSize;}
+
+		size_t size() const { return mlSize;}
+		bool empty() const { return mlSize==0;}
+
+		void push_back(iXmlNode* apNode, cMemoryArena *apArena);
+		void erase(size_t alIdx);
+		void clear(){ mpNodes=NULL; mlSize=0; mlCapacity=0;}
+
+	private:
+		iXmlNode** mpNodes;
+		size_t mlSize;
+		size_t mlCapacity;
+	};
+
+	typedef cXmlNodeArray tXmlNodeList;
+	typedef iXmlNode** tXmlNodeListIt;
 
 	typedef cSTLIterator<iXmlNode*, tXmlNodeList, tXmlNodeListIt> cXmlNodeListIterator;
 
@@ -53,6 +79,7 @@ namespace hpl {
 				
 		const tString& GetValue(){ return msValue;}
 		void SetValue(const tString& asValue){ msValue = asValue;}
+		void SetValue(const char* apValue, size_t alLength){ msValue.assign(apValue, alLength);}
 
 		eXmlNodeType GetType() { return mType;}
 
@@ -72,6 +99,10 @@ namespace hpl {
 		cXmlNodeListIterator GetChildIterator();
 
 		void DestroyChildren();
+
+	protected:
+		cMemoryArena *mpArena;
+
 	private:
 		eXmlNodeType mType;
 		tString msValue;
@@ -83,16 +114,25 @@ namespace hpl {
 	
 	//-------------------------------------
 	
-	typedef std::map<tString, tString> tAttributeMap;
-	typedef tAttributeMap::iterator tAttributeMapIt;
+	/**
+	 * Attribute stored in the arena of the document. The name hash is case sensitive, same as the names.
+	 */
+	struct cXmlAttribute
+	{
+		unsigned int mlNameHash;
+		const char* mpName;
+		const char* mpValue;
+	};
 
 	class cXmlElement : public iXmlNode
 	{
+	friend class iXmlDocument;
 	public:
 		cXmlElement(const tString& asName, iXmlNode* apParent);
 		virtual ~cXmlElement();
 		
 		const char* GetAttribute(const tString& asName);
+		const char* GetAttribute(const char* apName);
 		
 		tString GetAttributeString(const tString& asName, const tString& asDefault="");
 		float GetAttributeFloat(const tString& asName, float afDefault=0);
@@ -103,6 +143,7 @@ namespace hpl {
 		cColor GetAttributeColor(const tString& asName, const cColor& aDefault=cColor(0,0));
 
 		void SetAttribute(const tString& asName, const char* asVal);
+		void SetAttribute(const char* apName, size_t alNameLength, const char* apVal, size_t alValLength);
 		
 		void SetAttributeString(const tString& asName, const tString& asVal);
 		void SetAttributeFloat(const tString& asName, float afVal);
@@ -112,11 +153,22 @@ namespace hpl {
 		void SetAttributeVector3f(const tString& asName, const cVector3f& avVal);
 		void SetAttributeColor(const tString& asName, const cColor& aVal);
 
+		int GetAttributeNum(){ return mlAttributeNum;}
+		const char* GetAttributeName(int alIdx){ return mpAttributes[alIdx].mpName;}
+		const char* GetAttributeValue(int alIdx){ return mpAttributes[alIdx].mpValue;}
+
+		static unsigned int GetAttributeNameHash(const char* apName, size_t alLength);
+
+	protected:
+		void ClearAttributes();
 
-		tAttributeMap* GetAttributeMap(){ return &m_mapAttributes;}
-		
 	private:
-		tAttributeMap m_mapAttributes;
+		cXmlAttribute* FindAttribute(const char* apName, size_t alLength);
+		void SetParsedAttributes(const cXmlAttribute *apAttributes, int alNum);
+
+		cXmlAttribute *mpAttributes;
+		int mlAttributeNum;
+		int mlAttributeCapacity;
 	};
 
 	//-------------------------------------
@@ -141,15 +193,45 @@ namespace hpl {
 		virtual void SaveToString(tString *apDestData)=0;
 		virtual bool CreateFromString(const tString& asData)=0;
 
+		/**
+		 * Memory used by the elements and attributes of the document.
+		 */
+		size_t GetMemorySize();
+
 	protected:
 		void SaveErrorInfo(const tString& asDesc, int alRow, int alCol) { msErrorDesc = asDesc; mlErrorRow = alRow; mlErrorCol = alCol; }
 
+		/**
+		 * Parses the data and builds the elements directly, replacing the current content. The data must be
+		 * 0 terminated. On error the document is left empty and the error info is set.
+		 */
+		bool ParseData(const char* apData, size_t alSize);
+
 	private:
 		virtual bool LoadDataFromFile(const tWString& asPath)=0;
 		virtual bool SaveDataToFile(const tWString& asPath)=0;
 		
+		bool ParseElement(cXmlElement *apElement);
+		bool ParseAttributeValue(cXmlElement *apElement, const char* apName, size_t alNameLength);
+		bool ParseEndTag(cXmlElement *apElement);
+		bool SkipMarkup();
+		void SkipWhiteSpace();
+		size_t ReadName();
+		void DecodeText(const char* apStart, const char* apEnd, tString *apDest);
+		bool SetParseError(const tString& asDesc, const char* apPos);
+		const char* GetParsedName(const char* apName, size_t alLength, unsigned int alHash);
+
 		tWString msFile;
 
+		const char* mpParseStart;
+		const char* mpParseEnd;
+		const char* mpParsePos;
+		bool mbParseUTF8;
+		tString msParseBuffer;
+		std::vector<cXmlAttribute> mvParseAttributes;
+		const char* mvParseNames[256];
+		unsigned int mvParseNameHashes[256];
+
 		tString msErrorDesc;
 		int		mlErrorRow;
 		int		mlErrorCol;
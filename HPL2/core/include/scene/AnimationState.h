@@ -23,6 +23,7 @@
 #include "math/MathTypes.h"
 #include "system/SystemTypes.h"
 #include "graphics/GraphicsTypes.h"
+#include "graphics/AnimationClip.h"
 
 #include "engine/SaveGame.h"
 
@@ -163,6 +164,16 @@ namespace hpl {
 
 		cAnimation* GetAnimation();
 
+		/**
+		 * Samples all tracks of the animation at the current time position. The pose has the same index as the tracks.
+		 */
+		void SamplePose(cAnimationPose *apPose);
+		/**
+		 * Same as above but with a loop mode other than the state's own.
+		 */
+		void SamplePose(cAnimationPose *apPose, bool abLoop);
+		cAnimationClipCursor* GetClipCursor(){ return &mClipCursor;}
+
 		cAnimationEvent *CreateEvent();
 		cAnimationEvent *GetEvent(int alIdx);
 		int GetEventNum();
@@ -194,6 +205,8 @@ namespace hpl {
 
 		tSkeletonBoundsVec mvSkeletonBounds;
 
+		cAnimationClipCursor mClipCursor;
+
 		//Properties of the animation
 		float mfLength;
 		float mfWeight;
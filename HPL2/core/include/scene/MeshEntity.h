@@ -43,6 +43,7 @@ namespace hpl {
 	class cMeshEntity;
 	class cAnimation;
 	class cAnimationState;
+	class cAnimationTrack;
 	class cNodeState;
 	class cBone;
 	class cNode3D;
@@ -50,6 +51,7 @@ namespace hpl {
 	class iPhysicsBody;
 	class iPhysicsWorld;
 	class cWorld;
+	class cFrustum;
 
 	//-----------------------------------------------------------------------
 
@@ -172,6 +174,18 @@ namespace hpl {
 
 		void ResetGraphicsUpdated();
 
+		//Level of detail
+		/**
+		 * Part of the screen height covered by the mesh. Only calculated for the first viewport each frame, so 
+		 * the detail level (and skinning) stays the same for shadow maps and such.
+		 */
+		float GetLodScreenSize(cFrustum *apFrustum);
+		/**
+		 * Forces a detail level for all sub meshes, -1 means it is picked from the screen size.
+		 */
+		void SetForcedLod(int alX){ mlForcedLod = alX;}
+		int GetForcedLod(){ return mlForcedLod;}
+
 		//Node states
 		cNode3D* GetNodeState(int alIndex);
 		int GetNodeStateIndex(const tString &asName);
@@ -221,6 +235,11 @@ namespace hpl {
 
 		void UpdateNodeMatrixRec(cNode3D *apNode);
 
+		void ApplyAnimationPose(cAnimationState *apAnimState, float afWeight);
+		void UpdateBoneStatesFromAnimations(float afWeightMul, int alSoloIndex);
+		int GetTrackBoneIndex(cAnimationTrack *apTrack);
+		void SetupBoneOrder();
+
 		void HandleAnimationEvent(cAnimationEvent *apEvent);
 
 		void SetBoneMatrixFromBodyRec(const cMatrixf& a_mtxParentWorld,cBoneState *apBoneState);
@@ -246,12 +265,8 @@ namespace hpl {
 		tRenderableFlag mlRenderFlags;
 		
 		bool mbBoneMatricesNeedUpdate;
-		int mlBoneMatricesTransformCount;
 		int mlBoneMatricesUpdateCount;
 
-		cMatrixf m_mtxInvWorldMatrix;
-		int mlInvWorldMatrixTransformCount;
-
 		bool mbUpdateBonesWhenCulled;
 
 		bool mbStatic;
@@ -269,6 +284,12 @@ namespace hpl {
 		tNodeStateVec mvTempBoneStates;
 
 		std::vector<cMatrixf> mvBoneMatrices;
+		std::vector<cMatrixf> mvBoneMeshMatrices;
+		tIntVec mvBoneParents;
+		tIntVec mvBoneOrder;
+
+		cAnimationPose mAnimationPose;
+		cAnimationPose mBonePose;
 
 		bool mbSkeletonPhysics;
 		bool mbSkeletonPhysicsFading;
@@ -289,6 +310,10 @@ namespace hpl {
 		tNodeStateIndexMap m_mapNodeStateIndices;
 
 		cMesh* mpMesh;
+
+		float mfLodScreenSize;
+		int mlLodRenderFrameCount;
+		int mlForcedLod;
 		
 		cMeshEntityCallback *mpCallback;
 
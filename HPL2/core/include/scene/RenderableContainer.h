@@ -33,6 +33,7 @@ namespace hpl {
 	class cRendererCallbackFunctions;
 	class iRenderable;
 	class cFrustum;
+	class cRenderableFlatTree;
 
 	//-------------------------------------------
 	
@@ -164,6 +165,11 @@ namespace hpl {
 
 		virtual void RenderDebug(cRendererCallbackFunctions *apFunctions)=0;
 
+		/**
+		 * Compiled copy of the node tree used for faster culling, NULL if the container does not have one.
+		 */
+		virtual cRenderableFlatTree* GetFlatTree(){ return NULL;}
+
 	private:
 		void CheckNeedPropertyUpdateIteration(iRenderableContainerNode* apNode);
 		void CheckNeedAABBUpdateIteration(iRenderableContainerNode* apNode);
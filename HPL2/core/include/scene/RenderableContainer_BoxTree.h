@@ -44,6 +44,49 @@ namespace hpl {
 		tRenderableList mlstObjects;
 	};
 
+	//-------------------------------------------
+
+	class cBoxTreeBuildObject
+	{
+	public:
+		cVector3f mvMin;
+		cVector3f mvMax;
+		cVector3f mvCenter;
+		iRenderable *mpObject;
+	};
+
+	/**
+	 * Node in the flat array used by the SAH builder. Objects are a range in the object array,
+	 * children are indices in the node array (-1 for leaves).
+	 */
+	class cBoxTreeBuildNode
+	{
+	public:
+		cBoxTreeBuildNode() : mlFirst(0), mlCount(0), mlChildA(-1), mlChildB(-1) {}
+
+		cVector3f mvMin;
+		cVector3f mvMax;
+		int mlFirst;
+		int mlCount;
+		int mlChildA;
+		int mlChildB;
+	};
+
+	class cJobPool;
+	class cJobBatch;
+	class cRenderableFlatTree;
+
+	class cBoxTreeBuildData
+	{
+	public:
+		std::vector<cBoxTreeBuildObject> mvObjects;
+		std::vector<cBoxTreeBuildNode> mvNodes;
+
+		cJobPool *mpJobPool;
+		cJobBatch *mpJobBatch;
+		int mlJobMaxObjects;	//Subtrees with at most this many objects are built as a job
+	};
+
 	//-------------------------------------------
 	
 	class cRCNode_BoxTree : public iRenderableContainerNode
@@ -59,6 +102,7 @@ namespace hpl {
 	
 	class cRenderableContainer_BoxTree : public iRenderableContainer
 	{
+	friend class cBoxTreeBuildJob;
 	public:
 		cRenderableContainer_BoxTree();
 		~cRenderableContainer_BoxTree();
@@ -75,6 +119,8 @@ namespace hpl {
 
 		void RenderDebug(cRendererCallbackFunctions *apFunctions);
 
+		cRenderableFlatTree* GetFlatTree(){ return mpFlatTree;}
+
 		void SetMinLeafObjects(int alX){mlMinLeafObjects = alX;}
 		int GetMinLeafObjects(){ return mlMinLeafObjects;}
 
@@ -92,14 +138,41 @@ namespace hpl {
 		
 		void SetMinForceIntersectionRelativeSize(float afX){mfMinForceIntersectionRelativeSize = afX;}
 		float GetMinForceIntersectionRelativeSize(){ return mfMinForceIntersectionRelativeSize;}
+
+		/**
+		 * If true (default) the tree is built with a binned surface area heuristic, else the old
+		 * split plane search is used.
+		 */
+		void SetUseSAHBuild(bool abX){ mbUseSAHBuild = abX;}
+		bool GetUseSAHBuild(){ return mbUseSAHBuild;}
+
+		/**
+		 * Statistics from the last compile. The SAH cost is relative to the root area, with cost 1 for
+		 * a node visit and 1 for an object test. Compile time is in ms. The tree object num is the number of
+		 * objects found in the nodes, which must be the same as the object num.
+		 */
+		int GetObjectNum(){ return (int)m_mlstTempObjects.size();}
+		int GetTreeObjectNum(){ return mlTreeObjectNum;}
+		int GetNodeNum(){ return mlNodeNum;}
+		int GetLeafNum(){ return mlLeafNum;}
+		float GetSAHCost(){ return mfSAHCost;}
+		int GetCompileTime(){ return mlCompileTime;}
 		
 
 	private:
+		void CompileSAH();
+		void BuildSAHNode(cBoxTreeBuildData *apData, int alNode, int alFirst, int alCount, bool abAllowJobs);
+		int FindSAHSplit(cBoxTreeBuildData *apData, int alFirst, int alCount, const cVector3f &avCenterMin, const cVector3f &avCenterMax,
+							int alMinChildObjects, float &afCost);
+		void BuildNodeFromSAH(cBoxTreeBuildData *apData, int alBuildNode, cRCNode_BoxTree *apNode);
+
 		void CompileTempNode(cBoxTreeTempNode *apNode, int alLevel, int alSplitAxis);
 		void BuildNodeFromTemp(cBoxTreeTempNode *apTempNode, cRCNode_BoxTree *apNode, int alLevel);
 
 		void RenderDebugNode(cRendererCallbackFunctions *apFunctions, cRCNode_BoxTree *apNode, int alLevel);
 
+		void CalculateTreeStats(cRCNode_BoxTree *apNode, float afRootArea);
+
 		void CalculateMinMax(tRenderableList *apObjectList, cVector3f& avMin, cVector3f& avMax);
 		cVector3f CalculateSize(tRenderableList *apObjectList);
 
@@ -109,6 +182,7 @@ namespace hpl {
 		int GetSplitGroup(iRenderable *apObject, float afCutPlane, int alAxis, const cVector3f &avNodeSize);
 		
 		cRCNode_BoxTree* mpRoot;
+		cRenderableFlatTree* mpFlatTree;
 
 		int mlMinLeafObjects;
 		float mfMinSideLength;
@@ -116,6 +190,13 @@ namespace hpl {
 		float mfMaxIntersectionAmount;
 		int mlMaxVolumeCalcObjects;
 		float mfMinForceIntersectionRelativeSize;
+		bool mbUseSAHBuild;
+
+		int mlNodeNum;
+		int mlLeafNum;
+		int mlTreeObjectNum;
+		float mfSAHCost;
+		int mlCompileTime;
 
 		tRenderableList m_mlstTempObjects;
 
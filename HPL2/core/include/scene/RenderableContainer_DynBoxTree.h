@@ -56,36 +56,30 @@ namespace hpl {
 		cRCNode_DynBoxTree();
 		~cRCNode_DynBoxTree();
 
-		void UpdateBeforeUse();
-
-		void RemoveObject(iRenderable *apObject);
-
-		void RecalculateSplit();
-		void RecalculateAABB();
-
-		void ObjectMoved();
+		/**
+		 * Leaves hold exactly one object, other nodes have exactly two children (the container root has at most one).
+		 */
+		inline bool IsLeaf(){ return mlstObjects.empty()==false; }
 
 	private:
-		cRenderableContainer_DynBoxTree *mpContainer;
+		cRCNode_DynBoxTree* GetSibling(cRCNode_DynBoxTree *apChild);
+		void ReplaceChild(cRCNode_DynBoxTree *apOldChild, cRCNode_DynBoxTree *apNewChild);
+		void UpdateAABBFromChildren();
+		void UpdateSphere();
 
-		int mlSplitAxis;
-		float mfSplitPlane;
-
-		bool mbRecalculateSplit;
-		bool mbRecalculateSplitAxis;
-		bool mbRecalculateAABB;
-        bool mbObjectMoved;
-
-		bool mbIsSplit;
-
-		int mlIgnoreSplitCount;
-		int mlGarbageCollectCount;
+		cRenderableContainer_DynBoxTree *mpContainer;
 
-		cVector3f mvMeanPosition;
+		cVector3f mvInsertPosition;
 	};
 
 	//-------------------------------------------
 	
+	/**
+	 * Incremental AABB tree for dynamic objects. Every object gets its own leaf with an enlarged ("fat") AABB, 
+	 * so small movements do not change the tree at all. An object that leaves its fat AABB is removed and reinserted
+	 * using a surface area cost descent, and the nodes on the path back to the root are refitted and rotated 
+	 * to keep the tree quality up without full rebuilds.
+	 */
 	class cRenderableContainer_DynBoxTree : public iRenderableContainer
 	{
 	friend class cRCNode_DynBoxTree;
@@ -101,45 +95,72 @@ namespace hpl {
 
         void Compile();	
 
+		/**
+		 * Queues a full top down rebuild of the tree, done in the next update.
+		 */
 		void RebuildNodes();
 
 		void RenderDebug(cRendererCallbackFunctions *apFunctions);
+
+		/**
+		 * The distance the leaf AABBs are enlarged by on each side.
+		 */
+		void SetLeafMargin(float afX){ mfLeafMargin = afX;}
+		float GetLeafMargin(){ return mfLeafMargin;}
+
+		int GetLeafNum(){ return mlLeafNum;}
+
+		/**
+		 * Tree changes during the last renderer frame, Add/Remove since the frame before are included.
+		 */
+		int GetFrameReinsertCount(){ return mlFrameReinsertCount;}
+		int GetFrameRotationCount(){ return mlFrameRotationCount;}
+		int GetFrameRebuildCount(){ return mlFrameRebuildCount;}
 	
 	private:
-		void AddNodeObjectsToRoot(cRCNode_DynBoxTree *apNode);
 		void SpecificUpdateBeforeRendering();
 
 		void RenderDebugNode(cRendererCallbackFunctions *apFunctions, cRCNode_DynBoxTree *apNode, int alLevel);
 
-		void RemoveNode(cRCNode_DynBoxTree *apNode);
-		void CheckNodeAABBNeedsUpdateIterative(cRCNode_DynBoxTree *apNode, iRenderable *apObject);
-		
-		cRCNode_DynBoxTree *GetAddNode(cRCNode_DynBoxTree *apStartNode, iRenderable *apObject);
-		void AddObjectToNodeIterative(cRCNode_DynBoxTree *apNode, iRenderable *apObject);
+		cRCNode_DynBoxTree* CreateNode();
+		void DestroyNode(cRCNode_DynBoxTree *apNode);
 
-		int GetSplitGroup(iRenderable *apObject, float afSplitPlane, int alAxis, const cVector3f &avNodeSize);
+		void SetLeafAABB(cRCNode_DynBoxTree *apLeaf, iRenderable *apObject, const cVector3f& avDisplacement);
+
+		void InsertLeaf(cRCNode_DynBoxTree *apLeaf);
+		void RemoveLeaf(cRCNode_DynBoxTree *apLeaf);
+		void RefitAndRotate(cRCNode_DynBoxTree *apNode);
+		void RotateNode(cRCNode_DynBoxTree *apNode);
+		void UpdateRootAABB();
 
 		void UpdateObjectInContainer(iRenderable* apObject);
-		void CheckForFitIterative(cRCNode_DynBoxTree *apNode, cBoundingVolume *apBV);
 
+		void RebuildTree();
+		void CollectLeavesAndDestroyNodes(cRCNode_DynBoxTree *apNode, std::vector<cRCNode_DynBoxTree*>& avLeaves);
+		cRCNode_DynBoxTree* BuildNodeTopDown(cRCNode_DynBoxTree **apLeaves, int alCount);
 		
 		cRCNode_DynBoxTree mRoot;
 
-		int mlSplitThreshold;
-		float mfMaxIntersectionAmount;
-		int mlMaxIgnoreSplitCount;
-		int mlMaxGarbageCollectCount;
+		float mfLeafMargin;
+		float mfDisplacementMul;
+		float mfMaxFatAreaMul;
 
 		int mlRebuildCount;
-		int mlMaxRebuildCount;
+		int mlLeafNum;
+
+		int mlReinsertCount;
+		int mlRotationCount;
+		int mlRebuildNum;
+		int mlFrameReinsertCount;
+		int mlFrameRotationCount;
+		int mlFrameRebuildCount;
+		int mlStatsFrameCount;
 
-		cRCNode_DynBoxTree *mpCheckForFitTempNode;
+		std::vector<cRCNode_DynBoxTree*> mvFreeNodes;
 
 		tRenderableSet m_setObjectsToUpdate;
 
 		cDynBoxTreeObjectCallback *mpObjectCalllback;
-
-		cRCNode_DynBoxTree *mpTempNode;
 	};
 
 	//-------------------------------------------
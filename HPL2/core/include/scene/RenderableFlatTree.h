@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_RENDERABLE_FLAT_TREE_H
+#define HPL_RENDERABLE_FLAT_TREE_H
+
+#include "math/MathTypes.h"
+#include "graphics/GraphicsTypes.h"
+#include "system/SystemTypes.h"
+#include "scene/SceneTypes.h"
+
+namespace hpl {
+
+	//-------------------------------------------
+
+	class iRenderableContainerNode;
+	class iRenderable;
+
+	//-------------------------------------------
+
+	/**
+	 * Up to four sibling nodes with their AABBs stored per axis, so all four can be tested against a plane at once.
+	 */
+	class cRenderableFlatTreeNode
+	{
+	public:
+		float mvMinX[4];
+		float mvMinY[4];
+		float mvMinZ[4];
+		float mvMaxX[4];
+		float mvMaxY[4];
+		float mvMaxZ[4];
+
+		int mvChildNode[4];		//Index of the block with the children, -1 if none.
+		int mvObjectFirst[4];
+		int mvObjectNum[4];
+
+		int mlNum;
+	};
+
+	typedef std::vector<cRenderableFlatTreeNode> tRenderableFlatTreeNodeVec;
+
+	//-------------------------------------------
+
+	/**
+	 * Compiled copy of a static container node tree. Nodes are stored depth first in one array with four children
+	 * per block and the objects of each node are a range in one object array.
+	 * The tree is not updated, so it must be rebuilt if the source tree changes.
+	 */
+	class cRenderableFlatTree
+	{
+	public:
+		cRenderableFlatTree();
+		~cRenderableFlatTree();
+
+		void Build(iRenderableContainerNode *apRoot);
+		void Clear();
+
+		/**
+		 * Tests the children in a block against the planes set in alPlaneMask (at most 32 planes). 
+		 * Returns a bit for each child that is not outside any plane. apChildPlaneMasks gets the planes each child 
+		 * still intersects, so if it is 0 the child is inside all of them.
+		 */
+		static int CullNode(const cRenderableFlatTreeNode& aNode, const cPlanef *apPlanes, int alPlaneNum, int alPlaneMask, int *apChildPlaneMasks);
+
+		inline const cRenderableFlatTreeNode& GetNode(int alIdx) const { return mvNodes[alIdx];}
+		inline iRenderable* GetObject(int alIdx) const { return mvObjects[alIdx];}
+
+		inline int GetRootChildNode() const { return mlRootChildNode;}
+		inline int GetRootObjectFirst() const { return mlRootObjectFirst;}
+		inline int GetRootObjectNum() const { return mlRootObjectNum;}
+
+		int GetNodeNum(){ return (int)mvNodes.size();}
+		int GetObjectNum(){ return (int)mvObjects.size();}
+
+	private:
+		int BuildChildren(iRenderableContainerNode *apNode);
+		int BuildBlock(const std::vector<iRenderableContainerNode*>& avChildren, size_t alStart);
+		void AddObjects(iRenderableContainerNode *apNode, int &alFirst, int &alNum);
+		
+		tRenderableFlatTreeNodeVec mvNodes;
+		std::vector<iRenderable*> mvObjects;
+
+		int mlRootChildNode;
+		int mlRootObjectFirst;
+		int mlRootObjectNum;
+	};
+
+	//-------------------------------------------
+};
+#endif // HPL_RENDERABLE_FLAT_TREE_H
@@ -112,9 +112,19 @@ namespace hpl {
 		void SetCustomMaterial(cMaterial *apMaterial, bool abDestroyOldCustom=true);
 		cMaterial* GetCustomMaterial(){ return mpMaterial;}
 
+		/**
+		 * The detail level used for rendering, 0 is the full sub mesh.
+		 */
+		int GetLod(){ return mlLod;}
+
 	private:
 		void OnTransformUpdated();
 
+		int SelectLod(float afScreenSize);
+		void SetLod(int alLod);
+		iVertexBuffer* CreateSkinVertexBuffer(iVertexBuffer *apBindBuffer);
+		void UpdateSkinnedVertices();
+
 		cSubMesh *mpSubMesh;
 		cMeshEntity *mpMeshEntity;
 
@@ -127,6 +137,9 @@ namespace hpl {
 		iVertexBuffer* mpDynVtxBuffer;
 		tTriangleDataVec mvDynTriangles;
 
+		int mlLod;
+		std::vector<iVertexBuffer*> mvDynLodVtxBuffers;
+
 		cSubMeshEntityBodyUpdate* mpEntityCallback;
 		bool mbUpdateBody;
 
@@ -45,6 +45,7 @@ namespace hpl {
 		inline bool HasSound(eSoundEntityType aType){ return mvSoundNameVecs[aType].empty()==false;}
 		
 		void PreloadSounds();
+		void PrefetchSounds();
 
 		bool CreateFromFile(const tWString &asFile);
 
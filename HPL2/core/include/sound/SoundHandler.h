@@ -23,11 +23,13 @@
 #include <list>
 
 #include "system/SystemTypes.h"
+#include "system/NameTable.h"
 #include "math/MathTypes.h"
 #include "sound/SoundTypes.h"
 #include "engine/EngineTypes.h"
 
 #include "physics/PhysicsWorld.h"
+#include "sound/SoundChannel.h"
 
 namespace hpl {
 	
@@ -62,6 +64,63 @@ namespace hpl {
 
 	//----------------------------------------
 
+	////////////////////////////////////////////////////
+	//////////// PENDING CHANNEL ///////////////////////
+	////////////////////////////////////////////////////
+
+	//----------------------------------------
+
+	/**
+	 * Stand in for a channel while the sound data is loaded. Keeps all settings so they can be given
+	 * to the real channel once it is created.
+	 */
+	class cPendingSoundChannel : public iSoundChannel
+	{
+	public:
+		cPendingSoundChannel();
+
+		void Play(){ mbPaused = false; mbStopUsed = false;}
+		void Stop(){ mbStopUsed = true;}
+		
+		void SetPaused(bool abX){ mbPaused = abX;}
+		void SetSpeed(float afSpeed){ mfSpeed = afSpeed;}
+		void SetVolume (float afVolume){ mfVolume = afVolume;}
+		void SetLooping (bool abLoop){ mbLooping = abLoop;}
+		void SetPan (float afPan){ mfPan = afPan;}
+		void Set3D(bool ab3D){ mb3D = ab3D;}
+
+		void SetPriority(int alX);
+		int GetPriority(){ return mlPriority;}
+
+		void SetPositionIsRelative(bool abRelative){ mbPositionRelative = abRelative;}
+		void SetPosition(const cVector3f &avPos){ mvPosition = avPos;}
+
+		void SetVelocity(const cVector3f &avVel){ mvVelocity = avVel;}
+		
+		void SetMinDistance(float afMin){ mfMinDistance = afMin;}
+		void SetMaxDistance(float afMax){ mfMaxDistance = afMax;}
+
+		bool IsPlaying(){ return mbStopUsed==false;}
+		bool IsBufferUnderrun(){ return false;}
+		double GetElapsedTime(){ return mfElapsedTime;}
+		double GetTotalTime(){ return 0;}
+		void SetElapsedTime(double afTime){ mfElapsedTime = afTime;}
+
+		void SetFiltering ( bool abEnabled, int alFlags ){}
+		void SetFilterGain(float afGain){}
+		void SetFilterGainHF(float afGainHF){}
+
+		/**
+		 * Gives all settings to the real channel.
+		 */
+		void CopySettingsTo(iSoundChannel *apChannel);
+
+	private:
+		double mfElapsedTime;
+	};
+
+	//----------------------------------------
+
 	////////////////////////////////////////////////////
 	//////////// SOUND ENTRY ///////////////////////////
 	////////////////////////////////////////////////////
@@ -74,6 +133,7 @@ namespace hpl {
 	
 	class cSoundEntry
 	{
+	friend class cSoundHandler;
 	public:
 		cSoundEntry(const tString& asName, iSoundChannel* apSound, float afVolume,
 					eSoundEntryType aType, bool ab3D,
@@ -81,14 +141,24 @@ namespace hpl {
 					cSoundHandler *apSoundHandler);
 		~cSoundEntry();
 
+		/**
+		 * Sets up the entry for a new sound, used when reusing an entry from the pool.
+		 */
+		void Setup(	const tString& asName, iSoundChannel* apSound, float afVolume,
+					eSoundEntryType aType, bool ab3D,
+					bool abStream,int alId);
+		void DestroyChannel();
+
 		bool Update(float afTimeStep);
 
 		inline const tString& GetName() const { return msName;}
+		inline tNameId GetNameId() const { return mNameId;}
 		inline eSoundEntryType GetType() const { return mType; }
 		inline int GetId() const { return mlId; }
 		inline iSoundChannel* GetChannel() const { return mpSound; }
 		
 		inline bool IsFirstTime(){ return mbFirstTime; }
+		inline bool IsLoading(){ return mbLoading; }
 
 		void Stop();
 		void SetPaused(bool abX);
@@ -118,8 +188,10 @@ namespace hpl {
 		void UpdateSpeedMulFade(float afTimeStep);
 
 		void Update3DSpecifics(float afTimeStep);
+		bool UpdateLoading(float afTimeStep);
 		
 		tString msName;
+		tNameId mNameId;
 		iSoundChannel* mpSound;
 		cSoundHandler *mpSoundHandler;
 
@@ -148,6 +220,9 @@ namespace hpl {
 		bool mbStream;
 		bool mbStopDisabled;
 
+		bool mbLoading;
+		float mfLoadingTime;
+
 		iSoundEntryCallback *mpCallback;
 	};
 	
@@ -164,6 +239,8 @@ namespace hpl {
 	typedef tSoundEntryList::iterator tSoundEntryListIt;
 	typedef cSTLIterator<cSoundEntry,tSoundEntryList,tSoundEntryListIt> tSoundEntryIterator;
 
+	typedef std::vector<cSoundEntry*> tSoundEntryVec;
+
 	class cResources;
 
 	//----------------------------------------
@@ -215,8 +292,17 @@ namespace hpl {
 
 		void SetSilent(bool abX){ mbSilent = abX; }
 		bool GetSilent(){ return mbSilent; }
+
+		/**
+		 * If > 0, the first play of a sample that is not loaded does not wait for the disk. The sound starts
+		 * when the file has been read, or after at most this many seconds (then it waits).
+		 * 0 (default) means sounds are always loaded right away.
+		 */
+		void SetAsyncLoadMaxDelay(float afX){ mfAsyncLoadMaxDelay = afX;}
+		float GetAsyncLoadMaxDelay(){ return mfAsyncLoadMaxDelay;}
 		
 		bool Stop(const tString& asName);
+		bool Stop(tNameId alNameId);
 		bool StopAllExcept(const tString& asName);
 		
 		void StopAll(tFlag mTypes);
@@ -225,6 +311,7 @@ namespace hpl {
 		void FadeOutAll(tFlag mTypes,float afFadeSpeed, bool abDisableStop);
 
 		bool IsPlaying(const tString& asName);
+		bool IsPlaying(tNameId alNameId);
 
 		bool IsValid(cSoundEntry *apEntry, int alID);
 		
@@ -257,15 +344,17 @@ namespace hpl {
 	
 	private:
 		cSoundEntry* GetEntry(const tString& asName);
+		cSoundEntry* GetEntry(tNameId alNameId);
 
 		iLowLevelSound* mpLowLevelSound;
 		cResources* mpResources;
 
 		tSoundEntryList m_lstSoundEntries;
 
-		//tSoundEntryList m_lstSoundEntriesPool;
+		tSoundEntryVec mvSoundEntriesPool;
 		
 		bool mbSilent;
+		float mfAsyncLoadMaxDelay;
 
 		cWorld *mpWorld;
 
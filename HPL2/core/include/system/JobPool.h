@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_JOB_POOL_H
+#define HPL_JOB_POOL_H
+
+#include "system/SystemTypes.h"
+#include "system/Thread.h"
+
+namespace hpl {
+
+	//------------------------------------------
+
+	class iMutex;
+	class cJobPool;
+
+	//------------------------------------------
+
+	class iJob
+	{
+	public:
+		virtual ~iJob(){}
+		virtual void Run()=0;
+	};
+
+	//------------------------------------------
+
+	/**
+	 * Keeps track of a group of jobs so that it is possible to wait for all of them to finish.
+	 */
+	class cJobBatch
+	{
+	friend class cJobPool;
+	public:
+		cJobBatch() : mlJobsLeft(0) {}
+
+	private:
+		int mlJobsLeft;
+	};
+
+	//------------------------------------------
+
+	class cJobPoolWorker : public iThreadClass
+	{
+	public:
+		cJobPoolWorker(cJobPool *apPool) : mpPool(apPool) {}
+
+		void UpdateThread();
+
+	private:
+		cJobPool *mpPool;
+	};
+
+	//------------------------------------------
+
+	class cJobPoolEntry
+	{
+	public:
+		cJobPoolEntry(iJob *apJob, cJobBatch *apBatch) : mpJob(apJob), mpBatch(apBatch) {}
+
+		iJob *mpJob;
+		cJobBatch *mpBatch;
+	};
+
+	typedef std::list<cJobPoolEntry> tJobPoolEntryList;
+	typedef tJobPoolEntryList::iterator tJobPoolEntryListIt;
+
+	//------------------------------------------
+
+	class cJobPool
+	{
+	public:
+		/**
+		 * \param alThreadNum Number of worker threads, if 0 all jobs are run on the thread waiting for them.
+		 */
+		cJobPool(int alThreadNum);
+		~cJobPool();
+
+		/**
+		 * Adds a job to the queue. The pool takes ownership of the job and deletes it when it has been run.
+		 */
+		void AddJob(iJob *apJob, cJobBatch *apBatch=NULL);
+
+		/**
+		 * Waits until all jobs in the batch are done. Queued jobs are run on the calling thread while waiting,
+		 * so it is safe to wait from inside a job.
+		 */
+		void WaitForBatch(cJobBatch *apBatch);
+		bool IsBatchDone(cJobBatch *apBatch);
+
+		/**
+		 * Runs the next job in queue on the calling thread. Returns false if the queue was empty.
+		 */
+		bool RunNextJob();
+
+		int GetThreadNum(){ return (int)mvThreads.size();}
+
+	private:
+		iMutex *mpMutex;
+
+		tJobPoolEntryList mlstJobs;
+
+		std::vector<iThread*> mvThreads;
+		std::vector<cJobPoolWorker*> mvWorkers;
+	};
+
+	//------------------------------------------
+
+};
+#endif // HPL_JOB_POOL_H
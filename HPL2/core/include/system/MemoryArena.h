@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_MEMORY_ARENA_H
+#define HPL_MEMORY_ARENA_H
+
+#include "system/SystemTypes.h"
+
+namespace hpl {
+
+	//------------------------------------------
+
+	/**
+	 * Bump allocator that hands out memory from large blocks. Nothing is freed on its own, all memory
+	 * is released at once with Clear() or when the arena is destroyed. Objects with destructors must be
+	 * destroyed by hand before that.
+	 */
+	class cMemoryArena
+	{
+	public:
+		cMemoryArena(size_t alBlockSize=64*1024);
+		~cMemoryArena();
+
+		void* Alloc(size_t alSize, size_t alAlign=sizeof(void*)*2);
+
+		/**
+		 * Copies the string to the arena and adds a terminating 0.
+		 */
+		char* AllocString(const char* apString, size_t alLength);
+
+		/**
+		 * Releases all allocations. The first block is kept so refilling the arena does not hit the heap.
+		 */
+		void Clear();
+
+		size_t GetUsedSize(){ return mlUsedSize;}
+		size_t GetMemorySize(){ return mlMemorySize;}
+
+	private:
+		void AddBlock(size_t alMinSize);
+
+		std::vector<char*> mvBlocks;
+		size_t mlBlockSize;
+
+		char *mpCurrent;
+		char *mpEnd;
+
+		size_t mlUsedSize;
+		size_t mlMemorySize;
+		size_t mlFirstBlockSize;
+	};
+
+	//------------------------------------------
+
+};
+#endif // HPL_MEMORY_ARENA_H
@@ -22,6 +22,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace hpl {
 
@@ -99,6 +100,97 @@ namespace hpl {
 
 	//------------------------------------
 
+	enum eMemoryTag
+	{
+		eMemoryTag_Graphics,
+		eMemoryTag_Physics,
+		eMemoryTag_Scene,
+		eMemoryTag_Sound,
+		eMemoryTag_Script,
+		eMemoryTag_Gui,
+		eMemoryTag_Resources,
+		eMemoryTag_Game,
+		eMemoryTag_Other,
+
+		eMemoryTag_LastEnum
+	};
+
+	//------------------------------------
+
+	class cMemoryTagStats
+	{
+	public:
+		cMemoryTagStats() : mlLiveBytes(0), mlPeakBytes(0), mlLiveNum(0), mlAllocNum(0){}
+
+		size_t mlLiveBytes;
+		size_t mlPeakBytes;
+		size_t mlLiveNum;
+		size_t mlAllocNum;
+	};
+
+	//------------------------------------
+
+	class cMemoryAllocSite
+	{
+	public:
+		cMemoryAllocSite(const char* apFile, int alLine) : mpFile(apFile), mlLine(alLine){}
+
+		const char* mpFile;
+		int mlLine;
+	};
+
+	class cMemorySampledSite
+	{
+	public:
+		const char* mpFile;
+		int mlLine;
+		eMemoryTag mTag;
+		size_t mlSampleNum;
+		size_t mlSampledBytes;
+	};
+
+	typedef std::vector<cMemorySampledSite> tMemorySampledSiteVec;
+
+	//------------------------------------
+
+	/**
+	 * Counts memory per subsystem when built with MEMORY_TRACKING_ACTIVE. All new and delete calls then go through
+	 * the tracker, which keeps size and tag of each allocation in a pointer table and updates atomic counters.
+	 * hplNew passes its file, which gives the tag (from the source folder), other allocations count as Other.
+	 * Every Nth hplNew can also be sampled per file and line to find where the memory of a subsystem comes from.
+	 * Without MEMORY_TRACKING_ACTIVE nothing is tracked and all stats are zero.
+	 */
+	class cMemoryTracker
+	{
+	public:
+		static bool IsActive();
+
+		static const char* GetTagName(eMemoryTag aTag);
+		static eMemoryTag GetTagFromFile(const char* apFile);
+
+		static void GetTagStats(eMemoryTag aTag, cMemoryTagStats& aStats);
+
+		/**
+		 * Sample every alEveryNth allocation made with hplNew, 0 turns sampling off.
+		 */
+		static void SetSampleRate(int alEveryNth);
+		static int GetSampleRate();
+		static void GetSampledSites(tMemorySampledSiteVec& avSites);
+		static void ClearSampledSites();
+
+		static void LogReport();
+		static bool SaveReport(const std::wstring& asFile);
+
+		static void* Allocate(size_t alSize, eMemoryTag aTag);
+		static void* AllocateAtSite(size_t alSize, const cMemoryAllocSite& aSite);
+		static void Free(void *apData);
+
+		static void* AllocateAligned(size_t alSize, size_t alAlign, eMemoryTag aTag);
+		static void FreeAligned(void *apData);
+	};
+
+	//------------------------------------
+
 #ifdef MEMORY_MANAGER_ACTIVE
     
 	#define hplNew(classType, constructor) \
@@ -128,6 +220,28 @@ namespace hpl {
 			}//free(data);
 
 		
+#elif defined(MEMORY_TRACKING_ACTIVE)
+	#define hplNew(classType, constructor) \
+			new (hpl::cMemoryAllocSite(__FILE__,__LINE__)) classType constructor 
+	
+	#define hplNewArray(classType, amount) \
+			new (hpl::cMemoryAllocSite(__FILE__,__LINE__)) classType [ amount ] 
+	
+	#define hplMalloc(amount) \
+			malloc( amount )
+
+	#define hplRealloc(data, amount) \
+			realloc( data, amount )
+	
+	#define hplDelete(data) \
+		delete data;
+
+	#define hplDeleteArray(data) \
+		delete [] data;
+
+	#define hplFree(data) \
+		free(data);
+
 #else
 	#define hplNew(classType, constructor) \
 			new classType constructor 
@@ -156,4 +270,12 @@ namespace hpl {
 
 
 };
+
+#ifdef MEMORY_TRACKING_ACTIVE
+	void* operator new(size_t alSize, const hpl::cMemoryAllocSite& aSite);
+	void* operator new[](size_t alSize, const hpl::cMemoryAllocSite& aSite);
+	void operator delete(void *apData, const hpl::cMemoryAllocSite& aSite);
+	void operator delete[](void *apData, const hpl::cMemoryAllocSite& aSite);
+#endif
+
 #endif // HPL_MEMORY_MANAGER_H
@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_NAME_TABLE_H
+#define HPL_NAME_TABLE_H
+
+#include <deque>
+#include "system/SystemTypes.h"
+
+namespace hpl {
+
+	//------------------------------------------
+
+	class iMutex;
+
+	/**
+	 * Compact id for an interned name. Names are case insensitive, so "Door" and "door" give the same id.
+	 * 0 is never used for a name and means "no name".
+	 */
+	typedef unsigned int tNameId;
+
+	#define kNameId_None 0
+
+	//------------------------------------------
+
+	/**
+	 * Global table of interned lower case names. Lookups hash the string as is (folding ASCII case while hashing),
+	 * so no lower case copy has to be created. Thread safe.
+	 */
+	class cNameTable
+	{
+	public:
+		/**
+		 * Gets the id for a name, adding it to the table if it is not there.
+		 */
+		static tNameId GetId(const tString& asName);
+		static tNameId GetId(const char* apName, size_t alLength);
+
+		/**
+		 * Gets the id for a name if it has been added, else kNameId_None. Never adds anything,
+		 * so is the one to use for lookups with names coming from scripts and such.
+		 */
+		static tNameId FindId(const tString& asName);
+		static tNameId FindId(const char* apName, size_t alLength);
+
+		/**
+		 * Gets the lower case name for an id.
+		 */
+		static const tString& GetName(tNameId alId);
+
+		static int GetNameNum();
+
+		static unsigned int GetHash(const char* apName, size_t alLength);
+
+	private:
+		static tNameId FindIdNoLock(const char* apName, size_t alLength, unsigned int alHash, size_t *apSlot);
+		static void Grow();
+		static void Lock();
+		static void Unlock();
+
+		static std::deque<tString> mvNames; //deque so references from GetName stay valid when adding.
+		static std::vector<unsigned int> mvHashes;
+		static std::vector<tNameId> mvSlots;
+		static iMutex *mpMutex;
+	};
+
+	//------------------------------------------
+
+};
+#endif // HPL_NAME_TABLE_H
@@ -148,6 +148,11 @@ namespace hpl {
 		static iThread* CreateThread(iThreadClass* apThreadClass);
 
 		static iMutex* CreateMutEx(); // If you name this method CreateMutex strange stuff will happen :S
+
+		/**
+		 * Number of logical CPU cores, used to decide the number of worker threads.
+		 */
+		static int GetCPUCount();
 	
 	private:
         static void CreateMessageBoxBase(eMsgBoxType eType, const wchar_t* asCaption, const wchar_t* fmt, va_list ap);
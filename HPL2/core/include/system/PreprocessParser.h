@@ -169,6 +169,11 @@ namespace hpl {
 
 		cParserVarContainer* GetEnvVarContainer(){ return &mEnvironmentVars;}
 		cParserVarContainer* GetParsingVarContainer(){ return &mParsingVars;}
+
+		/**
+		 * Files added with @include during the last parse.
+		 */
+		const tWStringVec& GetIncludedFiles(){ return mvIncludedFiles;}
 		
 	private:
 		bool CharIsVariableValid(char alChar);
@@ -196,6 +201,7 @@ namespace hpl {
 		cParserVarContainer mParsingVars;
 		
 		tWString msCurrentDirectory;
+		tWStringVec mvIncludedFiles;
         const tString *mpCurrentInput;
 		tString *mpCurrentOutput;
 		cParserVarContainer *mpCurrentVarContainer;
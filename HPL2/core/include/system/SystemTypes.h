@@ -114,6 +114,9 @@ namespace hpl {
 	typedef std::vector<unsigned int> tUIntVec;
 	typedef tUIntVec::iterator tUIntVecIt;
 
+	typedef std::vector<unsigned short> tUShortVec;
+	typedef tUShortVec::iterator tUShortVecIt;
+
 	typedef std::vector<int> tIntVec;
 	typedef tIntVec::iterator tIntVecIt;
 
@@ -167,7 +167,7 @@ namespace hpl {
 
 		switch(aApi)
 		{
-			case eHplAPI_OpenGL: pGameSetup = hplNew(cSDLEngineSetup, (alHplModuleFlags) ); break;
+			case eHplAPI_OpenGL: pGameSetup = hplNew(cSDLEngineSetup, (alHplModuleFlags, apVars) ); break;
 		}
 
 		return hplNew( cEngine,  (pGameSetup,alHplModuleFlags, apVars) ); 
@@ -298,6 +298,7 @@ namespace hpl {
 
 		//Init physics
 		mpPhysics->Init(mpResources);
+		mpPhysics->SetWorldThreadNum(apVars->mPhysics.mlWorldThreadNum);
 
 		//Init AI
 		mpAI->Init();
@@ -355,6 +356,10 @@ namespace hpl {
 		mfFPSLimit = 1.0 / double(apVars->mGame.mlMaxFramesPerSec);
 		mfLastFrameRender = 0;
 
+		mbFixedStepMode = false;
+		mfPendingLogicTime = 0;
+		mlPendingLogicUpdates = 0;
+
 		mvMaxGameLogic.reserve(300);
 		mvMaxRenderLogic.reserve(300);
 
@@ -367,6 +372,7 @@ namespace hpl {
 		mpRenderingLogicTimer = cPlatform::CreateTimer();
 		mpFrameLimitTimer = cPlatform::CreateTimer();
 		mpFrameTimer = cPlatform::CreateTimer();
+		mpFramePartTimer = cPlatform::CreateTimer();
 		Log("--------------------------------------------------------\n\n");
 
 		Log("User Initialization\n");
@@ -386,6 +392,7 @@ namespace hpl {
 		hplDelete(mpRenderingLogicTimer);
 		hplDelete(mpFrameLimitTimer);
 		hplDelete(mpFrameTimer);
+		hplDelete(mpFramePartTimer);
 		hplDelete(mpMutex);
 		
 		hplDelete(mpUpdater);
@@ -448,7 +455,7 @@ namespace hpl {
 		{
 			//////////////////////////
 			//Check if application is in focus.
-			if(mbWaitIfAppOutOfFocus) CheckIfAppInFocusElseWait();
+			if(mbWaitIfAppOutOfFocus && mbFixedStepMode==false) CheckIfAppInFocusElseWait();
 
 			//////////////////////////
 			//Check if paused
@@ -466,7 +473,7 @@ namespace hpl {
 				//Update logic.
 				int lIterations = 0;
 				mpGameLogicTimer->Start();
-				while(mpLogicTimer->WantUpdate() && !GetGameIsDone())
+				while((mbFixedStepMode ? lIterations==0 : mpLogicTimer->WantUpdate()) && !GetGameIsDone())
 				{
 					/////////////////////////////////////////////
 					// Run Update callback in updater
@@ -509,6 +516,8 @@ namespace hpl {
 					mpInnerGameLogicTimer->Stop();
 
 					mvMaxGameLogic.push_back(mpInnerGameLogicTimer->GetTimeInMilliSec());
+					mfPendingLogicTime += mpInnerGameLogicTimer->GetTimeInMilliSec();
+					mlPendingLogicUpdates++;
 				}
 				mpLogicTimer->EndUpdateLoop();
 
@@ -556,8 +565,13 @@ namespace hpl {
 				STOP_TIMING(WaitAndFinishRendering)
 
 				START_TIMING(SwapBuffers)
+				mpFramePartTimer->Start();
 				mpGraphics->GetLowLevel()->SwapBuffers();
+				mpFramePartTimer->Stop();
 				STOP_TIMING(SwapBuffers)
+
+				mFrameTimes.mfSwap = mpFramePartTimer->GetTimeInMilliSec();
+				mLastFrameTimes = mFrameTimes;
 				
 				//Log("Swap done: %d\n", cPlatform::GetApplicationTime());
 				mpUpdater->RunMessage(eUpdateableMessage_OnPostBufferSwap);
@@ -569,7 +583,7 @@ namespace hpl {
 
 			//////////////
 			// Limit fps
-			if(mbLimitFPS)
+			if(mbLimitFPS && mbFixedStepMode==false)
 			{
 				double fNextFrame = mfLastFrameRender + mfFPSLimit;
 				double fTime = mpFrameLimitTimer->GetTimeInSec();
@@ -591,23 +605,42 @@ namespace hpl {
            		//Get the the from the last frame.
 				UpdateFrameTimer();
 
+				//The logic run since the last frame belongs to this one
+				mFrameTimes = cEngineFrameTimes();
+				mFrameTimes.mfLogic = mfPendingLogicTime;
+				mFrameTimes.mlLogicUpdates = mlPendingLogicUpdates;
+				mfPendingLogicTime = 0;
+				mlPendingLogicUpdates = 0;
+
 				mpRenderingLogicTimer->Start();
 				//On draw callback sending that to gui, etc
 				START_TIMING(OnDraw)
+				mpFramePartTimer->Start();
 				mpUpdater->RunMessage(eUpdateableMessage_OnDraw, mfFrameTime);
+				mpFramePartTimer->Stop();
+				mFrameTimes.mfDraw = mpFramePartTimer->GetTimeInMilliSec();
 				STOP_TIMING(OnDraw)
 				
 				//Render this frame
 				START_TIMING(RenderAll)
+				mpFramePartTimer->Start();
 				mpScene->Render(mfFrameTime, tSceneRenderFlag_All);
+				mpFramePartTimer->Stop();
+				mFrameTimes.mfRender = mpFramePartTimer->GetTimeInMilliSec();
 				STOP_TIMING(RenderAll)
 
 				START_TIMING(PostRender)
+				mpFramePartTimer->Start();
 				mpUpdater->RunMessage(eUpdateableMessage_OnPostRender, mfFrameTime);
+				mpFramePartTimer->Stop();
+				mFrameTimes.mfPostRender = mpFramePartTimer->GetTimeInMilliSec();
 				STOP_TIMING(PostRender)
 				
 				START_TIMING(FlushRender)
+				mpFramePartTimer->Start();
 				mpGraphics->GetLowLevel()->FlushRendering();
+				mpFramePartTimer->Stop();
+				mFrameTimes.mfFlush = mpFramePartTimer->GetTimeInMilliSec();
 				STOP_TIMING(FlushRender)
 				
 				//Update fps counter.
@@ -876,7 +909,7 @@ namespace hpl {
 	void cEngine::UpdateFrameTimer()
 	{
 		mpFrameTimer->Stop();
-		mfFrameTime = (float) mpFrameTimer->GetTimeInSec();
+		mfFrameTime = mbFixedStepMode ? GetStepSize() : (float) mpFrameTimer->GetTimeInSec();
 
 		/*mlstFrameTimes.push_back(mpFrameTimer->GetTimeInMilliSec());
 		if((int)mlstFrameTimes.size() >= mlMaxFrameTimes)
@@ -21,6 +21,7 @@
 
 #include "math/Math.h"
 #include "graphics/AnimationTrack.h"
+#include "graphics/AnimationClip.h"
 
 namespace hpl {
 
@@ -34,6 +35,9 @@ namespace hpl {
 	{
 		msAnimName = "";
 		msFileName = asFile;
+
+		mfLength = 0;
+		mpClip = NULL;
 	}
 
 	//-----------------------------------------------------------------------
@@ -41,6 +45,7 @@ namespace hpl {
 	cAnimation::~cAnimation()
 	{
 		STLDeleteAll(mvTracks);
+		DestroyClip();
 	}
 
 	//-----------------------------------------------------------------------
@@ -60,6 +65,7 @@ namespace hpl {
 
 	void cAnimation::SetLength(float afTime)
 	{
+		if(mfLength != afTime) DestroyClip();
 		mfLength = afTime;
 	}
 
@@ -70,6 +76,7 @@ namespace hpl {
 		cAnimationTrack *pTrack = hplNew( cAnimationTrack,(asName, aFlags, this) );
 
 		mvTracks.push_back(pTrack);
+		DestroyClip();
 
 		return pTrack;
 	}
@@ -122,6 +129,26 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	cAnimationClip* cAnimation::GetClip()
+	{
+		if(mpClip==NULL)
+		{
+			mpClip = hplNew( cAnimationClip, (this, cAnimationClip::GetQuantizeRotations()) );
+		}
+
+		return mpClip;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cAnimation::DestroyClip()
+	{
+		if(mpClip) hplDelete(mpClip);
+		mpClip = NULL;
+	}
+
+	//-----------------------------------------------------------------------
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// PRIVATE METHODS
@@ -0,0 +1,341 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/AnimationClip.h"
+
+#include "math/Math.h"
+#include "graphics/Animation.h"
+#include "graphics/AnimationTrack.h"
+
+namespace hpl {
+
+	bool cAnimationClip::mbQuantizeRotations = false;
+
+	static const float kQuantizeScale = 32767.0f;
+	static const float kDequantizeScale = 1.0f / 32767.0f;
+
+	//////////////////////////////////////////////////////////////////////////
+	// POSE
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cAnimationPose::Resize(int alNum)
+	{
+		mvRotations.resize(alNum);
+		mvTranslations.resize(alNum);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cAnimationClip::cAnimationClip(cAnimation *apAnimation, bool abQuantizeRotations)
+	{
+		mfLength = apAnimation->GetLength();
+		mbQuantizedRotations = abQuantizeRotations;
+
+		////////////////////////////
+		// Count key frames
+		int lKeyFrameNum =0;
+		mvTracks.resize(apAnimation->GetTrackNum());
+		for(int i=0; i<apAnimation->GetTrackNum(); ++i)
+		{
+			cAnimationTrack *pTrack = apAnimation->GetTrack(i);
+
+			mvTracks[i].mlFirstKeyFrame = lKeyFrameNum;
+			mvTracks[i].mlKeyFrameNum = pTrack->GetKeyFrameNum();
+			lKeyFrameNum += pTrack->GetKeyFrameNum();
+		}
+
+		mvTimes.resize(lKeyFrameNum);
+		mvTranslations.resize(lKeyFrameNum*3);
+		if(mbQuantizedRotations)	mvQuantizedRotations.resize(lKeyFrameNum*4);
+		else						mvRotations.resize(lKeyFrameNum*4);
+
+		////////////////////////////
+		// Fill streams
+		int lKey =0;
+		for(int i=0; i<apAnimation->GetTrackNum(); ++i)
+		{
+			cAnimationTrack *pTrack = apAnimation->GetTrack(i);
+			for(int j=0; j<pTrack->GetKeyFrameNum(); ++j, ++lKey)
+			{
+				cKeyFrame *pFrame = pTrack->GetKeyFrame(j);
+
+				mvTimes[lKey] = pFrame->time;
+
+				float *pTrans = &mvTranslations[lKey*3];
+				pTrans[0] = pFrame->trans.x;
+				pTrans[1] = pFrame->trans.y;
+				pTrans[2] = pFrame->trans.z;
+
+				//Normalize and make w positive here, so it does not need to be done when sampling.
+				cQuaternion qRot = pFrame->rotation;
+				qRot.Normalize();
+				if(qRot.w < 0) qRot = qRot * -1.0f;
+
+				if(mbQuantizedRotations)
+				{
+					short *pRot = &mvQuantizedRotations[lKey*4];
+					pRot[0] = (short)cMath::RoundToInt(qRot.v.x * kQuantizeScale);
+					pRot[1] = (short)cMath::RoundToInt(qRot.v.y * kQuantizeScale);
+					pRot[2] = (short)cMath::RoundToInt(qRot.v.z * kQuantizeScale);
+					pRot[3] = (short)cMath::RoundToInt(qRot.w * kQuantizeScale);
+				}
+				else
+				{
+					float *pRot = &mvRotations[lKey*4];
+					pRot[0] = qRot.v.x;
+					pRot[1] = qRot.v.y;
+					pRot[2] = qRot.v.z;
+					pRot[3] = qRot.w;
+				}
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	cAnimationClip::~cAnimationClip()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cAnimationClip::SamplePose(float afTime, bool abLoop, cAnimationClipCursor *apCursor, cAnimationPose *apPose)
+	{
+		const int lTrackNum = (int)mvTracks.size();
+		if(apPose->GetSize() < lTrackNum) apPose->Resize(lTrackNum);
+
+		int *pCursorKeys = GetCursorKeys(apCursor);
+
+		cQuaternion *pRotations = lTrackNum > 0 ? &apPose->mvRotations[0] : NULL;
+		cVector3f *pTranslations = lTrackNum > 0 ? &apPose->mvTranslations[0] : NULL;
+
+		for(int i=0; i<lTrackNum; ++i)
+		{
+			SampleTrackData(mvTracks[i], afTime, abLoop, pCursorKeys ? &pCursorKeys[i] : NULL,
+							pRotations[i], pTranslations[i]);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cAnimationClip::SampleTrack(int alTrack, float afTime, bool abLoop, cAnimationClipCursor *apCursor,
+									cQuaternion& aqRotation, cVector3f& avTranslation)
+	{
+		int *pCursorKeys = GetCursorKeys(apCursor);
+
+		SampleTrackData(mvTracks[alTrack], afTime, abLoop, pCursorKeys ? &pCursorKeys[alTrack] : NULL,
+						aqRotation, avTranslation);
+	}
+
+	//-----------------------------------------------------------------------
+
+	size_t cAnimationClip::GetMemorySize()
+	{
+		return	mvTracks.size() * sizeof(cAnimationClipTrack) + mvTimes.size() * sizeof(float) +
+				mvRotations.size() * sizeof(float) + mvQuantizedRotations.size() * sizeof(short) +
+				mvTranslations.size() * sizeof(float);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Same search rules as cAnimationTrack::GetKeyFramesAtTime, but the cursor key and
+	 * the one after it are tested before falling back to a binary search.
+	 */
+	float cAnimationClip::GetKeyFramesAtTime(const cAnimationClipTrack& aTrack, float afTime, bool abLoop, int *apCursorKey,
+											int &alKeyA, int &alKeyB)
+	{
+		const float *pTimes = &mvTimes[aTrack.mlFirstKeyFrame];
+		const int lSize = aTrack.mlKeyFrameNum;
+
+		int lIdxB=-1;
+
+		////////////////////////////
+		// Check cursor
+		if(apCursorKey)
+		{
+			int lCursor = *apCursorKey;
+			if(lCursor > 0 && lCursor < lSize && afTime >= pTimes[lCursor-1] && afTime <= pTimes[lCursor])
+			{
+				lIdxB = lCursor;
+			}
+			else if(lCursor >= 0 && lCursor+1 < lSize && afTime >= pTimes[lCursor] && afTime <= pTimes[lCursor+1])
+			{
+				lIdxB = lCursor+1;
+			}
+		}
+
+		////////////////////////////
+		// Binary search
+		if(lIdxB < 0)
+		{
+			int lFirst = 0, lLast = lSize - 1;
+			while(lFirst <= lLast)
+			{
+				int lMid = (lFirst + lLast) >> 1;
+				int lBefore = lMid > 0 ? lMid - 1 : 0;
+
+				if(afTime < pTimes[lBefore])
+					lLast = lMid - 1;
+				else if(afTime > pTimes[lMid])
+					lFirst = lMid + 1;
+				else
+				{
+					lIdxB = lMid;
+					break;
+				}
+			}
+
+			if(apCursorKey && lIdxB > 0) *apCursorKey = lIdxB;
+		}
+		else
+		{
+			*apCursorKey = lIdxB;
+		}
+
+		////////////////////////////
+		// Before first frame
+		if(lIdxB <= 0)
+		{
+			if(abLoop)
+			{
+				afTime = fmod(afTime, mfLength + kEpsilonf);
+
+				if(afTime < pTimes[0])
+				{
+					alKeyA = aTrack.mlFirstKeyFrame + lSize - 1;
+					alKeyB = aTrack.mlFirstKeyFrame;
+
+					return afTime / (pTimes[0] + kEpsilonf);
+				}
+			}
+
+			alKeyA = aTrack.mlFirstKeyFrame;
+			alKeyB = aTrack.mlFirstKeyFrame;
+			return 0.0f;
+		}
+
+		alKeyA = aTrack.mlFirstKeyFrame + lIdxB - 1;
+		alKeyB = aTrack.mlFirstKeyFrame + lIdxB;
+
+		float fDeltaT = pTimes[lIdxB] - pTimes[lIdxB-1] + kEpsilonf;
+
+		return (afTime - pTimes[lIdxB-1]) / fDeltaT;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cAnimationClip::SampleTrackData(const cAnimationClipTrack& aTrack, float afTime, bool abLoop, int *apCursorKey,
+										cQuaternion& aqRotation, cVector3f& avTranslation)
+	{
+		if(aTrack.mlKeyFrameNum == 0)
+		{
+			aqRotation = cQuaternion::Identity;
+			avTranslation = 0;
+			return;
+		}
+
+		int lKeyA, lKeyB;
+		float fT = GetKeyFramesAtTime(aTrack, afTime, abLoop, apCursorKey, lKeyA, lKeyB);
+
+		const float *pTransA = &mvTranslations[lKeyA*3];
+		GetRotation(lKeyA, aqRotation);
+
+		if(fT == 0.0f)
+		{
+			avTranslation.x = pTransA[0];
+			avTranslation.y = pTransA[1];
+			avTranslation.z = pTransA[2];
+		}
+		else
+		{
+			const float *pTransB = &mvTranslations[lKeyB*3];
+			float fInvT = 1.0f - fT;
+			avTranslation.x = pTransA[0]*fInvT + pTransB[0]*fT;
+			avTranslation.y = pTransA[1]*fInvT + pTransB[1]*fT;
+			avTranslation.z = pTransA[2]*fInvT + pTransB[2]*fT;
+
+			cQuaternion qRotB;
+			GetRotation(lKeyB, qRotB);
+
+			//Key frames are close enough for a normalized lerp to be used instead of a slerp.
+			aqRotation = cMath::QuaternionNlerp(fT, aqRotation, qRotB, true);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cAnimationClip::GetRotation(int alKey, cQuaternion& aqDest)
+	{
+		if(mbQuantizedRotations)
+		{
+			const short *pRot = &mvQuantizedRotations[alKey*4];
+			aqDest.v.x = (float)pRot[0] * kDequantizeScale;
+			aqDest.v.y = (float)pRot[1] * kDequantizeScale;
+			aqDest.v.z = (float)pRot[2] * kDequantizeScale;
+			aqDest.w = (float)pRot[3] * kDequantizeScale;
+			aqDest.Normalize();
+		}
+		else
+		{
+			const float *pRot = &mvRotations[alKey*4];
+			aqDest.v.x = pRot[0];
+			aqDest.v.y = pRot[1];
+			aqDest.v.z = pRot[2];
+			aqDest.w = pRot[3];
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	int* cAnimationClip::GetCursorKeys(cAnimationClipCursor *apCursor)
+	{
+		if(apCursor==NULL || mvTracks.empty()) return NULL;
+
+		if(apCursor->mpClip != this)
+		{
+			apCursor->mpClip = this;
+			apCursor->mvKeyFrames.assign(mvTracks.size(), 0);
+		}
+
+		return &apCursor->mvKeyFrames[0];
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -32,6 +32,9 @@
 #include "resources/AnimationManager.h"
 #include "scene/MeshEntity.h"
 #include "math/Math.h"
+#include "math/TriangleBVH.h"
+
+#include <algorithm>
 
 namespace hpl {
 
@@ -584,10 +587,32 @@ namespace hpl {
 		unsigned int* pIndices = pSubMeshVB->GetIndices();
 		int lPosStride = pSubMeshVB->GetElementNum(eVertexBufferElement_Position);
 		int lNrmStride = pSubMeshVB->GetElementNum(eVertexBufferElement_Normal);
+		bool bFloatNormals = pSubMeshVB->GetElementFormat(eVertexBufferElement_Normal) == eVertexBufferElementFormat_Float;
+
+		//////////////////////////////////////////////////
+		// Get the triangles near the decal box from the triangle tree of the sub mesh (shared by all entities with the mesh).
+		// Skinned entities have their own vertex buffer, so clip all triangles for those.
+		cSubMesh *pSubMesh = apSubMesh->GetSubMesh();
+		bool bUseTree = pSubMesh && pSubMesh->GetVertexBuffer()==pSubMeshVB;
+		int lTriNum = pSubMeshVB->GetIndexNum()/3;
+		if(bUseTree)
+		{
+			cVector3f vMin, vMax;
+			GetLocalDecalBox(mtxInvSubMeshWorldMatrix, vMin, vMax);
+
+			mvClipTriangles.clear();
+			pSubMesh->GetTriangleBVH()->GetTrianglesInAABB(vMin, vMax, mvClipTriangles);
+
+			//Keep the order of the index array, so the decal looks the same as when clipping all triangles
+			std::sort(mvClipTriangles.begin(), mvClipTriangles.end());
+			lTriNum = (int)mvClipTriangles.size();
+		}
 
-		// Clip every triangle in submesh
-		for(int j=0;j<pSubMeshVB->GetIndexNum();j+=3)
+		// Clip every triangle in submesh that can touch the decal
+		for(int lTri=0;lTri<lTriNum;++lTri)
 		{
+			int j = bUseTree ? mvClipTriangles[lTri] : lTri*3;
+
 			cVector3f vTriangle[3];
 			cVector3f vNormal[3];
 			
@@ -599,9 +624,19 @@ namespace hpl {
 				vTriangle[k] = cVector3f(pVertices[lPosBaseIdx],
 										pVertices[lPosBaseIdx+1],
 										pVertices[lPosBaseIdx+2]);
-				vNormal[k] = cVector3f(pNormals[lNrmBaseIdx],
-										pNormals[lNrmBaseIdx+1],
-										pNormals[lNrmBaseIdx+2]);
+				if(bFloatNormals)
+				{
+					vNormal[k] = cVector3f(pNormals[lNrmBaseIdx],
+											pNormals[lNrmBaseIdx+1],
+											pNormals[lNrmBaseIdx+2]);
+				}
+				else
+				{
+					//Compact vertex format
+					float vNrm[4];
+					pSubMeshVB->GetElementFloats(eVertexBufferElement_Normal, pIndices[j+k], vNrm);
+					vNormal[k] = cVector3f(vNrm[0], vNrm[1], vNrm[2]);
+				}
 
 			}
 
@@ -628,6 +663,34 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cDecalCreator::GetLocalDecalBox(const cMatrixf& a_mtxInvWorld, cVector3f& avMin, cVector3f& avMax)
+	{
+		cVector3f vHalfSize = mvDecalSize*0.5f;
+		cVector3f vAxes[] = { mvDecalRight*vHalfSize.x, mvDecalUp*vHalfSize.y, mvDecalForward*vHalfSize.z };
+
+		avMin = 100000.0f;
+		avMax = -100000.0f;
+		for(int i=0;i<8;++i)
+		{
+			cVector3f vCorner = mvDecalPosition;
+			for(int j=0;j<3;++j)
+				vCorner += (i & (1<<j)) ? vAxes[j] : vAxes[j]*-1.0f;
+
+			vCorner = cMath::MatrixMul(a_mtxInvWorld, vCorner);
+			for(int j=0;j<3;++j)
+			{
+				if(vCorner.v[j] < avMin.v[j]) avMin.v[j] = vCorner.v[j];
+				if(vCorner.v[j] > avMax.v[j]) avMax.v[j] = vCorner.v[j];
+			}
+		}
+
+		//Clip planes use an epsilon, so grow the box a little
+		avMin -= cVector3f(kEpsilonf);
+		avMax += cVector3f(kEpsilonf);
+	}
+
+	//-----------------------------------------------------------------------
+
 	int cDecalCreator::ClipPolygon(int alVertexCount, const cVector3f* apVertices, const cVector3f* apNormals,
 									cVector3f* apNewVertices, cVector3f* apNewNormals, const std::vector<cPlanef>& avPlanes)
 	{
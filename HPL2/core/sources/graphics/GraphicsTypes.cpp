@@ -21,6 +21,9 @@
 
 #include "graphics/Texture.h"
 #include "graphics/FrameBuffer.h"
+#include "math/Math.h"
+
+#include <cstring>
 
 
 namespace hpl {
@@ -62,11 +65,129 @@ namespace hpl {
 		case eVertexBufferElementFormat_Float:	return sizeof(float);
 		case eVertexBufferElementFormat_Int:	return sizeof(int);
 		case eVertexBufferElementFormat_Byte:	return sizeof(char);
+		case eVertexBufferElementFormat_Short:	return sizeof(short);
+		case eVertexBufferElementFormat_HalfFloat:	return sizeof(unsigned short);
 		}
 		
 		return 0;
 	}
 
+	//-----------------------------------------------------------------------
+
+	void VertexFormatToFloat(eVertexBufferElementFormat aFormat, const void *apSrc, float *apDest, size_t alNum)
+	{
+		switch(aFormat)
+		{
+		case eVertexBufferElementFormat_Float:
+			memcpy(apDest, apSrc, alNum * sizeof(float));
+			break;
+		case eVertexBufferElementFormat_Int:
+			for(size_t i=0; i<alNum; ++i) apDest[i] = (float)((const int*)apSrc)[i];
+			break;
+		case eVertexBufferElementFormat_Byte:
+			for(size_t i=0; i<alNum; ++i) apDest[i] = (float)((const unsigned char*)apSrc)[i] / 255.0f;
+			break;
+		case eVertexBufferElementFormat_Short:
+			for(size_t i=0; i<alNum; ++i) apDest[i] = cMath::Max((float)((const short*)apSrc)[i] / 32767.0f, -1.0f);
+			break;
+		case eVertexBufferElementFormat_HalfFloat:
+			for(size_t i=0; i<alNum; ++i) apDest[i] = HalfFloatToFloat(((const unsigned short*)apSrc)[i]);
+			break;
+		}
+	}
+
+	void FloatToVertexFormat(eVertexBufferElementFormat aFormat, const float *apSrc, void *apDest, size_t alNum)
+	{
+		switch(aFormat)
+		{
+		case eVertexBufferElementFormat_Float:
+			memcpy(apDest, apSrc, alNum * sizeof(float));
+			break;
+		case eVertexBufferElementFormat_Int:
+			for(size_t i=0; i<alNum; ++i) ((int*)apDest)[i] = cMath::RoundToInt(apSrc[i]);
+			break;
+		case eVertexBufferElementFormat_Byte:
+			for(size_t i=0; i<alNum; ++i) ((unsigned char*)apDest)[i] = (unsigned char)cMath::RoundToInt(cMath::Clamp(apSrc[i], 0.0f, 1.0f) * 255.0f);
+			break;
+		case eVertexBufferElementFormat_Short:
+			for(size_t i=0; i<alNum; ++i) ((short*)apDest)[i] = (short)cMath::RoundToInt(cMath::Clamp(apSrc[i], -1.0f, 1.0f) * 32767.0f);
+			break;
+		case eVertexBufferElementFormat_HalfFloat:
+			for(size_t i=0; i<alNum; ++i) ((unsigned short*)apDest)[i] = FloatToHalfFloat(apSrc[i]);
+			break;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	unsigned short FloatToHalfFloat(float afX)
+	{
+		unsigned int lBits;
+		memcpy(&lBits, &afX, sizeof(float));
+
+		unsigned int lSign = (lBits >> 16) & 0x8000;
+		int lExp = (int)((lBits >> 23) & 0xff) - 127 + 15;
+		unsigned int lMantissa = lBits & 0x7fffff;
+
+		//Inf and NaN
+		if(((lBits >> 23) & 0xff) == 0xff) return (unsigned short)(lSign | 0x7c00 | (lMantissa ? 0x200 : 0));
+		//Overflow, clamp to max value
+		if(lExp >= 31) return (unsigned short)(lSign | 0x7bff);
+		//Denormals and zero
+		if(lExp <= 0)
+		{
+			if(lExp < -10) return (unsigned short)lSign;
+			lMantissa |= 0x800000;
+			unsigned int lShift = (unsigned int)(14 - lExp);
+			unsigned int lHalf = lMantissa >> lShift;
+			//Round to nearest
+			if((lMantissa >> (lShift-1)) & 1) ++lHalf;
+			return (unsigned short)(lSign | lHalf);
+		}
+
+		unsigned int lHalf = lSign | ((unsigned int)lExp << 10) | (lMantissa >> 13);
+		//Round to nearest, a carry into the exponent is fine
+		if(lMantissa & 0x1000) ++lHalf;
+		if((lHalf & 0x7fff) >= 0x7c00) lHalf = lSign | 0x7bff;
+
+		return (unsigned short)lHalf;
+	}
+
+	float HalfFloatToFloat(unsigned short alX)
+	{
+		unsigned int lSign = ((unsigned int)alX & 0x8000) << 16;
+		unsigned int lExp = (alX >> 10) & 0x1f;
+		unsigned int lMantissa = alX & 0x3ff;
+		unsigned int lBits;
+
+		if(lExp == 0)
+		{
+			if(lMantissa == 0)
+			{
+				lBits = lSign;
+			}
+			else
+			{
+				//Denormal, normalize it
+				int lE = -1;
+				do { lMantissa <<= 1; ++lE; } while((lMantissa & 0x400) == 0);
+				lBits = lSign | ((unsigned int)(127 - 15 - lE) << 23) | ((lMantissa & 0x3ff) << 13);
+			}
+		}
+		else if(lExp == 31)
+		{
+			lBits = lSign | 0x7f800000 | (lMantissa << 13);
+		}
+		else
+		{
+			lBits = lSign | ((lExp - 15 + 127) << 23) | (lMantissa << 13);
+		}
+
+		float fX;
+		memcpy(&fX, &lBits, sizeof(float));
+		return fX;
+	}
+
 	int GetVertexElementTextureUnit(eVertexBufferElement aElement)
 	{
 		switch(aElement)
@@ -0,0 +1,775 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/MeshOptimizer.h"
+
+#include "graphics/VertexBuffer.h"
+#include "graphics/SubMesh.h"
+#include "graphics/LowLevelGraphics.h"
+#include "math/Math.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// HELPERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	static const int kMaxVertexCacheSize = 64;
+	
+	static float GetForsythVertexScore(int alCachePos, int alRemainingTris, int alCacheSize)
+	{
+		//No triangles left, vertex can never be used again.
+		if(alRemainingTris <= 0) return -1.0f;
+
+		float fScore = 0;
+		if(alCachePos >= 0)
+		{
+			//The vertices of the last triangle get a fixed score so that strips are not favored too much.
+			if(alCachePos < 3)
+			{
+				fScore = 0.75f;
+			}
+			else
+			{
+				float fScaler = 1.0f / (float)(alCacheSize - 3);
+				fScore = powf(1.0f - (float)(alCachePos - 3) * fScaler, 1.5f);
+			}
+		}
+
+		//Boost vertices with few triangles left so they get finished early.
+		fScore += 2.0f * powf((float)alRemainingTris, -0.5f);
+
+		return fScore;
+	}
+
+	//-----------------------------------------------------------------------
+
+	template<class T> static void RemapVertexArray(T *apArray, int alStride, int alVertexNum, const tUIntVec& avRemap)
+	{
+		if(apArray==NULL) return;
+
+		std::vector<T> vTemp(apArray, apArray + alVertexNum*alStride);
+		for(int i=0; i<alVertexNum; ++i)
+		{
+			memcpy(&apArray[avRemap[i]*alStride], &vTemp[i*alStride], sizeof(T)*alStride);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Sum of squared distances to a set of planes, stored as a symmetric 4x4 matrix.
+	 */
+	class cSimplifyQuadric
+	{
+	public:
+		cSimplifyQuadric() : a2(0),ab(0),ac(0),ad(0),b2(0),bc(0),bd(0),c2(0),cd(0),d2(0),w(0) {}
+
+		void AddPlane(double a, double b, double c, double d, double afWeight)
+		{
+			a2 += a*a*afWeight; ab += a*b*afWeight; ac += a*c*afWeight; ad += a*d*afWeight;
+			b2 += b*b*afWeight; bc += b*c*afWeight; bd += b*d*afWeight;
+			c2 += c*c*afWeight; cd += c*d*afWeight;
+			d2 += d*d*afWeight;
+			w += afWeight;
+		}
+
+		void Add(const cSimplifyQuadric& aQ)
+		{
+			a2 += aQ.a2; ab += aQ.ab; ac += aQ.ac; ad += aQ.ad;
+			b2 += aQ.b2; bc += aQ.bc; bd += aQ.bd;
+			c2 += aQ.c2; cd += aQ.cd;
+			d2 += aQ.d2;
+			w += aQ.w;
+		}
+
+		double Error(const float *apPos) const
+		{
+			double x = apPos[0], y = apPos[1], z = apPos[2];
+			double fErr =	a2*x*x + 2*ab*x*y + 2*ac*x*z + 2*ad*x +
+							b2*y*y + 2*bc*y*z + 2*bd*y + 
+							c2*z*z + 2*cd*z + 
+							d2;
+			return fErr < 0 ? 0 : fErr;
+		}
+
+		double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+		double w;
+	};
+
+	//-----------------------------------------------------------------------
+
+	class cSimplifyPosCompare
+	{
+	public:
+		cSimplifyPosCompare(const float *apPositions, int alStride) : mpPositions(apPositions), mlStride(alStride){}
+
+		bool operator()(unsigned int alA, unsigned int alB) const
+		{
+			const float *pA = &mpPositions[alA*mlStride];
+			const float *pB = &mpPositions[alB*mlStride];
+			if(pA[0] != pB[0]) return pA[0] < pB[0];
+			if(pA[1] != pB[1]) return pA[1] < pB[1];
+			return pA[2] < pB[2];
+		}
+
+		const float *mpPositions;
+		int mlStride;
+	};
+
+	//-----------------------------------------------------------------------
+
+	class cSimplifyCollapse
+	{
+	public:
+		bool operator<(const cSimplifyCollapse& aB) const { return mfError < aB.mfError;}
+
+		float mfError;
+		unsigned int mlFrom;
+		unsigned int mlTo;
+	};
+
+	//-----------------------------------------------------------------------
+
+	static cVector3f GetSimplifyTriNormal(const float *apA, const float *apB, const float *apC)
+	{
+		cVector3f vA(apA[0],apA[1],apA[2]);
+		return cMath::Vector3Cross(cVector3f(apB[0],apB[1],apB[2]) - vA, cVector3f(apC[0],apC[1],apC[2]) - vA);
+	}
+
+	//-----------------------------------------------------------------------
+
+	static void* GetElementArrayPtr(iVertexBuffer *apVtxBuffer, eVertexBufferElement aElement)
+	{
+		switch(apVtxBuffer->GetElementFormat(aElement))
+		{
+		case eVertexBufferElementFormat_Float:		return apVtxBuffer->GetFloatArray(aElement);
+		case eVertexBufferElementFormat_Int:		return apVtxBuffer->GetIntArray(aElement);
+		case eVertexBufferElementFormat_Byte:		return apVtxBuffer->GetByteArray(aElement);
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	return apVtxBuffer->GetShortArray(aElement);
+		default:									return NULL;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cMeshOptimizer::OptimizeVertexCache(unsigned int *apIndices, int alIndexNum, int alVertexNum, int alCacheSize)
+	{
+		int lTriNum = alIndexNum / 3;
+		if(lTriNum <= 1 || alVertexNum <= 0) return;
+
+		alCacheSize = cMath::Clamp(alCacheSize, 4, kMaxVertexCacheSize);
+
+		////////////////////////////
+		// Build vertex -> triangle lists
+		tIntVec vTriCount(alVertexNum, 0);
+		for(int i=0; i<lTriNum*3; ++i) vTriCount[apIndices[i]]++;
+
+		tIntVec vTriOffset(alVertexNum+1, 0);
+		for(int i=0; i<alVertexNum; ++i) vTriOffset[i+1] = vTriOffset[i] + vTriCount[i];
+
+		tIntVec vTriList(lTriNum*3);
+		tIntVec vFillCount(alVertexNum, 0);
+		for(int i=0; i<lTriNum*3; ++i)
+		{
+			unsigned int lVtx = apIndices[i];
+			vTriList[vTriOffset[lVtx] + vFillCount[lVtx]] = i/3;
+			vFillCount[lVtx]++;
+		}
+
+		////////////////////////////
+		// Initial scores
+		tIntVec vCachePos(alVertexNum, -1);
+		std::vector<float> vVtxScore(alVertexNum);
+		for(int i=0; i<alVertexNum; ++i) vVtxScore[i] = GetForsythVertexScore(-1, vTriCount[i], alCacheSize);
+
+		std::vector<float> vTriScore(lTriNum);
+		std::vector<bool> vTriAdded(lTriNum, false);
+		int lBestTri = 0;
+		for(int i=0; i<lTriNum; ++i)
+		{
+			vTriScore[i] = vVtxScore[apIndices[i*3]] + vVtxScore[apIndices[i*3+1]] + vVtxScore[apIndices[i*3+2]];
+			if(vTriScore[i] > vTriScore[lBestTri]) lBestTri = i;
+		}
+
+		////////////////////////////
+		// Add triangles, one at a time
+		tUIntVec vNewIndices(lTriNum*3);
+		int vCache[kMaxVertexCacheSize+3];
+		int vNewCache[kMaxVertexCacheSize+3];
+		int lCacheNum = 0;
+		int lScanPos = 0;
+
+		for(int lAdded=0; lAdded<lTriNum; ++lAdded)
+		{
+			//If no best triangle is known, take the next one not added.
+			if(lBestTri < 0)
+			{
+				while(vTriAdded[lScanPos]) ++lScanPos;
+				lBestTri = lScanPos;
+			}
+
+			vTriAdded[lBestTri] = true;
+			const unsigned int *pTri = &apIndices[lBestTri*3];
+			
+			int lNewCacheNum=0;
+			for(int i=0; i<3; ++i)
+			{
+				unsigned int lVtx = pTri[i];
+				vNewIndices[lAdded*3 + i] = lVtx;
+
+				//Remove triangle from the vertex list
+				int lStart = vTriOffset[lVtx];
+				int lEnd = lStart + vTriCount[lVtx];
+				for(int j=lStart; j<lEnd; ++j)
+				{
+					if(vTriList[j] == lBestTri)
+					{
+						vTriList[j] = vTriList[lEnd-1];
+						vTriCount[lVtx]--;
+						break;
+					}
+				}
+
+				//Put first in cache (degenerate triangles can have the same vertex twice)
+				bool bInCache = false;
+				for(int j=0; j<lNewCacheNum; ++j) if(vNewCache[j] == (int)lVtx) bInCache = true;
+				if(bInCache==false) vNewCache[lNewCacheNum++] = lVtx;
+			}
+
+			//Add the rest of the old cache behind the new vertices
+			for(int i=0; i<lCacheNum; ++i)
+			{
+				int lVtx = vCache[i];
+				if(lVtx != (int)pTri[0] && lVtx != (int)pTri[1] && lVtx != (int)pTri[2])
+					vNewCache[lNewCacheNum++] = lVtx;
+			}
+
+			//Update vertex scores, vertices pushed out of the cache get position -1
+			for(int i=0; i<lNewCacheNum; ++i)
+			{
+				int lVtx = vNewCache[i];
+				vCachePos[lVtx] = i < alCacheSize ? i : -1;
+				vVtxScore[lVtx] = GetForsythVertexScore(vCachePos[lVtx], vTriCount[lVtx], alCacheSize);
+			}
+
+			//Update scores of affected triangles and find the best one
+			lBestTri = -1;
+			float fBestScore = -1.0f;
+			for(int i=0; i<lNewCacheNum; ++i)
+			{
+				int lVtx = vNewCache[i];
+				int lStart = vTriOffset[lVtx];
+				int lEnd = lStart + vTriCount[lVtx];
+				for(int j=lStart; j<lEnd; ++j)
+				{
+					int lTri = vTriList[j];
+					const unsigned int *pTriVtx = &apIndices[lTri*3];
+					float fScore = vVtxScore[pTriVtx[0]] + vVtxScore[pTriVtx[1]] + vVtxScore[pTriVtx[2]];
+					vTriScore[lTri] = fScore;
+
+					if(fScore > fBestScore)
+					{
+						fBestScore = fScore;
+						lBestTri = lTri;
+					}
+				}
+			}
+
+			lCacheNum = cMath::Min(lNewCacheNum, alCacheSize);
+			memcpy(vCache, vNewCache, sizeof(int)*lCacheNum);
+		}
+
+		memcpy(apIndices, &vNewIndices[0], sizeof(unsigned int)*lTriNum*3);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshOptimizer::CreateVertexFetchRemap(const unsigned int *apIndices, int alIndexNum, int alVertexNum, tUIntVec& avRemap)
+	{
+		const unsigned int lUnused = 0xFFFFFFFF;
+		avRemap.assign(alVertexNum, lUnused);
+
+		unsigned int lNext =0;
+		for(int i=0; i<alIndexNum; ++i)
+		{
+			unsigned int lVtx = apIndices[i];
+			if(avRemap[lVtx] == lUnused) avRemap[lVtx] = lNext++;
+		}
+
+		//Keep unused vertices so the vertex count stays the same.
+		for(int i=0; i<alVertexNum; ++i)
+		{
+			if(avRemap[i] == lUnused) avRemap[i] = lNext++;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshOptimizer::RemapVertexBuffer(iVertexBuffer *apVtxBuffer, const tUIntVec& avRemap)
+	{
+		int lVtxNum = apVtxBuffer->GetVertexNum();
+
+		for(int i=0; i<eVertexBufferElement_LastEnum; ++i)
+		{
+			eVertexBufferElement element = (eVertexBufferElement)i;
+			int lStride = apVtxBuffer->GetElementNum(element);
+			if(lStride <= 0) continue;
+
+			switch(apVtxBuffer->GetElementFormat(element))
+			{
+			case eVertexBufferElementFormat_Float:
+				RemapVertexArray(apVtxBuffer->GetFloatArray(element), lStride, lVtxNum, avRemap);	break;
+			case eVertexBufferElementFormat_Int:
+				RemapVertexArray(apVtxBuffer->GetIntArray(element), lStride, lVtxNum, avRemap);	break;
+			case eVertexBufferElementFormat_Byte:
+				RemapVertexArray(apVtxBuffer->GetByteArray(element), lStride, lVtxNum, avRemap);	break;
+			case eVertexBufferElementFormat_Short:
+			case eVertexBufferElementFormat_HalfFloat:
+				RemapVertexArray(apVtxBuffer->GetShortArray(element), lStride, lVtxNum, avRemap);	break;
+			default:
+				break;
+			}
+		}
+
+		unsigned int *pIndices = apVtxBuffer->GetIndices();
+		for(int i=0; i<apVtxBuffer->GetIndexNum(); ++i)
+		{
+			pIndices[i] = avRemap[pIndices[i]];
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshOptimizer::OptimizeVertexBuffer(iVertexBuffer *apVtxBuffer, cSubMesh *apSubMesh)
+	{
+		int lVtxNum = apVtxBuffer->GetVertexNum();
+		int lIdxNum = apVtxBuffer->GetIndexNum();
+		if(lVtxNum <= 0 || lIdxNum < 6 || lIdxNum % 3 != 0) return;
+
+		unsigned int *pIndices = apVtxBuffer->GetIndices();
+		OptimizeVertexCache(pIndices, lIdxNum, lVtxNum);
+
+		tUIntVec vRemap;
+		CreateVertexFetchRemap(pIndices, lIdxNum, lVtxNum, vRemap);
+		RemapVertexBuffer(apVtxBuffer, vRemap);
+
+		if(apSubMesh)
+		{
+			for(int i=0; i<apSubMesh->GetVertexBonePairNum(); ++i)
+			{
+				cVertexBonePair& vtxBonePair = apSubMesh->GetVertexBonePair(i);
+				vtxBonePair.vtxIdx = vRemap[vtxBonePair.vtxIdx];
+			}
+
+			for(int i=0; i<apSubMesh->GetLodNum(); ++i)
+			{
+				tUIntVec& vLodRemap = apSubMesh->GetLod(i)->mvVertexRemap;
+				for(size_t j=0; j<vLodRemap.size(); ++j) vLodRemap[j] = vRemap[vLodRemap[j]];
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	float cMeshOptimizer::CalcACMR(const unsigned int *apIndices, int alIndexNum, int alVertexNum, int alCacheSize)
+	{
+		int lTriNum = alIndexNum / 3;
+		if(lTriNum <= 0) return 0;
+
+		//FIFO cache, a vertex is in cache if it was added less than alCacheSize misses ago.
+		tIntVec vAddedAt(alVertexNum, -alCacheSize-1);
+		int lMisses = 0;
+		for(int i=0; i<lTriNum*3; ++i)
+		{
+			unsigned int lVtx = apIndices[i];
+			if(lMisses - vAddedAt[lVtx] > alCacheSize)
+			{
+				vAddedAt[lVtx] = lMisses;
+				lMisses++;
+			}
+		}
+
+		return (float)lMisses / (float)lTriNum;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshOptimizer::SetupLoadedVertexFormat(iVertexBuffer *apVtxBuffer, bool abCompact, bool abHalfFloat)
+	{
+		if(abCompact==false)
+		{
+			apVtxBuffer->ConvertElementFormat(eVertexBufferElement_Normal, eVertexBufferElementFormat_Float);
+		}
+		if(abCompact==false || abHalfFloat==false)
+		{
+			apVtxBuffer->ConvertElementFormat(eVertexBufferElement_Texture1Tangent, eVertexBufferElementFormat_Float);
+			apVtxBuffer->ConvertElementFormat(eVertexBufferElement_Texture0, eVertexBufferElementFormat_Float);
+		}
+
+		if(abCompact) CompactVertexFormat(apVtxBuffer, abHalfFloat);
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cMeshOptimizer::CompactVertexFormat(iVertexBuffer *apVtxBuffer, bool abHalfFloat)
+	{
+		int lVtxNum = apVtxBuffer->GetVertexNum();
+		int lStartSize = 0;
+		for(int i=0; i<eVertexBufferElement_LastEnum; ++i)
+			lStartSize += apVtxBuffer->GetElementNum((eVertexBufferElement)i) * 
+							GetVertexFormatByteSize(apVtxBuffer->GetElementFormat((eVertexBufferElement)i));
+
+		///////////////////////
+		// Normals, unit length so signed normalized shorts are enough
+		if(apVtxBuffer->GetElementFormat(eVertexBufferElement_Normal) == eVertexBufferElementFormat_Float)
+		{
+			apVtxBuffer->ConvertElementFormat(eVertexBufferElement_Normal, eVertexBufferElementFormat_Short);
+		}
+
+		if(abHalfFloat)
+		{
+			///////////////////////
+			// Tangents, unit length with a +-1 handedness
+			if(apVtxBuffer->GetElementFormat(eVertexBufferElement_Texture1Tangent) == eVertexBufferElementFormat_Float)
+			{
+				apVtxBuffer->ConvertElementFormat(eVertexBufferElement_Texture1Tangent, eVertexBufferElementFormat_HalfFloat);
+			}
+
+			///////////////////////
+			// UVs, only when small enough to keep sub texel precision
+			if(apVtxBuffer->GetElementFormat(eVertexBufferElement_Texture0) == eVertexBufferElementFormat_Float)
+			{
+				float *pUV = apVtxBuffer->GetFloatArray(eVertexBufferElement_Texture0);
+				int lNum = lVtxNum * apVtxBuffer->GetElementNum(eVertexBufferElement_Texture0);
+				float fMax = 0;
+				for(int i=0; i<lNum; ++i) fMax = cMath::Max(fMax, cMath::Abs(pUV[i]));
+
+				if(fMax < 2.0f)
+					apVtxBuffer->ConvertElementFormat(eVertexBufferElement_Texture0, eVertexBufferElementFormat_HalfFloat);
+			}
+		}
+
+		int lEndSize = 0;
+		for(int i=0; i<eVertexBufferElement_LastEnum; ++i)
+			lEndSize += apVtxBuffer->GetElementNum((eVertexBufferElement)i) * 
+							GetVertexFormatByteSize(apVtxBuffer->GetElementFormat((eVertexBufferElement)i));
+
+		return (lStartSize - lEndSize) * lVtxNum;
+	}
+
+	//-----------------------------------------------------------------------
+	float cMeshOptimizer::SimplifyMesh(	const unsigned int *apIndices, int alIndexNum, const float *apPositions, int alPosStride, int alVertexNum,
+										int alTargetIndexNum, float afMaxError, tUIntVec& avDestIndices)
+	{
+		avDestIndices.assign(apIndices, apIndices + (alIndexNum/3)*3);
+		if(alVertexNum <= 0 || alIndexNum < 3) return 0;
+
+		///////////////////////////
+		// Group vertices with the same position, collapses are done between groups.
+		tUIntVec vPosGroup(alVertexNum);
+		{
+			tUIntVec vSorted(alVertexNum);
+			for(int i=0; i<alVertexNum; ++i) vSorted[i] = i;
+			cSimplifyPosCompare posCompare(apPositions, alPosStride);
+			std::sort(vSorted.begin(), vSorted.end(), posCompare);
+
+			for(int i=0; i<alVertexNum; ++i)
+			{
+				if(i>0 && posCompare(vSorted[i-1], vSorted[i])==false)	vPosGroup[vSorted[i]] = vPosGroup[vSorted[i-1]];
+				else													vPosGroup[vSorted[i]] = vSorted[i];
+			}
+		}
+
+		///////////////////////////
+		// Lock groups with more than one used vertex (seams) 
+		std::vector<char> vLocked(alVertexNum, 0);
+		{
+			tUIntVec vFirstUsed(alVertexNum, 0xFFFFFFFF);
+			for(size_t i=0; i<avDestIndices.size(); ++i)
+			{
+				unsigned int lVtx = avDestIndices[i];
+				unsigned int lGroup = vPosGroup[lVtx];
+				if(vFirstUsed[lGroup] == 0xFFFFFFFF)	vFirstUsed[lGroup] = lVtx;
+				else if(vFirstUsed[lGroup] != lVtx)		vLocked[lGroup] = 1;
+			}
+		}
+
+		///////////////////////////
+		// Lock borders and non manifold edges, edges that do not have exactly two triangles
+		{
+			std::vector<std::pair<unsigned int, unsigned int> > vEdges;
+			vEdges.reserve(avDestIndices.size());
+			for(size_t tri=0; tri<avDestIndices.size(); tri+=3)
+			{
+				for(int i=0; i<3; ++i)
+				{
+					unsigned int lA = vPosGroup[avDestIndices[tri + i]];
+					unsigned int lB = vPosGroup[avDestIndices[tri + (i+1)%3]];
+					if(lA > lB) std::swap(lA, lB);
+					vEdges.push_back(std::pair<unsigned int, unsigned int>(lA, lB));
+				}
+			}
+			std::sort(vEdges.begin(), vEdges.end());
+
+			size_t lStart =0;
+			for(size_t i=1; i<=vEdges.size(); ++i)
+			{
+				if(i < vEdges.size() && vEdges[i] == vEdges[lStart]) continue;
+				if(i - lStart != 2)
+				{
+					vLocked[vEdges[lStart].first] = 1;
+					vLocked[vEdges[lStart].second] = 1;
+				}
+				lStart = i;
+			}
+		}
+
+		///////////////////////////
+		// Quadrics for each group, planes weighted by triangle area
+		std::vector<cSimplifyQuadric> vQuadrics(alVertexNum);
+		cVector3f vMin(apPositions[0],apPositions[1],apPositions[2]), vMax = vMin;
+		for(size_t tri=0; tri<avDestIndices.size(); tri+=3)
+		{
+			const float *pA = &apPositions[avDestIndices[tri]*alPosStride];
+			const float *pB = &apPositions[avDestIndices[tri+1]*alPosStride];
+			const float *pC = &apPositions[avDestIndices[tri+2]*alPosStride];
+			cVector3f vNormal = GetSimplifyTriNormal(pA, pB, pC);
+			float fLength = vNormal.Length();
+			if(fLength <= 0) continue;
+			vNormal = vNormal / fLength;
+
+			double fD = -(vNormal.x*pA[0] + vNormal.y*pA[1] + vNormal.z*pA[2]);
+			for(int i=0; i<3; ++i)
+			{
+				unsigned int lVtx = avDestIndices[tri+i];
+				vQuadrics[vPosGroup[lVtx]].AddPlane(vNormal.x, vNormal.y, vNormal.z, fD, fLength*0.5f);
+
+				const float *pPos = &apPositions[lVtx*alPosStride];
+				vMin = cMath::Vector3Min(vMin, cVector3f(pPos[0],pPos[1],pPos[2]));
+				vMax = cMath::Vector3Max(vMax, cVector3f(pPos[0],pPos[1],pPos[2]));
+			}
+		}
+		float fMeshSize = cMath::Vector3Dist(vMin, vMax);
+		if(fMeshSize <= 0) return 0;
+		double fMaxErrorSqr = (double)afMaxError*fMeshSize * afMaxError*fMeshSize;
+		double fUsedErrorSqr = 0;
+
+		///////////////////////////
+		// Collapse in passes, each pass only touches every area once so the checks stay valid.
+		tUIntVec vCollapseTo(alVertexNum);
+		std::vector<char> vTouched(alVertexNum);
+		tIntVec vTriStart(alVertexNum+1);
+		tUIntVec vTriList;
+		std::vector<cSimplifyCollapse> vCollapses;
+
+		while((int)avDestIndices.size() > alTargetIndexNum)
+		{
+			int lTriNum = (int)avDestIndices.size()/3;
+
+			//Triangles for each vertex
+			std::fill(vTriStart.begin(), vTriStart.end(), 0);
+			for(size_t i=0; i<avDestIndices.size(); ++i) vTriStart[avDestIndices[i]+1]++;
+			for(int i=0; i<alVertexNum; ++i) vTriStart[i+1] += vTriStart[i];
+			vTriList.resize(avDestIndices.size());
+			{
+				tIntVec vFill(vTriStart.begin(), vTriStart.end()-1);
+				for(size_t i=0; i<avDestIndices.size(); ++i) vTriList[vFill[avDestIndices[i]]++] = (unsigned int)(i/3);
+			}
+
+			//Possible collapses, the vertex moved onto the other edge vertex
+			vCollapses.clear();
+			for(size_t tri=0; tri<avDestIndices.size(); tri+=3)
+			{
+				for(int i=0; i<3; ++i)
+				{
+					unsigned int lFrom = avDestIndices[tri + i];
+					unsigned int lTo = avDestIndices[tri + (i+1)%3];
+					unsigned int lFromGroup = vPosGroup[lFrom];
+					unsigned int lToGroup = vPosGroup[lTo];
+					if(lFromGroup == lToGroup) continue;
+
+					for(int j=0; j<2; ++j)
+					{
+						if(vLocked[lFromGroup]==0)
+						{
+							cSimplifyQuadric quadric = vQuadrics[lFromGroup];
+							quadric.Add(vQuadrics[lToGroup]);
+
+							cSimplifyCollapse collapse;
+							collapse.mfError = (float)(quadric.w > 0 ? quadric.Error(&apPositions[lTo*alPosStride]) / quadric.w : 0);
+							collapse.mlFrom = lFrom;
+							collapse.mlTo = lTo;
+							vCollapses.push_back(collapse);
+						}
+						std::swap(lFrom, lTo);
+						std::swap(lFromGroup, lToGroup);
+					}
+				}
+			}
+			std::sort(vCollapses.begin(), vCollapses.end());
+
+			//Do as many collapses as possible
+			for(int i=0; i<alVertexNum; ++i) vCollapseTo[i] = i;
+			std::fill(vTouched.begin(), vTouched.end(), 0);
+			int lTrisLeftToRemove = lTriNum - alTargetIndexNum/3;
+			int lCollapseNum = 0;
+
+			for(size_t i=0; i<vCollapses.size() && lTrisLeftToRemove > 0; ++i)
+			{
+				const cSimplifyCollapse &collapse = vCollapses[i];
+				if(collapse.mfError > fMaxErrorSqr) break;
+
+				unsigned int lFrom = collapse.mlFrom;
+				unsigned int lToGroup = vPosGroup[collapse.mlTo];
+				if(vTouched[vPosGroup[lFrom]] || vTouched[lToGroup]) continue;
+
+				//Check that no remaining triangle flips
+				const float *pToPos = &apPositions[collapse.mlTo*alPosStride];
+				bool bOk = true;
+				int lRemovedTris =0;
+				for(int j=vTriStart[lFrom]; j<vTriStart[lFrom+1] && bOk; ++j)
+				{
+					const unsigned int *pTri = &avDestIndices[vTriList[j]*3];
+					if(vPosGroup[pTri[0]]==lToGroup || vPosGroup[pTri[1]]==lToGroup || vPosGroup[pTri[2]]==lToGroup)
+					{
+						lRemovedTris++;
+						continue;
+					}
+
+					const float *pPos[3];
+					for(int k=0; k<3; ++k) pPos[k] = &apPositions[pTri[k]*alPosStride];
+					cVector3f vBefore = GetSimplifyTriNormal(pPos[0], pPos[1], pPos[2]);
+					for(int k=0; k<3; ++k) if(pTri[k]==lFrom) pPos[k] = pToPos;
+					cVector3f vAfter = GetSimplifyTriNormal(pPos[0], pPos[1], pPos[2]);
+
+					float fLengths = vBefore.Length() * vAfter.Length();
+					if(fLengths <= 0 || cMath::Vector3Dot(vBefore, vAfter) < 0.25f * fLengths) bOk = false;
+				}
+				if(bOk==false) continue;
+
+				//Collapse and touch all vertices around so the next collapses do not use old data
+				vCollapseTo[lFrom] = collapse.mlTo;
+				vQuadrics[lToGroup].Add(vQuadrics[vPosGroup[lFrom]]);
+				for(int j=vTriStart[lFrom]; j<vTriStart[lFrom+1]; ++j)
+				{
+					const unsigned int *pTri = &avDestIndices[vTriList[j]*3];
+					for(int k=0; k<3; ++k) vTouched[vPosGroup[pTri[k]]] = 1;
+				}
+
+				fUsedErrorSqr = cMath::Max((float)fUsedErrorSqr, collapse.mfError);
+				lTrisLeftToRemove -= lRemovedTris;
+				lCollapseNum++;
+			}
+			if(lCollapseNum==0) break;
+
+			//Remap indices and remove the triangles that are now degenerate
+			size_t lDest =0;
+			for(size_t tri=0; tri<avDestIndices.size(); tri+=3)
+			{
+				unsigned int lA = vCollapseTo[avDestIndices[tri]];
+				unsigned int lB = vCollapseTo[avDestIndices[tri+1]];
+				unsigned int lC = vCollapseTo[avDestIndices[tri+2]];
+				if(vPosGroup[lA]==vPosGroup[lB] || vPosGroup[lB]==vPosGroup[lC] || vPosGroup[lA]==vPosGroup[lC]) continue;
+
+				avDestIndices[lDest++] = lA;
+				avDestIndices[lDest++] = lB;
+				avDestIndices[lDest++] = lC;
+			}
+			avDestIndices.resize(lDest);
+		}
+
+		return (float)sqrt(fUsedErrorSqr) / fMeshSize;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshOptimizer::CreateLodIndices(const unsigned int *apIndices, int alIndexNum, int alVertexNum, tUIntVec& avVertexRemap, tUIntVec& avLodIndices)
+	{
+		avLodIndices.assign(apIndices, apIndices + alIndexNum);
+		avVertexRemap.clear();
+		if(alIndexNum <= 0) return;
+
+		OptimizeVertexCache(&avLodIndices[0], alIndexNum, alVertexNum);
+
+		//Vertices in the order they are first used
+		tUIntVec vNewIndex(alVertexNum, 0xFFFFFFFF);
+		for(int i=0; i<alIndexNum; ++i)
+		{
+			unsigned int &lNew = vNewIndex[avLodIndices[i]];
+			if(lNew == 0xFFFFFFFF)
+			{
+				lNew = (unsigned int)avVertexRemap.size();
+				avVertexRemap.push_back(avLodIndices[i]);
+			}
+			avLodIndices[i] = lNew;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	iVertexBuffer* cMeshOptimizer::CreateLodVertexBuffer(	iLowLevelGraphics *apLowLevelGraphics, iVertexBuffer *apSrcBuffer, 
+															const tUIntVec& avVertexRemap, const unsigned int *apLodIndices, int alIndexNum)
+	{
+		iVertexBuffer* pVtxBuff = apLowLevelGraphics->CreateVertexBuffer(	eVertexBufferType_Hardware, eVertexBufferDrawType_Tri,
+																			eVertexBufferUsageType_Static, 0, 0);
+		int lVtxNum = (int)avVertexRemap.size();
+
+		for(int i=0; i<eVertexBufferElement_LastEnum; ++i)
+		{
+			eVertexBufferElement element = (eVertexBufferElement)i;
+			int lElementNum = apSrcBuffer->GetElementNum(element);
+			if(lElementNum <= 0) continue;
+
+			eVertexBufferElementFormat format = apSrcBuffer->GetElementFormat(element);
+			pVtxBuff->CreateElementArray(element, format, lElementNum, apSrcBuffer->GetElementProgramVarIndex(element));
+			pVtxBuff->ResizeArray(element, lVtxNum * lElementNum);
+
+			const char *pSrc = (const char*)GetElementArrayPtr(apSrcBuffer, element);
+			char *pDest = (char*)GetElementArrayPtr(pVtxBuff, element);
+			if(pSrc==NULL || pDest==NULL) continue;
+
+			size_t lVtxSize = lElementNum * GetVertexFormatByteSize(format);
+			for(int vtx=0; vtx<lVtxNum; ++vtx)
+			{
+				memcpy(&pDest[vtx*lVtxSize], &pSrc[avVertexRemap[vtx]*lVtxSize], lVtxSize);
+			}
+		}
+
+		pVtxBuff->ResizeIndices(alIndexNum);
+		if(alIndexNum > 0) memcpy(pVtxBuff->GetIndices(), apLodIndices, alIndexNum*sizeof(unsigned int));
+
+		return pVtxBuff;
+	}
+
+	//-----------------------------------------------------------------------
+}
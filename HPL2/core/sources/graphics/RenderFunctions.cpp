@@ -26,6 +26,7 @@
 #include "graphics/LowLevelGraphics.h"
 #include "graphics/Texture.h"
 #include "graphics/Graphics.h"
+#include "graphics/Renderer.h"
 
 #include "system/LowLevelSystem.h"
 
@@ -541,6 +542,8 @@ namespace hpl {
 
 	void iRenderFunctions::SetTexture(int alUnit, iTexture *apTexture)
 	{
+		if(apTexture) apTexture->SetRenderFrameCount(iRenderer::GetRenderFrameCount());
+
 		if(mvCurrentTexture[alUnit] == apTexture) return;
 
 		if(mbLog) {
@@ -558,6 +561,8 @@ namespace hpl {
 
 	void iRenderFunctions::SetTextureRange(iTexture *apTexture, int alFirstUnit, int alLastUnit)
 	{
+		if(apTexture) apTexture->SetRenderFrameCount(iRenderer::GetRenderFrameCount());
+
 		for(int i=alFirstUnit; i<= alLastUnit; ++i)
 		{
 			if(mvCurrentTexture[i] != apTexture)
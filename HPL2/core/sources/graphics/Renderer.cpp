@@ -25,6 +25,8 @@
 #include "system/LowLevelSystem.h"
 #include "system/PreprocessParser.h"
 #include "system/String.h"
+#include "system/Platform.h"
+#include "system/Timer.h"
 
 #include "graphics/Graphics.h"
 #include "graphics/Texture.h"
@@ -51,6 +53,7 @@
 #include "scene/Camera.h"
 #include "scene/World.h"
 #include "scene/RenderableContainer.h"
+#include "scene/RenderableFlatTree.h"
 #include "scene/LightSpot.h"
 #include "scene/LightPoint.h"
 #include "scene/LightBox.h"
@@ -58,6 +61,7 @@
 #include "scene/FogArea.h"
 
 #include <algorithm>
+#include <iterator>
 
 namespace hpl {
 
@@ -73,6 +77,8 @@ namespace hpl {
 	bool iRenderer::mbParallaxEnabled=true;
 	int iRenderer::mlReflectionSizeDiv = 2;
 	bool iRenderer::mbRefractionEnabled=true;
+	bool iRenderer::mbUseFlatContainerTrees=true;
+	double iRenderer::mfContainerCullTime=0;
 	int iRenderer::mlDrawCalls=1;
 
 	//-----------------------------------------------------------------------
@@ -427,6 +433,9 @@ namespace hpl {
 
 		mlActiveOcclusionQueryNum =0;
 
+		mpCullCompareObjects = NULL;
+		mpContainerCullTimer = cPlatform::CreateTimer();
+
 		//////////////
 		// Create programs
 		cParserVarContainer vars;
@@ -457,6 +466,8 @@ namespace hpl {
 		hplDelete(mpProgramManager);
 		
 		hplDelete(mpDepthOnlyProgram);
+
+		hplDelete(mpContainerCullTimer);
 	}
 
 	//-----------------------------------------------------------------------
@@ -924,7 +935,7 @@ namespace hpl {
 			    if(	frustumCollision == eCollision_Inside ||
 					pObject->CollidesWithFrustum(mpCurrentFrustum))
 				{
-					mpCurrentRenderList->AddObject(pObject);
+					AddVisibleObjectToList(pObject);
 				}
 			}
 		}
@@ -936,7 +947,141 @@ namespace hpl {
 	{
 		apContainer->UpdateBeforeRendering();
 
+		mpContainerCullTimer->Start();
+
+		cRenderableFlatTree *pFlatTree = mbUseFlatContainerTrees ? apContainer->GetFlatTree() : NULL;
+		if(pFlatTree)
+			CheckFlatTreeAndAddToList(pFlatTree, alNeededFlags);
+		else
+			CheckNodesAndAddToListIterative(apContainer->GetRoot(), alNeededFlags);
+
+		mpContainerCullTimer->Stop();
+		mfContainerCullTime += mpContainerCullTimer->GetTimeInMilliSec();
+
+	#ifdef _DEBUG
+		if(pFlatTree) CompareFlatTreeWithNodes(apContainer, alNeededFlags);
+	#endif
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iRenderer::CheckFlatTreeAndAddToList(cRenderableFlatTree *apTree, tRenderableFlag alNeededFlags)
+	{
+		///////////////////////////////////////
+		//Frustum planes first and then user clip planes, these can only cull nodes.
+		int lFrustumPlanes = mpCurrentFrustum->GetInfFarPlane() ? 5 : 6;
+		
+		mvFlatTreeCullPlanes.resize(0);
+		for(int i=0; i<lFrustumPlanes; ++i)
+		{
+			mvFlatTreeCullPlanes.push_back(mpCurrentFrustum->GetPlane((eFrustumPlane)i));
+		}
+		if(mbOcclusionPlanesActive)
+		{
+			for(size_t i=0; i<mvCurrentOcclusionPlanes.size() && mvFlatTreeCullPlanes.size() < 32; ++i)
+			{
+				mvFlatTreeCullPlanes.push_back(mvCurrentOcclusionPlanes[i]);
+			}
+		}
+
+		mlFlatTreeFrustumPlaneMask = (1 << lFrustumPlanes) - 1;
+		int lPlaneMask = mvFlatTreeCullPlanes.size() >= 32 ? -1 : (1 << (int)mvFlatTreeCullPlanes.size()) - 1;
+
+		///////////////////////////////////////
+		//Root is always iterated
+		AddFlatTreeObjectsToList(apTree, apTree->GetRootObjectFirst(), apTree->GetRootObjectNum(), false, alNeededFlags);
+
+		if(apTree->GetRootChildNode() >= 0)
+			CheckFlatTreeNodesAndAddToList(apTree, apTree->GetRootChildNode(), lPlaneMask, alNeededFlags);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iRenderer::CheckFlatTreeNodesAndAddToList(cRenderableFlatTree *apTree, int alNode, int alPlaneMask, tRenderableFlag alNeededFlags)
+	{
+		const cRenderableFlatTreeNode& node = apTree->GetNode(alNode);
+
+		///////////////////////////////////////
+		//Only test planes that the parent intersects, if none the children are inside too.
+		int vChildPlaneMasks[4] = {0,0,0,0};
+		int lVisible;
+		if(alPlaneMask != 0)
+			lVisible = cRenderableFlatTree::CullNode(node, &mvFlatTreeCullPlanes[0], (int)mvFlatTreeCullPlanes.size(), alPlaneMask, vChildPlaneMasks);
+		else
+			lVisible = (1 << node.mlNum) - 1;
+		
+		for(int i=0; i<4; ++i)
+		{
+			if((lVisible & (1<<i))==0) continue;
+
+			if(node.mvChildNode[i] >= 0)
+				CheckFlatTreeNodesAndAddToList(apTree, node.mvChildNode[i], vChildPlaneMasks[i], alNeededFlags);
+
+			if(node.mvObjectNum[i] > 0)
+			{
+				bool bInside = (vChildPlaneMasks[i] & mlFlatTreeFrustumPlaneMask) == 0;
+				AddFlatTreeObjectsToList(apTree, node.mvObjectFirst[i], node.mvObjectNum[i], bInside, alNeededFlags);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iRenderer::AddFlatTreeObjectsToList(cRenderableFlatTree *apTree, int alFirst, int alNum, bool abInside, tRenderableFlag alNeededFlags)
+	{
+		for(int i=alFirst; i<alFirst+alNum; ++i)
+		{
+			iRenderable *pObject = apTree->GetObject(i);
+			if(CheckObjectIsVisible(pObject, alNeededFlags)==false) continue;
+
+			if(abInside || pObject->CollidesWithFrustum(mpCurrentFrustum))
+			{
+				AddVisibleObjectToList(pObject);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iRenderer::AddVisibleObjectToList(iRenderable *apObject)
+	{
+		if(mpCullCompareObjects)
+			mpCullCompareObjects->push_back(apObject);
+		else
+			mpCurrentRenderList->AddObject(apObject);
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	* Culls the container with both the flat tree and the nodes and warns if they do not find the same objects.
+	*/
+	void iRenderer::CompareFlatTreeWithNodes(iRenderableContainer *apContainer, tRenderableFlag alNeededFlags)
+	{
+		tRenderableVec vFlatTreeObjects;
+		tRenderableVec vNodeObjects;
+
+		mpCullCompareObjects = &vFlatTreeObjects;
+		CheckFlatTreeAndAddToList(apContainer->GetFlatTree(), alNeededFlags);
+		mpCullCompareObjects = &vNodeObjects;
 		CheckNodesAndAddToListIterative(apContainer->GetRoot(), alNeededFlags);
+		mpCullCompareObjects = NULL;
+
+		std::sort(vFlatTreeObjects.begin(), vFlatTreeObjects.end());
+		std::sort(vNodeObjects.begin(), vNodeObjects.end());
+		if(vFlatTreeObjects == vNodeObjects) return;
+
+		tRenderableVec vOnlyInFlatTree;
+		tRenderableVec vOnlyInNodes;
+		std::set_difference(vFlatTreeObjects.begin(), vFlatTreeObjects.end(), vNodeObjects.begin(), vNodeObjects.end(),
+							std::back_inserter(vOnlyInFlatTree));
+		std::set_difference(vNodeObjects.begin(), vNodeObjects.end(), vFlatTreeObjects.begin(), vFlatTreeObjects.end(),
+							std::back_inserter(vOnlyInNodes));
+
+		Warning("Flat tree culling differs from nodes! %d objects only in flat tree, %d only in nodes (frame %d)\n",
+				(int)vOnlyInFlatTree.size(), (int)vOnlyInNodes.size(), mlRenderFrameCount);
+		for(size_t i=0; i<vOnlyInFlatTree.size(); ++i) Log(" Only in flat tree: '%s'\n", vOnlyInFlatTree[i]->GetName().c_str());
+		for(size_t i=0; i<vOnlyInNodes.size(); ++i) Log(" Only in nodes: '%s'\n", vOnlyInNodes[i]->GetName().c_str());
 	}
 
 	//-----------------------------------------------------------------------
@@ -2159,6 +2304,7 @@ namespace hpl {
 		{
 			//Set texture, if special textures are used, check for those too!
 			iTexture *pTexture = apMaterial->GetTextureInUnit(aRenderMode,i);
+			if(pTexture) pTexture->SetRenderFrameCount(mlRenderFrameCount);
 			
 			if(mvCurrentTexture[i] != pTexture)
 			{
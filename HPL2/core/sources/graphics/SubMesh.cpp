@@ -28,12 +28,14 @@
 #include "graphics/Skeleton.h"
 #include "graphics/Bone.h"
 #include "math/Math.h"
+#include "math/TriangleBVH.h"
 
 #include "physics/PhysicsWorld.h"
 
 #include "system/MemoryManager.h"
 
 #include <cstring>
+#include <algorithm>
 
 namespace hpl {
 
@@ -51,13 +53,16 @@ namespace hpl {
 
 		mpMaterial = NULL;
 		mpVtxBuffer = NULL;
+		mpTriangleBVH = NULL;
 
 		mbDoubleSided = false;
 
 		mbCollideShape = false;
 
 		mpVertexWeights = NULL;
+		mpPackedVertexWeights = NULL;
 		mpVertexBones = NULL;
+		mbCompactBoneWeights = false;
 
 		m_mtxLocalTransform = cMatrixf::Identity;
 
@@ -72,10 +77,13 @@ namespace hpl {
 	{
 		if(mpMaterial)mpMaterialManager->Destroy(mpMaterial);
 		if(mpVtxBuffer) hplDelete(mpVtxBuffer);
+		if(mpTriangleBVH) hplDelete(mpTriangleBVH);
 		if(mpVertexBones) hplDeleteArray(mpVertexBones);
 		if(mpVertexWeights) hplDeleteArray(mpVertexWeights);
+		if(mpPackedVertexWeights) hplDeleteArray(mpPackedVertexWeights);
 
 		STLDeleteAll(mvColliders);
+		DestroyLods();
 	}
 
 	//-----------------------------------------------------------------------
@@ -99,6 +107,12 @@ namespace hpl {
 		if(mpVtxBuffer == apVtxBuffer) return;
 
 		mpVtxBuffer = apVtxBuffer;
+
+		if(mpTriangleBVH)
+		{
+			hplDelete(mpTriangleBVH);
+			mpTriangleBVH = NULL;
+		}
 	}
 
 	//-----------------------------------------------------------------------
@@ -115,6 +129,21 @@ namespace hpl {
 		return mpVtxBuffer;
 	}
 
+	//-----------------------------------------------------------------------
+
+	cTriangleBVH* cSubMesh::GetTriangleBVH()
+	{
+		if(mpTriangleBVH==NULL && mpVtxBuffer)
+		{
+			mpTriangleBVH = hplNew(cTriangleBVH, ());
+			mpTriangleBVH->Build(	mpVtxBuffer->GetIndices(), mpVtxBuffer->GetIndexNum(),
+									mpVtxBuffer->GetFloatArray(eVertexBufferElement_Position),
+									mpVtxBuffer->GetElementNum(eVertexBufferElement_Position));
+		}
+
+		return mpTriangleBVH;
+	}
+
 	//-----------------------------------------------------------------------
 	
 	void cSubMesh::ResizeVertexBonePairs(int alSize)
@@ -143,6 +172,31 @@ namespace hpl {
 
 
 	
+	//-----------------------------------------------------------------------
+
+	cSubMeshLod* cSubMesh::AddLod(float afMaxScreenSize, iVertexBuffer *apVtxBuffer, const tUIntVec& avVertexRemap)
+	{
+		cSubMeshLod *pLod = hplNew( cSubMeshLod, () );
+		pLod->mfMaxScreenSize = afMaxScreenSize;
+		pLod->mpVtxBuffer = apVtxBuffer;
+		pLod->mvVertexRemap = avVertexRemap;
+
+		mvLods.push_back(pLod);
+
+		return pLod;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSubMesh::DestroyLods()
+	{
+		for(size_t i=0; i<mvLods.size(); ++i)
+		{
+			if(mvLods[i]->mpVtxBuffer) hplDelete(mvLods[i]->mpVtxBuffer);
+		}
+		STLDeleteAll(mvLods);
+	}
+
 	//-----------------------------------------------------------------------
 
 	cMeshCollider* cSubMesh::CreateCollider(eCollideShapeType aType)
@@ -361,6 +415,58 @@ namespace hpl {
 		{
 			Warning("Some vertices in sub mesh '%s' in mesh '%s' are not connected to a bone!\n",GetName().c_str(), mpParent->GetName().c_str());
 		}
+
+		if(mbCompactBoneWeights) PackBoneWeights();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSubMesh::PackBoneWeights()
+	{
+		int lVtxNum = mpVtxBuffer->GetVertexNum();
+		mpPackedVertexWeights = hplNewArray( unsigned char, 4 * lVtxNum);
+
+		for(int vtx =0; vtx < lVtxNum; ++vtx)
+		{
+			float *pWeight = &mpVertexWeights[vtx*4];
+			unsigned char *pBoneIdx = &mpVertexBones[vtx*4];
+			unsigned char *pPacked = &mpPackedVertexWeights[vtx*4];
+
+			//////////////////////////
+			// Sort largest first, so a weight rounded to 0 cannot end the list before a larger one
+			for(int i=1; i<4; ++i)
+			{
+				for(int j=i; j>0 && pWeight[j] > pWeight[j-1]; --j)
+				{
+					std::swap(pWeight[j], pWeight[j-1]);
+					std::swap(pBoneIdx[j], pBoneIdx[j-1]);
+				}
+			}
+
+			//////////////////////////
+			// Round down and give the rest to the largest remainders, so connected vertices still add up to 255.
+			float fRemainder[4];
+			int lTotal = 0;
+			for(int i=0; i<4; ++i)
+			{
+				float fX = pWeight[i] * 255.0f;
+				pPacked[i] = (unsigned char)cMath::Min((int)fX, 255);
+				fRemainder[i] = pWeight[i] > 0 ? fX - (float)pPacked[i] : -1.0f;
+				lTotal += pPacked[i];
+			}
+			if(pWeight[0]==0) continue;
+
+			for(; lTotal < 255; ++lTotal)
+			{
+				int lMax = 0;
+				for(int i=1; i<4; ++i) if(fRemainder[i] > fRemainder[lMax]) lMax = i;
+				pPacked[lMax]++;
+				fRemainder[lMax] = -1;
+			}
+		}
+
+		hplDeleteArray(mpVertexWeights);
+		mpVertexWeights = NULL;
 	}
 
 	//-----------------------------------------------------------------------
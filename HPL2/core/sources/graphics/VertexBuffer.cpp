@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/VertexBuffer.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void iVertexBuffer::GetElementFloats(eVertexBufferElement aElement, int alVertex, float *apDest)
+	{
+		int lElementNum = GetElementNum(aElement);
+		if(lElementNum <= 0) return;
+
+		eVertexBufferElementFormat format = GetElementFormat(aElement);
+		const void *pSrc = NULL;
+		switch(format)
+		{
+		case eVertexBufferElementFormat_Float:		pSrc = GetFloatArray(aElement) + alVertex*lElementNum; break;
+		case eVertexBufferElementFormat_Int:		pSrc = GetIntArray(aElement) + alVertex*lElementNum; break;
+		case eVertexBufferElementFormat_Byte:		pSrc = GetByteArray(aElement) + alVertex*lElementNum; break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	pSrc = GetShortArray(aElement) + alVertex*lElementNum; break;
+		default:									return;
+		}
+
+		VertexFormatToFloat(format, pSrc, apDest, lElementNum);
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ *
+ * This file is part of Amnesia: A Machine For Pigs.
+ *
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "impl/GraphicsObjectsNull.h"
+
+#include "system/LowLevelSystem.h"
+#include "math/Math.h"
+
+#include "graphics/Bitmap.h"
+#include "graphics/Renderer.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// TEXTURE
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cTextureNull::cTextureNull(const tString &asName, eTextureType aType, eTextureUsage aUsage, iLowLevelGraphics* apLowLevelGraphics)
+				: iTexture(asName,_W(""),aType, aUsage, apLowLevelGraphics)
+	{
+		mlFrameNum = 0;
+		mfTimeCount = 0;
+	}
+
+	cTextureNull::~cTextureNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureNull::CreateFromBitmap(cBitmap* pBmp)
+	{
+		mlMemorySize = 0;
+		mlFrameNum = 1;
+		AddBitmap(pBmp);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureNull::CreateAnimFromBitmapVec(std::vector<cBitmap*> *avBitmaps)
+	{
+		mlMemorySize = 0;
+		mlFrameNum = (int)avBitmaps->size();
+		for(size_t i=0; i< avBitmaps->size(); ++i)
+		{
+			AddBitmap((*avBitmaps)[i]);
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureNull::CreateCubeFromBitmapVec(std::vector<cBitmap*> *avBitmaps)
+	{
+		if(mUsage == eTextureUsage_RenderTarget || mType != eTextureType_CubeMap)
+		{
+			return false;
+		}
+
+		if(avBitmaps->size()<6){
+			Error("Only %d bitmaps supplied for creation of cube map, 6 needed.",avBitmaps->size());
+			return false;
+		}
+
+		mlMemorySize = 0;
+		mlFrameNum = 1;
+		for(size_t i=0; i< 6; ++i)
+		{
+			AddBitmap((*avBitmaps)[i]);
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureNull::CreateFromRawData(const cVector3l &avSize,ePixelFormat aPixelFormat, unsigned char *apData)
+	{
+		mvSize = avSize;
+		mPixelFormat = aPixelFormat;
+
+		if(mvSize.x<1)mvSize.x=1;
+		if(mvSize.y<1)mvSize.y=1;
+		if(mvSize.z<1)mvSize.z=1;
+
+		mlFrameNum = 1;
+		mlMemorySize = mvSize.x * mvSize.y * mvSize.z * 4;
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTextureNull::Update(float afTimeStep)
+	{
+		if(mlFrameNum <= 1) return;
+
+		mfTimeCount += afTimeStep * (1.0f/mfFrameTime);
+		mfTimeCount = cMath::Modulus(mfTimeCount, (float)mlFrameNum);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTextureNull::NextFrame()
+	{
+		if(mlFrameNum <= 1) return;
+
+		mfTimeCount = cMath::Modulus(mfTimeCount + 1.0f, (float)mlFrameNum);
+	}
+
+	void cTextureNull::PrevFrame()
+	{
+		if(mlFrameNum <= 1) return;
+
+		mfTimeCount = cMath::Modulus(mfTimeCount - 1.0f + (float)mlFrameNum, (float)mlFrameNum);
+	}
+
+	float cTextureNull::GetT()
+	{
+		return cMath::Modulus(mfTimeCount,1.0f);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTextureNull::AddBitmap(cBitmap* apBmp)
+	{
+		mvSize = apBmp->GetSize();
+		mPixelFormat = apBmp->GetPixelFormat();
+		mbIsCompressed = apBmp->IsCompressed();
+
+		for(int lImage=0; lImage < apBmp->GetNumOfImages(); ++lImage)
+		for(int lMip=0; lMip < apBmp->GetNumOfMipMaps(); ++lMip)
+		{
+			mlMemorySize += apBmp->GetData(lImage, lMip)->mlSize;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// VERTEX BUFFER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cVertexBufferNull::cVertexBufferNull(	iLowLevelGraphics* apLowLevelGraphics, eVertexBufferType aType,
+											eVertexBufferDrawType aDrawType,eVertexBufferUsageType aUsageType,
+											int alReserveVtxSize,int alReserveIdxSize) :
+	iVertexBufferOpenGL(apLowLevelGraphics, aType, aDrawType,aUsageType, alReserveVtxSize, alReserveIdxSize)
+	{
+	}
+
+	cVertexBufferNull::~cVertexBufferNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cVertexBufferNull::Draw(eVertexBufferDrawType aDrawType)
+	{
+		iRenderer::IncDrawCalls();
+	}
+
+	void cVertexBufferNull::DrawIndices(unsigned int *apIndices, int alCount, eVertexBufferDrawType aDrawType)
+	{
+		iRenderer::IncDrawCalls();
+	}
+
+	//-----------------------------------------------------------------------
+
+	iVertexBufferOpenGL* cVertexBufferNull::CreateDataCopy(tVertexElementFlag aFlags, eVertexBufferDrawType aDrawType,
+														eVertexBufferUsageType aUsageType,
+														int alReserveVtxSize,int alReserveIdxSize)
+	{
+		return hplNew(cVertexBufferNull, (mpLowLevelGraphics,mType,aDrawType,aUsageType,alReserveVtxSize,alReserveIdxSize));
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// GPU SHADER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cGpuShaderNull::cGpuShaderNull(const tString& asName, eGpuShaderType aType)
+				: iGpuShader(asName, _W(""), aType, eGpuProgramFormat_GLSL)
+	{
+	}
+
+	cGpuShaderNull::~cGpuShaderNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cGpuShaderNull::CreateFromFile(const tWString& asFile, const tString& asEntry, bool abPrintInfoIfFail)
+	{
+		SetFullPath(asFile);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// GPU PROGRAM
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cGpuProgramNull::cGpuProgramNull(const tString& asName) : iGpuProgram(asName,eGpuProgramFormat_GLSL)
+	{
+	}
+
+	cGpuProgramNull::~cGpuProgramNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cGpuProgramNull::GetVariableId(const tString& asName)
+	{
+		std::map<tString, int>::iterator it = m_mapVariableIds.find(asName);
+		if(it != m_mapVariableIds.end()) return it->second;
+
+		int lId = (int)m_mapVariableIds.size();
+		m_mapVariableIds.insert(std::map<tString, int>::value_type(asName, lId));
+
+		return lId;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// FRAME BUFFER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cFrameBufferNull::cFrameBufferNull(const tString& asName, iLowLevelGraphics* apLowLevelGraphics) : iFrameBuffer(asName, apLowLevelGraphics)
+	{
+	}
+
+	cFrameBufferNull::~cFrameBufferNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cFrameBufferNull::SetTexture2D(int alColorIdx, iTexture *apTexture, int alMipmapLevel)
+	{
+		mpColorBuffer[alColorIdx] = apTexture;
+		if(apTexture) SetFirstSize(apTexture->GetSizeInt2D());
+	}
+
+	void cFrameBufferNull::SetTexture3D(int alColorIdx, iTexture *apTexture, int alZ, int alMipmapLevel)
+	{
+		SetTexture2D(alColorIdx, apTexture, alMipmapLevel);
+	}
+
+	void cFrameBufferNull::SetTextureCubeMap(int alColorIdx, iTexture *apTexture, int alFace, int alMipmapLevel)
+	{
+		SetTexture2D(alColorIdx, apTexture, alMipmapLevel);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cFrameBufferNull::SetDepthTexture2D(iTexture *apTexture, int alMipmapLevel)
+	{
+		mpDepthBuffer = apTexture;
+		if(apTexture) SetFirstSize(apTexture->GetSizeInt2D());
+	}
+
+	void cFrameBufferNull::SetDepthTextureCubeMap(iTexture *apTexture, int alFace, int alMipmapLevel)
+	{
+		SetDepthTexture2D(apTexture, alMipmapLevel);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cFrameBufferNull::SetDepthStencilBuffer(iDepthStencilBuffer* apBuffer)
+	{
+		if(apBuffer == NULL) return;
+
+		if(apBuffer->GetDepthBits() > 0)	mpDepthBuffer = apBuffer;
+		if(apBuffer->GetStencilBits() > 0)	mpStencilBuffer = apBuffer;
+
+		SetFirstSize(apBuffer->GetSize());
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cFrameBufferNull::SetFirstSize(const cVector2l &avSize)
+	{
+		if(mvSize.x > -1) return;
+
+		mvSize = avSize;
+	}
+
+	//-----------------------------------------------------------------------
+
+}
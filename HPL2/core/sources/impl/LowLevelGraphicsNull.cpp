@@ -0,0 +1,211 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ *
+ * This file is part of Amnesia: A Machine For Pigs.
+ *
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "impl/LowLevelGraphicsNull.h"
+
+#include "system/LowLevelSystem.h"
+
+#include "impl/GraphicsObjectsNull.h"
+#include "impl/SDLFontData.h"
+
+#include "graphics/Bitmap.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cLowLevelGraphicsNull::cLowLevelGraphicsNull()
+	{
+		mvScreenSize = cVector2l(800,600);
+		mlMultisampling = 0;
+		mbFullscreen = false;
+		mfGammaCorrection = 1.0f;
+		mGpuProgramFormat = eGpuProgramFormat_GLSL;
+		mpFrameBuffer = NULL;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cLowLevelGraphicsNull::~cLowLevelGraphicsNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// GENERAL SETUP
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cLowLevelGraphicsNull::Init(	int alWidth, int alHeight, int alDisplay, int alBpp, int abFullscreen,
+										int alMultisampling, eGpuProgramFormat aGpuProgramFormat,const tString& asWindowCaption,
+										const cVector2l &avWindowPos)
+	{
+		mvScreenSize.x = alWidth;
+		mvScreenSize.y = alHeight;
+		mbFullscreen = abFullscreen ? true : false;
+		mlMultisampling = alMultisampling;
+
+		Log(" Using null graphics device, nothing will be rendered. Size: %dx%d\n", alWidth, alHeight);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cLowLevelGraphicsNull::GetCaps(eGraphicCaps aType)
+	{
+		switch(aType)
+		{
+		case eGraphicCaps_TextureTargetRectangle:	return 1;
+		case eGraphicCaps_VertexBufferObject:		return 1;
+		case eGraphicCaps_VertexHalfFloat:			return 0;
+		case eGraphicCaps_TwoSideStencil:			return 1;
+		case eGraphicCaps_MaxTextureImageUnits:		return 16;
+		case eGraphicCaps_MaxTextureCoordUnits:		return 8;
+		case eGraphicCaps_MaxUserClipPlanes:		return kMaxClipPlanes;
+		case eGraphicCaps_AnisotropicFiltering:		return 1;
+		case eGraphicCaps_MaxAnisotropicFiltering:	return 16;
+		case eGraphicCaps_Multisampling:			return 1;
+		case eGraphicCaps_TextureCompression:		return 1;
+		case eGraphicCaps_TextureCompression_DXTC:	return 1;
+		case eGraphicCaps_AutoGenerateMipMaps:		return 1;
+		case eGraphicCaps_RenderToTexture:			return 1;
+		case eGraphicCaps_MaxDrawBuffers:			return kMaxDrawColorBuffers;
+		case eGraphicCaps_PackedDepthStencil:		return 1;
+		case eGraphicCaps_TextureFloat:				return 1;
+		case eGraphicCaps_PolygonOffset:			return 1;
+		case eGraphicCaps_ShaderModel_2:			return 1;
+		case eGraphicCaps_ShaderModel_3:			return mbForceShaderModel3And4Off ? 0 : 1;
+		case eGraphicCaps_ShaderModel_4:			return mbForceShaderModel3And4Off ? 0 : 1;
+		case eGraphicCaps_OGL_ATIFragmentShader:	return 0;
+		case eGraphicCaps_MaxColorRenderTargets:	return kMaxDrawColorBuffers;
+		}
+
+		return 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cVector2f cLowLevelGraphicsNull::GetScreenSizeFloat()
+	{
+		return cVector2f((float)mvScreenSize.x, (float)mvScreenSize.y);
+	}
+
+	const cVector2l& cLowLevelGraphicsNull::GetScreenSizeInt()
+	{
+		return mvScreenSize;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// DATA CREATION
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	iFontData* cLowLevelGraphicsNull::CreateFontData(const tString &asName)
+	{
+		return hplNew( cSDLFontData, (asName, this) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iGpuProgram* cLowLevelGraphicsNull::CreateGpuProgram(const tString& asName)
+	{
+		return hplNew( cGpuProgramNull, (asName) );
+	}
+
+	iGpuShader* cLowLevelGraphicsNull::CreateGpuShader(const tString& asName, eGpuShaderType aType)
+	{
+		return hplNew( cGpuShaderNull, (asName,aType) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iTexture* cLowLevelGraphicsNull::CreateTexture(const tString &asName,eTextureType aType, eTextureUsage aUsage)
+	{
+		return hplNew( cTextureNull, (asName,aType, aUsage, this) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iVertexBuffer* cLowLevelGraphicsNull::CreateVertexBuffer(	eVertexBufferType aType,
+																eVertexBufferDrawType aDrawType,
+																eVertexBufferUsageType aUsageType,
+																int alReserveVtxSize,int alReserveIdxSize)
+	{
+		return hplNew( cVertexBufferNull, (this, aType, aDrawType, aUsageType, alReserveVtxSize, alReserveIdxSize) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iFrameBuffer* cLowLevelGraphicsNull::CreateFrameBuffer(const tString& asName)
+	{
+		return hplNew( cFrameBufferNull, (asName, this) );
+	}
+
+	iDepthStencilBuffer* cLowLevelGraphicsNull::CreateDepthStencilBuffer(const cVector2l& avSize, int alDepthBits, int alStencilBits)
+	{
+		return hplNew( cDepthStencilBufferNull, (avSize, alDepthBits, alStencilBits) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iOcclusionQuery* cLowLevelGraphicsNull::CreateOcclusionQuery()
+	{
+		return hplNew( cOcclusionQueryNull, () );
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// FRAME BUFFER OPERATIONS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cBitmap* cLowLevelGraphicsNull::CopyFrameBufferToBitmap(const cVector2l &avScreenPos,const cVector2l &avScreenSize)
+	{
+		cVector2l vSize = avScreenSize;
+		if(vSize.x <= 0) vSize.x = mvScreenSize.x;
+		if(vSize.y <= 0) vSize.y = mvScreenSize.y;
+
+		cBitmap *pBitmap = hplNew(cBitmap, () );
+		pBitmap->CreateData(cVector3l(vSize.x, vSize.y,1),ePixelFormat_RGBA,0,0);
+
+		return pBitmap;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelGraphicsNull::SetCurrentFrameBuffer(iFrameBuffer* apFrameBuffer, const cVector2l &avPos, const cVector2l& avSize)
+	{
+		mpFrameBuffer = apFrameBuffer;
+	}
+
+	//-----------------------------------------------------------------------
+
+}
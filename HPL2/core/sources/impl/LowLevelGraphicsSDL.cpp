@@ -47,6 +47,7 @@
 #include "impl/OcclusionQueryOGL.h"
 
 #include "graphics/Bitmap.h"
+#include "graphics/Renderer.h"
 
 #ifdef __APPLE__
 #include <OpenGL/OpenGL.h>
@@ -492,6 +493,7 @@ namespace hpl {
 		Log("  Max user clip planes: %d\n",GetCaps(eGraphicCaps_MaxUserClipPlanes));
 		Log("  Two sided stencil: %d\n",GetCaps(eGraphicCaps_TwoSideStencil));
 		Log("  Vertex Buffer Object: %d\n",GetCaps(eGraphicCaps_VertexBufferObject));
+		Log("  Vertex Half Float: %d\n",GetCaps(eGraphicCaps_VertexHalfFloat));
 
 		Log("  Anisotropic filtering: %d\n",GetCaps(eGraphicCaps_AnisotropicFiltering));
 		if(GetCaps(eGraphicCaps_AnisotropicFiltering))
@@ -531,6 +533,7 @@ namespace hpl {
 		case eGraphicCaps_TextureTargetRectangle:	return 1;//GLEW_ARB_texture_rectangle?1:0;
 		
 		case eGraphicCaps_VertexBufferObject:		return GLEW_ARB_vertex_buffer_object?1:0;
+		case eGraphicCaps_VertexHalfFloat:			return GLEW_ARB_half_float_vertex?1:0;
 		case eGraphicCaps_TwoSideStencil:			
 			{
 				if(GLEW_EXT_stencil_two_side) return 1;
@@ -1537,6 +1540,9 @@ namespace hpl {
 
 			cSDLTexture *pSDLTex = static_cast<cSDLTexture*> (apTex);
 
+			//All binds (also gui and post effects) count as use for the texture memory budget
+			pSDLTex->SetRenderFrameCount(iRenderer::GetRenderFrameCount());
+
 			glBindTexture(NewTarget, pSDLTex->GetTextureHandle());
 			glEnable(NewTarget);
 
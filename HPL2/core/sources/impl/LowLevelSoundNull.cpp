@@ -0,0 +1,180 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ *
+ * This file is part of Amnesia: A Machine For Pigs.
+ *
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "impl/LowLevelSoundNull.h"
+
+#include "system/LowLevelSystem.h"
+#include "math/Math.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// SOUND DATA
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cSoundDataNull::cSoundDataNull(const tString& asName, bool abStream) : iSoundData(asName,_W(""),abStream)
+	{
+	}
+
+	cSoundDataNull::~cSoundDataNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cSoundDataNull::CreateFromFile(const tWString &asFile)
+	{
+		SetFullPath(asFile);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	iSoundChannel* cSoundDataNull::CreateChannel(int alPriority)
+	{
+		return hplNew( cSoundChannelNull, (this, alPriority, mpSoundManger) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// SOUND CHANNEL
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cSoundChannelNull::cSoundChannelNull(iSoundData* apData, int alPriority, cSoundManager* apSoundManger)
+	: iSoundChannel(apData, apSoundManger)
+	{
+		mlPriority = alPriority;
+	}
+
+	cSoundChannelNull::~cSoundChannelNull()
+	{
+		DestroyData();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSoundChannelNull::Play()
+	{
+		SetPaused(false);
+
+		mbStopUsed = false;
+	}
+
+	void cSoundChannelNull::Stop()
+	{
+		mbStopUsed = true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cSoundChannelNull::IsPlaying()
+	{
+		if(mbStopUsed) return false;
+
+		return mbLooping || (mpData && mpData->IsStream() && mpData->GetLoopStream());
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cLowLevelSoundNull::cLowLevelSoundNull()
+	{
+	}
+
+	cLowLevelSoundNull::~cLowLevelSoundNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHOD
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelSoundNull::GetSupportedFormats(tStringList &alstFormats)
+	{
+		alstFormats.push_back("WAV");
+		alstFormats.push_back("OGG");
+	}
+
+	//-----------------------------------------------------------------------
+
+	iSoundData* cLowLevelSoundNull::LoadSoundData(const tString& asName, const tWString& asFilePath,
+												const tString& asType, bool abStream,bool abLoopStream)
+	{
+		cSoundDataNull* pSoundData = hplNew( cSoundDataNull, (asName,abStream) );
+		pSoundData->SetLoopStream(abLoopStream);
+
+		if(pSoundData->CreateFromFile(asFilePath)==false)
+		{
+			hplDelete(pSoundData);
+			return NULL;
+		}
+
+		return pSoundData;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelSoundNull::SetListenerAttributes(const cVector3f &avPos,const cVector3f &avVel,
+							const cVector3f &avForward,const cVector3f &avUp)
+	{
+		mvListenerPosition = avPos;
+		mvListenerVelocity = avVel;
+		mvListenerForward = avForward;
+		mvListenerUp = avUp;
+
+		mvListenerRight = cMath::Vector3Cross(mvListenerForward,mvListenerUp);
+
+		m_mtxListener = cMatrixf::Identity;
+		m_mtxListener.SetRight(mvListenerRight);
+		m_mtxListener.SetUp(mvListenerUp);
+		m_mtxListener.SetForward(mvListenerForward*-1);
+		m_mtxListener = cMath::MatrixInverse(m_mtxListener);
+		m_mtxListener.SetTranslation(mvListenerPosition);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelSoundNull::Init(int alSoundDeviceID, bool abUseEnvAudio,int alMaxChannels,
+									int alStreamUpdateFreq, bool abUseThreading, bool abUseVoiceManagement,
+									int alMaxMonoSourceHint, int alMaxStereoSourceHint,
+									int alStreamingBufferSize, int alStreamingBufferCount, bool abEnableLowLevelLog)
+	{
+		Log(" Using null sound device, nothing will be played.\n");
+
+		mbEnvAudioEnabled = false;
+	}
+
+	//-----------------------------------------------------------------------
+
+}
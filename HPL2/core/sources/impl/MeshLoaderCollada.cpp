@@ -35,6 +35,7 @@
 #include "graphics/MaterialType.h"
 #include "graphics/LowLevelGraphics.h"
 #include "graphics/VertexBuffer.h"
+#include "graphics/MeshOptimizer.h"
 
 #include "resources/MaterialManager.h"
 #include "resources/MeshManager.h"
@@ -627,6 +628,10 @@ namespace hpl {
 				pVtxBuffer->Transform(mtxScale);
 			}
 
+			//Reorder for the vertex cache
+			if(mpMeshManager->GetOptimizeVertexCache())
+				cMeshOptimizer::OptimizeVertexBuffer(pVtxBuffer, pSubMesh);
+
 			pSubMesh->Compile();
 
 			//Compile the vertex buffer
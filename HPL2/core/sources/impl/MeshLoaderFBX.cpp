@@ -30,6 +30,7 @@
 
 #include "graphics/LowLevelGraphics.h"
 #include "graphics/VertexBuffer.h"
+#include "graphics/MeshOptimizer.h"
 #include "graphics/Mesh.h"
 #include "graphics/SubMesh.h"
 
@@ -213,6 +214,12 @@ namespace hpl {
 				pSubMesh->SetMaterialName("");
 			}
 
+			//Reorder for the vertex cache, buffer is already compiled so data must be updated.
+			if(mpMeshManager->GetOptimizeVertexCache())
+			{
+				cMeshOptimizer::OptimizeVertexBuffer(subData.mpVtxBuffer, pSubMesh);
+				subData.mpVtxBuffer->UpdateData(eFlagBit_All, true);
+			}
 
 			pSubMesh->Compile();
 		}
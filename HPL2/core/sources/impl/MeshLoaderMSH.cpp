@@ -22,6 +22,7 @@
 #include "system/LowLevelSystem.h"
 #include "graphics/LowLevelGraphics.h"
 #include "graphics/VertexBuffer.h"
+#include "graphics/MeshOptimizer.h"
 #include "system/String.h"
 #include "resources/BinaryBuffer.h"
 
@@ -109,7 +110,7 @@ namespace hpl {
 		}
 
 		//Check so file has he right version
-		if(lVersion != MSH_FORMAT_VERSION)
+		if(lVersion < MSH_FORMAT_MIN_VERSION || lVersion > MSH_FORMAT_VERSION)
 		{
 			Error("File '%s' does not have right MSH version!\n", cString::To8Char(asFile).c_str());
 			return NULL;
@@ -278,12 +279,49 @@ namespace hpl {
 				binBuff.GetInt32Array((int*)pVtxBuff->GetIndices(), lIdxNum);
 			}
 
+
+			////////////////////
+			//Get detail levels, created from the unoptimized buffer since they use the same vertex order
+			if(lVersion >= 8)
+			{
+				int lLodNum = binBuff.GetInt32();
+				if(gbLogMSHLoad) Log("Lods: %d\n", lLodNum);
+
+				for(int lod=0; lod<lLodNum; ++lod)
+				{
+					float fMaxScreenSize = binBuff.GetFloat32();
+
+					tUIntVec vVertexRemap(binBuff.GetInt32());
+					if(vVertexRemap.empty()==false) binBuff.GetInt32Array((int*)&vVertexRemap[0], vVertexRemap.size());
+
+					tUIntVec vLodIndices(binBuff.GetInt32());
+					if(vLodIndices.empty()==false) binBuff.GetInt32Array((int*)&vLodIndices[0], vLodIndices.size());
+					
+					iVertexBuffer *pLodVtxBuff = cMeshOptimizer::CreateLodVertexBuffer(	mpLowLevelGraphics, pVtxBuff, vVertexRemap,
+																						vLodIndices.empty() ? NULL : &vLodIndices[0], (int)vLodIndices.size());
+					pSubMesh->AddLod(fMaxScreenSize, pLodVtxBuff, vVertexRemap);
+				}
+			}
 			
 			///////////////////
-			//Compile vertex buffer and set to submesh
+			//Reorder for the vertex cache, done here since older files are not optimized
+			if(mpMeshManager->GetOptimizeVertexCache())
+				cMeshOptimizer::OptimizeVertexBuffer(pVtxBuff, pSubMesh);
+
+			///////////////////
+			//Compile vertex buffers and set to submesh
+			SetupVertexFormat(pVtxBuff);
 			pVtxBuff->Compile(0);
 
+			for(int lod=0; lod<pSubMesh->GetLodNum(); ++lod)
+			{
+				iVertexBuffer *pLodVtxBuff = pSubMesh->GetLod(lod)->mpVtxBuffer;
+				SetupVertexFormat(pLodVtxBuff);
+				pLodVtxBuff->Compile(0);
+			}
+
 			pSubMesh->SetVertexBuffer(pVtxBuff);
+			pSubMesh->SetCompactBoneWeights(mpMeshManager->GetCompactVertexFormat());
 			pSubMesh->Compile();
 		}
 
@@ -465,6 +503,25 @@ namespace hpl {
 				binBuff.AddInt32(lIdxNum);
 				binBuff.AddInt32Array((int*)pVtxBuff->GetIndices(), lIdxNum);
 			}
+
+			////////////////////////////
+			//Add detail levels
+			{
+				binBuff.AddInt32(pSubMesh->GetLodNum());
+				if(gbLogMSHLoad) Log("Lods: %d\n", pSubMesh->GetLodNum());
+
+				for(int lod=0; lod<pSubMesh->GetLodNum(); ++lod)
+				{
+					cSubMeshLod *pLod = pSubMesh->GetLod(lod);
+					binBuff.AddFloat32(pLod->mfMaxScreenSize);
+
+					binBuff.AddInt32((int)pLod->mvVertexRemap.size());
+					if(pLod->mvVertexRemap.empty()==false) binBuff.AddInt32Array((int*)&pLod->mvVertexRemap[0], pLod->mvVertexRemap.size());
+
+					binBuff.AddInt32(pLod->mpVtxBuffer->GetIndexNum());
+					binBuff.AddInt32Array((int*)pLod->mpVtxBuffer->GetIndices(), pLod->mpVtxBuffer->GetIndexNum());
+				}
+			}
 		}
 
 		
@@ -515,7 +572,7 @@ namespace hpl {
 		}
 
 		//Check so file has he right version
-		if(lVersion != MSH_FORMAT_VERSION)
+		if(lVersion < MSH_FORMAT_MIN_VERSION || lVersion > MSH_FORMAT_VERSION)
 		{
 			Warning("File '%s' does not have right MSH version!\n", cString::To8Char(asFile).c_str());
 			return NULL;
@@ -757,6 +814,18 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cMeshLoaderMSH::SetupVertexFormat(iVertexBuffer *apVtxBuffer)
+	{
+		///////////////////
+		//Half floats need hardware support. Skinning decodes compact normals and tangents of the bind pose.
+		bool bHalfFloat = mpLowLevelGraphics->GetCaps(eGraphicCaps_VertexHalfFloat)!=0;
+		bool bCompact = mpMeshManager->GetCompactVertexFormat();
+		
+		cMeshOptimizer::SetupLoadedVertexFormat(apVtxBuffer, bCompact, bHalfFloat);
+	}
+
+	//-----------------------------------------------------------------------
+
 	void* cMeshLoaderMSH::GetVertexBufferWithFormat(iVertexBuffer *apVtxBuffer, eVertexBufferElement aElement, eVertexBufferElementFormat aFormat)
 	{
 		switch(aFormat)
@@ -764,6 +833,8 @@ namespace hpl {
 		case eVertexBufferElementFormat_Int:		return (void*)apVtxBuffer->GetIntArray(aElement);
 		case eVertexBufferElementFormat_Float:		return (void*)apVtxBuffer->GetFloatArray(aElement);
 		case eVertexBufferElementFormat_Byte:		return (void*)apVtxBuffer->GetByteArray(aElement);
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	return (void*)apVtxBuffer->GetShortArray(aElement);
 		}
 		
 		Error("Vertex buffer has incorrect format when getting vertexbuffer data during loading of MSH file!\n");
@@ -785,6 +856,10 @@ namespace hpl {
 		case eVertexBufferElementFormat_Byte:		
 			apBuffer->AddCharArray((char*)apSrcData, alSize);
 			break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:
+			apBuffer->AddShort16Array((short*)apSrcData, alSize);
+			break;
 		default:
 			Error("Vertex buffer has incorrect format when adding binary data during loading of MSH file!\n");
 			break;
@@ -806,6 +881,10 @@ namespace hpl {
 		case eVertexBufferElementFormat_Byte:		
 			apBuffer->GetCharArray((char*)apDestData, alSize);
 			break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:
+			apBuffer->GetShort16Array((short*)apDestData, alSize);
+			break;
 		default:
 			Error("Vertex buffer has incorrect format when getting binary data during loading of MSH file!\n");
 			break;
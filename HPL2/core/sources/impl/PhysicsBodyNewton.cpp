@@ -72,6 +72,7 @@ namespace hpl {
 		//Clear the force accumulators
 		mvTotalForce = cVector3f(0,0,0);
 		mvTotalTorque = cVector3f(0,0,0);
+		mbHasForces = false;
 		
 		//Log("Creating newton body '%s' %d\n",msName.c_str(),(size_t)this);
 	}
@@ -80,6 +81,8 @@ namespace hpl {
 
 	cPhysicsBodyNewton::~cPhysicsBodyNewton()
 	{
+		if(mbHasForces) static_cast<cPhysicsWorldNewton*>(mpWorld)->RemoveForceBody(this);
+
 		//Log(" Destroying newton body '%s' %d\n",msName.c_str(),(size_t)this);
 	}
 
@@ -274,6 +277,7 @@ namespace hpl {
 	void cPhysicsBodyNewton::AddForce(const cVector3f &avForce)
 	{
 		mvTotalForce += avForce;
+		MarkHasForces();
 		Enable();
 
 		//Log("Added force %s\n",avForce.ToString().c_str());
@@ -294,6 +298,7 @@ namespace hpl {
 		cVector3f vTorque = cMath::Vector3Cross(vLocalPos, avForce);
 
 		mvTotalTorque += vTorque;
+		MarkHasForces();
 		Enable();
 
 		//Log("Added force %s\n",avForce.ToString().c_str());
@@ -304,6 +309,7 @@ namespace hpl {
 	void cPhysicsBodyNewton::AddTorque(const cVector3f &avTorque)
 	{
 		mvTotalTorque += avTorque;
+		MarkHasForces();
 		Enable();
 	}
 
@@ -431,6 +437,23 @@ namespace hpl {
 	{
 		mvTotalForce = cVector3f(0,0,0);
 		mvTotalTorque = cVector3f(0,0,0);
+		mbHasForces = false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cPhysicsBodyNewton::MarkHasForces()
+	{
+		if(mbHasForces) return;
+
+		mbHasForces = true;
+		static_cast<cPhysicsWorldNewton*>(mpWorld)->AddForceBody(this);
 	}
 
 	//-----------------------------------------------------------------------
@@ -449,6 +472,9 @@ namespace hpl {
 
 		pRigidBody->m_mtxLocalTransform.FromTranspose(apMatrix);
 
+		//Thread lock, entity callbacks and mbUseCallback are shared between worker threads.
+		cNewtonLockBodyUntilReturn criticalLock(apBody);
+
 		mbUseCallback = false;
 		pRigidBody->SetTransformUpdated(true);
 		mbUseCallback = true;
@@ -456,15 +482,16 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 	
-	//callback for buoyancy
-	static cPlanef gSurfacePlane;
+	//callback for buoyancy, context is the body so the callback is safe when simulating on several threads.
 	static int BuoyancyPlaneCallback (const int alCollisionID, void *apContext, 
 									const float* afGlobalSpaceMatrix, float* afGlobalSpacePlane)
 	{
-		afGlobalSpacePlane[0] = gSurfacePlane.a;
-		afGlobalSpacePlane[1] = gSurfacePlane.b;
-		afGlobalSpacePlane[2] = gSurfacePlane.c;
-		afGlobalSpacePlane[3] = gSurfacePlane.d;
+		cPlanef surfacePlane = static_cast<cPhysicsBodyNewton*>(apContext)->GetBuoyancySurface();
+
+		afGlobalSpacePlane[0] = surfacePlane.a;
+		afGlobalSpacePlane[1] = surfacePlane.b;
+		afGlobalSpacePlane[2] = surfacePlane.c;
+		afGlobalSpacePlane[3] = surfacePlane.d;
 		return 1;   
 	} 
 
@@ -487,6 +514,7 @@ namespace hpl {
 			//If not in update list, add body.
 			if(pRigidBody->IsInUpdateList()==false)
 			{
+				cNewtonLockBodyUntilReturn criticalLock(apBody);
 				pRigidBody->GetWorld()->AddBodyToUpdateList(pRigidBody);	
 			}
 		}
@@ -508,8 +536,6 @@ namespace hpl {
 		{
 			cVector3f vGravity = pRigidBody->mpWorld->GetGravity();
 
-			gSurfacePlane = pRigidBody->mBuoyancy.mSurface;
-			
 			NewtonBodyAddBuoyancyForce( apBody, 
 										pRigidBody->mBuoyancy.mfDensity * pRigidBody->mfBuoyancyDensityMul,
 										pRigidBody->mBuoyancy.mfLinearViscosity,
@@ -258,9 +258,8 @@ namespace hpl {
 		//Log("----- Begin contact between body '%s' and '%s'.\n",mpContactBody1->GetName().c_str(),
 		//													mpContactBody2->GetName().c_str());
 
-		//Thread lock
-		cNewtonLockBodyUntilReturn criticalLock1(apBody1);
-		cNewtonLockBodyUntilReturn criticalLock2(apBody2);
+		//Thread lock, both bodies are in the same world and the lock is not recursive, so only lock once.
+		cNewtonLockBodyUntilReturn criticalLock(apBody1);
 		
 		//Call the callbacks
 		if(pContactBody1->OnAABBCollision(pContactBody2)==false) return 0;
@@ -352,9 +351,8 @@ namespace hpl {
 		contactData.mvContactNormal = contactData.mvContactNormal / (float)lContactNum;
 		contactData.mvContactPosition = contactData.mvContactPosition / (float)lContactNum;
 
-		//Thread lock
+		//Thread lock, both bodies are in the same world and the lock is not recursive, so only lock once.
 		NewtonWorldCriticalSectionLock (NewtonBodyGetWorld (pBody0));
-		NewtonWorldCriticalSectionLock (NewtonBodyGetWorld (pBody1));
 
 		////////////////////////////
 		//Surface data stuff
@@ -399,9 +397,10 @@ namespace hpl {
 		pContactBody1->OnCollide(pContactBody2,&contactData);
 		pContactBody2->OnCollide(pContactBody1,&contactData);
 
+		pContactBody1->GetWorld()->AddContactsToStats(lContactNum);
+
 		//Thread unlock
 		NewtonWorldCriticalSectionUnlock (NewtonBodyGetWorld (pBody0));
-		NewtonWorldCriticalSectionUnlock (NewtonBodyGetWorld (pBody1));
 
 
 	}
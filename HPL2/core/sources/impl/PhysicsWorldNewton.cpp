@@ -35,6 +35,8 @@
 #include "scene/World.h"
 
 #include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/Timer.h"
 #include "graphics/VertexBuffer.h"
 #include "graphics/LowLevelGraphics.h"
 #include "math/Math.h"
@@ -79,6 +81,8 @@ namespace hpl {
 		mpTempDepths = hplNewArray( float,500);
 		mpTempNormals = hplNewArray( float,500 * 3);
 		mpTempPoints = hplNewArray( float,500 * 3);
+
+		mpSubStepTimer = cPlatform::CreateTimer();
 	}
 
 	//-----------------------------------------------------------------------
@@ -91,6 +95,8 @@ namespace hpl {
 		hplDeleteArray(mpTempDepths);
 		hplDeleteArray(mpTempNormals);
 		hplDeleteArray(mpTempPoints);
+
+		hplDelete(mpSubStepTimer);
 	}
 
 	//-----------------------------------------------------------------------
@@ -108,22 +114,34 @@ namespace hpl {
         //if(lUpdate % 30==0)
 		{
 
+			mStats.mlContactNum =0;
+			mStats.mlSubStepNum =0;
+			mStats.mfSimulateTime =0;
+
 			while(afTimeStep>mfMaxTimeStep)
 			{
-				NewtonUpdate(mpNewtonWorld, mfMaxTimeStep);
+				SimulateSubStep(mfMaxTimeStep);
 				afTimeStep -= mfMaxTimeStep;
 			}
-			NewtonUpdate(mpNewtonWorld, afTimeStep);
+			SimulateSubStep(afTimeStep);
 		}
 		//lUpdate++;
 		//cPhysicsBodyNewton::SetUseCallback(true);
-        			
-		tPhysicsBodyListIt it = mlstBodies.begin();
-		for(;it != mlstBodies.end(); ++it)
+
+		//////////////////////////////
+		// Clear forces, only bodies that had forces added need it.
+		for(size_t i=0; i<mvForceBodies.size(); ++i)
 		{
-			cPhysicsBodyNewton* pBody = static_cast<cPhysicsBodyNewton*>(*it);
-			pBody->ClearForces();
+			mvForceBodies[i]->ClearForces();
 		}
+		mvForceBodies.clear();
+
+		mStats.mlActiveBodyNum = (int)mvUpdateBodies.size();
+		mStats.mfSubStepTime = mStats.mlSubStepNum > 0 ? mStats.mfSimulateTime / (float)mStats.mlSubStepNum : 0;
+
+		LogUpdate(" Physics: %d bodies, %d active, %d contacts, %d substeps, %.3f ms per substep (%d threads)\n",
+					mStats.mlBodyNum, mStats.mlActiveBodyNum, mStats.mlContactNum, mStats.mlSubStepNum,
+					mStats.mfSubStepTime, GetNumberOfThreads());
 	}
 	
 	//-----------------------------------------------------------------------
@@ -377,11 +395,31 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cPhysicsWorldNewton::AddForceBody(cPhysicsBodyNewton *apBody)
+	{
+		mvForceBodies.push_back(apBody);
+	}
+
+	void cPhysicsWorldNewton::RemoveForceBody(cPhysicsBodyNewton *apBody)
+	{
+		for(size_t i=0; i<mvForceBodies.size(); ++i)
+		{
+			if(mvForceBodies[i] != apBody) continue;
+
+			mvForceBodies[i] = mvForceBodies.back();
+			mvForceBodies.pop_back();
+			return;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 	iPhysicsBody* cPhysicsWorldNewton::CreateBody(const tString &asName,iCollideShape *apShape)
 	{
 		cPhysicsBodyNewton *pBody = hplNew( cPhysicsBodyNewton, (asName,this, apShape) );
 
 		mlstBodies.push_back(pBody);
+		mStats.mlBodyNum++;
 
 		return pBody;
 	}
@@ -595,10 +633,41 @@ namespace hpl {
 			aCollideData.mlNumOfPoints = 0;
 			int lCollideDataStart =0;
 
+			//An empty compound can not collide with anything
+			if(lACount == 0 || lBCount == 0) return false;
+
+			//////////////////////////////
+			//Get world AABBs for all sub shapes, so only overlapping pairs are sent to Newton.
+			GetSubShapeWorldAABBs(pNewtonShapeA, a_mtxA, mvTempSubShapeMinA, mvTempSubShapeMaxA);
+			GetSubShapeWorldAABBs(pNewtonShapeB, a_mtxB, mvTempSubShapeMinB, mvTempSubShapeMaxB);
+
+			cVector3f vTotalMinB = mvTempSubShapeMinB[0];
+			cVector3f vTotalMaxB = mvTempSubShapeMaxB[0];
+			for(int b=1; b< lBCount; b++)
+			{
+				cMath::ExpandAABB(vTotalMinB, vTotalMaxB, mvTempSubShapeMinB[b], mvTempSubShapeMaxB[b]);
+			}
+
+			mlShapeCollisionPairCount += lACount * lBCount;
+
 			for(int a=0; a< lACount; a++)
 			{
+				//Skip the inner loop if sub shape is not touching B at all
+				if(cMath::CheckAABBIntersection(mvTempSubShapeMinA[a], mvTempSubShapeMaxA[a], vTotalMinB, vTotalMaxB)==false)
+				{
+					mlShapeCollisionPairCulledCount += lBCount;
+					continue;
+				}
+
 				for(int b=0; b< lBCount; b++)
 				{
+					if(cMath::CheckAABBIntersection(mvTempSubShapeMinA[a], mvTempSubShapeMaxA[a], 
+													mvTempSubShapeMinB[b], mvTempSubShapeMaxB[b])==false)
+					{
+						mlShapeCollisionPairCulledCount++;
+						continue;
+					}
+
 					cCollideShapeNewton *pSubShapeA = static_cast<cCollideShapeNewton*>(pNewtonShapeA->GetSubShape(a));
 					cCollideShapeNewton *pSubShapeB = static_cast<cCollideShapeNewton*>(pNewtonShapeB->GetSubShape(b));
 					
@@ -651,6 +720,8 @@ namespace hpl {
 		//Check NON compound collision
 		else 
 		{
+			mlShapeCollisionPairCount++;
+
 			//Log(" 1\n");
 			int lNum = NewtonCollisionCollide(mpNewtonWorld, alMaxPoints,
 										pNewtonShapeA->GetNewtonCollision(), &(mtxTransposeA.m[0][0]),
@@ -739,4 +810,65 @@ namespace hpl {
 	}
 
 	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cPhysicsWorldNewton::SimulateSubStep(float afTimeStep)
+	{
+		mpSubStepTimer->Start();
+		NewtonUpdate(mpNewtonWorld, afTimeStep);
+		mpSubStepTimer->Stop();
+
+		mStats.mlSubStepNum++;
+		mStats.mfSimulateTime += (float)mpSubStepTimer->GetTimeInMilliSec();
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * The sub shape bounding volumes are in the space of the parent shape (offset included),
+	 * the box is transformed using the absolute of the rotation to get a world AABB.
+	 */
+	void cPhysicsWorldNewton::GetSubShapeWorldAABBs(cCollideShapeNewton *apShape, const cMatrixf& a_mtxTransform,
+													tVector3fVec& avMin, tVector3fVec& avMax)
+	{
+		//Small padding so contacts within Newton's margin are not missed.
+		const float fPadding = 0.01f;
+
+		int lCount = apShape->GetSubShapeNum();
+		if((int)avMin.size() < lCount)
+		{
+			avMin.resize(lCount);
+			avMax.resize(lCount);
+		}
+
+		for(int i=0; i<lCount; ++i)
+		{
+			cBoundingVolume &subBV = apShape->GetSubShape(i)->GetBoundingVolume();
+			cVector3f vLocalMin = subBV.GetMin();
+			cVector3f vLocalMax = subBV.GetMax();
+
+			cVector3f vCenter = (vLocalMin + vLocalMax) * 0.5f;
+			cVector3f vExtent = (vLocalMax - vLocalMin) * 0.5f;
+
+			cVector3f vWorldCenter = cMath::MatrixMul(a_mtxTransform, vCenter);
+			cVector3f vWorldExtent;
+			for(int j=0; j<3; ++j)
+			{
+				vWorldExtent.v[j] =	cMath::Abs(a_mtxTransform.m[j][0]) * vExtent.x +
+									cMath::Abs(a_mtxTransform.m[j][1]) * vExtent.y +
+									cMath::Abs(a_mtxTransform.m[j][2]) * vExtent.z + fPadding;
+			}
+
+			avMin[i] = vWorldCenter - vWorldExtent;
+			avMax[i] = vWorldCenter + vWorldExtent;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 }
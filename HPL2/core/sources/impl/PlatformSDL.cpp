@@ -27,6 +27,7 @@
 #include "SDL2/SDL.h"
 #else
 #include "SDL/SDL.h"
+#include <unistd.h>
 #endif
 
 #include "impl/TimerSDL.h"
@@ -181,5 +182,17 @@ namespace hpl {
 	{
 		return hplNew(cMutexSDL, ());
 	}
+
+	//-----------------------------------------------------------------------
+
+	int cPlatform::GetCPUCount()
+	{
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		return SDL_GetCPUCount();
+#else
+		long lCount = sysconf(_SC_NPROCESSORS_ONLN);
+		return lCount > 0 ? (int)lCount : 1;
+#endif
+	}
 #endif
 }
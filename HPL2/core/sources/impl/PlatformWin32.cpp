@@ -780,6 +780,15 @@ namespace hpl {
 		return hplNew(cMutexWin32, ());
 	}
 
+	//-----------------------------------------------------------------------
+
+	int cPlatform::GetCPUCount()
+	{
+		SYSTEM_INFO sysInfo;
+		GetSystemInfo(&sysInfo);
+		return (int)sysInfo.dwNumberOfProcessors;
+	}
+
 
 	//-----------------------------------------------------------------------
 
@@ -38,6 +38,10 @@
 #include "impl/LowLevelSoundFmod.h"
 #include "impl/LowLevelSoundOpenAL.h"
 #include "impl/LowLevelPhysicsNewton.h"
+#include "impl/LowLevelGraphicsNull.h"
+#include "impl/LowLevelSoundNull.h"
+
+#include "engine/EngineInitVars.h"
 
 #ifdef INCLUDE_HAPTIC 
 	#include "impl/LowLevelHapticHaptX.h"
@@ -63,12 +67,16 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	cSDLEngineSetup::cSDLEngineSetup(tFlag alHplSetupFlags)
+	cSDLEngineSetup::cSDLEngineSetup(tFlag alHplSetupFlags, cEngineInitVars *apVars)
 	{
+		bool bNullGraphics = apVars && apVars->mGraphics.mbNullDevice;
+		bool bNullSound = apVars && apVars->mSound.mbNullDevice;
+
 #if SDL_VERSION_ATLEAST(2,0,0)
 		SDL_SetHint(SDL_HINT_VIDEO_MAC_FULLSCREEN_SPACES, "0");
 #endif
-		if(alHplSetupFlags & (eHplSetup_Screen | eHplSetup_Video))
+		//The null graphics device has no window, so video is not needed
+		if((alHplSetupFlags & (eHplSetup_Screen | eHplSetup_Video)) && bNullGraphics==false)
 		{
 			if(SDL_Init( SDL_INIT_VIDEO | SDL_INIT_TIMER ) < 0) {
 				FatalError("Error Initializing Display: %s",SDL_GetError()); 
@@ -115,7 +123,8 @@ namespace hpl {
 		
 		//////////////////////////
 		// Graphics
-		mpLowLevelGraphics = hplNew( cLowLevelGraphicsSDL,() );
+		if(bNullGraphics)	mpLowLevelGraphics = hplNew( cLowLevelGraphicsNull,() );
+		else				mpLowLevelGraphics = hplNew( cLowLevelGraphicsSDL,() );
 		
 		//////////////////////////
 		// Input
@@ -127,7 +136,8 @@ namespace hpl {
 		
 		//////////////////////////
 		// Sound
-		mpLowLevelSound	= hplNew( cLowLevelSoundOpenAL,() );
+		if(bNullSound)	mpLowLevelSound	= hplNew( cLowLevelSoundNull,() );
+		else			mpLowLevelSound	= hplNew( cLowLevelSoundOpenAL,() );
 		
 		//////////////////////////
 		// Physics
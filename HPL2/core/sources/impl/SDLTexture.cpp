@@ -72,6 +72,9 @@ namespace hpl {
 	{
 		;
 
+		//Texture might be recreated (at another size level), so reset memory count.
+		mlMemorySize = 0;
+
 		GenerateHandles(1);
 
         return CreateFromBitmapToIndex(apBmp,0);
@@ -83,6 +86,8 @@ namespace hpl {
 	{
 		;
 
+		mlMemorySize = 0;
+
 		GenerateHandles((int)avBitmaps->size());
 
 		//////////////////////////////////
@@ -116,6 +121,8 @@ namespace hpl {
 			return false;
 		}
 
+		mlMemorySize = 0;
+
 		GenerateHandles(1);
 
 		/////////////////////////////
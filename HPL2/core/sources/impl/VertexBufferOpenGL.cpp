@@ -29,6 +29,7 @@
 #include "impl/VertexBufferOGL_VBO.h"
 
 #include <memory.h>
+#include <algorithm>
 
 #include <GL/glew.h>
 
@@ -70,6 +71,8 @@ namespace hpl {
 		case eVertexBufferElementFormat_Float:	return GL_FLOAT;
 		case eVertexBufferElementFormat_Int:	return GL_INT;
 		case eVertexBufferElementFormat_Byte:	return GL_UNSIGNED_BYTE;
+		case eVertexBufferElementFormat_Short:	return GL_SHORT;
+		case eVertexBufferElementFormat_HalfFloat:	return GL_HALF_FLOAT_ARB;
 		}
 
 		return 0;
@@ -112,12 +115,15 @@ namespace hpl {
 		mpByteArray = NULL;
 		mpIntArray = NULL;
 		mpFloatArray = NULL;
+		mpShortArray = NULL;
 
 		switch(aFormat)
 		{
 		case eVertexBufferElementFormat_Float:	mpFloatArray = hplNew(tFloatVec, ()); break;
 		case eVertexBufferElementFormat_Int:	mpIntArray = hplNew(tIntVec, ());	break;
 		case eVertexBufferElementFormat_Byte:	mpByteArray = hplNew(tByteVec, ());	break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	mpShortArray = hplNew(tUShortVec, ());	break;
 		}
 	}
 	
@@ -126,6 +132,7 @@ namespace hpl {
 		if(mpByteArray)	hplDelete(mpByteArray);
 		if(mpIntArray)	hplDelete(mpIntArray);
 		if(mpFloatArray)hplDelete(mpFloatArray);
+		if(mpShortArray)hplDelete(mpShortArray);
 	}
 
 	//-----------------------------------------------------------------------
@@ -137,6 +144,8 @@ namespace hpl {
 		case eVertexBufferElementFormat_Float:	mpFloatArray->reserve(alSize); break;
 		case eVertexBufferElementFormat_Int:	mpIntArray->reserve(alSize); break;
 		case eVertexBufferElementFormat_Byte:	mpByteArray->reserve(alSize); break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	mpShortArray->reserve(alSize); break;
 		}
 	}
 	void cVtxBufferGLElementArray::Resize(size_t alSize)
@@ -146,6 +155,8 @@ namespace hpl {
 		case eVertexBufferElementFormat_Float:	mpFloatArray->resize(alSize); break;
 		case eVertexBufferElementFormat_Int:	mpIntArray->resize(alSize); break;
 		case eVertexBufferElementFormat_Byte:	mpByteArray->resize(alSize); break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	mpShortArray->resize(alSize); break;
 		}
 	}
 	void cVtxBufferGLElementArray::PushBack(const void *apData)
@@ -155,6 +166,8 @@ namespace hpl {
 		case eVertexBufferElementFormat_Float:	mpFloatArray->push_back( *((const float*)apData) ); break;
 		case eVertexBufferElementFormat_Int:	mpIntArray->push_back( *((const int*)apData) ); break;
 		case eVertexBufferElementFormat_Byte:	mpByteArray->push_back( *((const unsigned char*)apData) ); break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	mpShortArray->push_back( *((const unsigned short*)apData) ); break;
 		}
 	}
 
@@ -165,6 +178,8 @@ namespace hpl {
 		case eVertexBufferElementFormat_Float:	return &(*mpFloatArray)[0];
 		case eVertexBufferElementFormat_Int:	return &(*mpIntArray)[0];
 		case eVertexBufferElementFormat_Byte:	return &(*mpByteArray)[0];
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	return &(*mpShortArray)[0];
 		}
 		return NULL;
 	}
@@ -176,6 +191,8 @@ namespace hpl {
 		case eVertexBufferElementFormat_Float:	return mpFloatArray->size();
 		case eVertexBufferElementFormat_Int:	return mpIntArray->size();
 		case eVertexBufferElementFormat_Byte:	return mpByteArray->size();
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	return mpShortArray->size();
 		}
 		return 0;
 	}
@@ -387,6 +404,13 @@ namespace hpl {
 
 	void iVertexBufferOpenGL::Transform(const cMatrixf &a_mtxTransform)
 	{
+		///////////////
+		//Compact normals and tangents are transformed as floats
+		eVertexBufferElementFormat normalFormat = GetElementFormat(eVertexBufferElement_Normal);
+		eVertexBufferElementFormat tangentFormat = GetElementFormat(eVertexBufferElement_Texture1Tangent);
+		if(normalFormat != eVertexBufferElementFormat_LastEnum) ConvertElementFormat(eVertexBufferElement_Normal, eVertexBufferElementFormat_Float);
+		if(tangentFormat != eVertexBufferElementFormat_LastEnum) ConvertElementFormat(eVertexBufferElement_Texture1Tangent, eVertexBufferElementFormat_Float);
+
 		///////////////
 		//Get position
 		float *pPosArray = (float*)GetElementArray(eVertexBufferElement_Position)->GetArrayPtr();
@@ -460,12 +484,61 @@ namespace hpl {
 		tVertexElementFlag vtxFlag = eVertexElementFlag_Position;
 		if(pNormalArray) vtxFlag |= eVertexElementFlag_Normal;
 		if(pTangentArray) vtxFlag |= eVertexElementFlag_Texture1;
+
+		if(pNormalArray) ConvertElementFormat(eVertexBufferElement_Normal, normalFormat);
+		if(pTangentArray) ConvertElementFormat(eVertexBufferElement_Texture1Tangent, tangentFormat);
 		
 		UpdateData(vtxFlag ,false);
 	}
 
 	//-----------------------------------------------------------------------
 
+	unsigned short* iVertexBufferOpenGL::GetShortArray(eVertexBufferElement aElement)
+	{
+		cVtxBufferGLElementArray *pElement = GetElementArray(aElement);
+		if(pElement==NULL) return NULL;
+		if(	pElement->mFormat != eVertexBufferElementFormat_Short &&
+			pElement->mFormat != eVertexBufferElementFormat_HalfFloat)
+		{
+			return NULL;
+		}
+
+		return (unsigned short*)pElement->GetArrayPtr();
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool iVertexBufferOpenGL::ConvertElementFormat(eVertexBufferElement aElement, eVertexBufferElementFormat aFormat)
+	{
+		cVtxBufferGLElementArray *pElement = GetElementArray(aElement);
+		if(pElement==NULL) return false;
+		if(pElement->mFormat == aFormat) return true;
+
+		////////////////////////////
+		//Decode the current data
+		size_t lSize = (size_t)pElement->Size();
+		tFloatVec vValues(lSize);
+		if(lSize>0) VertexFormatToFloat(pElement->mFormat, pElement->GetArrayPtr(), &vValues[0], lSize);
+
+		////////////////////////////
+		//Encode into an array of the new format and swap the storage
+		cVtxBufferGLElementArray tempElement(aFormat);
+		tempElement.mFormat = aFormat;
+		tempElement.Resize(lSize);
+		if(lSize>0) FloatToVertexFormat(aFormat, &vValues[0], tempElement.GetArrayPtr(), lSize);
+
+		std::swap(pElement->mpFloatArray, tempElement.mpFloatArray);
+		std::swap(pElement->mpIntArray, tempElement.mpIntArray);
+		std::swap(pElement->mpByteArray, tempElement.mpByteArray);
+		std::swap(pElement->mpShortArray, tempElement.mpShortArray);
+		tempElement.mFormat = pElement->mFormat;
+		pElement->mFormat = aFormat;
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	int iVertexBufferOpenGL::GetElementNum(eVertexBufferElement aElement)
 	{
 		cVtxBufferGLElementArray *pElement = GetElementArray(aElement);
@@ -21,18 +21,29 @@
 
 #include "system/LowLevelSystem.h"
 #include "system/Platform.h"
+#include "system/Timer.h"
 #include "math/Math.h"
 #include "graphics/Texture.h"
 #include "system/String.h"
+#include "system/Mutex.h"
 
 #include <cstdio>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define HPL_VIDEO_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
 #pragma comment(lib, "libogg.lib")
 #pragma comment(lib, "libtheora.lib")
 
 namespace hpl {
 
+	static const int kVideoFrameRingSize = 4;
+
+	bool cVideoStreamTheora::mbUseSimdYuvConversion = true;
+
 	//////////////////////////////////////////////////////////////////////////
 	// LOADER
 	//////////////////////////////////////////////////////////////////////////
@@ -74,8 +85,8 @@ namespace hpl {
 
 		///////////////////////////////////////////////////
 		//Split the Green computation into two buffer
-		float fMinVal = 0.813f * (-128.0f) - 0.391f * 127;
-		float fMaxVal = 0.813f * (127.0f) + 0.391f * 128;
+		float fMinVal = 0.813f * (-128.0f) + 0.391f * (-128.0f);
+		float fMaxVal = 0.813f * (127.0f) + 0.391f * 127;
 
 		//Green UV part
 		for(int i=0; i<256; ++i)
@@ -85,7 +96,7 @@ namespace hpl {
 			fJ = (float)j;
 			fI = (float)i;
 
-			float fUV = 0.813f*(fJ - 128) - 0.391f * (fI - 128);
+			float fUV = 0.813f*(fJ - 128) + 0.391f * (fI - 128);
 			mpYuv_G_UV[i*256 + j] = (unsigned short)cMath::Clamp(((fUV - fMinVal) / (fMaxVal - fMinVal)) * 1023.0f,0,1023.0f);
 		}
 
@@ -146,7 +157,6 @@ namespace hpl {
 		mbPaused = false;
 		mbPlaying = false;
 
-		mlVideobufReady =0;
 		mlVideobufGranulePos=-1;
 		mfVideobufTime=0;
 
@@ -154,9 +164,18 @@ namespace hpl {
 
 		mlBufferSize = 4096;
 
+		mbVideoLoaded = false;
 		mbVideoFrameReady = false;
 
-		mpFrameBuffer = NULL;
+		mpDecodeThread = NULL;
+		mpFrameMutex = cPlatform::CreateMutEx();
+		mlFirstFrame = 0;
+		mlFrameNum = 0;
+		mlNextFrameId = 0;
+		mlShownFrameId = -1;
+		mbDecodeFinished = false;
+		mfDecodeTimeOffset = 0;
+		mfLastFrameTime = 0;
 
 		//Theora structs that we want until class i deleted.
 		theora_comment_init(&mTheoraComment);
@@ -170,6 +189,10 @@ namespace hpl {
 
 	cVideoStreamTheora::~cVideoStreamTheora()
 	{
+		StopDecodeThread();
+		if(mpDecodeThread) hplDelete(mpDecodeThread);
+		hplDelete(mpFrameMutex);
+
 		if(mpFile) fclose(mpFile);
 
 		ogg_sync_clear(&mOggSyncState);
@@ -182,7 +205,7 @@ namespace hpl {
 		if(mbVideoLoaded)
 		{
 			theora_clear(&mTheoraState);
-			if(mpFrameBuffer) hplDeleteArray(mpFrameBuffer);
+			for(size_t i=0; i<mvFrames.size(); ++i) hplDeleteArray(mvFrames[i].mpData);
 		}
 	}
 	
@@ -231,60 +254,46 @@ namespace hpl {
 		if(mbPlaying==false || mbPaused) return;
 
 		mfTime += afTimeStep;
+
 		////////////////////////////////
-		// Theora Decode packets until the video is ahead of real time. 
-		// (This could be skipped once non-keyframe seeks can be made?)
-		while(!mlVideobufReady && mfVideobufTime < mfTime)
+		// Pick the first decoded frame that is ahead of the current time.
+		// The front frame is kept in the ring while shown, so the decoder does not write to it.
+		mpFrameMutex->Lock();
+		
+		while(mlFrameNum > 1 && mvFrames[mlFirstFrame].mfTime < mfTime)
 		{
-			//Get first packet and decode,
-			ogg_packet packet;
-			if(ogg_stream_packetout(&mTheoraStreamState,&packet)>0)
-			{
-				if(theora_decode_packetin(&mTheoraState,&packet)==0)
-				{
-					//Get new time for current fram position.
-					mlVideobufGranulePos = mTheoraState.granulepos;
-					mfVideobufTime = theora_granule_time(&mTheoraState,mlVideobufGranulePos);
+			mlFirstFrame = (mlFirstFrame+1) % kVideoFrameRingSize;
+			--mlFrameNum;
+		}
 
-					mbVideoFrameReady = true;	
-				}
+		bool bVideoOver = false;
+		if(mlFrameNum > 0)
+		{
+			cVideoStreamTheoraFrame &frame = mvFrames[mlFirstFrame];
+			if(frame.mlId != mlShownFrameId)
+			{
+				mlShownFrameId = frame.mlId;
+				mbVideoFrameReady = true;
 			}
-			//No packets left, get new page.
-			else
+			else if(mbDecodeFinished && mlFrameNum==1 && frame.mfTime < mfTime)
 			{
-				//Get Next page
-				ogg_page page;
-				if(ogg_sync_pageout(&mOggSyncState,&page) > 0)
-				{
-					QueuePage(&page);	
-				}
-				//No pages left, read more buffer data.
-				else
-				{
-					int bytes= BufferData(mpFile,&mOggSyncState);
-					//Fill streams with pages.
-					if(bytes!=0)
-					{
-						while(ogg_sync_pageout(&mOggSyncState,&page)>0) QueuePage(&page);
-					}
-					//No more buffer data in file, stop video				
-					else
-					{
-						if(mbLooping==false) mbPlaying = false;
-						ResetStreams();
-					}
-					
-				}
+				bVideoOver = true;
 			}
 		}
+		else if(mbDecodeFinished)
+		{
+			bVideoOver = true;
+		}
+
+		mpFrameMutex->Unlock();
 
-		
 		////////////////////////////////
-		// Theora Check for end of file.
-		if(!mlVideobufReady && feof(mpFile))
+		// Stop and go back to start once the last frame has been shown.
+		if(bVideoOver)
 		{
-			if(mbLooping==false) mbPlaying = false;
-			ResetStreams();
+			mbPlaying = false;
+			StopDecodeThread();
+			Rewind();
 		}
 	}
 
@@ -292,7 +301,16 @@ namespace hpl {
 
 	void cVideoStreamTheora::Play()
 	{
+		if(mbVideoLoaded==false) return;
+
 		mbPlaying = true;
+
+		if(mpDecodeThread==NULL)
+		{
+			mpDecodeThread = cPlatform::CreateThread(this);
+			mpDecodeThread->SetSleepTime(1);
+		}
+		if(mpDecodeThread->IsActive()==false) mpDecodeThread->Start();
 	}
 	
 	//-----------------------------------------------------------------------
@@ -300,7 +318,8 @@ namespace hpl {
 	void cVideoStreamTheora::Stop()
 	{
 		mbPlaying = false;
-		ResetStreams();
+		StopDecodeThread();
+		Rewind();
 	}
 
 	//-----------------------------------------------------------------------
@@ -321,146 +340,349 @@ namespace hpl {
 
 	void cVideoStreamTheora::CopyToTexture(iTexture *apTexture)
 	{
-		if(mbVideoLoaded==false || mpFrameBuffer ==NULL) return;
+		if(mbVideoLoaded==false || mvFrames.empty()) return;
 
 		if(mbVideoFrameReady)
 		{
-			DrawFrameToBuffer();
-			apTexture->SetRawData(0,0,cVector3l(mvSize.x,mvSize.y,1) ,ePixelFormat_RGB,mpFrameBuffer);
+			//Only the main thread removes frames, so the front frame is safe to read.
+			apTexture->SetRawData(0,0,cVector3l(mvSize.x,mvSize.y,1) ,ePixelFormat_RGBA,mvFrames[mlFirstFrame].mpData);
 			mbVideoFrameReady = false;
 		}
 	}
 
 	//-----------------------------------------------------------------------
 
-	//////////////////////////////////////////////////////////////////////////
-	// PRIVATE METHODS
-	//////////////////////////////////////////////////////////////////////////
+	void cVideoStreamTheora::UpdateThread()
+	{
+		while(mbDecodeFinished==false)
+		{
+			////////////////////////////////
+			// Get a free frame, if ring is full wait until next update.
+			mpFrameMutex->Lock();
+			bool bFull = mlFrameNum >= kVideoFrameRingSize;
+			int lFrame = (mlFirstFrame + mlFrameNum) % kVideoFrameRingSize;
+			mpFrameMutex->Unlock();
+
+			if(bFull) return;
+
+			////////////////////////////////
+			// Decode next frame, at end of file restart or stop.
+			if(DecodeFrame()==false)
+			{
+				if(mbLooping)
+				{
+					mfDecodeTimeOffset = mfLastFrameTime;
+					ResetStreams();
+					continue;
+				}
+
+				mpFrameMutex->Lock();
+				mbDecodeFinished = true;
+				mpFrameMutex->Unlock();
+				return;
+			}
+
+			////////////////////////////////
+			// Convert and add to ring
+			yuv_buffer yuvBuffer;
+			theora_decode_YUVout(&mTheoraState,&yuvBuffer);
+
+			cVideoStreamTheoraFrame &frame = mvFrames[lFrame];
+			ConvertYuvToRgba(yuvBuffer, mTheoraInfo, mvSize, frame.mpData, mpLoader, mbUseSimdYuvConversion);
+			frame.mfTime = mfVideobufTime + mfDecodeTimeOffset;
+			frame.mlId = mlNextFrameId++;
+			mfLastFrameTime = frame.mfTime;
+
+			mpFrameMutex->Lock();
+			++mlFrameNum;
+			mpFrameMutex->Unlock();
+		}
+	}
 
 	//-----------------------------------------------------------------------
 
-	void cVideoStreamTheora::DrawFrameToBuffer()
+	bool cVideoStreamTheora::SimdYuvConversionSupported()
 	{
-		////////////////////////////////
-		//Get YUV buffer
-		yuv_buffer yuvBuffer;
-		theora_decode_YUVout(&mTheoraState,&yuvBuffer);
-		
-		/////////////////////////////
-		// Set up variables
+	#ifdef HPL_VIDEO_USE_SSE2
+		return true;
+	#else
+		return false;
+	#endif
+	}
 
-		//This is offsets in the SOURCE DATA
-		size_t lCropOffsetY = mTheoraInfo.offset_x + yuvBuffer.y_stride * mTheoraInfo.offset_y;
-		size_t lCropOffsetUV = mTheoraInfo.offset_x/2 + yuvBuffer.uv_stride * (mTheoraInfo.offset_y/2);
+	//-----------------------------------------------------------------------
 
-		//Pointers to conversion buffers.
-		unsigned char* pYuvToR = mpLoader->mpYuvToR;
-		unsigned char* pYuvToB = mpLoader->mpYuvToB;
+	void cVideoStreamTheora::MeasureYuvConversion(const cVector2l& avSize, int alFrames, double *apTableFps, double *apSimdFps, int *apMaxDiff)
+	{
+		////////////////////////////
+		// Generate a 4:2:0 frame, the same noise every time
+		cVector2l vUVSize = avSize / 2;
+		std::vector<unsigned char> vY(avSize.x * avSize.y);
+		std::vector<unsigned char> vU(vUVSize.x * vUVSize.y);
+		std::vector<unsigned char> vV(vUVSize.x * vUVSize.y);
+
+		unsigned int lSeed = 12345;
+		for(size_t i=0; i<vY.size(); ++i){ lSeed = lSeed*1103515245 + 12345; vY[i] = (unsigned char)(lSeed >> 16);}
+		for(size_t i=0; i<vU.size(); ++i){ lSeed = lSeed*1103515245 + 12345; vU[i] = (unsigned char)(lSeed >> 16);}
+		for(size_t i=0; i<vV.size(); ++i){ lSeed = lSeed*1103515245 + 12345; vV[i] = (unsigned char)(lSeed >> 16);}
+
+		yuv_buffer yuv;
+		memset(&yuv, 0, sizeof(yuv));
+		yuv.y_width = avSize.x;		yuv.y_height = avSize.y;	yuv.y_stride = avSize.x;
+		yuv.uv_width = vUVSize.x;	yuv.uv_height = vUVSize.y;	yuv.uv_stride = vUVSize.x;
+		yuv.y = &vY[0];
+		yuv.u = &vU[0];
+		yuv.v = &vV[0];
+
+		theora_info info;
+		memset(&info, 0, sizeof(info));
+		info.frame_width = avSize.x;
+		info.frame_height = avSize.y;
+
+		////////////////////////////
+		// Time both ways
+		cVideoStreamTheora_Loader *pLoader = hplNew( cVideoStreamTheora_Loader, () );
+		iTimer *pTimer = cPlatform::CreateTimer();
+
+		std::vector<unsigned char> vTableDest(avSize.x * avSize.y * 4, 0);
+		std::vector<unsigned char> vSimdDest(avSize.x * avSize.y * 4, 0);
+
+		pTimer->Start();
+		for(int i=0; i<alFrames; ++i) ConvertYuvToRgba(yuv, info, avSize, &vTableDest[0], pLoader, false);
+		pTimer->Stop();
+		*apTableFps = pTimer->GetTimeInSec() > 0 ? (double)alFrames / pTimer->GetTimeInSec() : 0;
+
+		*apSimdFps = 0;
+		*apMaxDiff = 0;
+		if(SimdYuvConversionSupported())
+		{
+			pTimer->Start();
+			for(int i=0; i<alFrames; ++i) ConvertYuvToRgba(yuv, info, avSize, &vSimdDest[0], pLoader, true);
+			pTimer->Stop();
+			*apSimdFps = pTimer->GetTimeInSec() > 0 ? (double)alFrames / pTimer->GetTimeInSec() : 0;
+
+			for(size_t i=0; i<vTableDest.size(); ++i)
+			{
+				int lDiff = cMath::Abs((int)vTableDest[i] - (int)vSimdDest[i]);
+				if(lDiff > *apMaxDiff) *apMaxDiff = lDiff;
+			}
+		}
 
-		unsigned short* pYuv_G_UV = mpLoader->mpYuv_G_UV;
-		unsigned char*  pYuv_G_Y_UV = mpLoader->mpYuv_G_Y_UV;
+		hplDelete(pTimer);
+		hplDelete(pLoader);
+	}
 
-		/////////////////////////////////
-		//Write Y to R
+	//-----------------------------------------------------------------------
 
-		//Get start of buffers
-		unsigned char *pSrcBuffer = mpFrameBuffer;
-		unsigned char *pYBuffer = yuvBuffer.y + lCropOffsetY;
-		
-		//Set up counters
-		int lXCount = mvSize.x;
-		int lYCount = mvSize.y;
-		
-		//Precalculate some values
-		const int lYBufferAdd = yuvBuffer.y_stride - mvSize.x;
+	#ifdef HPL_VIDEO_USE_SSE2
 
-		//Go through Y surface of copy to R in frame buffer
-		while(lYCount)
+	/**
+	 * Converts 16 pixels at a time with 16 bit fixed point math (6 fraction bits), returns number of pixels done.
+	 */
+	static int YuvRowToRgbaSSE2(const unsigned char *apY, const unsigned char *apU, const unsigned char *apV,
+								unsigned char *apDest, int alWidth)
+	{
+		const __m128i vZero = _mm_setzero_si128();
+		const __m128i vAlpha = _mm_set1_epi8((char)0xFF);
+		const __m128i vY16 = _mm_set1_epi16(16);
+		const __m128i vUV128 = _mm_set1_epi16(128);
+		const __m128i vYMul = _mm_set1_epi16(75);	// 1.164 * 64
+		const __m128i vRV = _mm_set1_epi16(102);	// 1.596 * 64
+		const __m128i vGU = _mm_set1_epi16(25);		// 0.391 * 64
+		const __m128i vGV = _mm_set1_epi16(52);		// 0.813 * 64
+		const __m128i vBU = _mm_set1_epi16(129);	// 2.018 * 64
+
+		int x=0;
+		for(; x+16 <= alWidth; x+=16)
 		{
-			*pSrcBuffer = *pYBuffer;
+			//Load 16 Y and 8 UV, and double the UV so there is one per pixel.
+			__m128i vY = _mm_loadu_si128((const __m128i*)(apY + x));
+			__m128i vU = _mm_loadl_epi64((const __m128i*)(apU + x/2));
+			__m128i vV = _mm_loadl_epi64((const __m128i*)(apV + x/2));
+			vU = _mm_unpacklo_epi8(vU, vU);
+			vV = _mm_unpacklo_epi8(vV, vV);
+
+			__m128i vRes[3][2];
+			for(int half=0; half<2; ++half)
+			{
+				__m128i vY16Bit = half==0 ? _mm_unpacklo_epi8(vY, vZero) : _mm_unpackhi_epi8(vY, vZero);
+				__m128i vU16Bit = half==0 ? _mm_unpacklo_epi8(vU, vZero) : _mm_unpackhi_epi8(vU, vZero);
+				__m128i vV16Bit = half==0 ? _mm_unpacklo_epi8(vV, vZero) : _mm_unpackhi_epi8(vV, vZero);
 
-			pSrcBuffer+=3;
-			pYBuffer++;
+				__m128i vYScaled = _mm_mullo_epi16(_mm_sub_epi16(vY16Bit, vY16), vYMul);
+				vU16Bit = _mm_sub_epi16(vU16Bit, vUV128);
+				vV16Bit = _mm_sub_epi16(vV16Bit, vUV128);
 
-			--lXCount;
-			if(!lXCount)
-			{
-				pYBuffer += lYBufferAdd;
-				lXCount = mvSize.x;
-				--lYCount;
+				__m128i vR = _mm_adds_epi16(vYScaled, _mm_mullo_epi16(vV16Bit, vRV));
+				__m128i vG = _mm_subs_epi16(vYScaled, _mm_add_epi16(_mm_mullo_epi16(vU16Bit, vGU), _mm_mullo_epi16(vV16Bit, vGV)));
+				__m128i vB = _mm_adds_epi16(vYScaled, _mm_mullo_epi16(vU16Bit, vBU));
+
+				vRes[0][half] = _mm_srai_epi16(vR, 6);
+				vRes[1][half] = _mm_srai_epi16(vG, 6);
+				vRes[2][half] = _mm_srai_epi16(vB, 6);
 			}
+
+			__m128i vR = _mm_packus_epi16(vRes[0][0], vRes[0][1]);
+			__m128i vG = _mm_packus_epi16(vRes[1][0], vRes[1][1]);
+			__m128i vB = _mm_packus_epi16(vRes[2][0], vRes[2][1]);
+
+			//Interleave to RGBA
+			__m128i vRGLo = _mm_unpacklo_epi8(vR, vG);
+			__m128i vRGHi = _mm_unpackhi_epi8(vR, vG);
+			__m128i vBALo = _mm_unpacklo_epi8(vB, vAlpha);
+			__m128i vBAHi = _mm_unpackhi_epi8(vB, vAlpha);
+
+			__m128i *pDest = (__m128i*)(apDest + x*4);
+			_mm_storeu_si128(pDest+0, _mm_unpacklo_epi16(vRGLo, vBALo));
+			_mm_storeu_si128(pDest+1, _mm_unpackhi_epi16(vRGLo, vBALo));
+			_mm_storeu_si128(pDest+2, _mm_unpacklo_epi16(vRGHi, vBAHi));
+			_mm_storeu_si128(pDest+3, _mm_unpackhi_epi16(vRGHi, vBAHi));
 		}
 
-		/////////////////////////////////
-		//Write UV and use R as Y
+		return x;
+	}
 
-		//Get start of buffers
-		pSrcBuffer = mpFrameBuffer;
-		unsigned char *pUBuffer = yuvBuffer.u + lCropOffsetUV;
-		unsigned char *pVBuffer = yuvBuffer.v + lCropOffsetUV;
-		
-		//Setup counters
-		lXCount = mvSize.x/2;
-		lYCount = mvSize.y/2;
-		
-		//Precalculate some values
-		const int lXRowAdd = mvSize.x/2;
-		const int lSourceRowSize = mvSize.x*3;
-		const int lUVBufferAdd = yuvBuffer.uv_stride - mvSize.x/2;
-		unsigned char y;
-		
-		//Go through UV surfaces and convert to RGB in frame buffer
-		while(lYCount)
+	#endif
+
+	//-----------------------------------------------------------------------
+
+	static void YuvRowToRgbaTable(const unsigned char *apY, const unsigned char *apU, const unsigned char *apV,
+								unsigned char *apDest, int alStart, int alWidth,
+								const unsigned char* apYuvToR, const unsigned char* apYuvToB,
+								const unsigned short* apYuv_G_UV, const unsigned char* apYuv_G_Y_UV)
+	{
+		for(int x=alStart; x<alWidth; ++x)
 		{
-			const unsigned short u_add = (*pUBuffer) <<8;
-			const unsigned short v_add = (*pVBuffer) <<8;
-			const unsigned int g_uv_add = (pYuv_G_UV[u_add + (*pVBuffer)])<<8;
-
-			//Here we draw to a 2x2 large piece of source.
-			y = *pSrcBuffer;
-			pSrcBuffer[0] = pYuvToR[y + v_add];
-			pSrcBuffer[1] = pYuv_G_Y_UV[y +(g_uv_add)];
-			pSrcBuffer[2] = pYuvToB[y + u_add];	
-
-			pSrcBuffer+= 3;
-			y = *pSrcBuffer;
-			pSrcBuffer[0] = pYuvToR[y + v_add];
-			pSrcBuffer[1] = pYuv_G_Y_UV[y +(g_uv_add)];
-			pSrcBuffer[2] = pYuvToB[y + u_add];			
-
-			pSrcBuffer += lSourceRowSize - 3;
-			y = *pSrcBuffer;
-			pSrcBuffer[0] = pYuvToR[y + v_add];
-			pSrcBuffer[1] = pYuv_G_Y_UV[y +(g_uv_add)];
-			pSrcBuffer[2] = pYuvToB[y + u_add];			
-
-			pSrcBuffer += 3;
-			y = *pSrcBuffer;
-			pSrcBuffer[0] = pYuvToR[y + v_add];
-			pSrcBuffer[1] = pYuv_G_Y_UV[y +(g_uv_add)];
-			pSrcBuffer[2] = pYuvToB[y + u_add];			
-
-			pSrcBuffer-= lSourceRowSize;
-
-			pSrcBuffer+=3;
-
-			pUBuffer++;
-			pVBuffer++;
-
-			--lXCount;
-			if(!lXCount)
+			const unsigned int y = apY[x];
+			const unsigned int u_add = apU[x/2] <<8;
+			const unsigned int v_add = apV[x/2] <<8;
+			const unsigned int g_uv_add = (apYuv_G_UV[u_add + apV[x/2]])<<8;
+
+			unsigned char *pDest = apDest + x*4;
+			pDest[0] = apYuvToR[y + v_add];
+			pDest[1] = apYuv_G_Y_UV[y + g_uv_add];
+			pDest[2] = apYuvToB[y + u_add];
+			pDest[3] = 0xFF;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cVideoStreamTheora::ConvertYuvToRgba(const yuv_buffer& aYuv, const theora_info& aInfo, const cVector2l& avSize,
+											unsigned char *apDest, cVideoStreamTheora_Loader* apLoader, bool abSimd)
+	{
+		//This is offsets in the SOURCE DATA
+		const unsigned char *pYBuffer = aYuv.y + aInfo.offset_x + aYuv.y_stride * aInfo.offset_y;
+		const unsigned char *pUBuffer = aYuv.u + aInfo.offset_x/2 + aYuv.uv_stride * (aInfo.offset_y/2);
+		const unsigned char *pVBuffer = aYuv.v + aInfo.offset_x/2 + aYuv.uv_stride * (aInfo.offset_y/2);
+
+		const int lRowSize = avSize.x*4;
+
+		//Rows are done in pairs as they share UV, same as before.
+		const int lRows = (avSize.y/2)*2;
+		for(int y=0; y<lRows; ++y)
+		{
+			const unsigned char *pY = pYBuffer + y * aYuv.y_stride;
+			const unsigned char *pU = pUBuffer + (y/2) * aYuv.uv_stride;
+			const unsigned char *pV = pVBuffer + (y/2) * aYuv.uv_stride;
+			unsigned char *pDest = apDest + y * lRowSize;
+
+			int lDone = 0;
+		#ifdef HPL_VIDEO_USE_SSE2
+			if(abSimd) lDone = YuvRowToRgbaSSE2(pY, pU, pV, pDest, avSize.x);
+		#endif
+			YuvRowToRgbaTable(pY, pU, pV, pDest, lDone, (avSize.x/2)*2,
+							apLoader->mpYuvToR, apLoader->mpYuvToB, apLoader->mpYuv_G_UV, apLoader->mpYuv_G_Y_UV);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Decodes packets until a new frame is ready. Returns false if there is no more data in the file.
+	 */
+	bool cVideoStreamTheora::DecodeFrame()
+	{
+		while(true)
+		{
+			//Get first packet and decode,
+			ogg_packet packet;
+			if(ogg_stream_packetout(&mTheoraStreamState,&packet)>0)
+			{
+				if(theora_decode_packetin(&mTheoraState,&packet)==0)
+				{
+					//Get new time for current fram position.
+					mlVideobufGranulePos = mTheoraState.granulepos;
+					mfVideobufTime = theora_granule_time(&mTheoraState,mlVideobufGranulePos);
+
+					return true;
+				}
+			}
+			//No packets left, get new page.
+			else
 			{
-				pSrcBuffer+= lSourceRowSize;
-				pVBuffer += lUVBufferAdd;
-				pUBuffer += lUVBufferAdd;
-				lXCount = lXRowAdd;
-				--lYCount;
+				//Get Next page
+				ogg_page page;
+				if(ogg_sync_pageout(&mOggSyncState,&page) > 0)
+				{
+					QueuePage(&page);	
+				}
+				//No pages left, read more buffer data.
+				else
+				{
+					int bytes= BufferData(mpFile,&mOggSyncState);
+					//Fill streams with pages.
+					if(bytes!=0)
+					{
+						while(ogg_sync_pageout(&mOggSyncState,&page)>0) QueuePage(&page);
+					}
+					//No more buffer data in file
+					else
+					{
+						return false;
+					}
+				}
 			}
 		}
 	}
 
 	//-----------------------------------------------------------------------
-	
+
+	/**
+	 * Must only be called when the decode thread is stopped.
+	 */
+	void cVideoStreamTheora::Rewind()
+	{
+		if(mbVideoLoaded==false) return;
+
+		ResetStreams();
+
+		mfTime =0;
+		mbVideoFrameReady = false;
+		
+		mlFirstFrame = 0;
+		mlFrameNum = 0;
+		mlShownFrameId = -1;
+		mbDecodeFinished = false;
+		mfDecodeTimeOffset = 0;
+		mfLastFrameTime = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cVideoStreamTheora::StopDecodeThread()
+	{
+		if(mpDecodeThread && mpDecodeThread->IsActive()) mpDecodeThread->Stop();
+	}
+
+	//-----------------------------------------------------------------------
+
 	/**
 	  * Gets BufferSize bytes to a sync buffer and checks how many bytes that
 	  * where written to it.
@@ -518,7 +740,14 @@ namespace hpl {
 
 			mvSize = cVector2l(mTheoraInfo.frame_width, mTheoraInfo.frame_height);
 
-			mpFrameBuffer = hplNewArray(unsigned char,mvSize.x * mvSize.y *3);
+			mvFrames.resize(kVideoFrameRingSize);
+			for(size_t i=0; i<mvFrames.size(); ++i)
+			{
+				mvFrames[i].mpData = hplNewArray(unsigned char,mvSize.x * mvSize.y *4);
+				memset(mvFrames[i].mpData, 0, mvSize.x * mvSize.y *4);
+				mvFrames[i].mfTime = 0;
+				mvFrames[i].mlId = -1;
+			}
 		}
 		else
 		{
@@ -549,9 +778,7 @@ namespace hpl {
 
 		////////////////////////////////
 		//Reset variables
-		mfTime =0;
 		mfVideobufTime =0;
-		mbVideoFrameReady = false;
 		
 		////////////////////////////////
 		//Clear all data structures
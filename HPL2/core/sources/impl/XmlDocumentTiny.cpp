@@ -25,9 +25,33 @@
 
 #include "impl/tinyXML/tinyxml.h"
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// HELPERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	class cSortAttributesByName
+	{
+	public:
+		cSortAttributesByName(cXmlElement *apElement) : mpElement(apElement) {}
+
+		bool operator()(int alA, int alB) const
+		{
+			return strcmp(mpElement->GetAttributeName(alA), mpElement->GetAttributeName(alB)) < 0;
+		}
+
+	private:
+		cXmlElement *mpElement;
+	};
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// PUBLIC METHODS
 	//////////////////////////////////////////////////////////////////////////
@@ -51,17 +75,27 @@ namespace hpl {
 
 	bool cXmlDocumentTiny::CreateFromString(const tString& asData)
 	{
-		TiXmlDocument *pXmlDoc = hplNew( TiXmlDocument, () );
-		
-		pXmlDoc->Parse(asData.c_str());
-		if(pXmlDoc->Error())
+		return ParseData(asData.c_str(), asData.size());
+	}
+	
+	//-----------------------------------------------------------------------
+
+	bool cXmlDocumentTiny::CreateFromFileWithTinyXML(const tWString& asPath)
+	{
+		FILE *pFile = cPlatform::OpenFile(asPath, _W("rb"));
+		if(pFile==NULL)
 		{
-			tString sErrorDesc = tString(pXmlDoc->ErrorDesc());
-			int lErrorRow = pXmlDoc->ErrorRow();
-			int lErrorCol = pXmlDoc->ErrorCol();
+			SaveErrorInfo("Failed to open file.", 0, 0);
+			return false;
+		}
 
-			SaveErrorInfo(sErrorDesc, lErrorRow, lErrorCol);
+		TiXmlDocument *pXmlDoc = hplNew( TiXmlDocument, () );
+		bool bRet = pXmlDoc->LoadFile(pFile);
+		fclose(pFile);
 
+		if(bRet==false)
+		{
+			SaveErrorInfo(pXmlDoc->ErrorDesc(), pXmlDoc->ErrorRow(), pXmlDoc->ErrorCol());
 			hplDelete( pXmlDoc );
 			return false;
 		}
@@ -72,7 +106,7 @@ namespace hpl {
 		hplDelete( pXmlDoc );
 		return true;
 	}
-	
+
 	//-----------------------------------------------------------------------
 
 	//////////////////////////////////////////////////////////////////////////
@@ -83,24 +117,26 @@ namespace hpl {
 
 	bool cXmlDocumentTiny::LoadDataFromFile(const tWString& asPath)
 	{
-		TiXmlDocument *pXmlDoc = hplNew( TiXmlDocument, () );
-		if(CreateTinyXMLFromFile(pXmlDoc,asPath)==false)
+		FILE *pFile = cPlatform::OpenFile(asPath, _W("rb"));
+		if(pFile==NULL)
 		{
-			tString sErrorDesc = tString(pXmlDoc->ErrorDesc());
-			int lErrorRow = pXmlDoc->ErrorRow();
-			int lErrorCol = pXmlDoc->ErrorCol();
-
-			SaveErrorInfo(sErrorDesc, lErrorRow, lErrorCol);
-	
-			hplDelete( pXmlDoc );
+			SaveErrorInfo("Failed to open file.", 0, 0);
 			return false;
 		}
-		
-		DestroyChildren();
-		LoadFromTinyXMLData(pXmlDoc->FirstChildElement(), this);
 
-        hplDelete( pXmlDoc );
-		return true;
+		fseek(pFile, 0, SEEK_END);
+		long lSize = ftell(pFile);
+		fseek(pFile, 0, SEEK_SET);
+		if(lSize < 0) lSize = 0;
+
+		//Read the whole file and parse it in one go, the parser wants the data 0 terminated.
+		std::vector<char> vData(lSize+1);
+		size_t lReadSize = fread(&vData[0], 1, lSize, pFile);
+		vData[lReadSize] = 0;
+
+		fclose(pFile);
+
+		return ParseData(&vData[0], lReadSize);
 	}
 
 	//-----------------------------------------------------------------------
@@ -127,7 +163,7 @@ namespace hpl {
 		//Load the attributes
 		apDestElem->SetValue(apTinyElem->Value());
 
-        TiXmlAttribute *pAttrib = apTinyElem->FirstAttribute();
+		TiXmlAttribute *pAttrib = apTinyElem->FirstAttribute();
 		for(; pAttrib != NULL; pAttrib = pAttrib->Next())
 		{
 			apDestElem->SetAttribute(pAttrib->Name(), pAttrib->Value());
@@ -139,8 +175,8 @@ namespace hpl {
 		for(; pChildElem != NULL; pChildElem = pChildElem->NextSiblingElement())
 		{
 			cXmlElement *pDestChild = apDestElem->CreateChildElement();
-			
-            LoadFromTinyXMLData(pChildElem, pDestChild);
+
+			LoadFromTinyXMLData(pChildElem, pDestChild);
 		}
 	}
 
@@ -152,11 +188,14 @@ namespace hpl {
 		//Save the attributes
 		apTinyElem->SetValue(apSrcElem->GetValue().c_str());
 
-		tAttributeMap *pAttributeMap = apSrcElem->GetAttributeMap();
-		tAttributeMapIt attrIt = pAttributeMap->begin();
-		for(; attrIt != pAttributeMap->end(); ++attrIt)
+		//Written sorted by name, which is the order saved files have always had.
+		tIntVec vOrder(apSrcElem->GetAttributeNum());
+		for(size_t i=0; i<vOrder.size(); ++i) vOrder[i] = (int)i;
+		std::sort(vOrder.begin(), vOrder.end(), cSortAttributesByName(apSrcElem));
+
+		for(size_t i=0; i<vOrder.size(); ++i)
 		{
-			apTinyElem->SetAttribute(attrIt->first.c_str(), attrIt->second.c_str());
+			apTinyElem->SetAttribute(apSrcElem->GetAttributeName(vOrder[i]), apSrcElem->GetAttributeValue(vOrder[i]));
 		}
 
 		/////////////////////////////
@@ -176,20 +215,6 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	bool cXmlDocumentTiny::CreateTinyXMLFromFile(TiXmlDocument* pDoc,const tWString& asPath)
-	{
-		FILE *pFile = cPlatform::OpenFile(asPath, _W("rb"));
-		if(pFile==NULL) return false;
-		
-		bool bRet = pDoc->LoadFile(pFile);
-
-		if(pFile) fclose(pFile);
-
-		return bRet;
-	}
-
-	//-----------------------------------------------------------------------
-
 	bool cXmlDocumentTiny::SaveTinyXMLToFile(TiXmlDocument* pDoc,const tWString& asPath)
 	{
 		if(asPath == _W("")) return false;
@@ -2492,6 +2492,19 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	cQuaternion cMath::QuaternionNlerp(float afT,const cQuaternion& aqA, const cQuaternion& aqB, 
+									bool abShortestPath)
+	{
+		float fT1 = afT;
+		if(abShortestPath && QuaternionDot(aqA,aqB) < 0.0f) fT1 = -afT;
+
+		cQuaternion qLerp(aqA * (1.0f - afT) + aqB * fT1);
+		qLerp.Normalize();
+		return qLerp;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// MATRICES
 	////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,332 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "math/TriangleBVH.h"
+
+#include "math/Math.h"
+
+#include <algorithm>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// HELPERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	#define kTriangleBVHMaxLeafTriangles 4
+	#define kTriangleBVHMaxStack 64
+
+	//-----------------------------------------------------------------------
+
+	class cTriangleBVHCentreCompare
+	{
+	public:
+		cTriangleBVHCentreCompare(const tVector3fVec *apCentres, int alAxis) : mpCentres(apCentres), mlAxis(alAxis){}
+
+		bool operator()(int alA, int alB) const
+		{
+			return (*mpCentres)[alA].v[mlAxis] < (*mpCentres)[alB].v[mlAxis];
+		}
+
+		const tVector3fVec *mpCentres;
+		int mlAxis;
+	};
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Slab test of a line against a box, afNearT is where the line enters the box (0 if start is inside).
+	 */
+	static inline bool LineIntersectsBox(	const cVector3f& avMin, const cVector3f& avMax, 
+											const cVector3f& avStart, const cVector3f& avInvDelta, float &afNearT)
+	{
+		float fNear = 0;
+		float fFar = 1;
+		for(int i=0; i<3; ++i)
+		{
+			float fT1 = (avMin.v[i] - avStart.v[i]) * avInvDelta.v[i];
+			float fT2 = (avMax.v[i] - avStart.v[i]) * avInvDelta.v[i];
+			if(fT1 > fT2) std::swap(fT1, fT2);
+
+			if(fT1 > fNear) fNear = fT1;
+			if(fT2 < fFar) fFar = fT2;
+			if(fNear > fFar) return false;
+		}
+
+		afNearT = fNear;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cTriangleBVH::cTriangleBVH()
+	{
+	}
+
+	cTriangleBVH::~cTriangleBVH()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::Build(const unsigned int* apIndexArray, int alIndexNum, const float* apVertexArray, int alVtxStride)
+	{
+		Clear();
+
+		int lTriNum = alIndexNum / 3;
+		if(lTriNum <= 0) return;
+
+		////////////////////////////
+		// Get the triangle positions and centres
+		mvPositions.resize(lTriNum*3);
+		mvCentres.resize(lTriNum);
+		mvTriIndices.resize(lTriNum);
+		for(int i=0; i<lTriNum; ++i)
+		{
+			for(int j=0; j<3; ++j)
+			{
+				const float *pVtx = &apVertexArray[apIndexArray[i*3 + j]*alVtxStride];
+				mvPositions[i*3 + j] = cVector3f(pVtx[0], pVtx[1], pVtx[2]);
+			}
+			mvCentres[i] = (mvPositions[i*3] + mvPositions[i*3+1] + mvPositions[i*3+2]) * (1.0f/3.0f);
+			mvTriIndices[i] = i;
+		}
+
+		////////////////////////////
+		// Build nodes, reserve so that references are not invalidated while building
+		mvNodes.reserve(lTriNum*2);
+		mvNodes.resize(1);
+		BuildNode(0, 0, lTriNum);
+
+		////////////////////////////
+		// Put the positions in tree order and convert to index array positions
+		tVector3fVec vSortedPositions(lTriNum*3);
+		for(int i=0; i<lTriNum; ++i)
+		{
+			int lTri = mvTriIndices[i];
+			for(int j=0; j<3; ++j) vSortedPositions[i*3 + j] = mvPositions[lTri*3 + j];
+			
+			mvTriIndices[i] = lTri*3;
+		}
+		mvPositions.swap(vSortedPositions);
+
+		mvCentres.clear();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::Clear()
+	{
+		mvNodes.clear();
+		mvTriIndices.clear();
+		mvPositions.clear();
+		mvCentres.clear();
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTriangleBVH::CheckLineIntersection(const cVector3f& avLineStart, const cVector3f& avLineEnd, float *apT, int *apTriIndex, bool abSkipBackfacing)
+	{
+		if(mvNodes.empty()) return false;
+
+		////////////////////////////
+		// Set up the inverse delta, zero components get a large value so the slab test still works
+		cVector3f vDelta = avLineEnd - avLineStart;
+		cVector3f vInvDelta;
+		for(int i=0; i<3; ++i)
+		{
+			if(std::fabs(vDelta.v[i]) > kEpsilonf)	vInvDelta.v[i] = 1.0f / vDelta.v[i];
+			else									vInvDelta.v[i] = vDelta.v[i] < 0 ? -1e30f : 1e30f;
+		}
+
+		float fMinT = 99999.0f;
+		int lHitTri = -1;
+
+		int vStack[kTriangleBVHMaxStack];
+		int lStackNum = 0;
+		vStack[lStackNum++] = 0;
+
+		////////////////////////////
+		// Traverse nodes, nearest child first so that the far one can often be skipped
+		while(lStackNum > 0)
+		{
+			const cTriangleBVHNode& node = mvNodes[vStack[--lStackNum]];
+
+			float fNearT;
+			if(LineIntersectsBox(node.mvMin, node.mvMax, avLineStart, vInvDelta, fNearT)==false || fNearT > fMinT) continue;
+
+			/////////////////////
+			// Leaf
+			if(node.mlNum > 0)
+			{
+				for(int i=node.mlFirst; i<node.mlFirst + node.mlNum; ++i)
+				{
+					float fT;
+					if(	cMath::CheckLineTriangleIntersection(	avLineStart, avLineEnd, mvPositions[i*3], mvPositions[i*3+1], mvPositions[i*3+2],
+															&fT, abSkipBackfacing) && fT < fMinT)
+					{
+						fMinT = fT;
+						lHitTri = i;
+					}
+				}
+			}
+			/////////////////////
+			// Inner node
+			else
+			{
+				float fT1, fT2;
+				bool bHit1 = LineIntersectsBox(mvNodes[node.mlFirst].mvMin, mvNodes[node.mlFirst].mvMax, avLineStart, vInvDelta, fT1);
+				bool bHit2 = LineIntersectsBox(mvNodes[node.mlFirst+1].mvMin, mvNodes[node.mlFirst+1].mvMax, avLineStart, vInvDelta, fT2);
+
+				if(bHit1 && bHit2)
+				{
+					if(fT1 <= fT2)	{ vStack[lStackNum++] = node.mlFirst+1; vStack[lStackNum++] = node.mlFirst; }
+					else			{ vStack[lStackNum++] = node.mlFirst; vStack[lStackNum++] = node.mlFirst+1; }
+				}
+				else if(bHit1)	vStack[lStackNum++] = node.mlFirst;
+				else if(bHit2)	vStack[lStackNum++] = node.mlFirst+1;
+			}
+		}
+
+		if(lHitTri < 0) return false;
+
+		if(apT) *apT = fMinT;
+		if(apTriIndex) *apTriIndex = mvTriIndices[lHitTri];
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::GetTrianglesInAABB(const cVector3f& avMin, const cVector3f& avMax, tIntVec& avTriIndices)
+	{
+		if(mvNodes.empty()) return;
+
+		int vStack[kTriangleBVHMaxStack];
+		int lStackNum = 0;
+		vStack[lStackNum++] = 0;
+
+		while(lStackNum > 0)
+		{
+			const cTriangleBVHNode& node = mvNodes[vStack[--lStackNum]];
+			if(cMath::CheckAABBIntersection(node.mvMin, node.mvMax, avMin, avMax)==false) continue;
+
+			/////////////////////
+			// Leaf
+			if(node.mlNum > 0)
+			{
+				for(int i=node.mlFirst; i<node.mlFirst + node.mlNum; ++i)
+				{
+					const cVector3f& vP0 = mvPositions[i*3];
+					const cVector3f& vP1 = mvPositions[i*3+1];
+					const cVector3f& vP2 = mvPositions[i*3+2];
+
+					cVector3f vTriMin( cMath::Min(vP0.x, cMath::Min(vP1.x, vP2.x)), cMath::Min(vP0.y, cMath::Min(vP1.y, vP2.y)), cMath::Min(vP0.z, cMath::Min(vP1.z, vP2.z)));
+					cVector3f vTriMax( cMath::Max(vP0.x, cMath::Max(vP1.x, vP2.x)), cMath::Max(vP0.y, cMath::Max(vP1.y, vP2.y)), cMath::Max(vP0.z, cMath::Max(vP1.z, vP2.z)));
+					
+					if(cMath::CheckAABBIntersection(vTriMin, vTriMax, avMin, avMax))
+						avTriIndices.push_back(mvTriIndices[i]);
+				}
+			}
+			/////////////////////
+			// Inner node
+			else
+			{
+				vStack[lStackNum++] = node.mlFirst;
+				vStack[lStackNum++] = node.mlFirst+1;
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::BuildNode(int alNode, int alFirst, int alNum)
+	{
+		cTriangleBVHNode& node = mvNodes[alNode];
+
+		////////////////////////////
+		// Get bounds of the triangles and of their centres
+		cVector3f vCentreMin = mvCentres[mvTriIndices[alFirst]];
+		cVector3f vCentreMax = vCentreMin;
+		node.mvMin = mvPositions[mvTriIndices[alFirst]*3];
+		node.mvMax = node.mvMin;
+		for(int i=alFirst; i<alFirst + alNum; ++i)
+		{
+			int lTri = mvTriIndices[i];
+			for(int j=0; j<3; ++j)
+			{
+				const cVector3f& vPos = mvPositions[lTri*3 + j];
+				node.mvMin = cVector3f(cMath::Min(node.mvMin.x, vPos.x), cMath::Min(node.mvMin.y, vPos.y), cMath::Min(node.mvMin.z, vPos.z));
+				node.mvMax = cVector3f(cMath::Max(node.mvMax.x, vPos.x), cMath::Max(node.mvMax.y, vPos.y), cMath::Max(node.mvMax.z, vPos.z));
+			}
+
+			const cVector3f& vCentre = mvCentres[lTri];
+			vCentreMin = cVector3f(cMath::Min(vCentreMin.x, vCentre.x), cMath::Min(vCentreMin.y, vCentre.y), cMath::Min(vCentreMin.z, vCentre.z));
+			vCentreMax = cVector3f(cMath::Max(vCentreMax.x, vCentre.x), cMath::Max(vCentreMax.y, vCentre.y), cMath::Max(vCentreMax.z, vCentre.z));
+		}
+
+		////////////////////////////
+		// Split on the median along the longest centre axis, unless few enough for a leaf
+		cVector3f vExtent = vCentreMax - vCentreMin;
+		int lAxis = 0;
+		if(vExtent.y > vExtent.v[lAxis]) lAxis = 1;
+		if(vExtent.z > vExtent.v[lAxis]) lAxis = 2;
+
+		if(alNum <= kTriangleBVHMaxLeafTriangles || vExtent.v[lAxis] <= 0)
+		{
+			node.mlFirst = alFirst;
+			node.mlNum = alNum;
+			return;
+		}
+
+		int lMid = alFirst + alNum/2;
+		std::nth_element(	mvTriIndices.begin()+alFirst, mvTriIndices.begin()+lMid, mvTriIndices.begin()+alFirst+alNum,
+							cTriangleBVHCentreCompare(&mvCentres, lAxis));
+
+		int lChild = (int)mvNodes.size();
+		node.mlFirst = lChild;
+		node.mlNum = 0;
+		mvNodes.resize(lChild + 2);
+
+		BuildNode(lChild, alFirst, lMid - alFirst);
+		BuildNode(lChild+1, lMid, alFirst + alNum - lMid);
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -47,6 +47,7 @@ namespace hpl {
 		mfImpactDuration = 0.4f;
 
 		mbLog = false;
+		mlWorldThreadNum = 1;
 	}
 
 	//-----------------------------------------------------------------------
@@ -89,6 +90,8 @@ namespace hpl {
 		iPhysicsWorld * pWorld = mpLowLevelPhysics->CreateWorld();
 		mlstWorlds.push_back(pWorld);
 
+		if(mlWorldThreadNum > 1) pWorld->SetNumberOfThreads(mlWorldThreadNum);
+
 		if(abAddSurfaceData)
 		{
 			tSurfaceDataMapIt it = m_mapSurfaceData.begin();
@@ -79,7 +79,7 @@ namespace hpl {
 		mlSlideCount = 0;
 		mlImpactCount = 0;
 
-		mbInUpdateList = false;
+		mlUpdateListIndex = -1;
 
 		mlPushStrength = 0;
 
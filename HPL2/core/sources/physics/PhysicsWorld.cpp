@@ -46,6 +46,10 @@ namespace hpl {
 	iPhysicsWorld::iPhysicsWorld()
 	{
 		mbLogDebug = false;
+		mbIteratingUpdateBodies = false;
+
+		mlShapeCollisionPairCount =0;
+		mlShapeCollisionPairCulledCount =0;
 	}
 
 	//-----------------------------------------------------------------------
@@ -68,6 +72,9 @@ namespace hpl {
 		//Clear all contact points.
 		mvContactPoints.clear();
 
+		mlShapeCollisionPairCount =0;
+		mlShapeCollisionPairCulledCount =0;
+
 		////////////////////////////////////
 		//Update controllers
 		for(tPhysicsControllerListIt CtrlIt = mlstControllers.begin(); CtrlIt != mlstControllers.end(); ++CtrlIt)
@@ -101,28 +108,19 @@ namespace hpl {
 		////////////////////////////////////
 		//Update the rigid bodies before simulation.
 		START_TIMING(BodyBeforeSimulate)
-		tPhysicsBodyList lstRemoveUpdateBodies;
-		for(tPhysicsBodySetIt BodyIt = m_setUpdateBodies.begin(); BodyIt != m_setUpdateBodies.end(); ++BodyIt)
+		mbIteratingUpdateBodies = true;
+		for(size_t i=0; i<mvUpdateBodies.size(); ++i)
 		{
-			iPhysicsBody *pBody = *BodyIt;
+			iPhysicsBody *pBody = mvUpdateBodies[i];
+			if(pBody==NULL) continue;
 
 			if(pBody->UpdateBeforeSimulate(afTimeStep)==false)
 			{
-				//Add to remove list
-				lstRemoveUpdateBodies.push_back(pBody);
-			}
-		}
-				
-		//Iterate remove list and remove all bodies in it from the update list.
-        if(lstRemoveUpdateBodies.empty()==false)
-		{
-			for(tPhysicsBodyListIt it = lstRemoveUpdateBodies.begin(); it != lstRemoveUpdateBodies.end(); ++it)
-			{
-				iPhysicsBody *pBody = *it;
-
 				RemoveBodyFromUpdateList(pBody, false);
 			}
 		}
+		mbIteratingUpdateBodies = false;
+		CompactUpdateBodies();
 		STOP_TIMING(BodyBeforeSimulate)
 		
 
@@ -157,12 +155,16 @@ namespace hpl {
 		////////////////////////////////////
 		//Update the rigid bodies after simulation.
 		START_TIMING(BodyAfterSimulate)	
-		for(tPhysicsBodySetIt BodyIt = m_setUpdateBodies.begin(); BodyIt != m_setUpdateBodies.end(); ++BodyIt)
+		mbIteratingUpdateBodies = true;
+		for(size_t i=0; i<mvUpdateBodies.size(); ++i)
 		{
-			iPhysicsBody *pBody = *BodyIt;
+			iPhysicsBody *pBody = mvUpdateBodies[i];
+			if(pBody==NULL) continue; //Removed by a callback during the loop
 			
 			pBody->UpdateAfterSimulate(afTimeStep);
 		}
+		mbIteratingUpdateBodies = false;
+		CompactUpdateBodies();
 		STOP_TIMING(BodyAfterSimulate)	
 
 		////////////////////////////////////
@@ -201,6 +203,7 @@ namespace hpl {
 				pBody->Destroy();
 				hplDelete(pBody);
 				mlstBodies.erase(it);
+				mStats.mlBodyNum--;
 				return;
 			}
 		}
@@ -240,8 +243,8 @@ namespace hpl {
 	{
 		if(apBody->IsInUpdateList()) return;
 
-		m_setUpdateBodies.insert(apBody);
-		apBody->SetInUpdateList(true);
+		apBody->SetUpdateListIndex((int)mvUpdateBodies.size());
+		mvUpdateBodies.push_back(apBody);
 	}
 
 	//NOTE: Skipping removing dynamic bodies for now since they will need to be checked if enabled 
@@ -250,8 +253,39 @@ namespace hpl {
 	{
 		if(apBody->IsInUpdateList()==false) return;
 
-		m_setUpdateBodies.erase(apBody);
-		apBody->SetInUpdateList(false);
+		int lIdx = apBody->GetUpdateListIndex();
+		apBody->SetUpdateListIndex(-1);
+
+		//Bodies are updated by index, so only clear the slot while iterating. CompactUpdateBodies removes it later.
+		if(mbIteratingUpdateBodies)
+		{
+			mvUpdateBodies[lIdx] = NULL;
+			return;
+		}
+
+		//Swap with the last body so the array stays dense.
+		iPhysicsBody *pLastBody = mvUpdateBodies.back();
+		mvUpdateBodies.pop_back();
+		if(pLastBody == apBody) return;
+
+		mvUpdateBodies[lIdx] = pLastBody;
+		pLastBody->SetUpdateListIndex(lIdx);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iPhysicsWorld::CompactUpdateBodies()
+	{
+		size_t lCount =0;
+		for(size_t i=0; i<mvUpdateBodies.size(); ++i)
+		{
+			iPhysicsBody *pBody = mvUpdateBodies[i];
+			if(pBody==NULL) continue;
+
+			pBody->SetUpdateListIndex((int)lCount);
+			mvUpdateBodies[lCount++] = pBody;
+		}
+		mvUpdateBodies.resize(lCount);
 	}
 
 	//-----------------------------------------------------------------------
@@ -359,7 +393,8 @@ namespace hpl {
 			hplDelete(pBody);
 		}
 		mlstBodies.clear();
-		m_setUpdateBodies.clear();
+		mvUpdateBodies.clear();
+		mStats.mlBodyNum =0;
 
 		STLDeleteAll(mlstRopes);
 
@@ -83,11 +83,11 @@ namespace hpl {
 		for(tWStringListIt it = lstFileNames.begin();it!=lstFileNames.end();it++)
 		{
 			tWString& sFile = *it;
-			tString sLowFile = cString::ToLowerCase(cString::To8Char(sFile));
+			tNameId lFileId = cNameTable::GetId(cString::To8Char(sFile));
 			tWString sFilePath = cString::ReplaceCharToW( cPlatform::GetFullFilePath( cString::SetFilePathW(sFile,sPath)), _W("\\"),_W("/"));;
 			
 			//Check if file and path already exist
-			tFilePathMapIt pathIt = m_mapFiles.find(sLowFile);
+			tFilePathMapIt pathIt = m_mapFiles.find(lFileId);
 			if(pathIt != m_mapFiles.end() && pathIt->second.msPath == sFilePath)
 			{
 				continue;
@@ -96,7 +96,7 @@ namespace hpl {
 			//Add file
 			//Log("Adding lowercase file: '%s' with path: '%s'\n 8bitHash: %u 16bitHash %u\n", sLowFile.c_str(), cString::To8Char(sFilePath).c_str(),
 			//	cString::GetHash(cString::To8Char(sFilePath)), cString::GetHashW(sFilePath));
-			m_mapFiles.insert(tFilePathMap::value_type(sLowFile, cFileSearcherEntry(sFilePath) ));
+			m_mapFiles.insert(tFilePathMap::value_type(lFileId, cFileSearcherEntry(sFilePath) ));
 		}
 		
 		//////////////////////////////////
@@ -127,12 +127,16 @@ namespace hpl {
 
 	const tWString& cFileSearcher::GetFilePath(const tString& asFileNameAndPath, int *apEqualCount)
 	{
-		tString sFile = cString::GetFileName(asFileNameAndPath);
-		tString sLowName = cString::ToLowerCase(sFile);
+		//////////////////////
+		//Get the id of the file name part, all added files are interned so an unknown name is not found.
+		size_t lNameStart = asFileNameAndPath.find_last_of("/\\");
+		lNameStart = lNameStart == tString::npos ? 0 : lNameStart+1;
 
+		tNameId lFileId = cNameTable::FindId(asFileNameAndPath.c_str() + lNameStart, asFileNameAndPath.size() - lNameStart);
+		
 		//////////////////////
 		//Get the iterator to path
-		tFilePathMapIt it = m_mapFiles.find(sLowName);
+		tFilePathMapIt it = lFileId==kNameId_None ? m_mapFiles.end() : m_mapFiles.find(lFileId);
 		if(it == m_mapFiles.end())
 		{
 			if(apEqualCount) *apEqualCount = 0;
@@ -142,7 +146,7 @@ namespace hpl {
 		//////////////////////
 		//Count the number of files with same name
 		//if 1, just return it.
-		size_t lCount = m_mapFiles.count(sLowName);
+		size_t lCount = m_mapFiles.count(lFileId);
 		if(lCount==1 && apEqualCount==NULL)
 		{
 			return it->second.msPath;
@@ -33,8 +33,60 @@
 #include <io.h>
 #endif
 
+#include <stdio.h>
+
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// HELPERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	static void AddVarsToKey(tString *apKey, cParserVarContainer *apVars)
+	{
+		tParseVarMap *pVarMap = apVars->GetMapPtr();
+		for(tParseVarMapIt it = pVarMap->begin(); it != pVarMap->end(); ++it)
+		{
+			*apKey += it->first;
+			*apKey += "=";
+			*apKey += it->second;
+			*apKey += ";";
+		}
+		*apKey += "\n";
+	}
+
+	//-----------------------------------------------------------------------
+
+	static void WriteInt(FILE *apFile, int alX)
+	{
+		fwrite(&alX, sizeof(int), 1, apFile);
+	}
+
+	static void WriteString(FILE *apFile, const tString& asX)
+	{
+		WriteInt(apFile, (int)asX.size());
+		if(asX.empty()==false) fwrite(asX.c_str(), 1, asX.size(), apFile);
+	}
+
+	static bool ReadInt(FILE *apFile, int *apX)
+	{
+		return fread(apX, sizeof(int), 1, apFile) == 1;
+	}
+
+	static bool ReadString(FILE *apFile, tString *apX)
+	{
+		int lSize=0;
+		if(ReadInt(apFile, &lSize)==false || lSize < 0) return false;
+
+		apX->resize(lSize);
+		if(lSize==0) return true;
+
+		return fread(&(*apX)[0], 1, lSize, apFile) == (size_t)lSize;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -65,6 +117,8 @@ namespace hpl {
 	{
 		hplDelete(mpPreprocessParser);
 
+		ClearParsedSourceCache();
+
 		DestroyAll();
 
 		Log(" Done with Gpu programs\n");
@@ -108,9 +162,6 @@ namespace hpl {
         // If we have a variable container do NOT add the shader as a resource!
 		if(apVarContainer)
 		{
-			tString sFileData;
-			tString sParsedOutput;
-		
 			/////////////////////////////////
 			//Get file from file searcher
 			tWString sPath = mpFileSearcher->GetFilePath(asName);
@@ -121,22 +172,15 @@ namespace hpl {
 			}
 
 			/////////////////////////////////
-			//Load data
-			unsigned int lFileSize = cPlatform::GetFileSize(sPath);
-
-			sFileData.resize(lFileSize);
-			cPlatform::CopyFileToBuffer(sPath,&sFileData[0],lFileSize);
-
-			/////////////////////////////////
-			//Parse file
-			mpPreprocessParser->Parse(&sFileData, &sParsedOutput,apVarContainer,cString::GetFilePathW(sPath));
+			//Get parsed source, only parsed the first time a combo is used
+			cParsedShaderSource *pSource = GetParsedSource(sPath, apVarContainer);
 			
 			/////////////////////////////////
 			//Compile
 			pShader = mpLowLevelGraphics->CreateGpuShader(asName, aType);
 			pShader->SetFullPath(sPath);
 			
-			if(pShader->CreateFromString(sParsedOutput.c_str())==false)
+			if(pShader->CreateFromString(pSource->msOutput.c_str())==false)
 			{
 				Error("Couldn't create program '%s'\n",asName.c_str());
 				hplDelete(pShader);
@@ -148,24 +192,9 @@ namespace hpl {
 			//Sampler to texture units setup, if needed
 			if(aType == eGpuShaderType_Fragment && pShader->SamplerNeedsTextureUnitSetup())
 			{
-				tParseVarMap *pVarMap = mpPreprocessParser->GetParsingVarContainer()->GetMapPtr();
-				tParseVarMapIt varIt = pVarMap->begin();
-				for(; varIt != pVarMap->end(); ++varIt)
+				for(size_t i=0; i<pSource->mvSamplerNames.size(); ++i)
 				{
-					const tString& sVarName = varIt->first;
-					const tString& sVarVal = varIt->second;
-					if(sVarName == "") continue;
-                    
-					tStringVec vStrings;
-					tString sSepp = "_";
-					cString::GetStringVec(sVarName,vStrings,&sSepp);
-					if(vStrings.size()>=2 && vStrings[0]=="sampler")
-					{
-						int lUnit = cString::ToInt(sVarVal.c_str(), 0);
-						
-						pShader->AddSamplerUnit(vStrings[1], lUnit);
-					}
-					
+					pShader->AddSamplerUnit(pSource->mvSamplerNames[i], pSource->mvSamplerUnits[i]);
 				}
 			}
 		}
@@ -220,6 +249,29 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cGpuShaderManager::SetParsedSourceCacheDir(const tWString& asDir)
+	{
+		if(asDir==_W(""))
+		{
+			msParsedSourceCacheDir = asDir;
+			return;
+		}
+
+		msParsedSourceCacheDir = cString::AddSlashAtEndW(asDir);
+		if(cPlatform::FolderExists(msParsedSourceCacheDir)==false)
+		{
+			cPlatform::CreateFolder(msParsedSourceCacheDir);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cGpuShaderManager::ClearParsedSourceCache()
+	{
+		STLMapDeleteAll(m_mapParsedSources);
+		m_mapFileData.clear();
+	}
+
 	//-----------------------------------------------------------------------
 
 	//////////////////////////////////////////////////////////////////////////
@@ -248,5 +300,174 @@ namespace hpl {
 		return bRet;
 	}
 	
+	//-----------------------------------------------------------------------
+	cParsedShaderSource* cGpuShaderManager::GetParsedSource(const tWString& asPath, cParserVarContainer *apVarContainer)
+	{
+		/////////////////////////////////
+		//Key is the file and all variables the parser can see
+		tString sKey = cString::To8Char(asPath) + "\n";
+		AddVarsToKey(&sKey, mpPreprocessParser->GetEnvVarContainer());
+		AddVarsToKey(&sKey, apVarContainer);
+
+		tParsedShaderSourceMapIt it = m_mapParsedSources.find(sKey);
+		if(it != m_mapParsedSources.end()) return it->second;
+
+		cParsedShaderSource *pSource = hplNew(cParsedShaderSource, () );
+		m_mapParsedSources.insert(tParsedShaderSourceMap::value_type(sKey, pSource));
+
+		const tString& sFileData = GetFileData(asPath);
+
+		/////////////////////////////////
+		//Check saved sources, the text of the file is part of the key so changed files are parsed again.
+		//Included files depend on the variables, so those are saved with the source and checked when loading.
+		tString sDiskKey;
+		tWString sDiskFile;
+		if(msParsedSourceCacheDir != _W(""))
+		{
+			sDiskKey = "v2\n" + sKey + cString::ToString((int)cString::GetHash(sFileData));
+
+			char sHash[16];
+			sprintf(sHash, "_%08x", cString::GetHash(sDiskKey));
+			sDiskFile = msParsedSourceCacheDir + cString::SetFileExtW(cString::GetFileNameW(asPath),_W("")) + 
+						cString::To16Char(sHash) + _W(".pss");
+
+			if(LoadParsedSourceFromDisk(sDiskFile, sDiskKey, pSource)) return pSource;
+		}
+
+		/////////////////////////////////
+		//Parse file
+		mpPreprocessParser->Parse(&sFileData, &pSource->msOutput, apVarContainer, cString::GetFilePathW(asPath));
+		pSource->mvIncludedFiles = mpPreprocessParser->GetIncludedFiles();
+
+		/////////////////////////////////
+		//Sampler to texture units set in the file (sampler_Name = unit)
+		tParseVarMap *pVarMap = mpPreprocessParser->GetParsingVarContainer()->GetMapPtr();
+		tParseVarMapIt varIt = pVarMap->begin();
+		for(; varIt != pVarMap->end(); ++varIt)
+		{
+			const tString& sVarName = varIt->first;
+			const tString& sVarVal = varIt->second;
+			if(sVarName == "") continue;
+            
+			tStringVec vStrings;
+			tString sSepp = "_";
+			cString::GetStringVec(sVarName,vStrings,&sSepp);
+			if(vStrings.size()>=2 && vStrings[0]=="sampler")
+			{
+				pSource->mvSamplerNames.push_back(vStrings[1]);
+				pSource->mvSamplerUnits.push_back(cString::ToInt(sVarVal.c_str(), 0));
+			}
+		}
+
+		if(sDiskFile != _W("")) SaveParsedSourceToDisk(sDiskFile, sDiskKey, pSource);
+
+		return pSource;
+	}
+
+	//-----------------------------------------------------------------------
+
+	const tString& cGpuShaderManager::GetFileData(const tWString& asPath)
+	{
+		tShaderFileDataMapIt it = m_mapFileData.find(asPath);
+		if(it != m_mapFileData.end()) return it->second;
+
+		tString& sFileData = m_mapFileData[asPath];
+
+		unsigned int lFileSize = cPlatform::GetFileSize(asPath);
+		sFileData.resize(lFileSize);
+		if(lFileSize > 0) cPlatform::CopyFileToBuffer(asPath,&sFileData[0],lFileSize);
+
+		return sFileData;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cGpuShaderManager::LoadParsedSourceFromDisk(const tWString& asFile, const tString& asKey, cParsedShaderSource *apSource)
+	{
+		FILE *pFile = cPlatform::OpenFile(asFile, _W("rb"));
+		if(pFile==NULL) return false;
+
+		/////////////////////////////////
+		//Key must match exactly, the hash in the file name can collide
+		tString sKey;
+		bool bOk = ReadString(pFile, &sKey) && sKey == asKey;
+
+		int lSamplerNum=0;
+		/////////////////////////////////
+		//Included files must have the same text as when saved
+		int lIncludeNum=0;
+		if(bOk) bOk = ReadInt(pFile, &lIncludeNum) && lIncludeNum >= 0;
+
+		for(int i=0; bOk && i<lIncludeNum; ++i)
+		{
+			tString sFile;
+			int lHash=0;
+			bOk = ReadString(pFile, &sFile) && ReadInt(pFile, &lHash);
+			if(bOk)
+			{
+				tWString sIncludePath = cString::To16Char(sFile);
+				bOk = (int)cString::GetHash(GetFileData(sIncludePath)) == lHash;
+				if(bOk) apSource->mvIncludedFiles.push_back(sIncludePath);
+			}
+		}
+
+		if(bOk) bOk = ReadInt(pFile, &lSamplerNum) && lSamplerNum >= 0;
+		
+		for(int i=0; bOk && i<lSamplerNum; ++i)
+		{
+			tString sName;
+			int lUnit=0;
+			bOk = ReadString(pFile, &sName) && ReadInt(pFile, &lUnit);
+			if(bOk)
+			{
+				apSource->mvSamplerNames.push_back(sName);
+				apSource->mvSamplerUnits.push_back(lUnit);
+			}
+		}
+
+		if(bOk) bOk = ReadString(pFile, &apSource->msOutput);
+
+		fclose(pFile);
+
+		if(bOk==false)
+		{
+			apSource->msOutput.clear();
+			apSource->mvSamplerNames.clear();
+			apSource->mvSamplerUnits.clear();
+			apSource->mvIncludedFiles.clear();
+		}
+
+		return bOk;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cGpuShaderManager::SaveParsedSourceToDisk(const tWString& asFile, const tString& asKey, cParsedShaderSource *apSource)
+	{
+		FILE *pFile = cPlatform::OpenFile(asFile, _W("wb"));
+		if(pFile==NULL) return;
+
+		WriteString(pFile, asKey);
+
+		WriteInt(pFile, (int)apSource->mvIncludedFiles.size());
+		for(size_t i=0; i<apSource->mvIncludedFiles.size(); ++i)
+		{
+			const tWString& sIncludePath = apSource->mvIncludedFiles[i];
+			WriteString(pFile, cString::To8Char(sIncludePath));
+			WriteInt(pFile, (int)cString::GetHash(GetFileData(sIncludePath)));
+		}
+
+		WriteInt(pFile, (int)apSource->mvSamplerNames.size());
+		for(size_t i=0; i<apSource->mvSamplerNames.size(); ++i)
+		{
+			WriteString(pFile, apSource->mvSamplerNames[i]);
+			WriteInt(pFile, apSource->mvSamplerUnits[i]);
+		}
+
+		WriteString(pFile, apSource->msOutput);
+
+		fclose(pFile);
+	}
+	
 	//-----------------------------------------------------------------------
 }
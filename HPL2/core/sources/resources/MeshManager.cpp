@@ -46,6 +46,8 @@ namespace hpl {
 
 		msFastloadMaterial = "";
 		mbUseFastloadMaterial = false;
+		mbOptimizeVertexCache = false;
+		mbCompactVertexFormat = false;
 	}
 
 	cMeshManager::~cMeshManager()
@@ -27,6 +27,8 @@
 #include "sound/SoundHandler.h"
 #include "sound/SoundChannel.h"
 
+#include <algorithm>
+
 namespace hpl {
 
 	//////////////////////////////////////////////////////////////////////////
@@ -66,7 +68,21 @@ namespace hpl {
 			return;
 		}
 
-		pData->PreloadSounds();
+		pData->PrefetchSounds();
+		mvPreloadQueue.push_back(pData);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSoundEntityManager::FlushPreloads()
+	{
+		if(mvPreloadQueue.empty()) return;
+
+		for(size_t i=0; i<mvPreloadQueue.size(); ++i)
+		{
+			mvPreloadQueue[i]->PreloadSounds();
+		}
+		mvPreloadQueue.clear();
 	}
 
 	//-----------------------------------------------------------------------
@@ -118,6 +134,9 @@ namespace hpl {
 		apResource->DecUserCount();
 
 		if(apResource->HasUsers()==false){
+			std::vector<cSoundEntityData*>::iterator it = std::find(mvPreloadQueue.begin(), mvPreloadQueue.end(), apResource);
+			if(it != mvPreloadQueue.end()) mvPreloadQueue.erase(it);
+
 			RemoveResource(apResource);
 			hplDelete(apResource);
 		}
@@ -25,9 +25,43 @@
 #include "sound/SoundData.h"
 #include "sound/LowLevelSound.h"
 #include "resources/FileSearcher.h"
+#include "system/JobPool.h"
+#include "system/Platform.h"
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// PREFETCH JOB
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Reads through a sound file so it is in the OS file cache when the sample is loaded.
+	 * Decoding is done when loading, which OALWrapper only does from file on the main thread.
+	 */
+	class cSoundPrefetchJob : public iJob
+	{
+	public:
+		cSoundPrefetchJob(const tWString& asPath) : msPath(asPath) {}
+
+		void Run()
+		{
+			FILE *pFile = cPlatform::OpenFile(msPath, _W("rb"));
+			if(pFile==NULL) return;
+
+			char vBuffer[16*1024];
+			while(fread(vBuffer, 1, sizeof(vBuffer), pFile) == sizeof(vBuffer)) {}
+
+			fclose(pFile);
+		}
+
+	private:
+		tWString msPath;
+	};
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -42,10 +76,20 @@ namespace hpl {
 		mpResources = apResources;
 
 		mpSound->GetLowLevel()->GetSupportedFormats(mlstFileFormats);
+
+		//One thread is enough, the jobs only wait for the disk.
+		mpPrefetchJobPool = hplNew( cJobPool, (1) );
 	}
 
 	cSoundManager::~cSoundManager()
 	{
+		for(tSoundPrefetchMapIt it = m_mapPrefetches.begin(); it != m_mapPrefetches.end(); ++it)
+		{
+			mpPrefetchJobPool->WaitForBatch(it->second);
+		}
+		STLMapDeleteAll(m_mapPrefetches);
+		hplDelete(mpPrefetchJobPool);
+
 		DestroyAll();
 		Log(" Done with sounds\n");
 	}
@@ -89,6 +133,8 @@ namespace hpl {
 		
 			if(pSound==NULL && sPath!=_W(""))
 			{
+				WaitForPrefetch(sPath);
+
 				pSound = mpSound->GetLowLevel()->LoadSoundData(	asName,sPath,"",abStream, abLoopStream);
 				if(pSound)
 				{
@@ -107,6 +153,35 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool cSoundManager::PrefetchSoundData(const tString& asName)
+	{
+		tWString sPath;
+		iSoundData *pSound = FindSampleData(asName, sPath);
+		if(pSound || sPath==_W("")) return false;
+
+		if(m_mapPrefetches.find(sPath) != m_mapPrefetches.end()) return true;
+
+		cJobBatch *pBatch = hplNew( cJobBatch, () );
+		m_mapPrefetches.insert(tSoundPrefetchMap::value_type(sPath, pBatch));
+
+		mpPrefetchJobPool->AddJob(hplNew( cSoundPrefetchJob, (sPath) ), pBatch);
+
+		return true;
+	}
+
+	bool cSoundManager::IsPrefetchDone(const tString& asName)
+	{
+		tWString sPath;
+		FindSampleData(asName, sPath);
+
+		tSoundPrefetchMapIt it = m_mapPrefetches.find(sPath);
+		if(it == m_mapPrefetches.end()) return true;
+
+		return mpPrefetchJobPool->IsBatchDone(it->second);
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cSoundManager::Unload(iResourceBase* apResource)
 	{
 
@@ -205,5 +280,17 @@ namespace hpl {
 		}
 	}
 
+	//-----------------------------------------------------------------------
+	void cSoundManager::WaitForPrefetch(const tWString &asFilePath)
+	{
+		tSoundPrefetchMapIt it = m_mapPrefetches.find(asFilePath);
+		if(it == m_mapPrefetches.end()) return;
+
+		mpPrefetchJobPool->WaitForBatch(it->second);
+		
+		hplDelete(it->second);
+		m_mapPrefetches.erase(it);
+	}
+
 	//-----------------------------------------------------------------------
 }
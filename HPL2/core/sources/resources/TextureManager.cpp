@@ -23,6 +23,7 @@
 #include "resources/Resources.h"
 #include "graphics/Texture.h"
 #include "graphics/LowLevelGraphics.h"
+#include "graphics/Renderer.h"
 #include "resources/LowLevelResources.h"
 #include "system/LowLevelSystem.h"
 #include "resources/FileSearcher.h"
@@ -48,6 +49,15 @@ namespace hpl {
 		mpBitmapLoaderHandler = mpResources->GetBitmapLoaderHandler();
 
 		mlMemoryUsage =0;
+		mlMemoryBudget =0;
+		mlReduceUnusedFrameLimit = 300;
+		mlMaxReduceLevels = 2;
+		mlBudgetReloadInterval = 20;
+		mlUpdatesSinceBudgetReload = 0;
+
+		mlReducedTextureNum =0;
+		mlReducedMemorySaved =0;
+		mlBudgetReloadCount =0;
 		
 		mvCubeSideSuffixes.push_back("_pos_x");
 		mvCubeSideSuffixes.push_back("_neg_x");
@@ -340,6 +350,7 @@ namespace hpl {
 		if(apResource->HasUsers()==false)
 		{
 			mlMemoryUsage -= static_cast<iTexture*>(apResource)->GetMemorySize();
+			m_mapReducibleTextures.erase(static_cast<iTexture*>(apResource));
 
 			RemoveResource(apResource);
 			hplDelete(apResource);
@@ -358,6 +369,8 @@ namespace hpl {
 
 			pTexture->Update(afTimeStep);
 		}
+
+		UpdateMemoryBudget();
 	}
 
 	//-----------------------------------------------------------------------
@@ -425,6 +438,14 @@ namespace hpl {
 			
 			mlMemoryUsage += pTexture->GetMemorySize();
 			AddResource(pTexture);
+
+			//Single file 2D and cube textures can be reloaded with another size level when over memory budget.
+			if((aType == eTextureType_2D || aType == eTextureType_CubeMap) && aUsage == eTextureUsage_Normal && isFlattened3d==false)
+			{
+				pTexture->SetRenderFrameCount(iRenderer::GetRenderFrameCount());
+				m_mapReducibleTextures.insert(tTextureResidencyMap::value_type(pTexture, 
+												cTextureResidency(alTextureSizeLevel, pTexture->GetMemorySize())));
+			}
 		}
 
 		if(pTexture)pTexture->IncUserCount();
@@ -477,6 +498,114 @@ namespace hpl {
 		return pTexture;
 	}
 
+	//-----------------------------------------------------------------------
+
+	void cTextureManager::UpdateMemoryBudget()
+	{
+		mlReducedTextureNum =0;
+		mlReducedMemorySaved =0;
+		
+		if(m_mapReducibleTextures.empty()) return;
+
+		int lFrameCount = iRenderer::GetRenderFrameCount();
+
+		////////////////////////////
+		// Find the least recently used texture that can be reduced and the most recently used one that is reduced
+		iTexture *pReduceTexture = NULL;
+		iTexture *pRestoreTexture = NULL;
+		
+		tTextureResidencyMapIt it = m_mapReducibleTextures.begin();
+		for(; it != m_mapReducibleTextures.end(); ++it)
+		{
+			iTexture *pTexture = it->first;
+			cTextureResidency& residency = it->second;
+
+			unsigned int lLevel = pTexture->GetSizeDownScaleLevel();
+			bool bReduced = lLevel > residency.mlBaseSizeLevel;
+			if(bReduced)
+			{
+				mlReducedTextureNum++;
+				mlReducedMemorySaved += residency.mlBaseMemorySize - pTexture->GetMemorySize();
+			}
+
+			if(lFrameCount - pTexture->GetRenderFrameCount() >= mlReduceUnusedFrameLimit)
+			{
+				if(	lLevel < residency.mlBaseSizeLevel + (unsigned int)mlMaxReduceLevels &&
+					(pReduceTexture==NULL || pTexture->GetRenderFrameCount() < pReduceTexture->GetRenderFrameCount()))
+				{
+					pReduceTexture = pTexture;
+				}
+			}
+			else if(bReduced)
+			{
+				if(pRestoreTexture==NULL || pTexture->GetRenderFrameCount() > pRestoreTexture->GetRenderFrameCount())
+				{
+					pRestoreTexture = pTexture;
+				}
+			}
+		}
+
+		////////////////////////////
+		// Reloading is a synchronous load and upload, so only do one every few updates to keep hitches spread out.
+		if(mlUpdatesSinceBudgetReload < mlBudgetReloadInterval)
+		{
+			mlUpdatesSinceBudgetReload++;
+			return;
+		}
+
+		////////////////////////////
+		// Reduce one texture when over budget
+		if(mlMemoryBudget > 0 && mlMemoryUsage > mlMemoryBudget)
+		{
+			if(pReduceTexture==NULL) return;
+
+			int lOldMemorySize = pReduceTexture->GetMemorySize();
+			unsigned int lOldLevel = pReduceTexture->GetSizeDownScaleLevel();
+			
+			//If the size did not change (e.g. compressed without mipmaps), the texture can not be reduced.
+			if(ReloadWithSizeLevel(pReduceTexture, lOldLevel+1)==false || pReduceTexture->GetMemorySize() >= lOldMemorySize)
+			{
+				if(pReduceTexture->GetSizeDownScaleLevel() != lOldLevel) ReloadWithSizeLevel(pReduceTexture, lOldLevel);
+				m_mapReducibleTextures.erase(pReduceTexture);
+			}
+		}
+		////////////////////////////
+		// Restore a texture that is in use again if it fits in budget. Going up a level is roughly 4x the size.
+		else if(pRestoreTexture)
+		{
+			if(mlMemoryBudget <= 0 || mlMemoryUsage + pRestoreTexture->GetMemorySize()*3 <= mlMemoryBudget)
+			{
+				ReloadWithSizeLevel(pRestoreTexture, pRestoreTexture->GetSizeDownScaleLevel()-1);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureManager::ReloadWithSizeLevel(iTexture *apTexture, unsigned int alLevel)
+	{
+		cBitmap *pBmp = mpBitmapLoaderHandler->LoadBitmap(apTexture->GetFullPath(),0);
+		if(pBmp==NULL)
+		{
+			Error("Texture manager couldn't reload bitmap '%s'\n", cString::To8Char(apTexture->GetFullPath()).c_str());
+			return false;
+		}
+
+		mlMemoryUsage -= apTexture->GetMemorySize();
+
+		apTexture->SetSizeDownScaleLevel(alLevel);
+		bool bRet = apTexture->CreateFromBitmap(pBmp);
+		
+		mlMemoryUsage += apTexture->GetMemorySize();
+		mlBudgetReloadCount++;
+		mlUpdatesSinceBudgetReload = 0;
+
+		hplDelete(pBmp);
+
+		if(bRet==false) Error("Texture manager couldn't reload texture '%s' at size level %d\n", apTexture->GetName().c_str(), alLevel);
+
+		return bRet;
+	}
 
 	//-----------------------------------------------------------------------
 }
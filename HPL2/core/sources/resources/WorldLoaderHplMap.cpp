@@ -50,6 +50,7 @@
 #include "graphics/LowLevelGraphics.h"
 #include "graphics/VertexBuffer.h"
 #include "graphics/MeshCreator.h"
+#include "graphics/MeshOptimizer.h"
 
 #include "physics/Physics.h"
 #include "physics/PhysicsWorld.h"
@@ -384,6 +385,8 @@ namespace hpl {
 		case eVertexBufferElementFormat_Int:		return (void*)apVtxBuffer->GetIntArray(aElement);
 		case eVertexBufferElementFormat_Float:		return (void*)apVtxBuffer->GetFloatArray(aElement);
 		case eVertexBufferElementFormat_Byte:		return (void*)apVtxBuffer->GetByteArray(aElement);
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:	return (void*)apVtxBuffer->GetShortArray(aElement);
 		}
 
 		Error("Vertex buffer has incorrect format when getting vertexbuffer data during loading of MSH file!\n");
@@ -405,6 +408,10 @@ namespace hpl {
 		case eVertexBufferElementFormat_Byte:		
 			apBuffer->AddCharArray((char*)apSrcData, alSize);
 			break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:
+			apBuffer->AddShort16Array((short*)apSrcData, alSize);
+			break;
 		default:
 			Error("Vertex buffer has incorrect format when adding binary data during loading of MSH file!\n");
 			break;
@@ -426,6 +433,10 @@ namespace hpl {
 		case eVertexBufferElementFormat_Byte:		
 			apBuffer->GetCharArray((char*)apDestData, alSize);
 			break;
+		case eVertexBufferElementFormat_Short:
+		case eVertexBufferElementFormat_HalfFloat:
+			apBuffer->GetShort16Array((short*)apDestData, alSize);
+			break;
 		default:
 			Error("Vertex buffer has incorrect format when getting binary data during loading of MSH file!\n");
 			break;
@@ -672,6 +683,11 @@ namespace hpl {
 				binBuff.GetInt32Array((int*)pVtxBuff->GetIndices(), lIdxNum);
 			}
 			
+			///////////////////
+			//Compact vertex format, half floats need hardware support
+			cMeshOptimizer::SetupLoadedVertexFormat(pVtxBuff,	mpResources->GetMeshManager()->GetCompactVertexFormat(),
+																mpGraphics->GetLowLevel()->GetCaps(eGraphicCaps_VertexHalfFloat)!=0);
+			
 			///////////////////
 			//Compile vertex buffer and set to sub mesh
 			pVtxBuff->Compile(0);
@@ -824,6 +840,8 @@ namespace hpl {
 						lCompressionType = 1;
 					if(arrayType == eVertexBufferElement_Normal || arrayType == eVertexBufferElement_Texture1Tangent) 
 						lCompressionType = 2;
+					if(elementFormat != eVertexBufferElementFormat_Float)
+						lCompressionType = 0;
 
 					binBuff.AddInt32(lCompressionType);
 
@@ -1404,6 +1422,8 @@ namespace hpl {
 			iVertexBuffer *pTransformedVtxBuffer = pSubVtxBuffer->CreateCopy(	eVertexBufferType_Software, eVertexBufferUsageType_Static,
 																				pSubVtxBuffer->GetVertexElementFlags());
 			pTransformedVtxBuffer->Transform(pObject->GetWorldMatrix());
+			for(int i=0; i<lDataArrayNum;++i)
+				pTransformedVtxBuffer->ConvertElementFormat(lDataArrayTypes[i].mType, eVertexBufferElementFormat_Float);
 			
 			//////////////////////////////////////////////////
 			//Copy to each data array and increase the data pointer
@@ -1433,6 +1453,9 @@ namespace hpl {
 
 		///////////////////////
 		// All meshes batched into one buffer, compile it.
+		if(mpResources->GetMeshManager()->GetCompactVertexFormat())
+			cMeshOptimizer::CompactVertexFormat(pVtxBuffer, mpGraphics->GetLowLevel()->GetCaps(eGraphicCaps_VertexHalfFloat)!=0);
+
 		pVtxBuffer->Compile(0);
 
 		///////////////////////////////////////////
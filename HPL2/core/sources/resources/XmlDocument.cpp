@@ -20,10 +20,133 @@
 #include "resources/XmlDocument.h"
 
 #include "system/LowLevelSystem.h"
+#include "system/MemoryArena.h"
 #include "system/String.h"
 
+#include <new>
+#include <string.h>
+
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// HELPERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	static void DestroyNode(iXmlNode *apNode)
+	{
+		//Memory is owned by the arena, so only run the destructor.
+		apNode->~iXmlNode();
+	}
+
+	//-----------------------------------------------------------------------
+
+	static inline bool IsWhiteSpace(char alChar)
+	{
+		return alChar==' ' || alChar=='\n' || alChar=='\r' || alChar=='\t';
+	}
+
+	static inline bool IsNameStartChar(char alChar)
+	{
+		unsigned char c = (unsigned char)alChar;
+		return (c>='a' && c<='z') || (c>='A' && c<='Z') || c=='_' || c>=128;
+	}
+
+	static inline bool IsNameChar(char alChar)
+	{
+		return IsNameStartChar(alChar) || (alChar>='0' && alChar<='9') || alChar=='-' || alChar=='.' || alChar==':';
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Same separators and result as cString::GetFloatVec, but without creating any strings.
+	 * Returns the number of values in the string, only the first alMaxNum are written.
+	 */
+	static inline bool IsFloatSeparator(char alChar)
+	{
+		return alChar==' ' || alChar=='\n' || alChar=='\r' || alChar=='\t' || alChar==',';
+	}
+
+	static int ParseFloatList(const char* apString, float *apDest, int alMaxNum)
+	{
+		int lNum=0;
+		const char* pChar = apString;
+		while(*pChar)
+		{
+			while(*pChar && IsFloatSeparator(*pChar)) ++pChar;
+			if(*pChar==0) break;
+
+			if(lNum < alMaxNum) apDest[lNum] = (float)atof(pChar);
+			++lNum;
+
+			while(*pChar && IsFloatSeparator(*pChar)==false) ++pChar;
+		}
+
+		return lNum;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static void AppendUTF8(unsigned long alCode, tString *apDest)
+	{
+		if(alCode < 0x80)
+		{
+			apDest->push_back((char)alCode);
+		}
+		else if(alCode < 0x800)
+		{
+			apDest->push_back((char)(0xC0 | (alCode >> 6)));
+			apDest->push_back((char)(0x80 | (alCode & 0x3F)));
+		}
+		else if(alCode < 0x10000)
+		{
+			apDest->push_back((char)(0xE0 | (alCode >> 12)));
+			apDest->push_back((char)(0x80 | ((alCode >> 6) & 0x3F)));
+			apDest->push_back((char)(0x80 | (alCode & 0x3F)));
+		}
+		else
+		{
+			apDest->push_back((char)(0xF0 | (alCode >> 18)));
+			apDest->push_back((char)(0x80 | ((alCode >> 12) & 0x3F)));
+			apDest->push_back((char)(0x80 | ((alCode >> 6) & 0x3F)));
+			apDest->push_back((char)(0x80 | (alCode & 0x3F)));
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// NODE ARRAY
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cXmlNodeArray::push_back(iXmlNode* apNode, cMemoryArena *apArena)
+	{
+		if(mlSize == mlCapacity)
+		{
+			size_t lNewCapacity = mlCapacity==0 ? 4 : mlCapacity*2;
+			iXmlNode** pNewNodes = (iXmlNode**)apArena->Alloc(sizeof(iXmlNode*)*lNewCapacity);
+			if(mlSize>0) memcpy(pNewNodes, mpNodes, sizeof(iXmlNode*)*mlSize);
+
+			mpNodes = pNewNodes;
+			mlCapacity = lNewCapacity;
+		}
+
+		mpNodes[mlSize] = apNode;
+		++mlSize;
+	}
+
+	void cXmlNodeArray::erase(size_t alIdx)
+	{
+		for(size_t i=alIdx+1; i<mlSize; ++i) mpNodes[i-1] = mpNodes[i];
+		--mlSize;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// NODE
 	//////////////////////////////////////////////////////////////////////////
@@ -35,6 +158,7 @@ namespace hpl {
 		mType = aType;
 		msValue = asValue;	
 		mpParent = apParent;
+		mpArena = apParent ? apParent->mpArena : NULL;
 	}
 	//-----------------------------------------------------------------------
 
@@ -63,7 +187,8 @@ namespace hpl {
 
 	cXmlElement * iXmlNode::CreateChildElement(const tString& asName)
 	{
-		cXmlElement *pElement = hplNew(cXmlElement, (asName,this));
+		void *pMem = mpArena->Alloc(sizeof(cXmlElement));
+		cXmlElement *pElement = new(pMem) cXmlElement(asName,this);
 
 		AddChild(pElement);
 
@@ -74,49 +199,46 @@ namespace hpl {
 
 	void iXmlNode::AddChild(iXmlNode* apNode)
 	{
-		mlstChildren.push_back(apNode);
+		mlstChildren.push_back(apNode, mpArena);
 	}
 	
 	void iXmlNode::DestroyChild(iXmlNode* apNode)
 	{
-		STLFindAndDelete(mlstChildren, apNode);
+		for(size_t i=0; i<mlstChildren.size(); ++i)
+		{
+			if(mlstChildren.begin()[i] != apNode) continue;
+
+			DestroyNode(apNode);
+			mlstChildren.erase(i);
+			return;
+		}
 	}
 
 	//-----------------------------------------------------------------------
 
 	iXmlNode* iXmlNode::GetFirstOfType(eXmlNodeType aType)
 	{
-		if(mlstChildren.empty()) return NULL;
-		
 		tXmlNodeListIt it = mlstChildren.begin();
-		iXmlNode *pNode = *it;
-		while(pNode->GetType() != eXmlNodeType_Element)
+		for(; it != mlstChildren.end(); ++it)
 		{
-			++it;
-			if(it == mlstChildren.end()) return NULL;
-			pNode = *it;
+			if((*it)->GetType() == eXmlNodeType_Element) return *it;
 		}
 
-		return pNode;
+		return NULL;
 	}
 
 	//-----------------------------------------------------------------------
 
 	iXmlNode* iXmlNode::GetFirstOfType(eXmlNodeType aType, const tString& asName)
 	{
-		if(mlstChildren.empty()) return NULL;
-
 		tXmlNodeListIt it = mlstChildren.begin();
-		iXmlNode *pNode = *it;
-		while(	pNode->GetType() != eXmlNodeType_Element ||
-				pNode->GetValue() != asName )
+		for(; it != mlstChildren.end(); ++it)
 		{
-			++it;
-			if(it == mlstChildren.end()) return NULL;
-			pNode = *it;
+			iXmlNode *pNode = *it;
+			if(pNode->GetType() == eXmlNodeType_Element && pNode->GetValue() == asName) return pNode;
 		}
 
-		return pNode;
+		return NULL;
 	}
 
 	//-----------------------------------------------------------------------
@@ -130,7 +252,12 @@ namespace hpl {
 
 	void iXmlNode::DestroyChildren()
 	{
-		STLDeleteAll(mlstChildren);
+		tXmlNodeListIt it = mlstChildren.begin();
+		for(; it != mlstChildren.end(); ++it)
+		{
+			DestroyNode(*it);
+		}
+		mlstChildren.clear();
 	}
 
 	//-----------------------------------------------------------------------
@@ -143,6 +270,9 @@ namespace hpl {
 
 	cXmlElement::cXmlElement(const tString& asName, iXmlNode* apParent) : iXmlNode(eXmlNodeType_Element,apParent,asName)
 	{
+		mpAttributes = NULL;
+		mlAttributeNum = 0;
+		mlAttributeCapacity = 0;
 	}
 
 	cXmlElement::~cXmlElement()
@@ -153,12 +283,14 @@ namespace hpl {
 
 	const char* cXmlElement::GetAttribute(const tString& asName)
 	{
-		tAttributeMapIt it = m_mapAttributes.find(asName);
-		if(it != m_mapAttributes.end())
-		{
-			return it->second.c_str();
-		}
-		return NULL;
+		cXmlAttribute *pAttribute = FindAttribute(asName.c_str(), asName.size());
+		return pAttribute ? pAttribute->mpValue : NULL;
+	}
+
+	const char* cXmlElement::GetAttribute(const char* apName)
+	{
+		cXmlAttribute *pAttribute = FindAttribute(apName, strlen(apName));
+		return pAttribute ? pAttribute->mpValue : NULL;
 	}
 
 	//-----------------------------------------------------------------------
@@ -183,38 +315,84 @@ namespace hpl {
 	bool cXmlElement::GetAttributeBool(const tString& asName, bool abDefault)
 	{
 		const char* pString = GetAttribute(asName);
-		return cString::ToBool(pString,abDefault);
+		if(pString==NULL) return abDefault;
+
+		//Case insensitive compare with "true", without making a lower case copy.
+		const char* pTrue = "true";
+		for(; *pTrue; ++pTrue, ++pString)
+		{
+			char c = *pString;
+			if(c>='A' && c<='Z') c += 'a'-'A';
+			if(c != *pTrue) return false;
+		}
+		return *pString==0;
 	}
 	cVector2f cXmlElement::GetAttributeVector2f(const tString& asName, const cVector2f& avDefault)
 	{	
 		const char* pString = GetAttribute(asName);
-		return cString::ToVector2f(pString,avDefault);
-		
+		if(pString==NULL) return avDefault;
+
+		float vValues[2];
+		if(ParseFloatList(pString, vValues, 2) != 2) return avDefault;
+
+		return cVector2f(vValues[0],vValues[1]);
 	}
 	cVector3f cXmlElement::GetAttributeVector3f(const tString& asName, const cVector3f& avDefault)
 	{
 		const char* pString = GetAttribute(asName);
-		return cString::ToVector3f(pString,avDefault);
+		if(pString==NULL) return avDefault;
+
+		float vValues[3];
+		if(ParseFloatList(pString, vValues, 3) != 3) return avDefault;
+
+		return cVector3f(vValues[0],vValues[1],vValues[2]);
 	}
 	cColor cXmlElement::GetAttributeColor(const tString& asName, const cColor& aDefault)
 	{
 		const char* pString = GetAttribute(asName);
-		return cString::ToColor(pString,aDefault);
+		if(pString==NULL) return aDefault;
+
+		float vValues[4];
+		if(ParseFloatList(pString, vValues, 4) != 4) return aDefault;
+
+		return cColor(vValues[0],vValues[1],vValues[2],vValues[3]);
 	}
 
 	//-----------------------------------------------------------------------
 
 	void cXmlElement::SetAttribute(const tString& asName, const char* asVal)
 	{
-		tAttributeMapIt it = m_mapAttributes.find(asName);
-		if(it != m_mapAttributes.end())
+		SetAttribute(asName.c_str(), asName.size(), asVal, strlen(asVal));
+	}
+
+	void cXmlElement::SetAttribute(const char* apName, size_t alNameLength, const char* apVal, size_t alValLength)
+	{
+		const char* pValue = mpArena->AllocString(apVal, alValLength);
+
+		//Old value is left in the arena, setting the same attribute over and over is rare.
+		cXmlAttribute *pAttribute = FindAttribute(apName, alNameLength);
+		if(pAttribute)
 		{
-			it->second = asVal;
+			pAttribute->mpValue = pValue;
+			return;
 		}
-		else
+
+		if(mlAttributeNum == mlAttributeCapacity)
 		{
-			m_mapAttributes.insert(tAttributeMap::value_type(asName, asVal));
+			int lNewCapacity = mlAttributeCapacity==0 ? 4 : mlAttributeCapacity*2;
+			cXmlAttribute *pNewAttributes = (cXmlAttribute*)mpArena->Alloc(sizeof(cXmlAttribute)*lNewCapacity);
+			if(mlAttributeNum>0) memcpy(pNewAttributes, mpAttributes, sizeof(cXmlAttribute)*mlAttributeNum);
+
+			mpAttributes = pNewAttributes;
+			mlAttributeCapacity = lNewCapacity;
 		}
+
+		pAttribute = &mpAttributes[mlAttributeNum];
+		++mlAttributeNum;
+
+		pAttribute->mlNameHash = GetAttributeNameHash(apName, alNameLength);
+		pAttribute->mpName = mpArena->AllocString(apName, alNameLength);
+		pAttribute->mpValue = pValue;
 	}
 
 	//-----------------------------------------------------------------------
@@ -223,7 +401,7 @@ namespace hpl {
 
 	void cXmlElement::SetAttributeString(const tString& asName, const tString& asVal)
 	{
-		SetAttribute(asName, asVal.c_str());
+		SetAttribute(asName.c_str(), asName.size(), asVal.c_str(), asVal.size());
 	}
 	void cXmlElement::SetAttributeFloat(const tString& asName, float afVal)
 	{
@@ -254,6 +432,61 @@ namespace hpl {
 	
 	//-----------------------------------------------------------------------
 
+	unsigned int cXmlElement::GetAttributeNameHash(const char* apName, size_t alLength)
+	{
+		//FNV-1a
+		unsigned int lHash = 2166136261U;
+		for(size_t i=0; i<alLength; ++i)
+		{
+			lHash ^= (unsigned char)apName[i];
+			lHash *= 16777619U;
+		}
+		return lHash;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cXmlElement::ClearAttributes()
+	{
+		mpAttributes = NULL;
+		mlAttributeNum = 0;
+		mlAttributeCapacity = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cXmlElement::SetParsedAttributes(const cXmlAttribute *apAttributes, int alNum)
+	{
+		if(alNum==0) return;
+
+		mpAttributes = (cXmlAttribute*)mpArena->Alloc(sizeof(cXmlAttribute)*alNum);
+		memcpy(mpAttributes, apAttributes, sizeof(cXmlAttribute)*alNum);
+
+		mlAttributeNum = alNum;
+		mlAttributeCapacity = alNum;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cXmlAttribute* cXmlElement::FindAttribute(const char* apName, size_t alLength)
+	{
+		if(mlAttributeNum==0) return NULL;
+
+		unsigned int lHash = GetAttributeNameHash(apName, alLength);
+		for(int i=0; i<mlAttributeNum; ++i)
+		{
+			cXmlAttribute *pAttribute = &mpAttributes[i];
+			if(	pAttribute->mlNameHash == lHash &&
+				strncmp(pAttribute->mpName, apName, alLength)==0 && pAttribute->mpName[alLength]==0)
+			{
+				return pAttribute;
+			}
+		}
+		return NULL;
+	}
+
+	//-----------------------------------------------------------------------
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
@@ -264,10 +497,21 @@ namespace hpl {
 	iXmlDocument::iXmlDocument(const tString& asName) : cXmlElement(asName, NULL)
 	{
 		msFile = _W("");
+
+		mpArena = hplNew( cMemoryArena, (16*1024) );
+
+		mlErrorRow = 0;
+		mlErrorCol = 0;
 	}
 
 	iXmlDocument::~iXmlDocument()
 	{
+		//Children live in the arena, so they must go before it.
+		DestroyChildren();
+		ClearAttributes();
+
+		hplDelete(mpArena);
+		mpArena = NULL;
 	}
 
 	//-----------------------------------------------------------------------
@@ -306,12 +550,394 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	size_t iXmlDocument::GetMemorySize()
+	{
+		return mpArena->GetMemorySize();
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PROTECTED METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool iXmlDocument::ParseData(const char* apData, size_t alSize)
+	{
+		DestroyChildren();
+		ClearAttributes();
+		mpArena->Clear();
+
+		memset(mvParseNames, 0, sizeof(mvParseNames));
+
+		mpParseStart = apData;
+		mpParseEnd = apData + alSize;
+		mpParsePos = apData;
+		mbParseUTF8 = false;
+
+		//UTF-8 byte order mark
+		if(alSize >= 3 && (unsigned char)apData[0]==0xEF && (unsigned char)apData[1]==0xBB && (unsigned char)apData[2]==0xBF)
+		{
+			mpParsePos += 3;
+			mbParseUTF8 = true;
+		}
+
+		////////////////////////////
+		// Skip declaration, comments and such before the root
+		for(;;)
+		{
+			SkipWhiteSpace();
+			if(mpParsePos >= mpParseEnd) return SetParseError("Document empty.", mpParsePos);
+			if(*mpParsePos != '<') return SetParseError("Error parsing Element.", mpParsePos);
+
+			if(mpParsePos[1]=='?' || mpParsePos[1]=='!')
+			{
+				if(SkipMarkup()==false) return false;
+				continue;
+			}
+			break;
+		}
+
+		////////////////////////////
+		// Root element is the document
+		++mpParsePos;
+		const char* pName = mpParsePos;
+		size_t lNameLength = ReadName();
+		if(lNameLength==0) return SetParseError("Failed to read Element name.", mpParsePos);
+
+		SetValue(pName, lNameLength);
+
+		if(ParseElement(this)==false)
+		{
+			DestroyChildren();
+			ClearAttributes();
+			return false;
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// PRIVATE METHODS
 	//////////////////////////////////////////////////////////////////////////
 
 	//-----------------------------------------------------------------------
 
-	
+	bool iXmlDocument::ParseElement(cXmlElement *apElement)
+	{
+		////////////////////////////
+		// Attributes, gathered first so the element gets an array of the exact size
+		mvParseAttributes.resize(0);
+		for(;;)
+		{
+			SkipWhiteSpace();
+			if(mpParsePos >= mpParseEnd) return SetParseError("Error reading Attributes.", mpParsePos);
+
+			char c = *mpParsePos;
+			if(c=='/')
+			{
+				if(mpParsePos[1] != '>') return SetParseError("Error parsing Empty tag.", mpParsePos);
+				mpParsePos += 2;
+
+				apElement->SetParsedAttributes(mvParseAttributes.empty() ? NULL : &mvParseAttributes[0], (int)mvParseAttributes.size());
+				return true;
+			}
+			if(c=='>')
+			{
+				++mpParsePos;
+
+				apElement->SetParsedAttributes(mvParseAttributes.empty() ? NULL : &mvParseAttributes[0], (int)mvParseAttributes.size());
+				break;
+			}
+
+			const char* pName = mpParsePos;
+			size_t lNameLength = ReadName();
+			if(lNameLength==0) return SetParseError("Error reading Attributes.", mpParsePos);
+
+			SkipWhiteSpace();
+			if(*mpParsePos != '=') return SetParseError("Error reading Attributes.", mpParsePos);
+			++mpParsePos;
+			SkipWhiteSpace();
+
+			if(ParseAttributeValue(apElement, pName, lNameLength)==false) return false;
+		}
+
+		////////////////////////////
+		// Content, text is skipped since only elements are kept
+		for(;;)
+		{
+			while(mpParsePos < mpParseEnd && *mpParsePos != '<') ++mpParsePos;
+			if(mpParsePos >= mpParseEnd) return SetParseError("Error reading end tag.", mpParsePos);
+
+			char cNext = mpParsePos[1];
+			if(cNext=='/')
+			{
+				mpParsePos += 2;
+				return ParseEndTag(apElement);
+			}
+			if(cNext=='!' || cNext=='?')
+			{
+				if(SkipMarkup()==false) return false;
+				continue;
+			}
+
+			++mpParsePos;
+			const char* pName = mpParsePos;
+			size_t lNameLength = ReadName();
+			if(lNameLength==0) return SetParseError("Failed to read Element name.", mpParsePos);
+
+			cXmlElement *pChild = apElement->CreateChildElement();
+			pChild->SetValue(pName, lNameLength);
+
+			if(ParseElement(pChild)==false) return false;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool iXmlDocument::ParseAttributeValue(cXmlElement *apElement, const char* apName, size_t alNameLength)
+	{
+		const char* pStart = mpParsePos;
+		const char* pEnd = NULL;
+
+		char cQuote = *mpParsePos;
+		if(cQuote=='"' || cQuote=='\'')
+		{
+			++pStart;
+			pEnd = (const char*)memchr(pStart, cQuote, mpParseEnd - pStart);
+			if(pEnd==NULL) return SetParseError("Error reading Attributes.", mpParsePos);
+
+			mpParsePos = pEnd+1;
+		}
+		else
+		{
+			//Unquoted values are read up to white space or the end of the tag
+			while(	mpParsePos < mpParseEnd && IsWhiteSpace(*mpParsePos)==false &&
+					*mpParsePos != '/' && *mpParsePos != '>')
+			{
+				++mpParsePos;
+			}
+			pEnd = mpParsePos;
+		}
+
+		////////////////////////////
+		// Most values have nothing to decode and are copied straight to the arena
+		const char* pValue = NULL;
+		size_t lLength = pEnd - pStart;
+		if(memchr(pStart, '&', lLength)==NULL && memchr(pStart, '\r', lLength)==NULL)
+		{
+			pValue = mpArena->AllocString(pStart, lLength);
+		}
+		else
+		{
+			DecodeText(pStart, pEnd, &msParseBuffer);
+			pValue = mpArena->AllocString(msParseBuffer.c_str(), msParseBuffer.size());
+		}
+
+		////////////////////////////
+		// Add attribute, a repeated name keeps the last value
+		unsigned int lHash = cXmlElement::GetAttributeNameHash(apName, alNameLength);
+		const char* pName = GetParsedName(apName, alNameLength, lHash);
+		for(size_t i=0; i<mvParseAttributes.size(); ++i)
+		{
+			if(mvParseAttributes[i].mlNameHash == lHash && strcmp(mvParseAttributes[i].mpName, pName)==0)
+			{
+				mvParseAttributes[i].mpValue = pValue;
+				return true;
+			}
+		}
+
+		cXmlAttribute attribute;
+		attribute.mlNameHash = lHash;
+		attribute.mpName = pName;
+		attribute.mpValue = pValue;
+		mvParseAttributes.push_back(attribute);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool iXmlDocument::ParseEndTag(cXmlElement *apElement)
+	{
+		const char* pName = mpParsePos;
+		size_t lNameLength = ReadName();
+
+		const tString& sValue = apElement->GetValue();
+		if(lNameLength != sValue.size() || memcmp(pName, sValue.c_str(), lNameLength)!=0)
+		{
+			return SetParseError("Error reading end tag.", pName);
+		}
+
+		SkipWhiteSpace();
+		if(mpParsePos >= mpParseEnd || *mpParsePos != '>') return SetParseError("Error reading end tag.", mpParsePos);
+		++mpParsePos;
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool iXmlDocument::SkipMarkup()
+	{
+		const char* pStart = mpParsePos;
+		const char* pEndMark = NULL;
+		const char* pEnd = NULL;
+
+		if(strncmp(pStart, "<!--", 4)==0)			pEndMark = "-->";
+		else if(strncmp(pStart, "<![CDATA[", 9)==0)	pEndMark = "]]>";
+		else if(strncmp(pStart, "<?", 2)==0)		pEndMark = "?>";
+		else										pEndMark = ">";
+
+		pEnd = strstr(pStart+2, pEndMark);
+		if(pEnd==NULL || pEnd >= mpParseEnd) return SetParseError("Error parsing Unknown.", pStart);
+
+		//Declaration can say that the text is UTF-8, this matters for how character references are decoded.
+		if(pStart[1]=='?')
+		{
+			for(const char* pChar = pStart; pChar + 5 <= pEnd; ++pChar)
+			{
+				if((pChar[0]=='u' || pChar[0]=='U') && (pChar[1]=='t' || pChar[1]=='T') && (pChar[2]=='f' || pChar[2]=='F') &&
+					pChar[3]=='-' && pChar[4]=='8')
+				{
+					mbParseUTF8 = true;
+					break;
+				}
+			}
+		}
+
+		mpParsePos = pEnd + strlen(pEndMark);
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iXmlDocument::SkipWhiteSpace()
+	{
+		while(mpParsePos < mpParseEnd && IsWhiteSpace(*mpParsePos)) ++mpParsePos;
+	}
+
+	//-----------------------------------------------------------------------
+
+	size_t iXmlDocument::ReadName()
+	{
+		const char* pStart = mpParsePos;
+		if(mpParsePos >= mpParseEnd || IsNameStartChar(*mpParsePos)==false) return 0;
+
+		++mpParsePos;
+		while(mpParsePos < mpParseEnd && IsNameChar(*mpParsePos)) ++mpParsePos;
+
+		return mpParsePos - pStart;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iXmlDocument::DecodeText(const char* apStart, const char* apEnd, tString *apDest)
+	{
+		apDest->resize(0);
+
+		for(const char* pChar = apStart; pChar < apEnd; ++pChar)
+		{
+			char c = *pChar;
+
+			////////////////////////////
+			// Line endings are always \n
+			if(c=='\r')
+			{
+				apDest->push_back('\n');
+				if(pChar+1 < apEnd && pChar[1]=='\n') ++pChar;
+				continue;
+			}
+
+			if(c!='&')
+			{
+				apDest->push_back(c);
+				continue;
+			}
+
+			////////////////////////////
+			// Character reference, a malformed one keeps the '&' as text
+			if(pChar+1 < apEnd && pChar[1]=='#')
+			{
+				const char* pNum = pChar+2;
+				int lBase = 10;
+				if(*pNum=='x' || *pNum=='X') { lBase = 16; ++pNum; }
+
+				char *pNumEnd = NULL;
+				unsigned long lCode = strtoul(pNum, &pNumEnd, lBase);
+				if(pNumEnd != pNum && pNumEnd < apEnd && *pNumEnd==';')
+				{
+					if(mbParseUTF8)	AppendUTF8(lCode, apDest);
+					else			apDest->push_back((char)lCode);
+
+					pChar = pNumEnd;
+					continue;
+				}
+			}
+			////////////////////////////
+			// Named entity, an unknown one keeps the '&' as text (same as TinyXML, which was used before)
+			else
+			{
+				static const char* vEntities[5] = { "&amp;", "&lt;", "&gt;", "&quot;", "&apos;" };
+				static const char vChars[5] = { '&', '<', '>', '"', '\'' };
+
+				bool bFound = false;
+				for(int i=0; i<5; ++i)
+				{
+					size_t lLen = strlen(vEntities[i]);
+					if(pChar + lLen <= apEnd && strncmp(pChar, vEntities[i], lLen)==0)
+					{
+						apDest->push_back(vChars[i]);
+						pChar += lLen-1;
+						bFound = true;
+						break;
+					}
+				}
+				if(bFound) continue;
+			}
+
+			apDest->push_back(c);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	const char* iXmlDocument::GetParsedName(const char* apName, size_t alLength, unsigned int alHash)
+	{
+		//Documents use the same few attribute names over and over, so keep a small cache and let them share the string.
+		int lSlot = alHash & 255;
+		const char* pName = mvParseNames[lSlot];
+		if(	pName && mvParseNameHashes[lSlot] == alHash &&
+			strncmp(pName, apName, alLength)==0 && pName[alLength]==0)
+		{
+			return pName;
+		}
+
+		pName = mpArena->AllocString(apName, alLength);
+		mvParseNames[lSlot] = pName;
+		mvParseNameHashes[lSlot] = alHash;
+
+		return pName;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool iXmlDocument::SetParseError(const tString& asDesc, const char* apPos)
+	{
+		int lRow = 1;
+		int lCol = 1;
+		for(const char* pChar = mpParseStart; pChar < apPos && pChar < mpParseEnd; ++pChar)
+		{
+			if(*pChar=='\n')	{ ++lRow; lCol = 1; }
+			else				++lCol;
+		}
+
+		SaveErrorInfo(asDesc, lRow, lCol);
+		return false;
+	}
+
 	//-----------------------------------------------------------------------
 }
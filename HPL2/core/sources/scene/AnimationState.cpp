@@ -353,6 +353,18 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cAnimationState::SamplePose(cAnimationPose *apPose)
+	{
+		mpAnimation->GetClip()->SamplePose(mfTimePos, mbLoop, &mClipCursor, apPose);
+	}
+
+	void cAnimationState::SamplePose(cAnimationPose *apPose, bool abLoop)
+	{
+		mpAnimation->GetClip()->SamplePose(mfTimePos, abLoop, &mClipCursor, apPose);
+	}
+
+	//-----------------------------------------------------------------------
+
 	
 	void cAnimationState::CreateSkeletonBoundsFromMesh(cMeshEntity * apMesh, tBoneStateVec * apvBoneStates)
 	{
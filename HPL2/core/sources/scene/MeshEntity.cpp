@@ -48,6 +48,7 @@
 #include "physics/PhysicsWorld.h"
 
 #include "math/Math.h"
+#include "math/Frustum.h"
 
 #include "engine/Engine.h"
 
@@ -85,8 +86,6 @@ namespace hpl {
 		mfCoverageAmount = 1.0f;
 		mlRenderFlags =0;
 
-		mlInvWorldMatrixTransformCount = -1;
-		mlBoneMatricesTransformCount = -1;
 		mlBoneMatricesUpdateCount = -1;
 
 		mbBoneMatricesNeedUpdate = true;
@@ -109,6 +108,10 @@ namespace hpl {
 		mbUpdatedBones = false;
 		mbHasUpdatedAnimation = true;
 
+		mfLodScreenSize = 1;
+		mlLodRenderFrameCount = -1;
+		mlForcedLod = -1;
+
 		////////////////////////////////////////////////
 		//Create sub entities
 		for(int i=0;i<mpMesh->GetSubMeshNum();i++)
@@ -197,6 +200,9 @@ namespace hpl {
 
 			//Create an array to fill with bone matrices
 			mvBoneMatrices.resize(pSkeleton->GetBoneNum());
+			mvBoneMeshMatrices.resize(pSkeleton->GetBoneNum());
+
+			SetupBoneOrder();
 
 			//////////////////////////////////
 			//Reset all bones states
@@ -362,6 +368,185 @@ namespace hpl {
 		}
 	}
 	
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::SetupBoneOrder()
+	{
+		const int lBoneNum = (int)mvBoneStates.size();
+
+		//////////////////////////////
+		// Get parent indices, -1 means the root node.
+		mvBoneParents.resize(lBoneNum);
+		for(int i=0; i<lBoneNum; ++i)
+		{
+			cNode3D *pParent = mvBoneStates[i]->GetParent();
+			mvBoneParents[i] = pParent && pParent != mpBoneStateRoot ? GetBoneStateIndex(pParent->GetName()) : -1;
+		}
+
+		//////////////////////////////
+		// Sort so that all parents come before their children
+		mvBoneOrder.clear();
+		mvBoneOrder.reserve(lBoneNum);
+		for(int i=0; i<lBoneNum; ++i)
+		{
+			if(mvBoneParents[i] < 0) mvBoneOrder.push_back(i);
+		}
+		for(size_t pos=0; pos<mvBoneOrder.size(); ++pos)
+		{
+			for(int i=0; i<lBoneNum; ++i)
+			{
+				if(mvBoneParents[i] == mvBoneOrder[pos]) mvBoneOrder.push_back(i);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Samples the whole animation in one go and then adds the weighted pose to the bone or node states.
+	 */
+	void cMeshEntity::ApplyAnimationPose(cAnimationState *apAnimState, float afWeight)
+	{
+		cAnimation *pAnim = apAnimState->GetAnimation();
+		cSkeleton *pSkeleton = mpMesh->GetSkeleton();
+
+		//Node tracks have always been sampled as looping, only bone tracks follow the state
+		apAnimState->SamplePose(&mAnimationPose, pSkeleton ? apAnimState->IsLooping() : true);
+
+		for(int i=0; i<pAnim->GetTrackNum(); i++)
+		{
+			cAnimationTrack *pTrack = pAnim->GetTrack(i);
+			cNode3D* pState = NULL;
+
+			if(pSkeleton)
+			{
+				pState = GetBoneState(GetTrackBoneIndex(pTrack));
+			}
+			else
+			{
+				if(pTrack->GetNodeIndex()<0)
+				{
+					pTrack->SetNodeIndex(GetNodeStateIndex(pTrack->GetName()));
+				}
+				pState = GetNodeState(pTrack->GetNodeIndex());
+			}
+
+			if(pState==NULL || pState->IsActive()==false) continue;
+
+			///////////////////////////////////
+			//Apply the weighted pose to node.
+			if(afWeight == 1.0f)
+			{
+				pState->AddRotation(mAnimationPose.mvRotations[i]);
+				pState->AddTranslation(mAnimationPose.mvTranslations[i]);
+			}
+			else
+			{
+				pState->AddRotation(cMath::QuaternionNlerp(afWeight, cQuaternion::Identity, mAnimationPose.mvRotations[i], true));
+				pState->AddTranslation(mAnimationPose.mvTranslations[i] * afWeight);
+			}
+		}
+	}
+	
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Blends all active animations into a bone indexed pose and then sets the local matrix
+	 * of every bone state in a single pass, without any recursion.
+	 */
+	void cMeshEntity::UpdateBoneStatesFromAnimations(float afWeightMul, int alSoloIndex)
+	{
+		cSkeleton *pSkeleton = mpMesh->GetSkeleton();
+		const int lBoneNum = (int)mvBoneStates.size();
+		if(lBoneNum==0) return;
+
+		//////////////////////////////
+		// Reset the blended pose
+		mBonePose.Resize(lBoneNum);
+		cQuaternion *pBoneRot = &mBonePose.mvRotations[0];
+		cVector3f *pBoneTrans = &mBonePose.mvTranslations[0];
+		for(int i=0; i<lBoneNum; ++i)
+		{
+			pBoneRot[i] = cQuaternion::Identity;
+			pBoneTrans[i] = 0;
+		}
+
+		//////////////////////////////
+		// Sample and add all active animations
+		for(size_t i=0; i< mvAnimationStates.size(); i++)
+		{
+			cAnimationState *pAnimState = mvAnimationStates[i];
+			if(pAnimState->IsActive()==false || (alSoloIndex != -1 && alSoloIndex != (int)i)) continue;
+
+			cAnimation *pAnim = pAnimState->GetAnimation();
+			float fWeight = pAnimState->GetWeight() * afWeightMul;
+
+			pAnimState->SamplePose(&mAnimationPose);
+			const cQuaternion *pPoseRot = pAnim->GetTrackNum()>0 ? &mAnimationPose.mvRotations[0] : NULL;
+			const cVector3f *pPoseTrans = pAnim->GetTrackNum()>0 ? &mAnimationPose.mvTranslations[0] : NULL;
+
+			for(int track=0; track<pAnim->GetTrackNum(); ++track)
+			{
+				int lBone = GetTrackBoneIndex(pAnim->GetTrack(track));
+				if(lBone < 0 || mvBoneStates[lBone]->IsActive()==false) continue;
+
+				if(fWeight == 1.0f)
+				{
+					pBoneRot[lBone] = cMath::QuaternionMul(pPoseRot[track], pBoneRot[lBone]);
+					pBoneTrans[lBone] += pPoseTrans[track];
+				}
+				else
+				{
+					cQuaternion qRot = cMath::QuaternionNlerp(fWeight, cQuaternion::Identity, pPoseRot[track], true);
+					pBoneRot[lBone] = cMath::QuaternionMul(qRot, pBoneRot[lBone]);
+					pBoneTrans[lBone] += pPoseTrans[track] * fWeight;
+				}
+			}
+		}
+
+		//////////////////////////////
+		// Set local matrices, the animation rotation is applied before the bind pose.
+		for(int i=0; i<lBoneNum; ++i)
+		{
+			cNode3D *pState = mvBoneStates[i];
+
+			if(pState->IsActive())
+			{
+				cMatrixf mtxLocal = pSkeleton->GetBoneByIndex(i)->GetLocalTransform();
+				cVector3f vPos = mtxLocal.GetTranslation();
+				mtxLocal.SetTranslation(0);
+
+				mtxLocal = cMath::MatrixMul(mtxLocal, cMath::MatrixQuaternion(pBoneRot[i]));
+				mtxLocal.SetTranslation(vPos + pBoneTrans[i]);
+
+				pState->SetMatrix(mtxLocal, false);
+			}
+
+			pState->ApplyPreAnimTransform(false);
+			pState->ApplyPostAnimTransform(false);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cMeshEntity::GetTrackBoneIndex(cAnimationTrack *apTrack)
+	{
+		///////////////////////////////////
+		//If index not yet, set get it!
+		if(apTrack->GetNodeIndex() <0)
+		{
+			int lBoneIdx = mpMesh->GetSkeleton()->GetBoneIndexByName(apTrack->GetName());
+			apTrack->SetNodeIndex(lBoneIdx);
+			if(lBoneIdx<0 && apTrack->GetNodeIndex()==-1)
+			{
+				//Error("Track '%s' in '%s' does not have a corresponding bone! Skeleton bone name mismatch?\n", apTrack->GetName().c_str(), mpMesh->GetName().c_str());
+				apTrack->SetNodeIndex(-2);
+			}
+		}
+
+		return apTrack->GetNodeIndex();
+	}
+
 	//-----------------------------------------------------------------------
 	
 	void cMeshEntity::UpdateLogic(float afTimeStep)
@@ -397,7 +582,7 @@ namespace hpl {
 				cBoneState *pState = GetBoneState(bone);
 				iPhysicsBody *pBody = pState->GetBody();
 				
-				if(pBody && pBody->GetEnabled()){
+				if(pBody && pBody->IsInUpdateList()){
 					bEnabled = true;
 					break;
 				}
@@ -457,8 +642,20 @@ namespace hpl {
 
 					//////////
 					//Reset all bones states
-					if(	bAnimationActive || mbUpdatedBones == false ||
-						(mbSkeletonPhysics && !mbSkeletonPhysicsSleeping))
+					//Without skeleton physics the animations can be blended into a single pose
+					bool bBlendPoses = bAnimationActive && mbSkeletonPhysics==false;
+
+					//////////
+					//Blend animations and set the bone states in one go
+					if(bBlendPoses)
+					{
+						UpdateBoneStatesFromAnimations(fAnimationWeightMul, soloIndex);
+						bUpdateTransform = true;
+					}
+					//////////
+					//Reset all bones states
+					else if(bAnimationActive || mbUpdatedBones == false ||
+							(mbSkeletonPhysics && !mbSkeletonPhysicsSleeping))
 					{
 						for(size_t i=0;i < mvBoneStates.size(); i++)
 						{
@@ -513,51 +710,22 @@ namespace hpl {
 
 					//////////////////////////////////
 					//Go through all animations states and update the bones 
-					for(size_t i=0; i< mvAnimationStates.size(); i++)
+					for(size_t i=0; i< mvAnimationStates.size() && bBlendPoses==false; i++)
 					{
 						cAnimationState *pAnimState = mvAnimationStates[i];
 					
 						if(pAnimState->IsActive())
 						{
-							cAnimation *pAnim = pAnimState->GetAnimation();
-
 							if ( soloIndex == -1 || soloIndex == i )
 							{
-								/////////////////////////////////////
-								//Go through all tracks in animation and apply to nodes
-								for(int i=0; i<pAnim->GetTrackNum(); i++)
-								{
-									cAnimationTrack *pTrack = pAnim->GetTrack(i);
-							
-									///////////////////////////////////
-									//If index not yet, set get it!
-									if(pTrack->GetNodeIndex() <0)
-									{
-										int lBoneIdx = mpMesh->GetSkeleton()->GetBoneIndexByName(pTrack->GetName());
-										pTrack->SetNodeIndex(lBoneIdx);
-										if(lBoneIdx<0 && pTrack->GetNodeIndex()==-1)
-										{
-											//Error("Track '%s' in '%s' does not have a corresponding bone! Skeleton bone name mismatch?\n", pTrack->GetName().c_str(), mpMesh->GetName().c_str());
-											pTrack->SetNodeIndex(-2);
-										}
-									}
-							
-									cNode3D* pState = GetBoneState(pTrack->GetNodeIndex());
-
-									///////////////////////////////////
-									//Apply the animation track to node.
-									if(pState && pState->IsActive())
-									{
-										pTrack->ApplyToNode(pState,pAnimState->GetTimePosition(),pAnimState->GetWeight() * fAnimationWeightMul, pAnimState->IsLooping());
-									}
-								}
+								ApplyAnimationPose(pAnimState, pAnimState->GetWeight() * fAnimationWeightMul);
 							}
 						}
 					}
 
 					//////////////////////////////////
 					//Go through all states and update the matrices (and thereby adding the animations together).
-					if(bAnimationActive)
+					if(bAnimationActive && bBlendPoses==false)
 					{
 						cNode3DIterator NodeIt = mpBoneStateRoot->GetChildIterator();
 						while(NodeIt.HasNext())
@@ -633,21 +801,7 @@ namespace hpl {
 							cAnimationState *pAnimState = mvAnimationStates[i];
 							if(pAnimState->IsActive())
 							{
-								cAnimation *pAnim = pAnimState->GetAnimation();
-
-								for(int i=0; i<pAnim->GetTrackNum(); i++)
-								{
-									cAnimationTrack *pTrack = pAnim->GetTrack(i);
-
-									if(pTrack->GetNodeIndex()<0)
-									{
-										pTrack->SetNodeIndex(GetNodeStateIndex(pTrack->GetName()));
-									}
-									cNode3D* pNodeState = GetNodeState(pTrack->GetNodeIndex());
-
-									if(pNodeState->IsActive()) 
-										pTrack->ApplyToNode(pNodeState,pAnimState->GetTimePosition(),pAnimState->GetWeight() * fAnimationWeightMul);
-								}
+								ApplyAnimationPose(pAnimState, pAnimState->GetWeight() * fAnimationWeightMul);
 							}
 						}
 
@@ -1242,6 +1396,34 @@ namespace hpl {
 
 	//----------------------------------------------------------------------
 
+	float cMeshEntity::GetLodScreenSize(cFrustum *apFrustum)
+	{
+		if(mlLodRenderFrameCount == iRenderer::GetRenderFrameCount()) return mfLodScreenSize;
+		mlLodRenderFrameCount = iRenderer::GetRenderFrameCount();
+
+		cBoundingVolume *pBV = GetBoundingVolume();
+		float fRadius = pBV->GetRadius();
+
+		if(apFrustum->GetProjectionType() == eProjectionType_Orthographic)
+		{
+			float fViewHeight = apFrustum->GetOrthoViewSize().y;
+			mfLodScreenSize = fViewHeight > 0 ? fRadius*2 / fViewHeight : 1;
+		}
+		else
+		{
+			float fDist = cMath::Vector3Dist(apFrustum->GetOrigin(), pBV->GetWorldCenter());
+			float fTanHalfFov = tan(apFrustum->GetFOV()*0.5f);
+
+			//Inside the mesh counts as covering the screen
+			if(fDist <= fRadius || fTanHalfFov <= 0)	mfLodScreenSize = 1;
+			else										mfLodScreenSize = fRadius / (fDist * fTanHalfFov);
+		}
+
+		return mfLodScreenSize;
+	}
+
+	//----------------------------------------------------------------------
+
 	cNode3D* cMeshEntity::GetNodeState(int alIndex)
 	{
 		return mvNodeStates[alIndex];
@@ -1305,13 +1487,9 @@ namespace hpl {
 	{
 		//////////////////////////////////////////
 		//Check so update is needed
-		if(	mbBoneMatricesNeedUpdate == false &&
-			mlBoneMatricesTransformCount == GetTransformUpdateCount())
-		{
-			return;
-		}
+		//Bone matrices are in mesh space, so moving the entity does not affect them.
+		if(mbBoneMatricesNeedUpdate == false) return;
 
-		mlBoneMatricesTransformCount = GetTransformUpdateCount();
 		mbBoneMatricesNeedUpdate = false;
 		mlBoneMatricesUpdateCount++;
 
@@ -1320,22 +1498,18 @@ namespace hpl {
 		cSkeleton *pSkeleton = mpMesh->GetSkeleton();
 		if(pSkeleton)
 		{
-			if(mlInvWorldMatrixTransformCount != GetTransformUpdateCount())
-			{
-				mlInvWorldMatrixTransformCount = GetTransformUpdateCount();
-				m_mtxInvWorldMatrix = cMath::MatrixInverse(GetWorldMatrix());
-			}
-			
-			for(int i=0; i< pSkeleton->GetBoneNum(); i++)
+			//Bones are sorted so that parents come first, meaning the mesh space
+			//matrices can be built in one pass from the local matrices.
+			const cMatrixf &mtxRoot = mpBoneStateRoot->GetLocalMatrix();
+			for(size_t i=0; i< mvBoneOrder.size(); i++)
 			{
-				cBone *pBone = pSkeleton->GetBoneByIndex(i);
-				cNode3D* pState = mvBoneStates[i];
-                
-				//Transform the movement of the bone into the
-				//Bind pose's local space.
-				cMatrixf mtxLocal = cMath::MatrixMul(m_mtxInvWorldMatrix,pState->GetWorldMatrix());
-				
-				mvBoneMatrices[i] = cMath::MatrixMul(mtxLocal,pBone->GetInvWorldTransform());
+				int lBone = mvBoneOrder[i];
+				int lParent = mvBoneParents[lBone];
+				const cMatrixf &mtxParent = lParent < 0 ? mtxRoot : mvBoneMeshMatrices[lParent];
+
+				mvBoneMeshMatrices[lBone] = cMath::MatrixMul(mtxParent, mvBoneStates[lBone]->GetLocalMatrix());
+
+				mvBoneMatrices[lBone] = cMath::MatrixMul(mvBoneMeshMatrices[lBone], pSkeleton->GetBoneByIndex(lBone)->GetInvWorldTransform());
 			}
 		}
 	}
@@ -1693,36 +1867,7 @@ namespace hpl {
 					
 			if(pAnimState->IsActive())
 			{
-				cAnimation *pAnim = pAnimState->GetAnimation();
-
-				/////////////////////////////////////
-				//Go through all tracks in animation and apply to nodes
-				for(int i=0; i<pAnim->GetTrackNum(); i++)
-				{
-					cAnimationTrack *pTrack = pAnim->GetTrack(i);
-							
-					///////////////////////////////////
-					//If index not yet, set get it!
-					if(pTrack->GetNodeIndex() <0)
-					{
-						int lBoneIdx = mpMesh->GetSkeleton()->GetBoneIndexByName(pTrack->GetName());
-						pTrack->SetNodeIndex(lBoneIdx);
-						if(lBoneIdx<0 && pTrack->GetNodeIndex()==-1)
-						{
-							//Error("Track '%s' in '%s' does not have a corresponding bone! Skeleton bone name mismatch?\n", pTrack->GetName().c_str(), mpMesh->GetName().c_str());
-							pTrack->SetNodeIndex(-2);
-						}
-					}
-							
-					cNode3D* pState = GetBoneState(pTrack->GetNodeIndex());
-
-					///////////////////////////////////
-					//Apply the animation track to node.
-					if(pState && pState->IsActive())
-					{
-						pTrack->ApplyToNode(pState,pAnimState->GetTimePosition(),pAnimState->GetWeight() * fAnimationWeightMul, pAnimState->IsLooping());
-					}
-				}
+				ApplyAnimationPose(pAnimState, pAnimState->GetWeight() * fAnimationWeightMul);
 			}
 		}
 
@@ -19,11 +19,17 @@
 
 #include "scene/RenderableContainer_BoxTree.h"
 
+#include "scene/RenderableFlatTree.h"
+
 #include "graphics/Renderable.h"
 #include "graphics/Renderer.h"
 #include "graphics/LowLevelGraphics.h"
 
 #include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/JobPool.h"
+
+#include "math/Math.h"
 
 #include <algorithm>
 
@@ -51,6 +57,33 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	//////////////////////////////////////////////////////////////////////////
+	// BUILD JOB
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	class cBoxTreeBuildJob : public iJob
+	{
+	public:
+		cBoxTreeBuildJob(cRenderableContainer_BoxTree *apContainer, cBoxTreeBuildData *apData, int alNode, int alFirst, int alCount) :
+						mpContainer(apContainer), mpData(apData), mlNode(alNode), mlFirst(alFirst), mlCount(alCount) {}
+
+		void Run()
+		{
+			mpContainer->BuildSAHNode(mpData, mlNode, mlFirst, mlCount, false);
+		}
+
+	private:
+		cRenderableContainer_BoxTree *mpContainer;
+		cBoxTreeBuildData *mpData;
+		int mlNode;
+		int mlFirst;
+		int mlCount;
+	};
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -72,6 +105,14 @@ namespace hpl {
 		//will still remian in intersection.
 		mfMinForceIntersectionRelativeSize = 0.8f;
 
+		mbUseSAHBuild = true;
+
+		mlNodeNum = 0;
+		mlLeafNum = 0;
+		mlTreeObjectNum = 0;
+		mfSAHCost = 0;
+		mlCompileTime = 0;
+
 		//Create the root
 		mpRoot = hplNew( cRCNode_BoxTree, ());
 		mpRoot->mpParent = NULL;
@@ -79,6 +120,8 @@ namespace hpl {
 		mpRoot->mbInsideView = true;
 
 		mpObjectCalllback = hplNew( cRenderableContainerObjectCallback, () );
+
+		mpFlatTree = hplNew( cRenderableFlatTree, () );
 	}
 	
 	cRenderableContainer_BoxTree::~cRenderableContainer_BoxTree()
@@ -86,6 +129,7 @@ namespace hpl {
 		if(mpRoot) hplDelete(mpRoot);
 
 		hplDelete( mpObjectCalllback );
+		hplDelete( mpFlatTree );
 	}
 
 	//-----------------------------------------------------------------------
@@ -117,8 +161,20 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	static float GetBoxArea(const cVector3f& avMin, const cVector3f& avMax)
+	{
+		cVector3f vSize = avMax - avMin;
+		if(vSize.x < 0 || vSize.y < 0 || vSize.z < 0) return 0;
+
+		return 2.0f * (vSize.x*vSize.y + vSize.y*vSize.z + vSize.z*vSize.x);
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cRenderableContainer_BoxTree::Compile()
 	{
+		unsigned long lStartTime = cPlatform::GetApplicationTime();
+
 		//Create root (delete first if needed)
 		if(mpRoot) hplDelete(mpRoot);
 		mpRoot = hplNew( cRCNode_BoxTree, ());
@@ -126,22 +182,45 @@ namespace hpl {
 		mpRoot->mfViewDistance =0;
 		mpRoot->mbInsideView = true;
 
-		//Set up temp root node.
-		cBoxTreeTempNode tempRoot(NULL);
-		
-		/////////////////////////////////////////////////
-		//Start by building the temp nodes where every node contains all children (that will later be in child nodes) and
-		//will later be used to easily calculated bounding volume for each node.
-		tRenderableListIt it = m_mlstTempObjects.begin();
-		for(; it != m_mlstTempObjects.end(); ++it)
+		if(mbUseSAHBuild)
 		{
-			tempRoot.mlstObjects.push_back(*it);
+			CompileSAH();
 		}
-		CompileTempNode(&tempRoot,0,-1);
+		else
+		{
+			//Set up temp root node.
+			cBoxTreeTempNode tempRoot(NULL);
+			
+			/////////////////////////////////////////////////
+			//Start by building the temp nodes where every node contains all children (that will later be in child nodes) and
+			//will later be used to easily calculated bounding volume for each node.
+			tRenderableListIt it = m_mlstTempObjects.begin();
+			for(; it != m_mlstTempObjects.end(); ++it)
+			{
+				tempRoot.mlstObjects.push_back(*it);
+			}
+			CompileTempNode(&tempRoot,0,-1);
+
+			//////////////////////////////
+			//Build the actual node tree from temp nodes
+			BuildNodeFromTemp(&tempRoot, mpRoot,0);
+		}
+
+		//Flat copy used when culling
+		mpFlatTree->Build(mpRoot);
+
+		mlCompileTime = (int)(cPlatform::GetApplicationTime() - lStartTime);
 
 		//////////////////////////////
-		//Build the actual node tree from temp nodes
-		BuildNodeFromTemp(&tempRoot, mpRoot,0);
+		//Statistics
+		mlNodeNum = 0;
+		mlLeafNum = 0;
+		mlTreeObjectNum = 0;
+		mfSAHCost = 0;
+		if(m_mlstTempObjects.empty()) return;
+
+		float fRootArea = GetBoxArea(mpRoot->mvMin, mpRoot->mvMax);
+		CalculateTreeStats(mpRoot, fRootArea > 0 ? fRootArea : 1.0f);
 	}
 
 	//-----------------------------------------------------------------------
@@ -355,6 +434,337 @@ namespace hpl {
 		return fLongestSide;
 	}
 
+	//-----------------------------------------------------------------------
+
+	static const int glSAHBinNum = 32;
+
+	static inline int GetSAHBin(float afCenter, float afMin, float afScale)
+	{
+		int lBin = (int)((afCenter - afMin) * afScale);
+		if(lBin < 0) return 0;
+		if(lBin >= glSAHBinNum) return glSAHBinNum-1;
+		return lBin;
+	}
+
+	class cBuildObjectInBins
+	{
+	public:
+		cBuildObjectInBins(int alAxis, float afMin, float afScale, int alMaxBin) : mlAxis(alAxis), mfMin(afMin), mfScale(afScale), mlMaxBin(alMaxBin) {}
+
+		bool operator()(const cBoxTreeBuildObject& aObject) const
+		{
+			return GetSAHBin(aObject.mvCenter.v[mlAxis], mfMin, mfScale) <= mlMaxBin;
+		}
+
+		int mlAxis;
+		float mfMin;
+		float mfScale;
+		int mlMaxBin;
+	};
+
+	class cSortBuildObjectByCenter
+	{
+	public:
+		cSortBuildObjectByCenter(int alAxis) : mlAxis(alAxis) {}
+
+		bool operator()(const cBoxTreeBuildObject& aObjectA, const cBoxTreeBuildObject& aObjectB) const
+		{
+			return aObjectA.mvCenter.v[mlAxis] < aObjectB.mvCenter.v[mlAxis];
+		}
+
+		int mlAxis;
+	};
+
+	//-----------------------------------------------------------------------
+
+	void cRenderableContainer_BoxTree::CompileSAH()
+	{
+		cBoxTreeBuildData buildData;
+
+		/////////////////////////////////////
+		//Gather objects in a flat array
+		int lObjectNum = (int)m_mlstTempObjects.size();
+		buildData.mvObjects.resize(lObjectNum);
+
+		int lIdx=0;
+		for(tRenderableListIt it = m_mlstTempObjects.begin(); it != m_mlstTempObjects.end(); ++it, ++lIdx)
+		{
+			iRenderable *pObject = *it;
+			cBoxTreeBuildObject &buildObject = buildData.mvObjects[lIdx];
+
+			buildObject.mpObject = pObject;
+			buildObject.mvMin = pObject->GetBoundingVolume()->GetMin();
+			buildObject.mvMax = pObject->GetBoundingVolume()->GetMax();
+			buildObject.mvCenter = (buildObject.mvMin + buildObject.mvMax) * 0.5f;
+		}
+
+		//A binary tree with at most one leaf per object never needs more than this.
+		buildData.mvNodes.resize(cMath::Max(lObjectNum*2 - 1, 1));
+
+		/////////////////////////////////////
+		//Build the upper part here and let the subtrees below be built by workers
+		buildData.mpJobPool = NULL;
+		buildData.mpJobBatch = NULL;
+		buildData.mlJobMaxObjects = 0;
+
+		int lThreadNum = cPlatform::GetCPUCount() - 1;
+		if(lThreadNum > 0 && lObjectNum >= 4096)
+		{
+			buildData.mpJobPool = hplNew( cJobPool, (lThreadNum) );
+			buildData.mpJobBatch = hplNew( cJobBatch, () );
+			buildData.mlJobMaxObjects = cMath::Max(lObjectNum / (lThreadNum*4), 1024);
+		}
+
+		BuildSAHNode(&buildData, 0, 0, lObjectNum, buildData.mpJobPool != NULL);
+
+		if(buildData.mpJobPool)
+		{
+			buildData.mpJobPool->WaitForBatch(buildData.mpJobBatch);
+			hplDelete(buildData.mpJobBatch);
+			hplDelete(buildData.mpJobPool);
+		}
+
+		/////////////////////////////////////
+		//Create the actual nodes
+		BuildNodeFromSAH(&buildData, 0, mpRoot);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cRenderableContainer_BoxTree::BuildSAHNode(cBoxTreeBuildData *apData, int alNode, int alFirst, int alCount, bool abAllowJobs)
+	{
+		cBoxTreeBuildNode &node = apData->mvNodes[alNode];
+		node.mlFirst = alFirst;
+		node.mlCount = alCount;
+
+		///////////////////////////
+		// Calculate bounds of the objects and of their centers
+		cVector3f vMin(100000.0f), vMax(-100000.0f);
+		cVector3f vCenterMin(100000.0f), vCenterMax(-100000.0f);
+		for(int i=alFirst; i<alFirst+alCount; ++i)
+		{
+			const cBoxTreeBuildObject &object = apData->mvObjects[i];
+			vMin = cMath::Vector3Min(vMin, object.mvMin);
+			vMax = cMath::Vector3Max(vMax, object.mvMax);
+			vCenterMin = cMath::Vector3Min(vCenterMin, object.mvCenter);
+			vCenterMax = cMath::Vector3Max(vCenterMax, object.mvCenter);
+		}
+		node.mvMin = vMin;
+		node.mvMax = vMax;
+
+		///////////////////////////
+		// Same stop rules as when using split planes
+		float fLongestSide = GetLongestSide(vMax - vMin);
+		if(fLongestSide < mfMinSideLength || alCount < 2) return;
+
+		if(	alCount < mlMinLeafObjects *2 &&
+			alNode != 0 &&
+			fLongestSide < mfMaxSideLength)
+		{
+			return;
+		}
+
+		//Only allow small children if the node must be split because of its size.
+		int lMinChildObjects = alCount >= mlMinLeafObjects*2 ? mlMinLeafObjects : 1;
+
+		///////////////////////////
+		// Find split
+		float fSplitCost=0;
+		int lLeftCount = FindSAHSplit(apData, alFirst, alCount, vCenterMin, vCenterMax, lMinChildObjects, fSplitCost);
+		
+		if(lLeftCount > 0)
+		{
+			//Stop if the split is more expensive than testing all objects, unless forced to split.
+			float fNodeArea = GetBoxArea(vMin, vMax);
+			if(	fNodeArea > 0 && alNode != 0 && fLongestSide < mfMaxSideLength && 
+				1.0f + fSplitCost / fNodeArea >= (float)alCount)
+			{
+				return;
+			}
+		}
+		//No split found among the bins, use the median along the axis the centers are spread the most.
+		else
+		{
+			cVector3f vCenterSize = vCenterMax - vCenterMin;
+			float fLongestCenterSide = GetLongestSide(vCenterSize);
+			if(fLongestCenterSide <= 0) return;
+
+			int lAxis = 0;
+			if(fLongestCenterSide == vCenterSize.y)			lAxis =1;
+			else if(fLongestCenterSide == vCenterSize.z)	lAxis =2;
+
+			lLeftCount = alCount / 2;
+			std::vector<cBoxTreeBuildObject>::iterator firstIt = apData->mvObjects.begin() + alFirst;
+			std::nth_element(firstIt, firstIt + lLeftCount, firstIt + alCount, cSortBuildObjectByCenter(lAxis));
+		}
+
+		///////////////////////////
+		// Build children, a subtree with N objects uses at most 2N-1 nodes following its root.
+		node.mlChildA = alNode + 1;
+		node.mlChildB = alNode + lLeftCount*2;
+
+		int vChildNode[2] = {node.mlChildA, node.mlChildB};
+		int vChildFirst[2] = {alFirst, alFirst + lLeftCount};
+		int vChildCount[2] = {lLeftCount, alCount - lLeftCount};
+
+		for(int i=0; i<2; ++i)
+		{
+			if(abAllowJobs && vChildCount[i] <= apData->mlJobMaxObjects)
+			{
+				apData->mpJobPool->AddJob(hplNew( cBoxTreeBuildJob, (this, apData, vChildNode[i], vChildFirst[i], vChildCount[i]) ), 
+											apData->mpJobBatch);
+			}
+			else
+			{
+				BuildSAHNode(apData, vChildNode[i], vChildFirst[i], vChildCount[i], abAllowJobs);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Returns number of objects in the first child (objects are partitioned) or -1 if no valid split was found.
+	 * afCost is set to the summed area times object count of the children.
+	 */
+	int cRenderableContainer_BoxTree::FindSAHSplit(	cBoxTreeBuildData *apData, int alFirst, int alCount, const cVector3f &avCenterMin, const cVector3f &avCenterMax,
+													int alMinChildObjects, float &afCost)
+	{
+		float fBestCost = -1;
+		int lBestAxis = -1;
+		int lBestBin = -1;
+
+		cVector3f vBinMin[glSAHBinNum];
+		cVector3f vBinMax[glSAHBinNum];
+		int vBinCount[glSAHBinNum];
+		float vRightArea[glSAHBinNum];
+		int vRightCount[glSAHBinNum];
+
+		for(int lAxis=0; lAxis<3; ++lAxis)
+		{
+			float fCenterMin = avCenterMin.v[lAxis];
+			float fExtent = avCenterMax.v[lAxis] - fCenterMin;
+			if(fExtent <= 0) continue;
+
+			float fScale = (float)glSAHBinNum / fExtent;
+
+			////////////////////////////
+			// Fill bins
+			for(int i=0; i<glSAHBinNum; ++i)
+			{
+				vBinMin[i] = cVector3f(100000.0f);
+				vBinMax[i] = cVector3f(-100000.0f);
+				vBinCount[i] = 0;
+			}
+
+			for(int i=alFirst; i<alFirst+alCount; ++i)
+			{
+				const cBoxTreeBuildObject &object = apData->mvObjects[i];
+				int lBin = GetSAHBin(object.mvCenter.v[lAxis], fCenterMin, fScale);
+
+				vBinMin[lBin] = cMath::Vector3Min(vBinMin[lBin], object.mvMin);
+				vBinMax[lBin] = cMath::Vector3Max(vBinMax[lBin], object.mvMax);
+				vBinCount[lBin]++;
+			}
+
+			////////////////////////////
+			// Sweep from the right to get area and count of everything above each bin
+			cVector3f vMin(100000.0f), vMax(-100000.0f);
+			int lCount=0;
+			for(int i=glSAHBinNum-1; i>0; --i)
+			{
+				vMin = cMath::Vector3Min(vMin, vBinMin[i]);
+				vMax = cMath::Vector3Max(vMax, vBinMax[i]);
+				lCount += vBinCount[i];
+
+				vRightArea[i] = GetBoxArea(vMin, vMax);
+				vRightCount[i] = lCount;
+			}
+
+			////////////////////////////
+			// Sweep from the left and evaluate a split after each bin
+			vMin = cVector3f(100000.0f);
+			vMax = cVector3f(-100000.0f);
+			lCount=0;
+			for(int i=0; i<glSAHBinNum-1; ++i)
+			{
+				vMin = cMath::Vector3Min(vMin, vBinMin[i]);
+				vMax = cMath::Vector3Max(vMax, vBinMax[i]);
+				lCount += vBinCount[i];
+
+				if(lCount < alMinChildObjects || vRightCount[i+1] < alMinChildObjects) continue;
+
+				float fCost = GetBoxArea(vMin, vMax) * (float)lCount + vRightArea[i+1] * (float)vRightCount[i+1];
+				if(fCost < fBestCost || fBestCost < 0)
+				{
+					fBestCost = fCost;
+					lBestAxis = lAxis;
+					lBestBin = i;
+				}
+			}
+		}
+
+		if(lBestAxis < 0) return -1;
+
+		afCost = fBestCost;
+
+		////////////////////////////
+		// Partition the objects
+		float fCenterMin = avCenterMin.v[lBestAxis];
+		float fScale = (float)glSAHBinNum / (avCenterMax.v[lBestAxis] - fCenterMin);
+
+		std::vector<cBoxTreeBuildObject>::iterator firstIt = apData->mvObjects.begin() + alFirst;
+		std::vector<cBoxTreeBuildObject>::iterator splitIt = std::partition(firstIt, firstIt + alCount, 
+																			cBuildObjectInBins(lBestAxis, fCenterMin, fScale, lBestBin));
+		
+		return (int)(splitIt - firstIt);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cRenderableContainer_BoxTree::BuildNodeFromSAH(cBoxTreeBuildData *apData, int alBuildNode, cRCNode_BoxTree *apNode)
+	{
+		cBoxTreeBuildNode &buildNode = apData->mvNodes[alBuildNode];
+
+		////////////////////////////
+		//Create the bounding volume, box and sphere
+		apNode->mvMin = buildNode.mvMin;
+		apNode->mvMax = buildNode.mvMax;
+		apNode->mvCenter = (apNode->mvMax + apNode->mvMin) *0.5f;
+		apNode->mfRadius = (apNode->mvMax - apNode->mvMin).Length()*0.5f;
+
+		////////////////////////////
+		//If leaf, add objects.
+		if(buildNode.mlChildA < 0)
+		{
+			for(int i=buildNode.mlFirst; i<buildNode.mlFirst+buildNode.mlCount; ++i)
+			{
+				iRenderable *pObject = apData->mvObjects[i].mpObject;
+
+				apNode->mlstObjects.push_back(pObject);
+
+				//Set object callback and node.
+				pObject->SetRenderCallback(mpObjectCalllback);
+				pObject->SetRenderContainerNode(apNode);
+			}
+			return;
+		}
+
+		////////////////////////////
+		//Add children
+		int vChildren[2] = {buildNode.mlChildA, buildNode.mlChildB};
+		for(int i=0; i<2; ++i)
+		{
+			cRCNode_BoxTree *pChildNode = hplNew(cRCNode_BoxTree, () );
+			pChildNode->mpParent = apNode;
+			apNode->mlstChildNodes.push_back(pChildNode);
+
+			BuildNodeFromSAH(apData, vChildren[i], pChildNode);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 	
 	void cRenderableContainer_BoxTree::CompileTempNode(cBoxTreeTempNode *apNode, int alLevel, int alSplitAxis)
 	{
@@ -728,6 +1138,31 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cRenderableContainer_BoxTree::CalculateTreeStats(cRCNode_BoxTree *apNode, float afRootArea)
+	{
+		mlNodeNum++;
+		mlTreeObjectNum += (int)apNode->mlstObjects.size();
+
+		float fRelArea = GetBoxArea(apNode->mvMin, apNode->mvMax) / afRootArea;
+		
+		if(apNode->mlstChildNodes.empty())
+		{
+			mlLeafNum++;
+			mfSAHCost += fRelArea * (float)apNode->mlstObjects.size();
+			return;
+		}
+
+		mfSAHCost += fRelArea;
+
+		tRenderableContainerNodeListIt childIt = apNode->mlstChildNodes.begin();
+		for(; childIt != apNode->mlstChildNodes.end(); ++childIt)
+		{
+			CalculateTreeStats(static_cast<cRCNode_BoxTree*>(*childIt), afRootArea);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cRenderableContainer_BoxTree::CalculateMinMax(tRenderableList *apObjectList, cVector3f& avMin, cVector3f& avMax)
 	{
 		cVector3f vNodeMin(100000.0f);
@@ -46,88 +46,45 @@ namespace hpl {
 	
 	//-----------------------------------------------------------------------
 
-	static tString gsTempSpaces="";
-
-	static const char *GetSpaces(int alNum)
+	static inline float GetSurfaceArea(const cVector3f& avMin, const cVector3f& avMax)
 	{
-		gsTempSpaces.resize(alNum,'\t');
-		return gsTempSpaces.c_str();		
+		cVector3f vSize = avMax - avMin;
+		return 2.0f*(vSize.x*vSize.y + vSize.y*vSize.z + vSize.z*vSize.x);
 	}
 
-	//-----------------------------------------------------------------------
-
-	static bool TestAndExpandNodeAABB(iRenderable *apObject, cVector3f& avNodeMin,cVector3f& avNodeMax)
+	static inline float GetUnionSurfaceArea(const cVector3f& avMinA, const cVector3f& avMaxA, const cVector3f& avMinB, const cVector3f& avMaxB)
 	{
-		const cVector3f &vMin = apObject->GetBoundingVolume()->GetMin();
-		const cVector3f &vMax = apObject->GetBoundingVolume()->GetMax();
-
-		//////////////////////////////////
-		//Check if object is inside
-		if(cMath::CheckAABBInside(vMin,vMax, avNodeMin, avNodeMax)) return false;
-
-		//////////////////////////////////
-		//Calculate the new AABB
-		cMath::ExpandAABB(avNodeMin, avNodeMax, vMin, vMax);
-
-		return true;
+		cVector3f vMin = avMinA;
+		cVector3f vMax = avMaxA;
+		cMath::ExpandAABB(vMin, vMax, avMinB, avMaxB);
+		return GetSurfaceArea(vMin, vMax);
 	}
 
-	//-----------------------------------------------------------------------
-
-	static bool CheckObjectIsAtEdgeOfAABB(iRenderable *apObject, const cVector3f& avNodeMin, const cVector3f& avNodeMax)
+	static inline float GetNodeUnionArea(cRCNode_DynBoxTree *apNodeA, cRCNode_DynBoxTree *apNodeB)
 	{
-		const cVector3f &vMin = apObject->GetBoundingVolume()->GetMin();
-		const cVector3f &vMax = apObject->GetBoundingVolume()->GetMax();
-
-		//if(	vMin.x == avNodeMin.x || vMin.y == avNodeMin.y || vMin.z == avNodeMin.z ||
-		//	vMax.x == avNodeMax.x || vMax.y == avNodeMax.y || vMax.z == avNodeMax.z)
-		if(	cMath::Abs(vMin.x - avNodeMin.x)<kEpsilonf || 
-			cMath::Abs(vMin.y - avNodeMin.y)<kEpsilonf || 
-			cMath::Abs(vMin.z - avNodeMin.z)<kEpsilonf ||
-			
-			cMath::Abs(vMax.x - avNodeMax.x)<kEpsilonf || 
-			cMath::Abs(vMax.y - avNodeMax.y)<kEpsilonf || 
-			cMath::Abs(vMax.z - avNodeMax.z)<kEpsilonf)
-		{
-			return true;
-		}
-		
-		return false;
+		return GetUnionSurfaceArea(apNodeA->GetMin(), apNodeA->GetMax(), apNodeB->GetMin(), apNodeB->GetMax());
 	}
 
-	//-----------------------------------------------------------------------
-
-	//0=x, 1=y, 2=z
-	static float GetAxisFromVec(const cVector3f& avVec, int alAxis)
+	static inline float GetNodeArea(cRCNode_DynBoxTree *apNode)
 	{
-		switch(alAxis)
-		{
-		case 0: return avVec.x;
-		case 1: return avVec.y;
-		case 2: return avVec.z;
-		}
-
-		return 0;
+		return GetSurfaceArea(apNode->GetMin(), apNode->GetMax());
 	}
 
 	//-----------------------------------------------------------------------
 
-	static bool SortFunc_X(iRenderable* apObjectA, iRenderable *apObjectB)
+	class cSortLeavesByCenter
 	{
-		return apObjectA->GetBoundingVolume()->GetWorldCenter().x < apObjectB->GetBoundingVolume()->GetWorldCenter().x;
-	}
-	static bool SortFunc_Y(iRenderable* apObjectA, iRenderable *apObjectB)
-	{
-		return apObjectA->GetBoundingVolume()->GetWorldCenter().y < apObjectB->GetBoundingVolume()->GetWorldCenter().y;
-	}
-	static bool SortFunc_Z(iRenderable* apObjectA, iRenderable *apObjectB)
-	{
-		return apObjectA->GetBoundingVolume()->GetWorldCenter().z < apObjectB->GetBoundingVolume()->GetWorldCenter().z;
-	}
+	public:
+		cSortLeavesByCenter(int alAxis) : mlAxis(alAxis){}
 
-	typedef bool (*tSortFunc)(iRenderable*,iRenderable*); 
-	static tSortFunc gvSortFunctions[3] = {SortFunc_X, SortFunc_Y,SortFunc_Z};
+		bool operator()(cRCNode_DynBoxTree *apLeafA, cRCNode_DynBoxTree *apLeafB) const
+		{
+			return apLeafA->GetCenter().v[mlAxis] < apLeafB->GetCenter().v[mlAxis];
+		}
 
+	private:
+		int mlAxis;
+	};
 	
 	//-----------------------------------------------------------------------
 
@@ -165,452 +122,70 @@ namespace hpl {
 	cRCNode_DynBoxTree::cRCNode_DynBoxTree()
 	{
 		mpParent = NULL;
-		mbRecalculateSplit = false;
-		mbRecalculateAABB = false;
-
-		mbIsSplit = false;
-
-		mbRecalculateSplitAxis = true;
-		mlSplitAxis = -1;
-		mfSplitPlane =0;
+		mpContainer = NULL;
 
 		mbUsesFlagsAndVisibility = false;
 
-		mlGarbageCollectCount =0;
-		mlIgnoreSplitCount =0;
+		mvMin =0;
+		mvMax =0;
+		mvCenter =0;
+		mfRadius =0;
 
-		mvMeanPosition =0;
+		mvInsertPosition =0;
 	}
 
 	//-----------------------------------------------------------------------
 
 	cRCNode_DynBoxTree::~cRCNode_DynBoxTree()
 	{
-		//Log("Deleting %d\n", this);
 		STLDeleteAll(mlstChildNodes);
 	}
 
 	//-----------------------------------------------------------------------
 
-	void cRCNode_DynBoxTree::UpdateBeforeUse()
+	cRCNode_DynBoxTree* cRCNode_DynBoxTree::GetSibling(cRCNode_DynBoxTree *apChild)
 	{
-		//////////////////////////////////
-		// Garbage collect check
-		//  Use the var mbRecalculateSplit to see if anything has changed, else there is no use in a garbage collection.
-		if(mbObjectMoved)
-		{
-			//////////////
-			//Time for collection, counter is done
-			if(mlGarbageCollectCount <=0)
-			{
-				if(gbLog){
-					Log(" Check garbage collecion for node %d\n", this);
-				}
-
-				mlGarbageCollectCount = mpContainer->mlMaxGarbageCollectCount;
-
-				////////////////////////////////////////
-				// Make sure AABB is updated and as tight as possible
-				mbRecalculateAABB = true;
-
-				///////////////////////////////////////////
-				//Check if any child nodes are leaves and if so the total number of objects are 
-				// less then split threshold. If so, delete that node.
-				if(HasChildNodes())
-				{
-					cRCNode_DynBoxTree *pChild1 = static_cast<cRCNode_DynBoxTree*>(mlstChildNodes.front());
-					cRCNode_DynBoxTree *pChild2 = static_cast<cRCNode_DynBoxTree*>(mlstChildNodes.back());
-
-					//What lower limit is best really?
-					int lLowerObjectLimit = mpContainer->mlSplitThreshold;
-					//int lLowerObjectLimit = (mpContainer->mlSplitThreshold*2)/3;
-					//int lLowerObjectLimit = mpContainer->mlSplitThreshold - 2;
-					
-					//Check if nodes are leaves and if they have few enough objects
-					if(	pChild1->HasChildNodes()==false && pChild2->HasChildNodes()==false &&
-						(pChild1->GetObjectNum() + pChild2->GetObjectNum() + GetObjectNum() < lLowerObjectLimit))
-					{
-						if(gbLog){
-							Log("  Collection garbage!\n");
-						}
-						
-						//Iterate child nodes
-						tRenderableContainerNodeListIt nodeIt = mlstChildNodes.begin();
-						for(; nodeIt != mlstChildNodes.end(); ++nodeIt)
-						{
-							//Copy child object to this node
-							cRCNode_DynBoxTree *pChildNode = static_cast<cRCNode_DynBoxTree*>(*nodeIt);
-
-							tRenderableListIt objIt = pChildNode->mlstObjects.begin();
-							for(; objIt != pChildNode->mlstObjects.end(); ++objIt)
-							{
-								iRenderable *pObject = *objIt;
-								
-								pObject->SetRenderContainerNode(this);
-								mlstObjects.push_back(pObject);
-							}
-						}
-
-						STLDeleteAll(mlstChildNodes);
-						mbIsSplit = false;	//Reset that it is split;
-						mbRecalculateSplitAxis = true;	//Need a new split axis!
-					}
-				}
-
-
-				/////////////////////////////
-				//Recalculate the split axis this time if there is enough objects
-				// or if a node was deleted.
-				if((int)mlstObjects.size() >= mpContainer->mlSplitThreshold)	
-				{
-					mbRecalculateSplitAxis = true;
-				}
-			}
-			////////////////
-			//Just decrement the counter.
-			else 
-			{
-				--mlGarbageCollectCount;
-			}
-		}
-
-
-		//////////////////////////////////
-		// AABB update
-		if(mbRecalculateAABB)
-		{
-			if(gbLog){
-				Log(" Recalculating AABB for node %d\n", this);
-			}
-
-			mbRecalculateAABB = false;
-
-			//Calculate the AABB based on the objects (if any)
-			if(HasObjects()) CalculateMinMaxFromObjects();
-
-			//Increase the AABB based on children.
-			if(HasChildNodes())
-			{
-				cRCNode_DynBoxTree* pNodeA = static_cast<cRCNode_DynBoxTree*>(mlstChildNodes.front());
-				cRCNode_DynBoxTree* pNodeB = static_cast<cRCNode_DynBoxTree*>(mlstChildNodes.back());
-
-				cMath::ExpandAABB(mvMin,mvMax, pNodeA->GetMin(), pNodeA->GetMax());
-				cMath::ExpandAABB(mvMin,mvMax, pNodeB->GetMin(), pNodeB->GetMax());
-			}
-
-			//Sphere center and radius
-			mvCenter = (mvMax + mvMin) *0.5f;
-			mfRadius = (mvMax - mvMin).Length()*0.5f;            
-		}
-
-		//////////////////////////////////
-		// Check if a recalculate of split axis is really needed.
-		if(mbRecalculateSplit)
-		{
-			if(GetObjectNum() < mpContainer->mlSplitThreshold && HasChildNodes()==false)
-			{
-				mbRecalculateSplit = false;
-			}
-		}
-		else
-		{
-			//Always recalculate the split plane before a split
-			if(mbIsSplit==false && GetObjectNum() >= mpContainer->mlSplitThreshold)
-			{
-				mbRecalculateSplit = true;
-			}
-		}
-		
-		//////////////////////////////////
-		// Recalculate the split properties
-		if(mbRecalculateSplit)
-		{
-			if(gbLog){
-				Log(" Recalculating split for node %d\n", this);
-			}
-			
-			mbRecalculateSplit = false;
-			
-			////////////////////////////////////////
-			// Get the split axis (only do once or else the tree will become a mess!)
-			if(mbRecalculateSplitAxis)
-			{
-				mbRecalculateSplitAxis = false;
-
-				cVector3f vNodeSize = mvMax - mvMin;
-
-				float fLongestSide = vNodeSize.x;
-				mlSplitAxis =0;
-				if(fLongestSide < vNodeSize.y){	
-					fLongestSide = vNodeSize.y;
-					mlSplitAxis = 1;
-				}
-				if(fLongestSide < vNodeSize.z){	
-					fLongestSide = vNodeSize.z;	
-					mlSplitAxis = 2;
-				}
-			}
-
-			////////////////////////////////////////
-			// Calculate the split plane by taking the average of all objects's centers
-			// and the nodes split planes (but with more weight(.
-
-			/*cVector3f vPosSum=0;
-			float fWeightSum=0;
-			
-			//Objects
-			if(mlstObjects.empty()==false)
-			{
-				tRenderableListIt it = mlstObjects.begin();
-				for(; it != mlstObjects.end(); ++it)
-				{
-					iRenderable *pObject = *it;
-
-					vPosSum += 	pObject->GetBoundingVolume()->GetPosition();
-					fWeightSum += 1;
-				}
-			}
-
-			//Nodes
-			if(HasChildNodes())
-			{
-				tRenderableContainerNodeListIt it = mlstChildNodes.begin();
-				for(; it != mlstChildNodes.end(); ++it)
-				{
-					cRCNode_DynBoxTree *pChildNode = static_cast<cRCNode_DynBoxTree*>(*it);
-					
-					float fObjNum = (float)pChildNode->mlstObjects.size();
-					vPosSum += pChildNode->mvMeanPosition * fObjNum;
-                    fWeightSum += fObjNum;
-				}
-			}
-
-			mvMeanPosition = vPosSum / fWeightSum;
-            mfSplitPlane = mvMeanPosition.v[mlSplitAxis];*/
-		
-			
-			
-			float fPosSum =0;
-			float fWeightSum = 0;
-
-			//Objects
-			if(mlstObjects.empty()==false)
-			{
-				tRenderableListIt it = mlstObjects.begin();
-				for(; it != mlstObjects.end(); ++it)
-				{
-					iRenderable *pObject = *it;
-
-					fPosSum += 	GetAxisFromVec(pObject->GetBoundingVolume()->GetPosition(), mlSplitAxis);
-					fWeightSum += 1;
-				}
-			}
-
-			//Nodes
-			if(HasChildNodes())
-			{
-				float fPosMul = (float)mpContainer->mlSplitThreshold;
-				tRenderableContainerNodeListIt it = mlstChildNodes.begin();
-                for(; it != mlstChildNodes.end(); ++it)
-				{
-					cRCNode_DynBoxTree *pChildNode = static_cast<cRCNode_DynBoxTree*>(*it);
-
-					//Use split plane if axes are the same
-                    if(pChildNode->mlSplitAxis == mlSplitAxis)
-					{
-						fPosSum += pChildNode->mfSplitPlane * fPosMul;
-						fWeightSum += fPosMul;	
-					}
-					//Else just use AABB center
-					else
-					{
-						fPosSum += pChildNode->mvCenter.v[mlSplitAxis] * fPosMul;
-						fWeightSum += fPosMul;
-					}
-				}
-			}
-
-            mfSplitPlane = fPosSum / fWeightSum;
-		}
+		iRenderableContainerNode *pFront = mlstChildNodes.front();
+		return static_cast<cRCNode_DynBoxTree*>(pFront == apChild ? mlstChildNodes.back() : pFront);
+	}
 
+	//-----------------------------------------------------------------------
 
-		//////////////////////////////////
-		// If enough objects, create children and objects to them.
-		// Also make sure that the node does not already have childe nodes!
-        if(	(int)mlstObjects.size() >= mpContainer->mlSplitThreshold &&
-			HasChildNodes()==false)
+	void cRCNode_DynBoxTree::ReplaceChild(cRCNode_DynBoxTree *apOldChild, cRCNode_DynBoxTree *apNewChild)
+	{
+		//Assign in place so the child list is never reallocated.
+		tRenderableContainerNodeListIt it = mlstChildNodes.begin();
+		for(; it != mlstChildNodes.end(); ++it)
 		{
-			/////////////
-			//Check if tree has already been split
-			if(mbIsSplit)
+			if(*it == apOldChild)
 			{
-				//There has been any object changes in thenode, lower the ignore split count
-				// this will mean that split can be recalculated later on, but not very often.
-                if(mbObjectMoved)
-				{
-					mlIgnoreSplitCount--;
-					if(mlIgnoreSplitCount <=0)
-					{
-						mbIsSplit = false;
-					}
-				}
-			}
-			/////////////
-			// Tree is really in need of split
-			else
-			{
-				if(gbLog){
-					Log(" Splitting node %d\n", this);
-					Log(" --------------------\n", this);
-				}
-
-				mbIsSplit = true;
-				mlIgnoreSplitCount = mpContainer->mlMaxIgnoreSplitCount;
-
-				///////////////////////////////////
-				// Setup before objects are added
-				cVector3f vNodeSize = GetMax() - GetMin();
-				
-				std::vector<iRenderable*> vTempObjects;
-				vTempObjects.resize(mlstObjects.size());
-
-				int lCount =0;
-				for(tRenderableListIt it = mlstObjects.begin(); it != mlstObjects.end(); ++it,++lCount)
-				{
-					vTempObjects[lCount] = *it;	
-				}
-				
-				mlstObjects.clear();
-
-				tRenderableList lstChildObjects[2];
-			
-				
-				///////////////////////////////////
-				// Iterate 
-				for(size_t i=0; i<vTempObjects.size(); ++i)
-				{
-					iRenderable *pObject = vTempObjects[i];
-
-					int lSplitGroup = mpContainer->GetSplitGroup(pObject,mfSplitPlane, mlSplitAxis ,vNodeSize);
-
-					/////////////////////////////
-					// If object is intersecting then add to this node, else add to a child.
-					if(lSplitGroup == 2)
-					{
-						mlstObjects.push_back(pObject);	
-						if(gbLog){
-							Log("  Object '%s'/%d stay put\n", pObject->GetName().c_str(), pObject);
-						}
-					}
-					else 
-					{
-						//Add to child list
-						lstChildObjects[lSplitGroup].push_back(pObject);
-						if(gbLog){
-							Log("  Object '%s'/%d moved to node %d\n", pObject->GetName().c_str(), pObject, lSplitGroup);
-						}
-					}
-				}
-
-				//////////////////////////////////
-				// If either child object list is empty, add objects back to node
-				if(lstChildObjects[0].empty() ||  lstChildObjects[1].empty())
-				{
-					for(int i=0; i<2; ++i)
-					for(tRenderableListIt it = lstChildObjects[i].begin(); it != lstChildObjects[i].end(); ++it)
-					{
-						mlstObjects.push_back(*it);
-					}
-				}
-				//////////////////////////////////
-				// If split worked, create child nodes and add objects to them
-				else
-				{
-					///////////////////////////////////
-					// Create and setup child nodes
-					// Make sure to create mean position here too! ( can remove later on?)
-					for(int i=0; i<2; ++i)
-					{
-						cRCNode_DynBoxTree* pChildNode = hplNew( cRCNode_DynBoxTree, () ); 
-						pChildNode->mpContainer = mpContainer;
-						pChildNode->mpParent = this;
-
-						mlstChildNodes.push_back(pChildNode);
-						
-                        pChildNode->mvMeanPosition =0;                        
-						for(tRenderableListIt it = lstChildObjects[i].begin(); it != lstChildObjects[i].end(); ++it)
-						{
-							iRenderable *pObject = *it;
-							
-							pChildNode->mlstObjects.push_back(pObject);
-
-							pChildNode->mvMeanPosition += pObject->GetBoundingVolume()->GetWorldCenter();
-
-							//Set new node to object
-							pObject->SetRenderContainerNode(pChildNode);
-						}
-
-						pChildNode->mvMeanPosition = pChildNode->mvMeanPosition / (float)lstChildObjects[i].size();
-
-						pChildNode->RecalculateSplit();
-						pChildNode->RecalculateAABB();
-
-						/////////////////////////////////////
-						//Just to be extra sure, caclulate proper AABB directly!
-						pChildNode->CalculateMinMaxFromObjects();
-						//Sphere center and radius
-						pChildNode->mvCenter = (pChildNode->mvMax + pChildNode->mvMin) *0.5f;
-						pChildNode->mfRadius = (pChildNode->mvMax - pChildNode->mvMin).Length()*0.5f;
-					}
-				}
-
-				if(gbLog){
-					Log(" --------------------\n", this);
-				}
+				*it = apNewChild;
+				break;
 			}
 		}
-
-		//////////////////////////////////
-		// Reset variables
-		mbObjectMoved = false;
-	}
-
-	//-----------------------------------------------------------------------
-
-	void cRCNode_DynBoxTree::RemoveObject(iRenderable *apObject)
-	{
-		/////////////////////////////////
-		// Remove object from list and clears node list
-		STLFindAndRemove(mlstObjects, apObject);
+		apNewChild->mpParent = this;
 	}
 	
 	//-----------------------------------------------------------------------
 
-	void cRCNode_DynBoxTree::RecalculateSplit()
+	void cRCNode_DynBoxTree::UpdateAABBFromChildren()
 	{
-		mbRecalculateSplit = true;
-
-		//No need to push up, since recalculation is called on all nodes where AABB is changed.
-	}
-
-	//-----------------------------------------------------------------------
+		cRCNode_DynBoxTree* pNodeA = static_cast<cRCNode_DynBoxTree*>(mlstChildNodes.front());
+		cRCNode_DynBoxTree* pNodeB = static_cast<cRCNode_DynBoxTree*>(mlstChildNodes.back());
 
-	void cRCNode_DynBoxTree::RecalculateAABB()
-	{
-		mbRecalculateAABB = true;
+		mvMin = pNodeA->mvMin;
+		mvMax = pNodeA->mvMax;
+		cMath::ExpandAABB(mvMin,mvMax, pNodeB->mvMin, pNodeB->mvMax);
 
-		//Do calculation in BeforeUse()...
+		UpdateSphere();
 	}
 
 	//-----------------------------------------------------------------------
 
-	void cRCNode_DynBoxTree::ObjectMoved()
+	void cRCNode_DynBoxTree::UpdateSphere()
 	{
-		if(mbObjectMoved) return;
-
-		mbObjectMoved = true;
-		cRCNode_DynBoxTree* pParentNode = static_cast<cRCNode_DynBoxTree*>(mpParent);       
-		if(pParentNode) pParentNode->ObjectMoved();
+		mvCenter = (mvMax + mvMin) *0.5f;
+		mfRadius = (mvMax - mvMin).Length()*0.5f;
 	}
 
 	//-----------------------------------------------------------------------
@@ -623,26 +198,20 @@ namespace hpl {
 	
 	cRenderableContainer_DynBoxTree::cRenderableContainer_DynBoxTree()
 	{
-		mlSplitThreshold = 30;		//Number of objects a node should have before split.
-
-		mlMaxGarbageCollectCount = 60;		//How often (measured in accesses with change, meaning when the renderer checks the node and there has been some movement)
-											//certain a "garbage check should be made. This means:
-											//- If node has leaves as children, check so that the child objects contained is equal or greater then then split threshold
-											//  else move all the objects in the child nodes to the node.
-											//- Recalculate the split axis.
-
-		mlMaxIgnoreSplitCount = 30;			//How often new splits should be done, after the first split has been made.
-											//If objects are removed from child nodes they may be deleted and an already split
-											//node is without child nodes. If the object here grows to split size a new split can happen
-											//but only after a number of checks determined by this variable.
-											//Node: IsSplit variable cannot be reseted since there are cases when there are enough objects but all
-											//will go into the same child node and eternal iteration ensues.
+		mfLeafMargin = 0.1f;		//How much the leaf AABBs are enlarged on each side, objects moving inside this margin do not change the tree.
+		mfDisplacementMul = 2.0f;	//How far ahead (measured in the movement since last insert) the leaf AABB is extended when an object is reinserted.
+		mfMaxFatAreaMul = 4.0f;		//If the leaf AABB has an area this many times larger than needed (object shrunk or stopped), the object is reinserted.
 
-		mfMaxIntersectionAmount = 0.2f;		//The amount (1=100%) an object can be over the splitting line and still not be an intersecting object
-											//Also is the amount by which a new AABB can be expanded.
+		mlRebuildCount = -1;		//Number of tree changes left before a queued rebuild is made, -1 means no rebuild is queued.
+		mlLeafNum =0;
 
-		mlMaxRebuildCount = 600;			//The number changes the need to occur in the tree before it is rebuilt from scratch.
-		mlRebuildCount = mlMaxRebuildCount;
+		mlReinsertCount =0;
+		mlRotationCount =0;
+		mlRebuildNum =0;
+		mlFrameReinsertCount =0;
+		mlFrameRotationCount =0;
+		mlFrameRebuildCount =0;
+		mlStatsFrameCount = -1;
 
 		mRoot.mpContainer = this;
 		mRoot.mpParent = NULL;
@@ -655,6 +224,8 @@ namespace hpl {
 	cRenderableContainer_DynBoxTree::~cRenderableContainer_DynBoxTree()
 	{
 		hplDelete( mpObjectCalllback );
+
+		STLDeleteAll(mvFreeNodes);
 	}
 
 	//-----------------------------------------------------------------------
@@ -672,11 +243,14 @@ namespace hpl {
 		}
 	
 		///////////////////////////////////////////
-		//Get the node where object is to be added and then add it there.
-		cRCNode_DynBoxTree *pNode = GetAddNode(&mRoot, apRenderable);
+		//Create a leaf for the object and insert it in the tree
+		cRCNode_DynBoxTree *pLeaf = CreateNode();
+		pLeaf->mlstObjects.push_back(apRenderable);
+		apRenderable->SetRenderContainerNode(pLeaf);
 
-		pNode->mlstObjects.push_back(apRenderable);
-		apRenderable->SetRenderContainerNode(pNode);
+		SetLeafAABB(pLeaf, apRenderable, 0);
+		InsertLeaf(pLeaf);
+		++mlLeafNum;
 
 		/////////////////////////
 		//Add callbacks
@@ -684,20 +258,11 @@ namespace hpl {
 		apRenderable->AddCallback(mpObjectCalllback);
 
 		if(gbLog || HasDebug(apRenderable)){
-			Log("Added object '%s' / %d to Node %d\n",apRenderable->GetName().c_str(), apRenderable, pNode);
-
-			Log("Objects:\n");
-			tRenderableList *pObjList = pNode->GetObjectList();
-			for(tRenderableListIt it = pObjList->begin(); it != pObjList->end(); ++it)
-			{
-				iRenderable *pObj = *it;
-				tString sParent = pObj->GetEntityParent() ? pObj->GetEntityParent()->GetName() : "NULL";
-				Log(" '%s'id: %d  parent: '%s' size: %s\n", pObj->GetName().c_str(),pObj->GetUniqueID(),sParent.c_str(), pObj->GetBoundingVolume()->GetSize().ToString().c_str());
-			}
+			Log("Added object '%s' / %d to leaf %d with parent %d\n",apRenderable->GetName().c_str(), apRenderable, pLeaf, pLeaf->GetParent());
 		}
 
-		//Increase rebuild count.
-		mlRebuildCount--;
+		++mlReinsertCount;
+		if(mlRebuildCount >0) mlRebuildCount--;
 	}
 
 	//-----------------------------------------------------------------------
@@ -712,35 +277,20 @@ namespace hpl {
 		}
 		
 		//////////////////////////////////
-		// Get the node where the object is
-		cRCNode_DynBoxTree *pNode = static_cast<cRCNode_DynBoxTree*>(apRenderable->GetRenderContainerNode());	//Assume one node only
-		if(pNode==NULL) return;
+		// Get the leaf of the object
+		cRCNode_DynBoxTree *pLeaf = static_cast<cRCNode_DynBoxTree*>(apRenderable->GetRenderContainerNode());
+		if(pLeaf==NULL) return;
 
 		if(gbLog  || HasDebug(apRenderable)){
-			Log("Removing object '%s' / %d from node %d\n",apRenderable->GetName().c_str(), apRenderable, pNode);
+			Log("Removing object '%s' / %d from leaf %d\n",apRenderable->GetName().c_str(), apRenderable, pLeaf);
 		}
 
 		//////////////////////////////////
-		// Remove object from node.
-        pNode->RemoveObject(apRenderable);
-
-		//////////////////////////////////
-		// If nodes is leaf, has no objects left and is not the root, delete it.
-		if(	pNode->HasChildNodes()==false && pNode->HasObjects()==false && pNode->GetParent() != NULL)
-		{
-			if(gbLog || HasDebug(apRenderable)){
-				Log(" Remove node %d\n", pNode);
-			}
-			RemoveNode(pNode);
-		}
-		// If not, check if AABB update is needed.
-		else
-		{
-			if(gbLog || HasDebug(apRenderable)){
-				Log(" Iterate AABB update for node %d\n", pNode);
-			}
-			CheckNodeAABBNeedsUpdateIterative(pNode,apRenderable);
-		}
+		// Remove leaf from tree and destroy it
+		RemoveLeaf(pLeaf);
+		pLeaf->mlstObjects.clear();
+		DestroyNode(pLeaf);
+		--mlLeafNum;
 		
 		////////////////////////
 		//Remove callbacks
@@ -748,8 +298,7 @@ namespace hpl {
 		apRenderable->SetRenderCallback(NULL);
 		apRenderable->RemoveCallback(mpObjectCalllback);
 
-		//Increase rebuild count.
-		mlRebuildCount--;
+		if(mlRebuildCount >0) mlRebuildCount--;
 	}
 
 	//-----------------------------------------------------------------------
@@ -797,31 +346,23 @@ namespace hpl {
 	//////////////////////////////////////////////////////////////////////////
 	
 	//-----------------------------------------------------------------------
-	
-	void cRenderableContainer_DynBoxTree::AddNodeObjectsToRoot(cRCNode_DynBoxTree *apNode)
+
+	void cRenderableContainer_DynBoxTree::SpecificUpdateBeforeRendering()
 	{
-		tRenderableListIt objIt = apNode->mlstObjects.begin();
-		for(; objIt != apNode->mlstObjects.end(); ++objIt)
+		///////////////////////////////////
+		// Store counts for the last frame. This is called several times a frame (shadows, occlusion), so only at the first call.
+		if(mlStatsFrameCount != iRenderer::GetRenderFrameCount())
 		{
-			iRenderable *pObject = *objIt;
-			
-			pObject->SetRenderContainerNode(&mRoot);
-			mRoot.mlstObjects.push_back(pObject);
-		}
+			mlStatsFrameCount = iRenderer::GetRenderFrameCount();
 
-		tRenderableContainerNodeListIt nodeIt = apNode->mlstChildNodes.begin();
-		for(; nodeIt != apNode->mlstChildNodes.end(); ++nodeIt)
-		{
-			cRCNode_DynBoxTree *pChildNode = static_cast<cRCNode_DynBoxTree*>(*nodeIt);
-			
-			AddNodeObjectsToRoot(pChildNode);
+			mlFrameReinsertCount = mlReinsertCount;
+			mlFrameRotationCount = mlRotationCount;
+			mlFrameRebuildCount = mlRebuildNum;
+			mlReinsertCount =0;
+			mlRotationCount =0;
+			mlRebuildNum =0;
 		}
-	}
 
-	//-----------------------------------------------------------------------
-
-	void cRenderableContainer_DynBoxTree::SpecificUpdateBeforeRendering()
-	{
 		///////////////////////////////////
 		// Update tree for objects that have moved
 		if(m_setObjectsToUpdate.empty()==false)
@@ -836,27 +377,13 @@ namespace hpl {
             m_setObjectsToUpdate.clear();
 		}
 
-
 		///////////////////////////////////
-		// Rebuild tree if needed
-		if(mlRebuildCount >0) return;
-
-		mlRebuildCount = mlMaxRebuildCount;
-		
-		tRenderableContainerNodeListIt it = mRoot.mlstChildNodes.begin();
-		for(; it != mRoot.mlstChildNodes.end(); ++it)
+		// Rebuild tree if queued
+		if(mlRebuildCount ==0)
 		{
-			cRCNode_DynBoxTree *pNode = static_cast<cRCNode_DynBoxTree*>(*it);
-
-            AddNodeObjectsToRoot(pNode);
+			mlRebuildCount = -1;
+			RebuildTree();
 		}
-
-		STLDeleteAll(mRoot.mlstChildNodes);
-
-		mRoot.mbIsSplit = false;
-		mRoot.mbRecalculateAABB = true;
-		mRoot.mbRecalculateSplitAxis = true;
-		mRoot.mbRecalculateSplit = true;
 	}
 
 	//-----------------------------------------------------------------------
@@ -869,19 +396,6 @@ namespace hpl {
 		//AABB
 		apFunctions->GetLowLevelGfx()->DrawBoxMinMax(apNode->GetMin(),apNode->GetMax(),LevelColor[alLevel % 10]);
 
-		//Split plane
-		if(apNode->HasChildNodes())
-		{
-			cVector3f vMin = apNode->GetMin();
-			cVector3f vMax = apNode->GetMax();
-			vMin.v[apNode->mlSplitAxis] = apNode->mfSplitPlane;
-			vMax.v[apNode->mlSplitAxis] = apNode->mfSplitPlane;
-
-			apFunctions->GetLowLevelGfx()->DrawBoxMinMax(vMin, vMax,LevelColor[alLevel % 10]);
-
-		}
-				
-
 		tRenderableContainerNodeListIt childIt = apNode->GetChildNodeList()->begin();
 		for(; childIt != apNode->GetChildNodeList()->end(); ++childIt)
 		{
@@ -892,349 +406,350 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	void cRenderableContainer_DynBoxTree::RemoveNode(cRCNode_DynBoxTree *apRemoveNode)
+	cRCNode_DynBoxTree* cRenderableContainer_DynBoxTree::CreateNode()
 	{
-		cRCNode_DynBoxTree *pParent = static_cast<cRCNode_DynBoxTree*>(apRemoveNode->GetParent());
-		if(pParent == NULL) return;
-
-		
-		if(gbLog){
-			Log(" Remove node %d from parent %d\n", apRemoveNode, pParent);
+		cRCNode_DynBoxTree *pNode = NULL;
+		if(mvFreeNodes.empty())
+		{
+			pNode = hplNew( cRCNode_DynBoxTree, () ); 
+			pNode->mpContainer = this;
+		}
+		else
+		{
+			pNode = mvFreeNodes.back();
+			mvFreeNodes.pop_back();
 		}
 
-		////////////////////////////////////
-		// Remove the node from the parent
-		STLFindAndDelete(pParent->mlstChildNodes, apRemoveNode);
+		return pNode;
+	}
 
-		////////////////////////////////////
-		// Get Remaining child node and then clear child node list
-		cRCNode_DynBoxTree *pChild = static_cast<cRCNode_DynBoxTree*>(pParent->mlstChildNodes.front());
-		
-        pParent->mlstChildNodes.clear();
-		
-		////////////////////////////////////
-		// Move the objects from the remaining child in parent to parent
-		if(pChild->HasObjects())
+	//-----------------------------------------------------------------------
+
+	void cRenderableContainer_DynBoxTree::DestroyNode(cRCNode_DynBoxTree *apNode)
+	{
+		//The child list must be empty, else the nodes would be deleted with the free node.
+		apNode->mlstChildNodes.clear();
+		apNode->mpParent = NULL;
+		apNode->SetPrevFrustumCollision(eCollision_Outside);
+
+		mvFreeNodes.push_back(apNode);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cRenderableContainer_DynBoxTree::SetLeafAABB(cRCNode_DynBoxTree *apLeaf, iRenderable *apObject, const cVector3f& avDisplacement)
+	{
+		cBoundingVolume *pBV = apObject->GetBoundingVolume();
+
+		apLeaf->mvMin = pBV->GetMin() - cVector3f(mfLeafMargin);
+		apLeaf->mvMax = pBV->GetMax() + cVector3f(mfLeafMargin);
+
+		//Extend in the direction the object is moving, so objects moving steadily are reinserted less often.
+		cVector3f vDisplacement = avDisplacement * mfDisplacementMul;
+		for(int i=0; i<3; ++i)
 		{
-			if(gbLog){
-				Log("  Moving objects from node %d to parent %d\n", pChild, pParent);
-			}
+			if(vDisplacement.v[i] < 0)	apLeaf->mvMin.v[i] += vDisplacement.v[i];
+			else						apLeaf->mvMax.v[i] += vDisplacement.v[i];
+		}
 
-			tRenderableListIt it = pChild->mlstObjects.begin();
-			for(; it != pChild->mlstObjects.end(); ++it)
-			{
-				iRenderable *pChildObject = *it;
-				if(gbLog) Log("   %s / %d\n", pChildObject->GetName().c_str(), pChildObject);
+		apLeaf->UpdateSphere();
+		apLeaf->mvInsertPosition = pBV->GetWorldCenter();
+	}
 
-				//Set new node
-				pChildObject->SetRenderContainerNode(pParent);
-				
-				pParent->mlstObjects.push_back(pChildObject);
-			}
+	//-----------------------------------------------------------------------
+
+	void cRenderableContainer_DynBoxTree::InsertLeaf(cRCNode_DynBoxTree *apLeaf)
+	{
+		////////////////////////////////////
+		// Empty tree, leaf becomes the root
+		if(mRoot.HasChildNodes()==false)
+		{
+			mRoot.mlstChildNodes.push_back(apLeaf);
+			apLeaf->mpParent = &mRoot;
+			UpdateRootAABB();
+			return;
 		}
 
 		////////////////////////////////////
-		// Move the child nodes from the remaining child in parent to parent
-		if(pChild->HasChildNodes())
+		// Find the best sibling by descending the cheapest path. The cost of a sibling
+		// is the area of the new parent plus the area increase of all the ancestors.
+		cRCNode_DynBoxTree *pNode = static_cast<cRCNode_DynBoxTree*>(mRoot.mlstChildNodes.front());
+		while(pNode->IsLeaf()==false)
 		{
-			if(gbLog){
-				Log("  Moving children from node %d to parent %d\n", pChild, pParent);
-			}
+			cRCNode_DynBoxTree *pChildA = static_cast<cRCNode_DynBoxTree*>(pNode->mlstChildNodes.front());
+			cRCNode_DynBoxTree *pChildB = static_cast<cRCNode_DynBoxTree*>(pNode->mlstChildNodes.back());
 
-			tRenderableContainerNodeListIt it = pChild->mlstChildNodes.begin();
-			for(; it != pChild->mlstChildNodes.end(); ++it)
-			{
-				iRenderableContainerNode *pChild_ChildNode = *it;
+			float fArea = GetNodeArea(pNode);
+			float fCombinedArea = GetNodeUnionArea(pNode, apLeaf);
 
-				if(gbLog) Log("   %d\n", pChild_ChildNode);
+			//Cost of making a new parent for this node and the leaf
+			float fCost = 2.0f * fCombinedArea;
 
-				//Set new parent and add to parents child node list
-                pChild_ChildNode->SetParent(pParent);				
-                pParent->mlstChildNodes.push_back(pChild_ChildNode);
-			}
+			//Minimum cost of pushing the leaf further down the tree
+			float fInheritanceCost = 2.0f * (fCombinedArea - fArea);
 
-			//Clear all nodes, else they will be deleted later on
-			pChild->mlstChildNodes.clear();	
-		}
+			float fCostA = GetNodeUnionArea(pChildA, apLeaf) + fInheritanceCost;
+			if(pChildA->IsLeaf()==false) fCostA -= GetNodeArea(pChildA);
 
-		if(gbLog){
-			Log(" Deleting other node %d and recalculating AABB for parent %d\n", pChild, pParent);
+			float fCostB = GetNodeUnionArea(pChildB, apLeaf) + fInheritanceCost;
+			if(pChildB->IsLeaf()==false) fCostB -= GetNodeArea(pChildB);
+
+			if(fCost < fCostA && fCost < fCostB) break;
+
+			pNode = fCostA < fCostB ? pChildA : pChildB;
 		}
 
 		////////////////////////////////////
-		// Delete the remaining child node.
-		hplDelete(pChild);
+		// Create a new parent for the sibling and the leaf
+		cRCNode_DynBoxTree *pSibling = pNode;
+		cRCNode_DynBoxTree *pOldParent = static_cast<cRCNode_DynBoxTree*>(pSibling->mpParent);
 
-		////////////////////////////////////
-		// Recalculate the AABB of parent and set as not split
-        pParent->RecalculateAABB();
-        pParent->mbIsSplit = false;
+		cRCNode_DynBoxTree *pNewParent = CreateNode();
+		pOldParent->ReplaceChild(pSibling, pNewParent);
+
+		pNewParent->mlstChildNodes.push_back(pSibling);
+		pNewParent->mlstChildNodes.push_back(apLeaf);
+		pSibling->mpParent = pNewParent;
+		apLeaf->mpParent = pNewParent;
+		
+		RefitAndRotate(pNewParent);
 	}
 
 	//-----------------------------------------------------------------------
 
-	void cRenderableContainer_DynBoxTree::CheckNodeAABBNeedsUpdateIterative(cRCNode_DynBoxTree *apNode, iRenderable *apObject)
+	void cRenderableContainer_DynBoxTree::RemoveLeaf(cRCNode_DynBoxTree *apLeaf)
 	{
-		if(CheckObjectIsAtEdgeOfAABB(apObject, apNode->GetMin(), apNode->GetMax()))
-		{
-			if(gbLog){
-				Log("  Updating AABB for node %d\n", apNode);
-			}
+		cRCNode_DynBoxTree *pParent = static_cast<cRCNode_DynBoxTree*>(apLeaf->mpParent);
+		if(pParent==NULL) return;
 
-			//Calculate a new AABB size
-			apNode->RecalculateAABB();
-			
-			//Check if parent needs update too
-			cRCNode_DynBoxTree *pParent = static_cast<cRCNode_DynBoxTree*>(apNode->GetParent());
-			if(pParent)
-				CheckNodeAABBNeedsUpdateIterative(pParent, apObject);
+		apLeaf->mpParent = NULL;
+
+		////////////////////////////////////
+		// Leaf is the only node in the tree
+		if(pParent == &mRoot)
+		{
+			mRoot.mlstChildNodes.clear();
+			UpdateRootAABB();
+			return;
 		}
-	}
-	
-	//-----------------------------------------------------------------------
 
-	
-	cRCNode_DynBoxTree *cRenderableContainer_DynBoxTree::GetAddNode(cRCNode_DynBoxTree *apStartNode, iRenderable *apObject)
-	{
-		mpTempNode = NULL; //Where the node is placed.
-		AddObjectToNodeIterative(apStartNode, apObject);
+		////////////////////////////////////
+		// Replace the parent with the sibling and refit from the grand parent
+		cRCNode_DynBoxTree *pSibling = pParent->GetSibling(apLeaf);
+		cRCNode_DynBoxTree *pGrandParent = static_cast<cRCNode_DynBoxTree*>(pParent->mpParent);
+
+		pGrandParent->ReplaceChild(pParent, pSibling);
+		DestroyNode(pParent);
 
-		return mpTempNode;
+		RefitAndRotate(pGrandParent);
 	}
 
 	//-----------------------------------------------------------------------
 
-	void cRenderableContainer_DynBoxTree::AddObjectToNodeIterative(cRCNode_DynBoxTree *apNode, iRenderable *apObject)
+	void cRenderableContainer_DynBoxTree::RefitAndRotate(cRCNode_DynBoxTree *apNode)
 	{
-		if(gbLog || HasDebug(apObject) ){
-			cBoundingVolume *pBV = apObject->GetBoundingVolume();
-			Log(" Testing node %d. Inside: %d Intersect: %d (%s)-(%s) vs (%s)-(%s)\n",	apNode,
-																			cMath::CheckAABBInside(pBV->GetMin(),pBV->GetMax(), apNode->mvMin, apNode->mvMax)?1:0,
-																			cMath::CheckAABBIntersection(pBV->GetMin(),pBV->GetMax(), apNode->mvMin, apNode->mvMax)?1:0,
-																			pBV->GetMin().ToString().c_str(), pBV->GetMax().ToString().c_str(), 
-																			apNode->mvMin.ToString().c_str(), apNode->mvMax.ToString().c_str());
-		}
-		/////////////////////////////
-		// Expand the AABB of node if needed
-		if( TestAndExpandNodeAABB(apObject, apNode->mvMin, apNode->mvMax) )
+		cRCNode_DynBoxTree *pNode = apNode;
+		while(pNode != &mRoot)
 		{
-			//TODO: Perhaps sphere calc can be skipped here and done in UpdateBeforeUse instead.
-			apNode->mvCenter = (apNode->mvMax + apNode->mvMin) *0.5f;
-			apNode->mfRadius = (apNode->mvMax - apNode->mvMin).Length()*0.5f;
-
-			apNode->RecalculateSplit();
-
-			if(gbLog || HasDebug(apObject)) Log("  Expanded AABB\n");
-		}
+			pNode->UpdateAABBFromChildren();
+			RotateNode(pNode);
 
-		/////////////////////////////
-		// If node has no children, add it here.
-		if(apNode->HasChildNodes()==false)
-		{
-			mpTempNode = apNode;
-			return;
+			pNode = static_cast<cRCNode_DynBoxTree*>(pNode->mpParent);
 		}
 
-		/////////////////////////////
-		// Calculate what group the new object belongs to
-		cVector3f vNodeSize = apNode->GetMax() - apNode->GetMin();
-		int lSplitGroup = GetSplitGroup(apObject,apNode->mfSplitPlane, apNode->mlSplitAxis ,vNodeSize);
-		
-		
-		/////////////////////////////
-		// If object is intersecting then add to this node, else add to a child.
-		if(lSplitGroup == 2)
-		{
-			mpTempNode = apNode;
-		}
-		else 
-		{
-			//Assuming always two children!
-			if(lSplitGroup==0)	AddObjectToNodeIterative(static_cast<cRCNode_DynBoxTree*>(apNode->mlstChildNodes.front()),apObject);
-			if(lSplitGroup==1)	AddObjectToNodeIterative(static_cast<cRCNode_DynBoxTree*>(apNode->mlstChildNodes.back()),apObject);
-		}
+		UpdateRootAABB();
 	}
 
 	//-----------------------------------------------------------------------
 
 	/**
-	 * Returns 0=above, 1=below, 2=intersection
+	 * Tries to swap one child with a grand child on the other side, and does the swap that reduces the
+	 * surface area of the changed child the most. The area of the node itself is not changed.
 	 */
-	int cRenderableContainer_DynBoxTree::GetSplitGroup(iRenderable *apObject, float afSplitPlane, int alAxis, const cVector3f &avNodeSize)
+	void cRenderableContainer_DynBoxTree::RotateNode(cRCNode_DynBoxTree *apNode)
 	{
-		float fMinVal =   GetAxisFromVec(apObject->GetBoundingVolume()->GetMin(),alAxis);
-		float fMaxVal =   GetAxisFromVec(apObject->GetBoundingVolume()->GetMax(),alAxis);
+		cRCNode_DynBoxTree *pChild[2] = {	static_cast<cRCNode_DynBoxTree*>(apNode->mlstChildNodes.front()),
+											static_cast<cRCNode_DynBoxTree*>(apNode->mlstChildNodes.back()) };
+
+		float fBestGain = 0;
+		int lBestSide = -1;			//The child that gets a grand child swapped into it
+		cRCNode_DynBoxTree *pBestGrandChild = NULL;
 
-		//////////////////////////
-		//Above cut plane
-		if(fMinVal >= afSplitPlane)
+		for(int lSide=0; lSide<2; ++lSide)
 		{
-			return 0;
+			cRCNode_DynBoxTree *pInner = pChild[lSide];
+			cRCNode_DynBoxTree *pOuter = pChild[1-lSide];
+			if(pInner->IsLeaf()) continue;
+
+			cRCNode_DynBoxTree *pGrandChildA = static_cast<cRCNode_DynBoxTree*>(pInner->mlstChildNodes.front());
+			cRCNode_DynBoxTree *pGrandChildB = static_cast<cRCNode_DynBoxTree*>(pInner->mlstChildNodes.back());
+			float fInnerArea = GetNodeArea(pInner);
+
+			//Swap outer with grand child A, inner is then made up of outer and grand child B
+			float fGain = fInnerArea - GetNodeUnionArea(pOuter, pGrandChildB);
+			if(fGain > fBestGain)
+			{
+				fBestGain = fGain;
+				lBestSide = lSide;
+				pBestGrandChild = pGrandChildA;
+			}
+
+			fGain = fInnerArea - GetNodeUnionArea(pOuter, pGrandChildA);
+			if(fGain > fBestGain)
+			{
+				fBestGain = fGain;
+				lBestSide = lSide;
+				pBestGrandChild = pGrandChildB;
+			}
 		}
-		//////////////////////////
-		//Below cut plane
-		else if(fMaxVal <= afSplitPlane)
+
+		//Skip gains too small to matter, so nodes are not swapped back and forth.
+		if(lBestSide < 0 || fBestGain <= GetNodeArea(apNode) * 0.001f) return;
+
+		cRCNode_DynBoxTree *pInner = pChild[lBestSide];
+		cRCNode_DynBoxTree *pOuter = pChild[1-lBestSide];
+
+		apNode->ReplaceChild(pOuter, pBestGrandChild);
+		pInner->ReplaceChild(pBestGrandChild, pOuter);
+		pInner->UpdateAABBFromChildren();
+
+		++mlRotationCount;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cRenderableContainer_DynBoxTree::UpdateRootAABB()
+	{
+		if(mRoot.HasChildNodes())
 		{
-			return 1;
+			cRCNode_DynBoxTree *pTreeRoot = static_cast<cRCNode_DynBoxTree*>(mRoot.mlstChildNodes.front());
+			mRoot.mvMin = pTreeRoot->mvMin;
+			mRoot.mvMax = pTreeRoot->mvMax;
 		}
-		//////////////////////////
-		//Intersection
 		else
 		{
-			////////////////////////
-			//Calculate how much the object crosses over on each side
-			float fAboveDist = fMaxVal - afSplitPlane;
-			float fBelowDist = afSplitPlane - fMinVal;
-			
-			float fNodeSize = GetAxisFromVec(avNodeSize, alAxis);	//Using the size of entire node since it one side might be very small.
-
-			/////////////////////
-			//Get the least amount of cross over, and on which side it is.
-			float fMinDist = fAboveDist;
-			int lDestDir = 1;	//If above is smallest, object should be below and vice verce.
-			if(fBelowDist < fMinDist)
-			{
-				fMinDist = fBelowDist;
-				lDestDir =0;
-			}
-			
-			/////////////////////
-			//Check if the amount of cross over is small enough to not treat it as an intersection.
-			float fMinCrossOverAmount = fMinDist / fNodeSize;
-			if(fMinCrossOverAmount <= mfMaxIntersectionAmount) return lDestDir;
-			
-			return 2;
+			mRoot.mvMin = 0;
+			mRoot.mvMax = 0;
 		}
+		mRoot.UpdateSphere();
 	}
-	
-	//-----------------------------------------------------------------------
 
+	//-----------------------------------------------------------------------
 
 	void cRenderableContainer_DynBoxTree::UpdateObjectInContainer(iRenderable* apObject)
 	{
-		const bool bUpdateLog=false;
-		//bool bUpdateLog= HasDebug(apObject);
-	
-
 		////////////////////////////////////////////
-		//Get Node of correct type
-		cRCNode_DynBoxTree *pNode =  static_cast<cRCNode_DynBoxTree*>(apObject->GetRenderContainerNode());
-		if(pNode==NULL) return;
-
-		pNode->ObjectMoved();	//Notify the node that an object moved inside it.
-
-		if(bUpdateLog) 
-			Log("------- Updating %s. Node: %d -------\n",apObject->GetName().c_str(), pNode);
-
+		//Get leaf of the object
+		cRCNode_DynBoxTree *pLeaf =  static_cast<cRCNode_DynBoxTree*>(apObject->GetRenderContainerNode());
+		if(pLeaf==NULL) return;
 
 		////////////////////////////////////////////
-		//Get bounding volume and see if still contained in node
+		//If the object is still inside the fat AABB, nothing needs to be done unless the AABB is far too large
 		cBoundingVolume *pBV = apObject->GetBoundingVolume();
-
-		if(cMath::CheckAABBInside(pBV->GetMin(), pBV->GetMax(), pNode->GetMin(), pNode->GetMax()))
+		if(cMath::CheckAABBInside(pBV->GetMin(), pBV->GetMax(), pLeaf->GetMin(), pLeaf->GetMax()))
 		{
-			//Do not Check if AABB of node needs updating, since it will only take time and not gain much since the garbaage collection will fix it after a while.
-
-			//The node is still inside the same node
-			if(bUpdateLog) {
-				Log(" Still inside AABB, not doing anything!\n");
-				Log("---------------------\n");
-			}
-			return; 
+			float fNeededArea = GetSurfaceArea(pBV->GetMin() - cVector3f(mfLeafMargin), pBV->GetMax() + cVector3f(mfLeafMargin));
+			if(GetNodeArea(pLeaf) <= fNeededArea * mfMaxFatAreaMul) return;
 		}
 
-		////////////////////////////////////////////
-		// Iterate through the parent nodes of the current and try and find one that fits the node, stopping at root
-		mpCheckForFitTempNode = pNode; //Node with fit will be placed here
-		cRCNode_DynBoxTree *pParent =  static_cast<cRCNode_DynBoxTree*>(pNode->GetParent());
-		if(pParent) CheckForFitIterative(pParent, pBV);
-
-		if(bUpdateLog) Log(" Found fit in %d (by starting in parent %d)\n", mpCheckForFitTempNode, pParent);
+		if(HasDebug(apObject)) 
+			Log("Reinserting '%s' / %d. Leaf: %d\n",apObject->GetName().c_str(), apObject, pLeaf);
 
 		////////////////////////////////////////////
-		// Get the node where the object is to be added
-		cRCNode_DynBoxTree *pNewNode = GetAddNode(mpCheckForFitTempNode, apObject);
+		//Reinsert the leaf with a new fat AABB
+		RemoveLeaf(pLeaf);
+		SetLeafAABB(pLeaf, apObject, pBV->GetWorldCenter() - pLeaf->mvInsertPosition);
+		InsertLeaf(pLeaf);
 
-		if(bUpdateLog) Log("  Node to add object in: %d (leaf: %d)\n", pNewNode, pNewNode->HasChildNodes()==false ? 1:0);
+		++mlReinsertCount;
+		if(mlRebuildCount >0) mlRebuildCount--;
+	}
 
-		////////////////////////////////////////////
-		// If the new node is not the same, then the the object needs removed from the old node and added to new.
-		if(pNewNode != pNode)
-		{
-			if(bUpdateLog) Log("  Moving node\n");
+	//-----------------------------------------------------------------------
 
-			//Notify the new node that an object moved inside it.
-			pNewNode->ObjectMoved();	
+	void cRenderableContainer_DynBoxTree::RebuildTree()
+	{
+		if(mRoot.HasChildNodes()==false) return;
 
-			//Decrease container rebuild count.
-			mlRebuildCount--;
+		///////////////////////////////
+		// Get all leaves and free the other nodes
+		std::vector<cRCNode_DynBoxTree*> vLeaves;
+		vLeaves.reserve(mlLeafNum);
+		CollectLeavesAndDestroyNodes(static_cast<cRCNode_DynBoxTree*>(mRoot.mlstChildNodes.front()), vLeaves);
+		mRoot.mlstChildNodes.clear();
 
-			/////////////////////////////////////
-			//If the object is not inside new node need to recalc AABB
-			cBoundingVolume *pObjBV = apObject->GetBoundingVolume();
-			//if(CheckObjectIsAtEdgeOfAABB(apObject,pNewNode->mvMin,pNewNode->mvMax)) //<- Old bad code! Just have for future reference!
-			if(cMath::CheckAABBInside(pObjBV->GetMin(), pObjBV->GetMax(), pNewNode->mvMin,pNewNode->mvMax)==false)
-			{
-				pNewNode->PushUpNeedAABBUpdate();
-			}
+		///////////////////////////////
+		// Tighten the leaf AABBs and build from the top
+		for(size_t i=0; i<vLeaves.size(); ++i)
+		{
+			cRCNode_DynBoxTree *pLeaf = vLeaves[i];
+			SetLeafAABB(pLeaf, pLeaf->mlstObjects.front(), 0);
+		}
 
-			/////////////////////////////////////
-			//Remove the node and set new one from node list
-			apObject->SetRenderContainerNode(pNewNode);
+		cRCNode_DynBoxTree *pTreeRoot = BuildNodeTopDown(&vLeaves[0], (int)vLeaves.size());
+		mRoot.mlstChildNodes.push_back(pTreeRoot);
+		pTreeRoot->mpParent = &mRoot;
+		UpdateRootAABB();
 
-			/////////////////////////////////////
-			//Add to new node
-			pNewNode->mlstObjects.push_back(apObject);
+		++mlRebuildNum;
 
-			/////////////////////////////////////
-			//Remove from old
-			pNode->RemoveObject(apObject);
+		if(gbLog) Log("Rebuilt dynamic box tree with %d leaves\n", (int)vLeaves.size());
+	}
 
-			// If old node is leaf and has no objects left, delete it.
-			if(pNode->HasChildNodes()==false && pNode->HasObjects()==false)
-			{
-				RemoveNode(pNode);
-			}
-			// If not, set that AABB update is needed.
-			else
-			{
-				pNode->PushUpNeedAABBUpdate();
-			}
-		}
-		///////////
-		//If the same node, then we want to recalculate AABB
-		else
-		{
-			if(bUpdateLog) Log("  Same node %d\n", pNode);
+	//-----------------------------------------------------------------------
 
-			pNode->PushUpNeedAABBUpdate();
+	void cRenderableContainer_DynBoxTree::CollectLeavesAndDestroyNodes(cRCNode_DynBoxTree *apNode, std::vector<cRCNode_DynBoxTree*>& avLeaves)
+	{
+		if(apNode->IsLeaf())
+		{
+			avLeaves.push_back(apNode);
+			return;
 		}
 
-		if(bUpdateLog) Log("---------------------\n");
+		CollectLeavesAndDestroyNodes(static_cast<cRCNode_DynBoxTree*>(apNode->mlstChildNodes.front()), avLeaves);
+		CollectLeavesAndDestroyNodes(static_cast<cRCNode_DynBoxTree*>(apNode->mlstChildNodes.back()), avLeaves);
+
+		DestroyNode(apNode);
 	}
 
 	//-----------------------------------------------------------------------
 
-	void cRenderableContainer_DynBoxTree::CheckForFitIterative(cRCNode_DynBoxTree *apNode, cBoundingVolume *apBV)
+	/**
+	 * Splits the leaves at the median along the longest axis of the leaf centers.
+	 */
+	cRCNode_DynBoxTree* cRenderableContainer_DynBoxTree::BuildNodeTopDown(cRCNode_DynBoxTree **apLeaves, int alCount)
 	{
-		///////////////////////////////////
-		//Check if there is a fit or node is root, if so set the temp var and continue
-		if(	apNode->GetParent() == NULL ||
-			cMath::CheckAABBInside(apBV->GetMin(), apBV->GetMax(), apNode->GetMin(), apNode->GetMax()))
+		if(alCount == 1) return apLeaves[0];
+
+		cVector3f vCenterMin = apLeaves[0]->GetCenter();
+		cVector3f vCenterMax = vCenterMin;
+		for(int i=1; i<alCount; ++i)
 		{
-			mpCheckForFitTempNode = apNode;
-			return; 
+			cVector3f vCenter = apLeaves[i]->GetCenter();
+			cMath::ExpandAABB(vCenterMin, vCenterMax, vCenter, vCenter);
 		}
 
-		///////////////////////////////////////////
-		//If no fit in curremt, check parent
-		cRCNode_DynBoxTree *pParent =  static_cast<cRCNode_DynBoxTree*>(apNode->GetParent());
-		CheckForFitIterative(pParent, apBV);
+		cVector3f vSize = vCenterMax - vCenterMin;
+		int lAxis = 0;
+		if(vSize.y > vSize.v[lAxis]) lAxis = 1;
+		if(vSize.z > vSize.v[lAxis]) lAxis = 2;
+
+		int lHalf = alCount / 2;
+		std::nth_element(apLeaves, apLeaves + lHalf, apLeaves + alCount, cSortLeavesByCenter(lAxis));
+
+		cRCNode_DynBoxTree *pNode = CreateNode();
+		cRCNode_DynBoxTree *pChildA = BuildNodeTopDown(apLeaves, lHalf);
+		cRCNode_DynBoxTree *pChildB = BuildNodeTopDown(apLeaves + lHalf, alCount - lHalf);
+
+		pNode->mlstChildNodes.push_back(pChildA);
+		pNode->mlstChildNodes.push_back(pChildB);
+		pChildA->mpParent = pNode;
+		pChildB->mpParent = pNode;
+		pNode->UpdateAABBFromChildren();
+
+		return pNode;
 	}
 
-	
 	//-----------------------------------------------------------------------
 
-	
-
 }
@@ -0,0 +1,285 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "scene/RenderableFlatTree.h"
+
+#include "scene/RenderableContainer.h"
+#include "graphics/Renderable.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define HPL_FLAT_TREE_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cRenderableFlatTree::cRenderableFlatTree()
+	{
+		Clear();
+	}
+
+	cRenderableFlatTree::~cRenderableFlatTree()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cRenderableFlatTree::Build(iRenderableContainerNode *apRoot)
+	{
+		Clear();
+
+		AddObjects(apRoot, mlRootObjectFirst, mlRootObjectNum);
+		mlRootChildNode = BuildChildren(apRoot);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cRenderableFlatTree::Clear()
+	{
+		mvNodes.clear();
+		mvObjects.clear();
+
+		mlRootChildNode = -1;
+		mlRootObjectFirst = 0;
+		mlRootObjectNum = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cRenderableFlatTree::CullNode(const cRenderableFlatTreeNode& aNode, const cPlanef *apPlanes, int alPlaneNum, int alPlaneMask, int *apChildPlaneMasks)
+	{
+		int lValid = (1 << aNode.mlNum) - 1;
+		int lOutside = 0;
+
+		for(int i=0; i<4; ++i) apChildPlaneMasks[i] = 0;
+
+	#ifdef HPL_FLAT_TREE_USE_SSE
+		__m128 vMinX = _mm_loadu_ps(aNode.mvMinX);
+		__m128 vMinY = _mm_loadu_ps(aNode.mvMinY);
+		__m128 vMinZ = _mm_loadu_ps(aNode.mvMinZ);
+		__m128 vMaxX = _mm_loadu_ps(aNode.mvMaxX);
+		__m128 vMaxY = _mm_loadu_ps(aNode.mvMaxY);
+		__m128 vMaxZ = _mm_loadu_ps(aNode.mvMaxZ);
+		__m128 vZero = _mm_setzero_ps();
+	#endif
+
+		for(int lPlane=0; lPlane<alPlaneNum; ++lPlane)
+		{
+			if((alPlaneMask & (1<<lPlane))==0) continue;
+
+			const cPlanef& plane = apPlanes[lPlane];
+			int lIntersect = 0;
+
+			////////////////////////////////
+			// Test the corner furthest along the normal (p) and the one furthest against it (n).
+			// If p is behind the plane, the box is outside, if n is behind the box intersects the plane.
+		#ifdef HPL_FLAT_TREE_USE_SSE
+			__m128 vA = _mm_set1_ps(plane.a);
+			__m128 vB = _mm_set1_ps(plane.b);
+			__m128 vC = _mm_set1_ps(plane.c);
+			__m128 vD = _mm_set1_ps(plane.d);
+
+			__m128 vDistP = _mm_add_ps(	_mm_add_ps(_mm_mul_ps(vA, plane.a >= 0 ? vMaxX : vMinX), _mm_mul_ps(vB, plane.b >= 0 ? vMaxY : vMinY)),
+										_mm_add_ps(_mm_mul_ps(vC, plane.c >= 0 ? vMaxZ : vMinZ), vD));
+			__m128 vDistN = _mm_add_ps(	_mm_add_ps(_mm_mul_ps(vA, plane.a >= 0 ? vMinX : vMaxX), _mm_mul_ps(vB, plane.b >= 0 ? vMinY : vMaxY)),
+										_mm_add_ps(_mm_mul_ps(vC, plane.c >= 0 ? vMinZ : vMaxZ), vD));
+
+			lOutside |= _mm_movemask_ps(_mm_cmplt_ps(vDistP, vZero));
+			lIntersect = _mm_movemask_ps(_mm_cmplt_ps(vDistN, vZero));
+		#else
+			for(int i=0; i<4; ++i)
+			{
+				float fDistP = (plane.a * (plane.a >= 0 ? aNode.mvMaxX[i] : aNode.mvMinX[i]) + 
+								plane.b * (plane.b >= 0 ? aNode.mvMaxY[i] : aNode.mvMinY[i])) + 
+								(plane.c * (plane.c >= 0 ? aNode.mvMaxZ[i] : aNode.mvMinZ[i]) + plane.d);
+				float fDistN = (plane.a * (plane.a >= 0 ? aNode.mvMinX[i] : aNode.mvMaxX[i]) + 
+								plane.b * (plane.b >= 0 ? aNode.mvMinY[i] : aNode.mvMaxY[i])) + 
+								(plane.c * (plane.c >= 0 ? aNode.mvMinZ[i] : aNode.mvMaxZ[i]) + plane.d);
+
+				if(fDistP < 0) lOutside |= 1<<i;
+				if(fDistN < 0) lIntersect |= 1<<i;
+			}
+		#endif
+			
+			if((lOutside & lValid) == lValid) return 0;
+
+			for(int i=0; i<4; ++i)
+			{
+				if(lIntersect & (1<<i)) apChildPlaneMasks[i] |= 1<<lPlane;
+			}
+		}
+
+		return lValid & ~lOutside;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	static float GetNodeArea(iRenderableContainerNode *apNode)
+	{
+		cVector3f vSize = apNode->GetMax() - apNode->GetMin();
+		return vSize.x*vSize.y + vSize.y*vSize.z + vSize.z*vSize.x;
+	}
+
+	int cRenderableFlatTree::BuildChildren(iRenderableContainerNode *apNode)
+	{
+		if(apNode->HasChildNodes()==false) return -1;
+
+		std::vector<iRenderableContainerNode*> vChildren;
+		vChildren.reserve(4);
+		for(tRenderableContainerNodeListIt it = apNode->GetChildNodeList()->begin(); it != apNode->GetChildNodeList()->end(); ++it)
+		{
+			vChildren.push_back(*it);
+		}
+
+		////////////////////////////////
+		// Pull up grand children until the block is full, largest nodes first.
+		// Only nodes without objects can be removed, since objects belong to a node.
+		while(vChildren.size() < 4)
+		{
+			int lBest = -1;
+			float fBestArea = -1;
+			for(size_t i=0; i<vChildren.size(); ++i)
+			{
+				iRenderableContainerNode *pChild = vChildren[i];
+				if(pChild->HasObjects() || pChild->HasChildNodes()==false) continue;
+				if(vChildren.size() - 1 + pChild->GetChildNodeList()->size() > 4) continue;
+
+				float fArea = GetNodeArea(pChild);
+				if(fArea > fBestArea)
+				{
+					fBestArea = fArea;
+					lBest = (int)i;
+				}
+			}
+			if(lBest < 0) break;
+
+			iRenderableContainerNode *pChild = vChildren[lBest];
+			vChildren.erase(vChildren.begin() + lBest);
+			for(tRenderableContainerNodeListIt it = pChild->GetChildNodeList()->begin(); it != pChild->GetChildNodeList()->end(); ++it)
+			{
+				vChildren.push_back(*it);
+			}
+		}
+
+		return BuildBlock(vChildren, 0);
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cRenderableFlatTree::BuildBlock(const std::vector<iRenderableContainerNode*>& avChildren, size_t alStart)
+	{
+		int lIdx = (int)mvNodes.size();
+		mvNodes.push_back(cRenderableFlatTreeNode());
+
+		////////////////////////////////
+		// Set up empty slots so that they are outside of any plane
+		cRenderableFlatTreeNode &node = mvNodes[lIdx];
+		for(int i=0; i<4; ++i)
+		{
+			node.mvMinX[i] = node.mvMinY[i] = node.mvMinZ[i] = 100000.0f;
+			node.mvMaxX[i] = node.mvMaxY[i] = node.mvMaxZ[i] = -100000.0f;
+			node.mvChildNode[i] = -1;
+			node.mvObjectFirst[i] = 0;
+			node.mvObjectNum[i] = 0;
+		}
+
+		//If more than 4 children, the last slot gets an extra block with the rest
+		size_t lLeft = avChildren.size() - alStart;
+		int lNum = lLeft > 4 ? 3 : (int)lLeft;
+		node.mlNum = lLeft > 4 ? 4 : lNum;
+
+		for(int i=0; i<lNum; ++i)
+		{
+			iRenderableContainerNode *pChild = avChildren[alStart + i];
+			const cVector3f& vMin = pChild->GetMin();
+			const cVector3f& vMax = pChild->GetMax();
+
+			//Node is referenced by index since the array grows when building children.
+			mvNodes[lIdx].mvMinX[i] = vMin.x;	mvNodes[lIdx].mvMaxX[i] = vMax.x;
+			mvNodes[lIdx].mvMinY[i] = vMin.y;	mvNodes[lIdx].mvMaxY[i] = vMax.y;
+			mvNodes[lIdx].mvMinZ[i] = vMin.z;	mvNodes[lIdx].mvMaxZ[i] = vMax.z;
+
+			int lFirst, lObjectNum;
+			AddObjects(pChild, lFirst, lObjectNum);
+			mvNodes[lIdx].mvObjectFirst[i] = lFirst;
+			mvNodes[lIdx].mvObjectNum[i] = lObjectNum;
+
+			int lChildNode = BuildChildren(pChild);
+			mvNodes[lIdx].mvChildNode[i] = lChildNode;
+		}
+
+		if(lLeft > 4)
+		{
+			cVector3f vMin(100000.0f), vMax(-100000.0f);
+			for(size_t i=alStart+3; i<avChildren.size(); ++i)
+			{
+				const cVector3f& vChildMin = avChildren[i]->GetMin();
+				const cVector3f& vChildMax = avChildren[i]->GetMax();
+				if(vMin.x > vChildMin.x) vMin.x = vChildMin.x;
+				if(vMin.y > vChildMin.y) vMin.y = vChildMin.y;
+				if(vMin.z > vChildMin.z) vMin.z = vChildMin.z;
+				if(vMax.x < vChildMax.x) vMax.x = vChildMax.x;
+				if(vMax.y < vChildMax.y) vMax.y = vChildMax.y;
+				if(vMax.z < vChildMax.z) vMax.z = vChildMax.z;
+			}
+
+			mvNodes[lIdx].mvMinX[3] = vMin.x;	mvNodes[lIdx].mvMaxX[3] = vMax.x;
+			mvNodes[lIdx].mvMinY[3] = vMin.y;	mvNodes[lIdx].mvMaxY[3] = vMax.y;
+			mvNodes[lIdx].mvMinZ[3] = vMin.z;	mvNodes[lIdx].mvMaxZ[3] = vMax.z;
+
+			int lChildNode = BuildBlock(avChildren, alStart+3);
+			mvNodes[lIdx].mvChildNode[3] = lChildNode;
+		}
+
+		return lIdx;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cRenderableFlatTree::AddObjects(iRenderableContainerNode *apNode, int &alFirst, int &alNum)
+	{
+		alFirst = (int)mvObjects.size();
+		alNum = apNode->GetObjectNum();
+
+		for(tRenderableListIt it = apNode->GetObjectList()->begin(); it != apNode->GetObjectList()->end(); ++it)
+		{
+			mvObjects.push_back(*it);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -32,6 +32,7 @@
 #include "resources/ScriptManager.h"
 #include "resources/FileSearcher.h"
 #include "resources/WorldLoaderHandler.h"
+#include "resources/SoundEntityManager.h"
 
 #include "graphics/Graphics.h"
 #include "graphics/Renderer.h"
@@ -321,6 +322,9 @@ namespace hpl {
 			return NULL;
 		}
 
+		//Create the sound data of all sound entities preloaded by the map
+		mpResources->GetSoundEntityManager()->FlushPreloads();
+
 		return pWorld;
 	}
 
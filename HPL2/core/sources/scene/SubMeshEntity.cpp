@@ -61,7 +61,7 @@ namespace hpl {
 
 		if(mpMeshEntity->GetMesh()->GetSkeleton())
 		{
-			mpDynVtxBuffer = mpSubMesh->GetVertexBuffer()->CreateCopy(eVertexBufferType_Hardware,eVertexBufferUsageType_Dynamic,eFlagBit_All);
+			mpDynVtxBuffer = CreateSkinVertexBuffer(mpSubMesh->GetVertexBuffer());
 			mvDynTriangles = *mpSubMesh->GetTriangleVecPtr();
 		}
 		else
@@ -69,6 +69,9 @@ namespace hpl {
 			mpDynVtxBuffer = NULL;
 		}
 
+		mlLod = 0;
+		if(mpDynVtxBuffer) mvDynLodVtxBuffers.resize(mpSubMesh->GetLodNum(), NULL);
+
 		mpLocalNode = NULL;
 
 		mpEntityCallback = hplNew( cSubMeshEntityBodyUpdate, () );
@@ -92,6 +95,10 @@ namespace hpl {
 		hplDelete(mpEntityCallback);
 
 		if(mpDynVtxBuffer) hplDelete(mpDynVtxBuffer);
+		for(size_t i=0; i<mvDynLodVtxBuffers.size(); ++i)
+		{
+			if(mvDynLodVtxBuffers[i]) hplDelete(mvDynLodVtxBuffers[i]);
+		}
 
 		/* Clear any custom textures here*/	
 		if(mpMaterial) mpMaterialManager->Destroy(mpMaterial);
@@ -193,6 +200,17 @@ namespace hpl {
 		// Get distance to frustum
 		if(IsStatic() == false && apFrustum) mfDistanceToFrustum = cMath::Vector3DistSqr(apFrustum->GetOrigin(), GetWorldPosition());
 
+		/////////////////
+		// Pick detail level
+		if(mpSubMesh->GetLodNum() > 0 && apFrustum)
+		{
+			int lLod = mpMeshEntity->GetForcedLod();
+			if(lLod < 0)	lLod = SelectLod(mpMeshEntity->GetLodScreenSize(apFrustum));
+			else			lLod = cMath::Min(lLod, mpSubMesh->GetLodNum());
+
+			if(lLod != mlLod) SetLod(lLod);
+		}
+
 		return true;
 	}
 
@@ -219,87 +237,7 @@ namespace hpl {
 			mlBoneMatricesUpdateCount = mpMeshEntity->mlBoneMatricesUpdateCount;
 			mbGraphicsUpdated = true;
 
-			const float *pBindPos = mpSubMesh->GetVertexBuffer()->GetFloatArray(eVertexBufferElement_Position);
-			const float *pBindNormal = mpSubMesh->GetVertexBuffer()->GetFloatArray(eVertexBufferElement_Normal);
-			const float *pBindTangent = mpSubMesh->GetVertexBuffer()->GetFloatArray(eVertexBufferElement_Texture1Tangent);
-
-			float *pSkinPos = mpDynVtxBuffer->GetFloatArray(eVertexBufferElement_Position);
-			float *pSkinNormal = mpDynVtxBuffer->GetFloatArray(eVertexBufferElement_Normal);
-			float *pSkinTangent = mpDynVtxBuffer->GetFloatArray(eVertexBufferElement_Texture1Tangent);
-
-			const int lVtxStride = mpDynVtxBuffer->GetElementNum(eVertexBufferElement_Position);
-			const int lVtxNum = mpDynVtxBuffer->GetVertexNum();
-
-			for(int vtx=0; vtx < lVtxNum; vtx++)
-			{
-				//To count the bone bindings
-				int lCount = 0;
-				//Get pointer to weights and bone index.
-				const float *pWeight = &mpSubMesh->mpVertexWeights[vtx*4];
-				if(*pWeight==0) continue;
-
-				const unsigned char *pBoneIdx = &mpSubMesh->mpVertexBones[vtx*4];
-
-				const cMatrixf &mtxTransform = mpMeshEntity->mvBoneMatrices[*pBoneIdx];
-				
-				
-				MatrixFloatTransformSet(pSkinPos,mtxTransform, pBindPos, *pWeight);
-
-				MatrixFloatRotateSet(pSkinNormal,mtxTransform, pBindNormal, *pWeight);
-
-				MatrixFloatRotateSet(pSkinTangent,mtxTransform, pBindTangent, *pWeight);
-
-				++pWeight; ++pBoneIdx; ++lCount;
-
-				//Iterate weights until 0 is found or count < 4
-				while(*pWeight != 0 && lCount < 4)
-				{
-					//Log("Boneidx: %d Count %d Weight: %f\n",(int)*pBoneIdx,lCount, *pWeight);				
-					const cMatrixf &mtxTransform = mpMeshEntity->mvBoneMatrices[*pBoneIdx];
-
-					//Transform with the local movement of the bone.
-					MatrixFloatTransformAdd(pSkinPos,mtxTransform, pBindPos, *pWeight);
-
-					MatrixFloatRotateAdd(pSkinNormal,mtxTransform, pBindNormal, *pWeight);
-
-					MatrixFloatRotateAdd(pSkinTangent,mtxTransform, pBindTangent, *pWeight);
-
-					++pWeight; ++pBoneIdx; ++lCount;
-				}
-
-				pBindPos += lVtxStride;
-				pSkinPos += lVtxStride;
-
-				pBindNormal += 3;
-				pSkinNormal += 3;
-
-				pBindTangent += 4;
-				pSkinTangent += 4;
-			}
-
-			//No stencil shadows:
-			/*float *pSkinPosArray = mpDynVtxBuffer->GetArray(eVertexElementFlag_Position);
-			if(mpMeshEntity->GetRenderFlagBit(eRenderableFlag_ShadowCaster))
-			{
-				//Update the shadow double
-				memcpy(&pSkinPosArray[lVtxStride*lVtxNum],pSkinPosArray,sizeof(float)*lVtxStride*lVtxNum);
-				for(int vtx=lVtxStride*lVtxNum + lVtxStride-1; vtx < lVtxStride*lVtxNum*2; vtx+=lVtxStride)
-				{
-					pSkinPosArray[vtx] = 0;
-				}
-			}*/
-
-			//Update buffer
-			mpDynVtxBuffer->UpdateData(eVertexElementFlag_Position | eVertexElementFlag_Normal | eVertexElementFlag_Texture1,false);
-			
-			//No stencil shadows:
-			/*if(mpMeshEntity->GetRenderFlagBit(eRenderableFlag_ShadowCaster))
-			{
-				//Update triangles
-				cMath::CreateTriangleData(mvDynTriangles,
-					mpDynVtxBuffer->GetIndices(), mpDynVtxBuffer->GetIndexNum(),
-					pSkinPosArray, lVtxStride, lVtxNum);
-			}*/
+			UpdateSkinnedVertices();
 		}
 		
 	}
@@ -309,6 +247,12 @@ namespace hpl {
 
 	iVertexBuffer* cSubMeshEntity::GetVertexBuffer()
 	{
+		if(mlLod > 0)
+		{
+			if(mpDynVtxBuffer)	return mvDynLodVtxBuffers[mlLod-1];
+			else				return mpSubMesh->GetLod(mlLod-1)->mpVtxBuffer;
+		}
+
 		if(mpDynVtxBuffer)
 		{
 			return mpDynVtxBuffer;
@@ -473,4 +417,180 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	int cSubMeshEntity::SelectLod(float afScreenSize)
+	{
+		int lLod = 0;
+		for(int i=0; i<mpSubMesh->GetLodNum(); ++i)
+		{
+			//Levels at or below the current need a bit bigger size to change back, so the level does not flicker at the border.
+			float fMaxScreenSize = mpSubMesh->GetLod(i)->mfMaxScreenSize;
+			if(i < mlLod) fMaxScreenSize *= 1.1f;
+
+			if(afScreenSize >= fMaxScreenSize) break;
+			lLod = i+1;
+		}
+		return lLod;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSubMeshEntity::SetLod(int alLod)
+	{
+		mlLod = alLod;
+		if(mpDynVtxBuffer==NULL) return;
+
+		/////////////////////////
+		// Skinned meshes have a dynamic buffer for each level, created when first used.
+		if(mlLod > 0 && mvDynLodVtxBuffers[mlLod-1]==NULL)
+		{
+			mvDynLodVtxBuffers[mlLod-1] = CreateSkinVertexBuffer(mpSubMesh->GetLod(mlLod-1)->mpVtxBuffer);
+		}
+
+		//The new level has not been skinned for the current pose, if there is one yet.
+		if(mlBoneMatricesUpdateCount != -2) UpdateSkinnedVertices();
+	}
+
+	//-----------------------------------------------------------------------
+
+	iVertexBuffer* cSubMeshEntity::CreateSkinVertexBuffer(iVertexBuffer *apBindBuffer)
+	{
+		iVertexBuffer *pSkinBuffer = apBindBuffer->CreateCopy(eVertexBufferType_Hardware,eVertexBufferUsageType_Dynamic,eFlagBit_All);
+
+		//Skinned normals and tangents are written as floats, the bind pose can be compact.
+		if(	pSkinBuffer->GetElementFormat(eVertexBufferElement_Normal) != eVertexBufferElementFormat_Float ||
+			pSkinBuffer->GetElementFormat(eVertexBufferElement_Texture1Tangent) != eVertexBufferElementFormat_Float)
+		{
+			pSkinBuffer->ConvertElementFormat(eVertexBufferElement_Normal, eVertexBufferElementFormat_Float);
+			pSkinBuffer->ConvertElementFormat(eVertexBufferElement_Texture1Tangent, eVertexBufferElementFormat_Float);
+			pSkinBuffer->UpdateData(eVertexElementFlag_Normal | eVertexElementFlag_Texture1,false);
+		}
+
+		return pSkinBuffer;
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Returns the raw data of an element that is either float or compact (Short / HalfFloat).
+	 */
+	static const char* GetBindElementData(iVertexBuffer *apBuffer, eVertexBufferElement aElement, int *apVertexBytes)
+	{
+		eVertexBufferElementFormat format = apBuffer->GetElementFormat(aElement);
+		*apVertexBytes = apBuffer->GetElementNum(aElement) * GetVertexFormatByteSize(format);
+
+		if(format == eVertexBufferElementFormat_Float)	return (const char*)apBuffer->GetFloatArray(aElement);
+		else											return (const char*)apBuffer->GetShortArray(aElement);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSubMeshEntity::UpdateSkinnedVertices()
+	{
+		///////////////////////////
+		// Get the buffers for the current detail level
+		iVertexBuffer *pBindBuffer = mpSubMesh->GetVertexBuffer();
+		iVertexBuffer *pSkinBuffer = mpDynVtxBuffer;
+		const unsigned int *pVertexRemap = NULL;
+		if(mlLod > 0)
+		{
+			cSubMeshLod *pLod = mpSubMesh->GetLod(mlLod-1);
+			pBindBuffer = pLod->mpVtxBuffer;
+			pSkinBuffer = mvDynLodVtxBuffers[mlLod-1];
+			pVertexRemap = &pLod->mvVertexRemap[0];
+		}
+
+		const float *pBindPosArray = pBindBuffer->GetFloatArray(eVertexBufferElement_Position);
+		//Normals and tangents of compact buffers are decoded for each vertex
+		eVertexBufferElementFormat bindNormalFormat = pBindBuffer->GetElementFormat(eVertexBufferElement_Normal);
+		eVertexBufferElementFormat bindTangentFormat = pBindBuffer->GetElementFormat(eVertexBufferElement_Texture1Tangent);
+		int lBindNormalBytes, lBindTangentBytes;
+		const char *pBindNormalData = GetBindElementData(pBindBuffer, eVertexBufferElement_Normal, &lBindNormalBytes);
+		const char *pBindTangentData = GetBindElementData(pBindBuffer, eVertexBufferElement_Texture1Tangent, &lBindTangentBytes);
+
+		float *pSkinPosArray = pSkinBuffer->GetFloatArray(eVertexBufferElement_Position);
+		float *pSkinNormalArray = pSkinBuffer->GetFloatArray(eVertexBufferElement_Normal);
+		float *pSkinTangentArray = pSkinBuffer->GetFloatArray(eVertexBufferElement_Texture1Tangent);
+
+		const int lVtxStride = pSkinBuffer->GetElementNum(eVertexBufferElement_Position);
+		const int lVtxNum = pSkinBuffer->GetVertexNum();
+
+		for(int vtx=0; vtx < lVtxNum; vtx++)
+		{
+			//Weights are stored for the full sub mesh vertices
+			int lWeightVtx = pVertexRemap ? (int)pVertexRemap[vtx] : vtx;
+
+			//To count the bone bindings
+			int lCount = 0;
+			//Get weights (may be unorm8) and pointer to bone index.
+			float vWeights[4];
+			mpSubMesh->GetBoneWeights(lWeightVtx, vWeights);
+			const float *pWeight = vWeights;
+			if(*pWeight==0) continue;
+
+			const unsigned char *pBoneIdx = &mpSubMesh->mpVertexBones[lWeightVtx*4];
+
+			const float *pBindPos = &pBindPosArray[vtx*lVtxStride];
+			float vBindNormal[3], vBindTangent[4];
+			VertexFormatToFloat(bindNormalFormat, pBindNormalData + vtx*lBindNormalBytes, vBindNormal, 3);
+			VertexFormatToFloat(bindTangentFormat, pBindTangentData + vtx*lBindTangentBytes, vBindTangent, 4);
+
+			float *pSkinPos = &pSkinPosArray[vtx*lVtxStride];
+			float *pSkinNormal = &pSkinNormalArray[vtx*3];
+			float *pSkinTangent = &pSkinTangentArray[vtx*4];
+
+			const cMatrixf &mtxTransform = mpMeshEntity->mvBoneMatrices[*pBoneIdx];
+			
+			
+			MatrixFloatTransformSet(pSkinPos,mtxTransform, pBindPos, *pWeight);
+
+			MatrixFloatRotateSet(pSkinNormal,mtxTransform, vBindNormal, *pWeight);
+
+			MatrixFloatRotateSet(pSkinTangent,mtxTransform, vBindTangent, *pWeight);
+
+			++pWeight; ++pBoneIdx; ++lCount;
+
+			//Iterate weights until 0 is found or count < 4
+			while(lCount < 4 && *pWeight != 0)
+			{
+				//Log("Boneidx: %d Count %d Weight: %f\n",(int)*pBoneIdx,lCount, *pWeight);				
+				const cMatrixf &mtxTransform = mpMeshEntity->mvBoneMatrices[*pBoneIdx];
+
+				//Transform with the local movement of the bone.
+				MatrixFloatTransformAdd(pSkinPos,mtxTransform, pBindPos, *pWeight);
+
+				MatrixFloatRotateAdd(pSkinNormal,mtxTransform, vBindNormal, *pWeight);
+
+				MatrixFloatRotateAdd(pSkinTangent,mtxTransform, vBindTangent, *pWeight);
+
+				++pWeight; ++pBoneIdx; ++lCount;
+			}
+		}
+
+		//No stencil shadows:
+		/*float *pSkinPosArray = pSkinBuffer->GetArray(eVertexElementFlag_Position);
+		if(mpMeshEntity->GetRenderFlagBit(eRenderableFlag_ShadowCaster))
+		{
+			//Update the shadow double
+			memcpy(&pSkinPosArray[lVtxStride*lVtxNum],pSkinPosArray,sizeof(float)*lVtxStride*lVtxNum);
+			for(int vtx=lVtxStride*lVtxNum + lVtxStride-1; vtx < lVtxStride*lVtxNum*2; vtx+=lVtxStride)
+			{
+				pSkinPosArray[vtx] = 0;
+			}
+		}*/
+
+		//Update buffer
+		pSkinBuffer->UpdateData(eVertexElementFlag_Position | eVertexElementFlag_Normal | eVertexElementFlag_Texture1,false);
+		
+		//No stencil shadows:
+		/*if(mpMeshEntity->GetRenderFlagBit(eRenderableFlag_ShadowCaster))
+		{
+			//Update triangles
+			cMath::CreateTriangleData(mvDynTriangles,
+				pSkinBuffer->GetIndices(), pSkinBuffer->GetIndexNum(),
+				pSkinPosArray, lVtxStride, lVtxNum);
+		}*/
+	}
+
+	//-----------------------------------------------------------------------
+
 }
@@ -43,7 +43,7 @@ namespace hpl {
 		mfMinDistance=0;
 
 		mpData = apData;
-		mpData->IncUserCount();
+		if(mpData) mpData->IncUserCount();
 
 		mpSoundManger = apSoundManger;
 
@@ -78,7 +78,7 @@ namespace hpl {
 
 	void iSoundChannel::DestroyData()
 	{
-		if(mpSoundManger)
+		if(mpSoundManger && mpData)
 		{
 			mpSoundManger->Destroy(mpData);
 		}
@@ -155,6 +155,18 @@ namespace hpl {
 		for(int i=0; i<3; ++i) PreloadSoundsOfType( (eSoundEntityType)i );
 	}
 
+	void cSoundEntityData::PrefetchSounds()
+	{
+		if(mbStream) return;
+
+		cSoundManager *pSoundManager = mpResources->GetSoundManager();
+		for(int i=0; i<3; ++i)
+		{
+			for(size_t j=0; j<mvSoundNameVecs[i].size(); ++j)
+				pSoundManager->PrefetchSoundData(mvSoundNameVecs[i][j]);
+		}
+	}
+
 	//-----------------------------------------------------------------------
 
 	void cSoundEntityData::LoadSoundsInElement(cXmlElement *apElement, tStringVec *apStringVec)
@@ -67,6 +67,57 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	//////////////////////////////////////////////////////////////////////////
+	// PENDING CHANNEL
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cPendingSoundChannel::cPendingSoundChannel() : iSoundChannel(NULL,NULL)
+	{
+		mb3D = false;
+		mfPan = 0;
+		mlPriority = 0;
+		mfElapsedTime = 0;
+		mbPaused = false; //Only true if paused while loading
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cPendingSoundChannel::SetPriority(int alX)
+	{
+		mlPriority = alX + mlPriorityModifier;
+		if(mlPriority > 255) mlPriority = 255;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cPendingSoundChannel::CopySettingsTo(iSoundChannel *apChannel)
+	{
+		apChannel->SetLooping(mbLooping);
+		apChannel->SetMinDistance(mfMinDistance);
+		apChannel->SetMaxDistance(mfMaxDistance);
+		apChannel->Set3D(mb3D);
+		apChannel->SetPriorityModifier(mlPriorityModifier);
+		apChannel->SetPriority(mlPriority - mlPriorityModifier);
+		apChannel->SetAffectedByEnv(mbAffectedByEnv);
+		
+		apChannel->SetPositionIsRelative(mbPositionRelative);
+		apChannel->SetRelPosition(mvRelPosition);
+		apChannel->SetPosition(mvPosition);
+		apChannel->SetVelocity(mvVelocity);
+
+		apChannel->SetBlockable(mbBlockable);
+		apChannel->SetBlockVolumeMul(mfBlockVolumeMul);
+		apChannel->SetSpeed(mfSpeed);
+		apChannel->SetVolume(mfVolume);
+
+		if(mfElapsedTime > 0) apChannel->SetElapsedTime(mfElapsedTime);
+		if(mbPaused) apChannel->SetPaused(true);
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// SOUND ENTRY
 	//////////////////////////////////////////////////////////////////////////
@@ -80,61 +131,37 @@ namespace hpl {
 								bool abStream, int alId,
 								cSoundHandler *apSoundHandler)
 	{
-		msName = cString::ToLowerCase(asName);
-		mpSound = apSound;
-		mfNormalVolume = afVolume;
-		mType = aType;
-		mbStream = abStream;
-		mlId = alId;
 		mpSoundHandler = apSoundHandler;
-		mb3D = ab3D;
-		
-		////////////////////////
-		// Set up defaults
-		mfVolumeMul = 1;
-		mfVolumeFadeDest = 1;
-		mfVolumeFadeSpeed =0;
-		mbStopAfterFadeOut = false;
-		
-		mbStopDisabled = false;
-
-		mfNormalSpeed = 1;
-
-		mfSpeedMul = 1;
-		mfSpeedFadeDest = 1;
-		mfSpeedFadeSpeed = 0;
-
-		mbFirstTime = true;
+		mpSound = NULL;
 
-		mfBlockMul = 1;
-		mfBlockFadeDest = 1;
-		mfBlockFadeSpeed = 0;
-
-		mpCallback = NULL;
+		Setup(asName, apSound, afVolume, aType, ab3D, abStream, alId);
 
 		if(gbLogEntry)Log("Creating sound entry %d id: %d\n", this, mlId);
 	}
 
-	///////////////////////////////////////
-	//DEBUG when using pooling test
-	/*void cSoundEntry::Setup(const tString& asName, iSoundChannel* apSound, float afVolume,
-		eSoundEntryType aType, bool ab3D,
-		bool abStream,int alId)
+	//-----------------------------------------------------------------------
+
+	void cSoundEntry::Setup(const tString& asName, iSoundChannel* apSound, float afVolume,
+							eSoundEntryType aType, bool ab3D,
+							bool abStream,int alId)
 	{
 		msName = cString::ToLowerCase(asName);
+		mNameId = cNameTable::GetId(msName);
 		mpSound = apSound;
 		mfNormalVolume = afVolume;
 		mType = aType;
 		mbStream = abStream;
 		mlId = alId;
 		mb3D = ab3D;
-
+		
 		////////////////////////
 		// Set up defaults
 		mfVolumeMul = 1;
 		mfVolumeFadeDest = 1;
 		mfVolumeFadeSpeed =0;
 		mbStopAfterFadeOut = false;
+		
+		mbStopDisabled = false;
 
 		mfNormalSpeed = 1;
 
@@ -149,24 +176,45 @@ namespace hpl {
 		mfBlockFadeSpeed = 0;
 
 		mpCallback = NULL;
-	}*/
+
+		mbLoading = false;
+		mfLoadingTime = 0;
+
+	}
 
 	//-----------------------------------------------------------------------
 
 	cSoundEntry::~cSoundEntry()
 	{
 		if(gbLogEntry)Log("Destroying sound entry %d id: %d\n", this, mlId);
-		if(mpSound)
-		{
-			mpSound->Stop();
-			hplDelete( mpSound );
-		}
+		DestroyChannel();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSoundEntry::DestroyChannel()
+	{
+		if(mpSound==NULL) return;
+
+		mpSound->Stop();
+		hplDelete( mpSound );
+		mpSound = NULL;
 	}
 
 	//-----------------------------------------------------------------------
 	
 	bool cSoundEntry::Update(float afTimeStep)
 	{
+		////////////////////////////////////////////
+		// Wait for data, the pending channel keeps all settings until then
+		if(mbLoading)
+		{
+			//Stopped (or failed to load) before it could be started
+			if(mpSound->IsPlaying()==false) return false;
+
+			if(UpdateLoading(afTimeStep)==false) return true;
+		}
+
 		////////////////////////////////////////////
 		// Update Fading
 		UpdateVolumeMulFade(afTimeStep);
@@ -255,6 +303,48 @@ namespace hpl {
 
 	//----------------------------------------------------------------------
 
+	bool cSoundEntry::UpdateLoading(float afTimeStep)
+	{
+		cSoundManager *pSoundManager = mpSoundHandler->mpResources->GetSoundManager();
+
+		mfLoadingTime += afTimeStep;
+		if(	mfLoadingTime < mpSoundHandler->mfAsyncLoadMaxDelay &&
+			pSoundManager->IsPrefetchDone(msName)==false)
+		{
+			return false;
+		}
+
+		cPendingSoundChannel *pPending = static_cast<cPendingSoundChannel*>(mpSound);
+		
+		bool bNotEnoughChannels;
+		iSoundChannel *pChannel = mpSoundHandler->CreateChannel(msName, pPending->GetPriority(), false, &bNotEnoughChannels);
+		if(pChannel == NULL)
+		{
+			if(bNotEnoughChannels==false)
+				Error("Can't find sound '%s'!\n",msName.c_str());
+			else
+				Warning("Could not start sound '%s', too many sounds playing!\n",msName.c_str());
+
+			//Entry is removed at next update
+			pPending->Stop();
+			return false;
+		}
+
+		pPending->CopySettingsTo(pChannel);
+
+		//Paused while loading, so it is started when unpaused instead.
+		if(pPending->GetPaused()) mbFirstTime = false;
+
+		hplDelete( pPending );
+
+		mpSound = pChannel;
+		mbLoading = false;
+
+		return true;
+	}
+
+	//----------------------------------------------------------------------
+
 	void cSoundEntry::UpdateVolumeMulFade(float afTimeStep)
 	{
 		if(mfVolumeMul != mfVolumeFadeDest)
@@ -476,6 +566,7 @@ namespace hpl {
 		mlIdCount = 0;
 
 		mbSilent = false;
+		mfAsyncLoadMaxDelay = 0;
 
 		mfGlobalVolume[0] = 1;
 		mfGlobalVolume[1] = 1;
@@ -488,6 +579,7 @@ namespace hpl {
 	cSoundHandler::~cSoundHandler()
 	{
 		STLDeleteAll(m_lstSoundEntries);
+		STLDeleteAll(mvSoundEntriesPool);
 	}
 
 	//-----------------------------------------------------------------------
@@ -512,6 +604,10 @@ namespace hpl {
 		mGlobalVolumeHandler.Update(afTimeStep);
 		mGlobalSpeedHandler.Update(afTimeStep);
 
+		///////////////////////////////////////////////
+		// Create entities preloaded since last update in one go
+		mpResources->GetSoundEntityManager()->FlushPreloads();
+
 		///////////////////////////////////////////////
 		// Update entries
 		tSoundEntryListIt it = m_lstSoundEntries.begin();
@@ -521,8 +617,8 @@ namespace hpl {
 
 			if(pEntry->Update(afTimeStep) == false)
 			{
-				hplDelete( pEntry );
-				//m_lstSoundEntriesPool.push_back(pEntry);
+				pEntry->DestroyChannel();
+				mvSoundEntriesPool.push_back(pEntry);
 				it = m_lstSoundEntries.erase(it);
 			}
 			else
@@ -560,18 +656,31 @@ namespace hpl {
 		///////////////////////////////
 		//Create sound channel
 		if(apNotEnoughChannels) *apNotEnoughChannels = false;
-		bool bNotEnoughChannels;
-		iSoundChannel *pSound = CreateChannel(asName,lDistPrio + alPriorityModifier, abStream,&bNotEnoughChannels);
-		if(pSound == NULL)
+		iSoundChannel *pSound = NULL;
+		bool bLoading = false;
+
+		//If data is not loaded, read it in the background and use a stand in until it is
+		if(	abStream==false && mbSilent==false && mfAsyncLoadMaxDelay > 0 && 
+			mpResources->GetSoundManager()->PrefetchSoundData(asName))
+		{
+			pSound = hplNew( cPendingSoundChannel, () );
+			bLoading = true;
+		}
+		else
 		{
-			if(apNotEnoughChannels) *apNotEnoughChannels = bNotEnoughChannels;
+			bool bNotEnoughChannels;
+			pSound = CreateChannel(asName,lDistPrio + alPriorityModifier, abStream,&bNotEnoughChannels);
+			if(pSound == NULL)
+			{
+				if(apNotEnoughChannels) *apNotEnoughChannels = bNotEnoughChannels;
 
-			if(bNotEnoughChannels==false)
-				Error("Can't find sound '%s'!\n",asName.c_str());
-			else
-				Warning("Could not start sound '%s', too many sounds playing!\n",asName.c_str());
-			
-			return NULL;
+				if(bNotEnoughChannels==false)
+					Error("Can't find sound '%s'!\n",asName.c_str());
+				else
+					Warning("Could not start sound '%s', too many sounds playing!\n",asName.c_str());
+				
+				return NULL;
+			}
 		}
 
 		/////////////////////////////////
@@ -635,19 +744,19 @@ namespace hpl {
 
 		////////////////////////
 		// Create entry
-		cSoundEntry *pEntry = hplNew( cSoundEntry, (asName,pSound,afVolume,aEntryType, ab3D, false,mlIdCount,this) );
-		/*cSoundEntry *pEntry = NULL;
-		if(m_lstSoundEntriesPool.empty())
+		cSoundEntry *pEntry = NULL;
+		if(mvSoundEntriesPool.empty())
 		{
 			pEntry = hplNew( cSoundEntry, (asName,pSound,afVolume,aEntryType, ab3D, false,mlIdCount,this) );
 		}
 		else
 		{
-			pEntry = m_lstSoundEntriesPool.back();
-			m_lstSoundEntriesPool.pop_back();
+			pEntry = mvSoundEntriesPool.back();
+			mvSoundEntriesPool.pop_back();
 
 			pEntry->Setup(asName,pSound,afVolume,aEntryType, ab3D, false,mlIdCount);
-		}*/
+		}
+		pEntry->mbLoading = bLoading;
 
 		m_lstSoundEntries.push_back(pEntry);
 
@@ -708,7 +817,12 @@ namespace hpl {
 
 	bool cSoundHandler::Stop(const tString& asName)
 	{
-		cSoundEntry *pEntry = GetEntry(asName);
+		return Stop(cNameTable::FindId(asName));
+	}
+
+	bool cSoundHandler::Stop(tNameId alNameId)
+	{
+		cSoundEntry *pEntry = GetEntry(alNameId);
 		if(pEntry) 
 		{
 			pEntry->Stop();
@@ -796,7 +910,12 @@ namespace hpl {
 
 	bool cSoundHandler::IsPlaying(const tString& asName)
 	{
-		cSoundEntry *pEntry = GetEntry(asName);
+		return IsPlaying(cNameTable::FindId(asName));
+	}
+
+	bool cSoundHandler::IsPlaying(tNameId alNameId)
+	{
+		cSoundEntry *pEntry = GetEntry(alNameId);
 		
 		if(pEntry) return pEntry->GetChannel()->IsPlaying();
 		
@@ -930,14 +1049,20 @@ namespace hpl {
 
 	cSoundEntry* cSoundHandler::GetEntry(const tString& asName)
 	{
-		tString sLowName = cString::ToLowerCase(asName);
-		
+		return GetEntry(cNameTable::FindId(asName));
+	}
+
+	cSoundEntry* cSoundHandler::GetEntry(tNameId alNameId)
+	{
+		//A name that was never interned can not belong to an entry.
+		if(alNameId == kNameId_None) return NULL;
+
 		tSoundEntryListIt it = m_lstSoundEntries.begin();
 		for(; it != m_lstSoundEntries.end(); ++it)
 		{
 			cSoundEntry *pEntry = *it;
 
-			if(pEntry->GetName() == sLowName)
+			if(pEntry->GetNameId() == alNameId)
 			{
 				return pEntry;
 			}
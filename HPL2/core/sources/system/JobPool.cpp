@@ -0,0 +1,152 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "system/JobPool.h"
+
+#include "system/Mutex.h"
+#include "system/Platform.h"
+#include "system/MemoryManager.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// WORKER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cJobPoolWorker::UpdateThread()
+	{
+		//Run until queue is empty, then the thread sleeps a little before checking again.
+		while(mpPool->RunNextJob());
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cJobPool::cJobPool(int alThreadNum)
+	{
+		mpMutex = cPlatform::CreateMutEx();
+
+		for(int i=0; i<alThreadNum; ++i)
+		{
+			cJobPoolWorker *pWorker = hplNew(cJobPoolWorker, (this) );
+			iThread *pThread = cPlatform::CreateThread(pWorker);
+			pThread->SetSleepTime(1);
+			pThread->Start();
+
+			mvWorkers.push_back(pWorker);
+			mvThreads.push_back(pThread);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	cJobPool::~cJobPool()
+	{
+		//Finish all queued jobs before the workers are stopped.
+		while(RunNextJob());
+
+		for(size_t i=0; i<mvThreads.size(); ++i)
+		{
+			mvThreads[i]->Stop();
+			hplDelete(mvThreads[i]);
+			hplDelete(mvWorkers[i]);
+		}
+
+		hplDelete(mpMutex);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cJobPool::AddJob(iJob *apJob, cJobBatch *apBatch)
+	{
+		mpMutex->Lock();
+		
+		if(apBatch) apBatch->mlJobsLeft++;
+		mlstJobs.push_back(cJobPoolEntry(apJob, apBatch));
+		
+		mpMutex->Unlock();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cJobPool::WaitForBatch(cJobBatch *apBatch)
+	{
+		while(IsBatchDone(apBatch)==false)
+		{
+			if(RunNextJob()==false) cPlatform::Sleep(0);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cJobPool::IsBatchDone(cJobBatch *apBatch)
+	{
+		mpMutex->Lock();
+		bool bDone = apBatch->mlJobsLeft <= 0;
+		mpMutex->Unlock();
+
+		return bDone;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cJobPool::RunNextJob()
+	{
+		////////////////////////
+		// Get job
+		mpMutex->Lock();
+		if(mlstJobs.empty())
+		{
+			mpMutex->Unlock();
+			return false;
+		}
+		cJobPoolEntry entry = mlstJobs.front();
+		mlstJobs.pop_front();
+		mpMutex->Unlock();
+
+		////////////////////////
+		// Run and mark as done
+		entry.mpJob->Run();
+		hplDelete(entry.mpJob);
+
+		if(entry.mpBatch)
+		{
+			mpMutex->Lock();
+			entry.mpBatch->mlJobsLeft--;
+			mpMutex->Unlock();
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "system/MemoryArena.h"
+
+#include "system/MemoryManager.h"
+#include <string.h>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cMemoryArena::cMemoryArena(size_t alBlockSize)
+	{
+		mlBlockSize = alBlockSize;
+
+		mpCurrent = NULL;
+		mpEnd = NULL;
+
+		mlUsedSize = 0;
+		mlMemorySize = 0;
+		mlFirstBlockSize = 0;
+	}
+
+	cMemoryArena::~cMemoryArena()
+	{
+		for(size_t i=0; i<mvBlocks.size(); ++i)
+		{
+			hplDeleteArray(mvBlocks[i]);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void* cMemoryArena::Alloc(size_t alSize, size_t alAlign)
+	{
+		char *pData = (char*)(((size_t)mpCurrent + (alAlign-1)) & ~(alAlign-1));
+		if(mpCurrent==NULL || pData + alSize > mpEnd)
+		{
+			AddBlock(alSize + alAlign);
+			pData = (char*)(((size_t)mpCurrent + (alAlign-1)) & ~(alAlign-1));
+		}
+
+		mpCurrent = pData + alSize;
+		mlUsedSize += alSize;
+
+		return pData;
+	}
+
+	//-----------------------------------------------------------------------
+
+	char* cMemoryArena::AllocString(const char* apString, size_t alLength)
+	{
+		char *pString = (char*)Alloc(alLength+1, 1);
+		memcpy(pString, apString, alLength);
+		pString[alLength] = 0;
+
+		return pString;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryArena::Clear()
+	{
+		if(mvBlocks.empty()) return;
+
+		for(size_t i=1; i<mvBlocks.size(); ++i)
+		{
+			hplDeleteArray(mvBlocks[i]);
+		}
+		mvBlocks.resize(1);
+
+		mpCurrent = mvBlocks[0];
+		mpEnd = mpCurrent + mlFirstBlockSize;
+
+		mlUsedSize = 0;
+		mlMemorySize = mlFirstBlockSize;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryArena::AddBlock(size_t alMinSize)
+	{
+		size_t lSize = alMinSize > mlBlockSize ? alMinSize : mlBlockSize;
+
+		char *pBlock = hplNewArray(char, lSize);
+		mvBlocks.push_back(pBlock);
+		if(mvBlocks.size()==1) mlFirstBlockSize = lSize;
+
+		mpCurrent = pBlock;
+		mpEnd = pBlock + lSize;
+
+		mlMemorySize += lSize;
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -20,6 +20,18 @@
 #include "system/MemoryManager.h"
 
 #include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/String.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+	#include <malloc.h>
+#endif
 
 namespace hpl {
 
@@ -177,5 +189,700 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	//////////////////////////////////////////////////////////////////////////
+	// MEMORY TRACKER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	// All tracker data is plain static arrays, so it is valid before any constructors have been run.
+	// The only memory used while tracking is the pointer tables, which are allocated with malloc.
+
+	#define kMemoryTrackTableNum 64
+	#define kMemoryTrackTableStartSize 1024
+	#define kMemoryTrackRemoved ((void*)1)
+
+	#define kMemoryTagCacheSize 1024
+	#define kMemoryTagCacheMaxProbes 8
+
+	#define kMemorySampleSiteNum 4096
+	#define kMemorySampleSiteMaxProbes 32
+
+	class cMemoryTrackEntry
+	{
+	public:
+		void* mpData;
+		size_t mlSize;
+		int mlTag;
+	};
+
+	/**
+	 * Open addressing table from pointer to size and tag. mlUsedNum counts live and removed entries.
+	 */
+	class cMemoryTrackTable
+	{
+	public:
+		cMemoryTrackEntry* mpEntries;
+		size_t mlSize;
+		size_t mlUsedNum;
+		size_t mlLiveNum;
+		volatile size_t mlLock;
+	};
+
+	class cMemorySampleSlot
+	{
+	public:
+		const char* mpFile;
+		int mlLine;
+		int mlTag;
+		size_t mlSampleNum;
+		size_t mlSampledBytes;
+	};
+
+	static volatile size_t gvTagLiveBytes[eMemoryTag_LastEnum];
+	static volatile size_t gvTagPeakBytes[eMemoryTag_LastEnum];
+	static volatile size_t gvTagLiveNum[eMemoryTag_LastEnum];
+	static volatile size_t gvTagAllocNum[eMemoryTag_LastEnum];
+
+	static const char* volatile gvTagCacheFiles[kMemoryTagCacheSize];
+	static volatile int gvTagCacheTags[kMemoryTagCacheSize];
+
+	static cMemoryTrackTable gvTrackTables[kMemoryTrackTableNum];
+
+	static cMemorySampleSlot gvSampleSlots[kMemorySampleSiteNum];
+	static volatile size_t glSampleLock = 0;
+	static volatile size_t glSampleCount = 0;
+	static volatile size_t glDroppedSampleNum = 0;
+	static volatile int glSampleRate = 0;
+
+	static const char* gvTagNames[eMemoryTag_LastEnum] =
+	{
+		"Graphics", "Physics", "Scene", "Sound", "Script", "Gui", "Resources", "Game", "Other"
+	};
+
+	//-----------------------------------------------------------------------
+
+	static size_t AtomicAdd(volatile size_t *apValue, size_t alAdd)
+	{
+	#if defined(_MSC_VER) && defined(_WIN64)
+		return (size_t)_InterlockedExchangeAdd64((volatile __int64*)apValue, (__int64)alAdd) + alAdd;
+	#elif defined(_MSC_VER)
+		return (size_t)_InterlockedExchangeAdd((volatile long*)apValue, (long)alAdd) + alAdd;
+	#else
+		return __sync_add_and_fetch(apValue, alAdd);
+	#endif
+	}
+
+	static bool AtomicCompareAndSwap(volatile size_t *apValue, size_t alOld, size_t alNew)
+	{
+	#if defined(_MSC_VER) && defined(_WIN64)
+		return _InterlockedCompareExchange64((volatile __int64*)apValue, (__int64)alNew, (__int64)alOld) == (__int64)alOld;
+	#elif defined(_MSC_VER)
+		return _InterlockedCompareExchange((volatile long*)apValue, (long)alNew, (long)alOld) == (long)alOld;
+	#else
+		return __sync_bool_compare_and_swap(apValue, alOld, alNew);
+	#endif
+	}
+
+	//-----------------------------------------------------------------------
+
+	static void AddToTag(int alTag, size_t alSize)
+	{
+		size_t lLive = AtomicAdd(&gvTagLiveBytes[alTag], alSize);
+		AtomicAdd(&gvTagLiveNum[alTag], 1);
+		AtomicAdd(&gvTagAllocNum[alTag], 1);
+
+		size_t lPeak = gvTagPeakBytes[alTag];
+		while(lLive > lPeak)
+		{
+			if(AtomicCompareAndSwap(&gvTagPeakBytes[alTag], lPeak, lLive)) break;
+			lPeak = gvTagPeakBytes[alTag];
+		}
+	}
+
+	static void RemoveFromTag(int alTag, size_t alSize)
+	{
+		AtomicAdd(&gvTagLiveBytes[alTag], (size_t)0 - alSize);
+		AtomicAdd(&gvTagLiveNum[alTag], (size_t)0 - 1);
+	}
+
+	//-----------------------------------------------------------------------
+
+	static void LockTable(cMemoryTrackTable& aTable)
+	{
+		while(AtomicCompareAndSwap(&aTable.mlLock, 0, 1)==false){}
+	}
+
+	static void UnlockTable(cMemoryTrackTable& aTable)
+	{
+		AtomicCompareAndSwap(&aTable.mlLock, 1, 0);
+	}
+
+	static size_t GetPointerHash(const void* apData)
+	{
+		size_t lX = (size_t)apData >> 4;
+		lX ^= lX >> 13;
+		lX *= 0x9E3779B1;
+		lX ^= lX >> 15;
+		return lX;
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Rebuilds the table without removed entries, twice as big if half of it is live. Table must be locked.
+	 */
+	static bool RebuildTable(cMemoryTrackTable& aTable)
+	{
+		size_t lNewSize = aTable.mlSize == 0 ? kMemoryTrackTableStartSize : aTable.mlSize;
+		if(aTable.mlLiveNum * 2 >= lNewSize) lNewSize *= 2;
+
+		cMemoryTrackEntry *pNewEntries = (cMemoryTrackEntry*)calloc(lNewSize, sizeof(cMemoryTrackEntry));
+		if(pNewEntries==NULL) return false;
+
+		for(size_t i=0; i<aTable.mlSize; ++i)
+		{
+			const cMemoryTrackEntry& entry = aTable.mpEntries[i];
+			if(entry.mpData == NULL || entry.mpData == kMemoryTrackRemoved) continue;
+
+			size_t lSlot = (GetPointerHash(entry.mpData) / kMemoryTrackTableNum) & (lNewSize-1);
+			while(pNewEntries[lSlot].mpData != NULL) lSlot = (lSlot+1) & (lNewSize-1);
+
+			pNewEntries[lSlot] = entry;
+		}
+
+		free(aTable.mpEntries);
+		aTable.mpEntries = pNewEntries;
+		aTable.mlSize = lNewSize;
+		aTable.mlUsedNum = aTable.mlLiveNum;
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static void TrackAllocation(void *apData, size_t alSize, int alTag)
+	{
+		size_t lHash = GetPointerHash(apData);
+		cMemoryTrackTable& table = gvTrackTables[lHash % kMemoryTrackTableNum];
+
+		LockTable(table);
+
+		//Keep the table at most 3/4 full so there is always an empty slot ending a search.
+		//If there is no memory to grow, the allocation is simply not counted.
+		if((table.mlUsedNum+1)*4 > table.mlSize*3 && RebuildTable(table)==false)
+		{
+			UnlockTable(table);
+			return;
+		}
+
+		//The pointer is not in the table, so a removed entry can be reused
+		size_t lSlot = (lHash / kMemoryTrackTableNum) & (table.mlSize-1);
+		while(table.mpEntries[lSlot].mpData != NULL && table.mpEntries[lSlot].mpData != kMemoryTrackRemoved)
+		{
+			lSlot = (lSlot+1) & (table.mlSize-1);
+		}
+
+		cMemoryTrackEntry& entry = table.mpEntries[lSlot];
+		if(entry.mpData == NULL) table.mlUsedNum++;
+		entry.mpData = apData;
+		entry.mlSize = alSize;
+		entry.mlTag = alTag;
+		table.mlLiveNum++;
+
+		UnlockTable(table);
+
+		AddToTag(alTag, alSize);
+	}
+
+	//-----------------------------------------------------------------------
+
+	static void UntrackAllocation(void *apData)
+	{
+		size_t lHash = GetPointerHash(apData);
+		cMemoryTrackTable& table = gvTrackTables[lHash % kMemoryTrackTableNum];
+
+		LockTable(table);
+
+		if(table.mlSize == 0)
+		{
+			UnlockTable(table);
+			return;
+		}
+
+		size_t lSlot = (lHash / kMemoryTrackTableNum) & (table.mlSize-1);
+		for(; table.mpEntries[lSlot].mpData != NULL; lSlot = (lSlot+1) & (table.mlSize-1))
+		{
+			cMemoryTrackEntry& entry = table.mpEntries[lSlot];
+			if(entry.mpData != apData) continue;
+
+			size_t lSize = entry.mlSize;
+			int lTag = entry.mlTag;
+
+			entry.mpData = kMemoryTrackRemoved;
+			table.mlLiveNum--;
+
+			UnlockTable(table);
+
+			RemoveFromTag(lTag, lSize);
+			return;
+		}
+
+		UnlockTable(table);
+	}
+
+	//-----------------------------------------------------------------------
+
+	static void LockSamples()
+	{
+		while(AtomicCompareAndSwap(&glSampleLock, 0, 1)==false){}
+	}
+
+	static void UnlockSamples()
+	{
+		AtomicCompareAndSwap(&glSampleLock, 1, 0);
+	}
+
+	static void AddSample(const cMemoryAllocSite& aSite, int alTag, size_t alSize)
+	{
+		size_t lHash = ((size_t)aSite.mpFile >> 3) * 31 + (size_t)aSite.mlLine;
+
+		LockSamples();
+		for(int i=0; i<kMemorySampleSiteMaxProbes; ++i)
+		{
+			cMemorySampleSlot& slot = gvSampleSlots[(lHash + i) % kMemorySampleSiteNum];
+			if(slot.mpFile == NULL)
+			{
+				slot.mpFile = aSite.mpFile;
+				slot.mlLine = aSite.mlLine;
+				slot.mlTag = alTag;
+			}
+			if(slot.mpFile == aSite.mpFile && slot.mlLine == aSite.mlLine)
+			{
+				slot.mlSampleNum++;
+				slot.mlSampledBytes += alSize;
+				UnlockSamples();
+				return;
+			}
+		}
+		UnlockSamples();
+
+		AtomicAdd(&glDroppedSampleNum, 1);
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Returns the part after the last game or engine source folder, eg "graphics/mesh.cpp". Only this part
+	 * is checked, so folder names above the checkout can not change the tag.
+	 */
+	static const char* GetRepoSubPath(const char* apLowerFile, bool &abGame)
+	{
+		const char *pSubPath = NULL;
+		const char* vRoots[3] = {"/src/game/", "/sources/", "/include/"};
+		for(int i=0; i<3; ++i)
+		{
+			for(const char *pC = strstr(apLowerFile, vRoots[i]); pC; pC = strstr(pC+1, vRoots[i]))
+			{
+				const char *pAfter = pC + strlen(vRoots[i]);
+				if(pSubPath && pAfter <= pSubPath) continue;
+
+				pSubPath = pAfter;
+				abGame = i==0;
+			}
+		}
+		return pSubPath;
+	}
+
+	static bool SubPathHasFolder(const char* apSubPath, const char* apFolder)
+	{
+		return apSubPath && strncmp(apSubPath, apFolder, strlen(apFolder))==0;
+	}
+
+	static eMemoryTag GetTagFromPath(const char* apFile)
+	{
+		/////////////////////////
+		// Lower case path with forward slashes, starting with a slash so the first folder can be found too
+		char sPath[260];
+		int lLen = 0;
+		sPath[lLen++] = '/';
+		for(const char *pC = apFile; *pC && lLen < (int)sizeof(sPath)-1; ++pC)
+		{
+			char c = *pC;
+			if(c == '\\') c = '/';
+			else if(c >= 'A' && c <= 'Z') c = c - 'A' + 'a';
+			sPath[lLen++] = c;
+		}
+		sPath[lLen] = 0;
+
+		const char *pFileName = strrchr(sPath, '/') + 1;
+
+		/////////////////////////
+		// Game code
+		bool bGame = false;
+		const char *pSubPath = GetRepoSubPath(sPath, bGame);
+		if(bGame || strncmp(pFileName, "lux", 3)==0) return eMemoryTag_Game;
+
+		/////////////////////////
+		// Engine folders
+		if(SubPathHasFolder(pSubPath, "graphics/"))		return eMemoryTag_Graphics;
+		if(SubPathHasFolder(pSubPath, "physics/"))		return eMemoryTag_Physics;
+		if(SubPathHasFolder(pSubPath, "scene/"))		return eMemoryTag_Scene;
+		if(SubPathHasFolder(pSubPath, "sound/"))		return eMemoryTag_Sound;
+		if(SubPathHasFolder(pSubPath, "script/"))		return eMemoryTag_Script;
+		if(SubPathHasFolder(pSubPath, "gui/"))			return eMemoryTag_Gui;
+		if(SubPathHasFolder(pSubPath, "resources/"))	return eMemoryTag_Resources;
+
+		/////////////////////////
+		// Implementations are all in one folder, so use the file name
+		if(strstr(pFileName, "graphics") || strstr(pFileName, "texture") || strstr(pFileName, "shader") ||
+			strstr(pFileName, "framebuffer") || strstr(pFileName, "vertexbuffer"))	return eMemoryTag_Graphics;
+		if(strstr(pFileName, "physics") || strstr(pFileName, "newton"))				return eMemoryTag_Physics;
+		if(strstr(pFileName, "sound") || strstr(pFileName, "oal"))					return eMemoryTag_Sound;
+		if(strstr(pFileName, "script"))												return eMemoryTag_Script;
+
+		return eMemoryTag_Other;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static bool SortSampledSitesByBytes(const cMemorySampledSite& aA, const cMemorySampledSite& aB)
+	{
+		return aA.mlSampledBytes > aB.mlSampledBytes;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cMemoryTracker::IsActive()
+	{
+	#ifdef MEMORY_TRACKING_ACTIVE
+		return true;
+	#else
+		return false;
+	#endif
+	}
+
+	//-----------------------------------------------------------------------
+
+	const char* cMemoryTracker::GetTagName(eMemoryTag aTag)
+	{
+		if(aTag < 0 || aTag >= eMemoryTag_LastEnum) return "";
+		return gvTagNames[aTag];
+	}
+
+	//-----------------------------------------------------------------------
+
+	eMemoryTag cMemoryTracker::GetTagFromFile(const char* apFile)
+	{
+		if(apFile == NULL) return eMemoryTag_Other;
+
+		////////////////////////
+		// __FILE__ is the same pointer for a file, so cache the tag on the pointer
+		size_t lHash = ((size_t)apFile >> 3) % kMemoryTagCacheSize;
+		for(int i=0; i<kMemoryTagCacheMaxProbes; ++i)
+		{
+			size_t lSlot = (lHash + i) % kMemoryTagCacheSize;
+			const char* pCached = gvTagCacheFiles[lSlot];
+			if(pCached == apFile) return (eMemoryTag)gvTagCacheTags[lSlot];
+			
+			if(pCached == NULL)
+			{
+				//Tag is set before the file so a reader never sees the file without its tag
+				eMemoryTag tag = GetTagFromPath(apFile);
+				gvTagCacheTags[lSlot] = tag;
+				gvTagCacheFiles[lSlot] = apFile;
+				return tag;
+			}
+		}
+
+		return GetTagFromPath(apFile);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryTracker::GetTagStats(eMemoryTag aTag, cMemoryTagStats& aStats)
+	{
+		aStats.mlLiveBytes = gvTagLiveBytes[aTag];
+		aStats.mlPeakBytes = gvTagPeakBytes[aTag];
+		aStats.mlLiveNum = gvTagLiveNum[aTag];
+		aStats.mlAllocNum = gvTagAllocNum[aTag];
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryTracker::SetSampleRate(int alEveryNth)
+	{
+		glSampleRate = alEveryNth > 0 ? alEveryNth : 0;
+	}
+
+	int cMemoryTracker::GetSampleRate()
+	{
+		return glSampleRate;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryTracker::GetSampledSites(tMemorySampledSiteVec& avSites)
+	{
+		//Reserve first, so nothing is allocated while locked
+		avSites.reserve(avSites.size() + kMemorySampleSiteNum);
+
+		LockSamples();
+		for(int i=0; i<kMemorySampleSiteNum; ++i)
+		{
+			const cMemorySampleSlot& slot = gvSampleSlots[i];
+			if(slot.mpFile == NULL) continue;
+
+			cMemorySampledSite site;
+			site.mpFile = slot.mpFile;
+			site.mlLine = slot.mlLine;
+			site.mTag = (eMemoryTag)slot.mlTag;
+			site.mlSampleNum = slot.mlSampleNum;
+			site.mlSampledBytes = slot.mlSampledBytes;
+			avSites.push_back(site);
+		}
+		UnlockSamples();
+
+		std::sort(avSites.begin(), avSites.end(), SortSampledSitesByBytes);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryTracker::ClearSampledSites()
+	{
+		LockSamples();
+		memset(gvSampleSlots, 0, sizeof(gvSampleSlots));
+		UnlockSamples();
+
+		glDroppedSampleNum = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryTracker::LogReport()
+	{
+		Log("\n|--Memory Tracker Report------------------------------|\n");
+		if(IsActive()==false)
+		{
+			Log("| Not active, build with MEMORY_TRACKING_ACTIVE.\n");
+			Log("|------------------------------------------------------|\n\n");
+			return;
+		}
+
+		Log("| tag\t\t live MB\t peak MB\t live\t\t allocs\n");
+		for(int i=0; i<eMemoryTag_LastEnum; ++i)
+		{
+			cMemoryTagStats stats;
+			GetTagStats((eMemoryTag)i, stats);
+			Log("| %-10s\t %8.2f\t %8.2f\t %8d\t %10d\n", gvTagNames[i],
+				(double)stats.mlLiveBytes / (1024.0*1024.0), (double)stats.mlPeakBytes / (1024.0*1024.0),
+				(int)stats.mlLiveNum, (int)stats.mlAllocNum);
+		}
+
+		if(glSampleRate > 0)
+		{
+			tMemorySampledSiteVec vSites;
+			GetSampledSites(vSites);
+
+			Log("|\n| Top sampled sites (every %d allocations):\n", glSampleRate);
+			for(size_t i=0; i<vSites.size() && i<20; ++i)
+			{
+				Log("| %s:%d [%s] samples: %d bytes: %d\n", vSites[i].mpFile, vSites[i].mlLine, gvTagNames[vSites[i].mTag],
+					(int)vSites[i].mlSampleNum, (int)vSites[i].mlSampledBytes);
+			}
+		}
+		Log("|------------------------------------------------------|\n\n");
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cMemoryTracker::SaveReport(const std::wstring& asFile)
+	{
+		FILE *pFile = cPlatform::OpenFile(asFile, _W("w"));
+		if(pFile==NULL)
+		{
+			Error("Could not save memory report to '%ls'!\n", asFile.c_str());
+			return false;
+		}
+
+		fprintf(pFile, "{\n");
+		fprintf(pFile, "\t\"active\": %s,\n", IsActive() ? "true" : "false");
+
+		/////////////////////////
+		// Tags
+		fprintf(pFile, "\t\"tags\": {\n");
+		for(int i=0; i<eMemoryTag_LastEnum; ++i)
+		{
+			cMemoryTagStats stats;
+			GetTagStats((eMemoryTag)i, stats);
+			fprintf(pFile, "\t\t\"%s\": { \"live_bytes\": %lu, \"peak_bytes\": %lu, \"live_allocs\": %lu, \"total_allocs\": %lu }%s\n",
+					gvTagNames[i], (unsigned long)stats.mlLiveBytes, (unsigned long)stats.mlPeakBytes,
+					(unsigned long)stats.mlLiveNum, (unsigned long)stats.mlAllocNum,
+					i < eMemoryTag_LastEnum-1 ? "," : "");
+		}
+		fprintf(pFile, "\t},\n");
+
+		/////////////////////////
+		// Sampled sites, biggest first
+		tMemorySampledSiteVec vSites;
+		GetSampledSites(vSites);
+
+		fprintf(pFile, "\t\"sample_rate\": %d,\n", glSampleRate);
+		fprintf(pFile, "\t\"dropped_samples\": %lu,\n", (unsigned long)glDroppedSampleNum);
+		fprintf(pFile, "\t\"sites\": [\n");
+		for(size_t i=0; i<vSites.size(); ++i)
+		{
+			tString sFile = cString::ReplaceCharTo(vSites[i].mpFile, "\\", "/");
+			fprintf(pFile, "\t\t{ \"file\": \"%s\", \"line\": %d, \"tag\": \"%s\", \"samples\": %lu, \"sampled_bytes\": %lu }%s\n",
+					sFile.c_str(), vSites[i].mlLine, gvTagNames[vSites[i].mTag],
+					(unsigned long)vSites[i].mlSampleNum, (unsigned long)vSites[i].mlSampledBytes,
+					i+1 < vSites.size() ? "," : "");
+		}
+		fprintf(pFile, "\t]\n");
+		fprintf(pFile, "}\n");
+
+		fclose(pFile);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void* cMemoryTracker::Allocate(size_t alSize, eMemoryTag aTag)
+	{
+		void *pData = malloc(alSize);
+		if(pData==NULL) return NULL;
+
+		TrackAllocation(pData, alSize, aTag);
+
+		return pData;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void* cMemoryTracker::AllocateAligned(size_t alSize, size_t alAlign, eMemoryTag aTag)
+	{
+		if(alAlign < sizeof(void*)) alAlign = sizeof(void*);
+
+	#ifdef _MSC_VER
+		void *pData = _aligned_malloc(alSize, alAlign);
+	#else
+		void *pData = NULL;
+		if(posix_memalign(&pData, alAlign, alSize) != 0) pData = NULL;
+	#endif
+		if(pData==NULL) return NULL;
+
+		TrackAllocation(pData, alSize, aTag);
+
+		return pData;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void* cMemoryTracker::AllocateAtSite(size_t alSize, const cMemoryAllocSite& aSite)
+	{
+		eMemoryTag tag = GetTagFromFile(aSite.mpFile);
+
+		int lRate = glSampleRate;
+		if(lRate > 0 && AtomicAdd(&glSampleCount, 1) % (size_t)lRate == 0)
+		{
+			AddSample(aSite, tag, alSize);
+		}
+
+		return Allocate(alSize, tag);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryTracker::Free(void *apData)
+	{
+		if(apData==NULL) return;
+
+		//Pointers that are not in the table (not counted) are still from malloc, as all of new goes through here
+		UntrackAllocation(apData);
+
+		free(apData);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryTracker::FreeAligned(void *apData)
+	{
+		if(apData==NULL) return;
+
+		UntrackAllocation(apData);
+
+	#ifdef _MSC_VER
+		_aligned_free(apData);
+	#else
+		free(apData);
+	#endif
+	}
+
+	//-----------------------------------------------------------------------
+
 
 }
+
+//////////////////////////////////////////////////////////////////////////
+// GLOBAL NEW AND DELETE
+//////////////////////////////////////////////////////////////////////////
+
+#ifdef MEMORY_TRACKING_ACTIVE
+
+//-----------------------------------------------------------------------
+
+static void* TrackedNew(size_t alSize, const hpl::cMemoryAllocSite* apSite)
+{
+	if(alSize==0) alSize = 1;
+
+	void *pData = apSite ?	hpl::cMemoryTracker::AllocateAtSite(alSize, *apSite) :
+							hpl::cMemoryTracker::Allocate(alSize, hpl::eMemoryTag_Other);
+	if(pData==NULL) throw std::bad_alloc();
+
+	return pData;
+}
+
+//-----------------------------------------------------------------------
+
+void* operator new(size_t alSize)												{ return TrackedNew(alSize, NULL); }
+void* operator new[](size_t alSize)												{ return TrackedNew(alSize, NULL); }
+void* operator new(size_t alSize, const std::nothrow_t&) throw()				{ return hpl::cMemoryTracker::Allocate(alSize ? alSize : 1, hpl::eMemoryTag_Other); }
+void* operator new[](size_t alSize, const std::nothrow_t&) throw()				{ return hpl::cMemoryTracker::Allocate(alSize ? alSize : 1, hpl::eMemoryTag_Other); }
+void* operator new(size_t alSize, const hpl::cMemoryAllocSite& aSite)			{ return TrackedNew(alSize, &aSite); }
+void* operator new[](size_t alSize, const hpl::cMemoryAllocSite& aSite)			{ return TrackedNew(alSize, &aSite); }
+
+void operator delete(void *apData) throw()										{ hpl::cMemoryTracker::Free(apData); }
+void operator delete[](void *apData) throw()									{ hpl::cMemoryTracker::Free(apData); }
+void operator delete(void *apData, const std::nothrow_t&) throw()				{ hpl::cMemoryTracker::Free(apData); }
+void operator delete[](void *apData, const std::nothrow_t&) throw()				{ hpl::cMemoryTracker::Free(apData); }
+void operator delete(void *apData, const hpl::cMemoryAllocSite& aSite)			{ hpl::cMemoryTracker::Free(apData); }
+void operator delete[](void *apData, const hpl::cMemoryAllocSite& aSite)		{ hpl::cMemoryTracker::Free(apData); }
+
+//-----------------------------------------------------------------------
+
+#ifdef __cpp_aligned_new
+
+static void* TrackedNewAligned(size_t alSize, std::align_val_t aAlign)
+{
+	void *pData = hpl::cMemoryTracker::AllocateAligned(alSize ? alSize : 1, (size_t)aAlign, hpl::eMemoryTag_Other);
+	if(pData==NULL) throw std::bad_alloc();
+
+	return pData;
+}
+
+void* operator new(size_t alSize, std::align_val_t aAlign)									{ return TrackedNewAligned(alSize, aAlign); }
+void* operator new[](size_t alSize, std::align_val_t aAlign)								{ return TrackedNewAligned(alSize, aAlign); }
+void* operator new(size_t alSize, std::align_val_t aAlign, const std::nothrow_t&) throw()	{ return hpl::cMemoryTracker::AllocateAligned(alSize ? alSize : 1, (size_t)aAlign, hpl::eMemoryTag_Other); }
+void* operator new[](size_t alSize, std::align_val_t aAlign, const std::nothrow_t&) throw()	{ return hpl::cMemoryTracker::AllocateAligned(alSize ? alSize : 1, (size_t)aAlign, hpl::eMemoryTag_Other); }
+
+void operator delete(void *apData, std::align_val_t aAlign) throw()								{ hpl::cMemoryTracker::FreeAligned(apData); }
+void operator delete[](void *apData, std::align_val_t aAlign) throw()							{ hpl::cMemoryTracker::FreeAligned(apData); }
+void operator delete(void *apData, std::align_val_t aAlign, const std::nothrow_t&) throw()		{ hpl::cMemoryTracker::FreeAligned(apData); }
+void operator delete[](void *apData, std::align_val_t aAlign, const std::nothrow_t&) throw()	{ hpl::cMemoryTracker::FreeAligned(apData); }
+
+#endif
+
+//-----------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "system/NameTable.h"
+
+#include "system/Mutex.h"
+#include "system/Platform.h"
+#include "system/MemoryManager.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// STATIC DATA
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	std::deque<tString> cNameTable::mvNames;
+	std::vector<unsigned int> cNameTable::mvHashes;
+	std::vector<tNameId> cNameTable::mvSlots;
+	iMutex *cNameTable::mpMutex = NULL;
+
+	//-----------------------------------------------------------------------
+
+	static inline char LowerChar(char alChar)
+	{
+		return (alChar >= 'A' && alChar <= 'Z') ? alChar + ('a' - 'A') : alChar;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	tNameId cNameTable::GetId(const tString& asName)
+	{
+		return GetId(asName.c_str(), asName.size());
+	}
+
+	tNameId cNameTable::GetId(const char* apName, size_t alLength)
+	{
+		if(alLength==0) return kNameId_None;
+
+		unsigned int lHash = GetHash(apName, alLength);
+
+		Lock();
+
+		size_t lSlot=0;
+		tNameId lId = FindIdNoLock(apName, alLength, lHash, &lSlot);
+		if(lId == kNameId_None)
+		{
+			//////////////////////////
+			//Add the name, first entry is reserved for kNameId_None.
+			if(mvNames.empty())
+			{
+				mvNames.push_back("");
+				mvHashes.push_back(0);
+			}
+
+			tString sLowName(apName, alLength);
+			for(size_t i=0; i<alLength; ++i) sLowName[i] = LowerChar(sLowName[i]);
+
+			lId = (tNameId)mvNames.size();
+			mvNames.push_back(sLowName);
+			mvHashes.push_back(lHash);
+
+			//Keep load at most half, growing rehashes so the slot found above is no longer valid.
+			if(mvNames.size()*2 > mvSlots.size())	Grow();
+			else									mvSlots[lSlot] = lId;
+		}
+
+		Unlock();
+
+		return lId;
+	}
+
+	//-----------------------------------------------------------------------
+
+	tNameId cNameTable::FindId(const tString& asName)
+	{
+		return FindId(asName.c_str(), asName.size());
+	}
+
+	tNameId cNameTable::FindId(const char* apName, size_t alLength)
+	{
+		if(alLength==0) return kNameId_None;
+
+		unsigned int lHash = GetHash(apName, alLength);
+
+		Lock();
+		tNameId lId = FindIdNoLock(apName, alLength, lHash, NULL);
+		Unlock();
+
+		return lId;
+	}
+
+	//-----------------------------------------------------------------------
+
+	const tString& cNameTable::GetName(tNameId alId)
+	{
+		static const tString sNull = "";
+		
+		Lock();
+		const tString& sName = alId < mvNames.size() ? mvNames[alId] : sNull;
+		Unlock();
+
+		return sName;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cNameTable::GetNameNum()
+	{
+		Lock();
+		int lNum = mvNames.empty() ? 0 : (int)mvNames.size()-1;
+		Unlock();
+
+		return lNum;
+	}
+
+	//-----------------------------------------------------------------------
+
+	unsigned int cNameTable::GetHash(const char* apName, size_t alLength)
+	{
+		//FNV-1a on the lower case characters.
+		unsigned int lHash = 2166136261U;
+		for(size_t i=0; i<alLength; ++i)
+		{
+			lHash ^= (unsigned char)LowerChar(apName[i]);
+			lHash *= 16777619U;
+		}
+		return lHash;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	tNameId cNameTable::FindIdNoLock(const char* apName, size_t alLength, unsigned int alHash, size_t *apSlot)
+	{
+		if(mvSlots.empty())
+		{
+			if(apSlot) *apSlot = 0;
+			return kNameId_None;
+		}
+
+		size_t lMask = mvSlots.size()-1;
+		size_t lSlot = alHash & lMask;
+		
+		//Linear probing until an empty slot is found.
+		for(;;)
+		{
+			tNameId lId = mvSlots[lSlot];
+			if(lId == kNameId_None) break;
+
+			const tString& sName = mvNames[lId];
+			if(mvHashes[lId] == alHash && sName.size() == alLength)
+			{
+				size_t i=0;
+				for(; i<alLength; ++i)
+				{
+					if(sName[i] != LowerChar(apName[i])) break;
+				}
+				if(i == alLength) return lId;
+			}
+
+			lSlot = (lSlot+1) & lMask;
+		}
+
+		if(apSlot) *apSlot = lSlot;
+		return kNameId_None;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cNameTable::Grow()
+	{
+		size_t lNewSize = mvSlots.empty() ? 1024 : mvSlots.size()*2;
+		mvSlots.assign(lNewSize, kNameId_None);
+
+		size_t lMask = lNewSize-1;
+		for(size_t lId=1; lId<mvNames.size(); ++lId)
+		{
+			size_t lSlot = mvHashes[lId] & lMask;
+			while(mvSlots[lSlot] != kNameId_None) lSlot = (lSlot+1) & lMask;
+
+			mvSlots[lSlot] = (tNameId)lId;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cNameTable::Lock()
+	{
+		//Created on first use, which is during engine start up on the main thread.
+		if(mpMutex==NULL) mpMutex = cPlatform::CreateMutEx();
+		mpMutex->Lock();
+	}
+
+	void cNameTable::Unlock()
+	{
+		mpMutex->Unlock();
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -153,6 +153,7 @@ namespace hpl {
 		mpCurrentVars = apVarContainer;
 
 		mParsingVars.Clear();
+		mvIncludedFiles.clear();
 
 		msCurrentDirectory = asDir;
 		msCurrentString = "";
@@ -741,6 +742,7 @@ namespace hpl {
 				cPlatform::CopyFileToBuffer(sPath,&sFileData[0],lFileSize);
 				
 				*mpCurrentOutput += sFileData;
+				mvIncludedFiles.push_back(sPath);
 			}
 			else
 			{
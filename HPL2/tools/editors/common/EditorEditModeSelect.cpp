@@ -199,6 +199,14 @@ bool cUIPickMethodRay::PickSpecific(iEntityWrapper* apEnt)
 	return apEnt->CheckRayIntersect(mpViewport, &mvTempPosition, &mTempTriangle);
 }
 
+bool cUIPickMethodRay::PicksBounds(const cVector3f& avMin, const cVector3f& avMax)
+{
+	const cVector3f& vStart = mpViewport->GetUnprojectedStart();
+
+	return cMath::CheckPointInAABBIntersection(vStart, avMin, avMax) ||
+			cMath::CheckAABBLineIntersection(avMin, avMax, vStart, mpViewport->GetUnprojectedEnd(), NULL, NULL);
+}
+
 bool cUIPickMethodBox::PickSpecific(iEntityWrapper* apEnt)
 {
 	if(apEnt->Check2DBoxIntersect(mpViewport, mRect, NULL))
@@ -209,6 +217,35 @@ bool cUIPickMethodBox::PickSpecific(iEntityWrapper* apEnt)
 	return false;
 }
 
+bool cUIPickMethodBox::PicksBounds(const cVector3f& avMin, const cVector3f& avMax)
+{
+	cFrustum* pFrustum = mpViewport->GetCamera()->GetFrustum();
+
+	////////////////////////////////////////////
+	// Boxes reaching past the near plane can get clip rects that do not hold the ones of their contents, so never skip those
+	if(pFrustum->GetProjectionType()==eProjectionType_Perspective)
+	{
+		const cMatrixf& mtxView = pFrustum->GetViewMatrix();
+		cVector3f vCentre = (avMin + avMax)*0.5f;
+		cVector3f vHalfSize = (avMax - avMin)*0.5f;
+
+		float fMaxViewZ =	mtxView.m[2][0]*vCentre.x + mtxView.m[2][1]*vCentre.y + mtxView.m[2][2]*vCentre.z + mtxView.m[2][3] +
+							fabs(mtxView.m[2][0])*vHalfSize.x + fabs(mtxView.m[2][1])*vHalfSize.y + fabs(mtxView.m[2][2])*vHalfSize.z;
+		if(fMaxViewZ > -pFrustum->GetNearPlane())
+			return true;
+	}
+
+	////////////////////////////////////////////
+	// Same test as the entities use on their pick boxes
+	cBoundingVolume bv;
+	bv.SetLocalMinMax(avMin, avMax);
+
+	cRect2l rect;
+	cMath::GetClipRectFromBV(rect, bv, pFrustum, mpViewport->GetGuiViewportSizeInt(), pFrustum->GetFOV()*0.5f);
+
+	return cMath::CheckRectIntersection(mRect, rect);
+}
+
 //----------------------------------------------------------------------
 //----------------------------------------------------------------------
 //----------------------------------------------------------------------
@@ -51,6 +51,9 @@ class cUIPickMethodRay : public cUIPickMethod
 {
 public:
 	bool PickSpecific(iEntityWrapper* apEnt);
+
+	bool UsesPickBounds() { return true; }
+	bool PicksBounds(const cVector3f& avMin, const cVector3f& avMax);
 };
 
 //------------------------------------------------------------
@@ -65,6 +68,9 @@ class cUIPickMethodBox : public cUIPickMethod
 public:
 	bool PickSpecific(iEntityWrapper* apEnt);
 
+	bool UsesPickBounds() { return true; }
+	bool PicksBounds(const cVector3f& avMin, const cVector3f& avMax);
+
 	void SetMouseBox(const cRect2l& aRect) { mRect = aRect; }
 
 protected:
@@ -323,12 +323,22 @@ bool cEditorHelper::CheckRayMeshEntityIntersect(const cVector3f& avRayStart, con
 
 bool cEditorHelper::CheckRaySubMeshEntityIntersect(const cVector3f& avRayStart, const cVector3f& avRayEnd, cSubMeshEntity* apObject, cVector3f* apIntersection, float *apT,unsigned int* apTriangleIdx, tVector3fVec* apTriangle)
 {
-	iVertexBuffer* pVB = apObject->GetSubMesh()->GetVertexBuffer();
+	cTriangleBVH* pTriangleBVH = apObject->GetSubMesh()->GetTriangleBVH();
+	if(pTriangleBVH==NULL)
+		return false;
+
 	cMatrixf mtxInvWorld = cMath::MatrixInverse(apObject->GetWorldMatrix());
 	int lTriIndex = -1;
+	float fT;
 
-	if(cMath::CheckLineTriVertexBufferIntersection(avRayStart, avRayEnd, mtxInvWorld, pVB, apIntersection, apT, &lTriIndex))
+	// Line is tested in mesh local space against the mesh triangle tree
+	if(pTriangleBVH->CheckLineIntersection(cMath::MatrixMul(mtxInvWorld, avRayStart), cMath::MatrixMul(mtxInvWorld, avRayEnd), &fT, &lTriIndex))
 	{
+		if(apIntersection)
+			*apIntersection = avRayStart + (avRayEnd - avRayStart)*fT;
+		if(apT)
+			*apT = fT;
+
 		if(apTriangleIdx)
 			*apTriangleIdx = lTriIndex;
 		if(apTriangle)
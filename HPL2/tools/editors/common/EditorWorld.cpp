@@ -164,6 +164,7 @@ bool iEditorWorld::AddObject(iEntityWrapper* apObject)
 		return false;
 
 	mmapEntities.insert(pair<unsigned int, iEntityWrapper*>(apObject->GetID(), apObject));
+	mpPicker->AddEntity(apObject);
 
 	// Call on add stuff.
 	apObject->OnAddToWorld();
@@ -181,7 +182,10 @@ bool iEditorWorld::AddObject(iEntityWrapper* apObject)
 void iEditorWorld::RemoveObject(iEntityWrapper* apObject)
 {
 	if(apObject)
+	{
 		mmapEntities.erase(apObject->GetID());
+		mpPicker->RemoveEntity(apObject);
+	}
 }
 
 //----------------------------------------------------------------------------
@@ -252,6 +256,8 @@ void iEditorWorld::ClearEntities()
 {
 	mbIsClearingEntities=true;
 
+	mpPicker->ClearEntities();
+
 	tEntityWrapperMap mapEntitiesCopy = mmapEntities;
 	tEntityWrapperMapIt it = mapEntitiesCopy.begin();
 	for(;it!=mapEntitiesCopy.end();++it)
@@ -60,6 +60,10 @@ public:
 
 	virtual cBoundingVolume* GetRenderBV();
 	virtual cBoundingVolume* GetPickBV(cEditorWindowViewport* apViewport)=0;
+	/**
+	 * True if GetPickBV is in world space and does not depend on the viewport, so it can be put in the pick tree.
+	 */
+	virtual bool HasWorldPickBV() { return false; }
 
 	void SetMatrix(const cMatrixf& amtxX);
 	const cMatrixf& GetWorldMatrix();
@@ -104,6 +108,7 @@ public:
 	bool CheckRayIntersect(cEditorWindowViewport* apViewport, cVector3f* apPos, tVector3fVec* apTriangle, float* apT=NULL);
 
 	cBoundingVolume* GetPickBV(cEditorWindowViewport* apViewport) { return mpEntity->GetBoundingVolume(); }
+	bool HasWorldPickBV() { return true; }
 
 	void Update();
 	void UpdateVisibility();
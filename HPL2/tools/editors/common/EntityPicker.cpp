@@ -19,6 +19,7 @@
 
 #include "EntityPicker.h"
 #include "EditorWorld.h"
+#include "EntityWrapper.h"
 
 #include <algorithm>
 
@@ -30,6 +31,267 @@ bool SortHitsByDistance(const cPickData& apHit1, const cPickData& apHit2)
 }
 
 //-----------------------------------------------------------------------------
+
+static inline float GetBoxSurfaceArea(const cVector3f& avMin, const cVector3f& avMax)
+{
+	cVector3f vSize = avMax - avMin;
+	return 2*(vSize.x*vSize.y + vSize.y*vSize.z + vSize.z*vSize.x);
+}
+
+static inline float GetUnionSurfaceArea(const cEntityPickTreeNode& aA, const cEntityPickTreeNode& aB)
+{
+	return GetBoxSurfaceArea(cMath::Vector3Min(aA.mvMin, aB.mvMin), cMath::Vector3Max(aA.mvMax, aB.mvMax));
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////
+// PICK TREE
+//////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+
+cEntityPickTree::cEntityPickTree()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+
+int cEntityPickTree::Insert(iEntityWrapper* apEntity, const cVector3f& avMin, const cVector3f& avMax)
+{
+	int lLeaf = CreateNode();
+	mvNodes[lLeaf].mpEntity = apEntity;
+	SetFatBounds(lLeaf, avMin, avMax);
+
+	InsertLeaf(lLeaf);
+	++mlLeafNum;
+
+	return lLeaf;
+}
+
+void cEntityPickTree::Remove(int alLeaf)
+{
+	RemoveLeaf(alLeaf);
+	DestroyNode(alLeaf);
+	--mlLeafNum;
+}
+
+void cEntityPickTree::Move(int alLeaf, const cVector3f& avMin, const cVector3f& avMax)
+{
+	/////////////////////////////////////////////
+	// Only reinsert if the new box is not inside the fat one
+	cEntityPickTreeNode& leaf = mvNodes[alLeaf];
+	if(	avMin.x >= leaf.mvMin.x && avMin.y >= leaf.mvMin.y && avMin.z >= leaf.mvMin.z &&
+		avMax.x <= leaf.mvMax.x && avMax.y <= leaf.mvMax.y && avMax.z <= leaf.mvMax.z)
+	{
+		return;
+	}
+
+	RemoveLeaf(alLeaf);
+	SetFatBounds(alLeaf, avMin, avMax);
+	InsertLeaf(alLeaf);
+}
+
+void cEntityPickTree::Clear()
+{
+	mvNodes.clear();
+	mvFreeNodes.clear();
+	mlRoot = -1;
+	mlLeafNum = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+void cEntityPickTree::GetEntities(iPickMethod* apMethod, std::vector<iEntityWrapper*>& avEntities)
+{
+	if(mlRoot==-1)
+		return;
+
+	mvStack.clear();
+	mvStack.push_back(mlRoot);
+	while(mvStack.empty()==false)
+	{
+		const cEntityPickTreeNode& node = mvNodes[mvStack.back()];
+		mvStack.pop_back();
+
+		if(apMethod->PicksBounds(node.mvMin, node.mvMax)==false)
+			continue;
+
+		if(node.mlChild1==-1)
+		{
+			avEntities.push_back(node.mpEntity);
+		}
+		else
+		{
+			mvStack.push_back(node.mlChild1);
+			mvStack.push_back(node.mlChild2);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+int cEntityPickTree::CreateNode()
+{
+	int lNode;
+	if(mvFreeNodes.empty())
+	{
+		lNode = (int)mvNodes.size();
+		mvNodes.push_back(cEntityPickTreeNode());
+	}
+	else
+	{
+		lNode = mvFreeNodes.back();
+		mvFreeNodes.pop_back();
+	}
+
+	cEntityPickTreeNode& node = mvNodes[lNode];
+	node.mlParent = -1;
+	node.mlChild1 = -1;
+	node.mlChild2 = -1;
+	node.mpEntity = NULL;
+
+	return lNode;
+}
+
+void cEntityPickTree::DestroyNode(int alNode)
+{
+	mvNodes[alNode].mpEntity = NULL;
+	mvFreeNodes.push_back(alNode);
+}
+
+//-----------------------------------------------------------------------------
+
+void cEntityPickTree::InsertLeaf(int alLeaf)
+{
+	if(mlRoot==-1)
+	{
+		mlRoot = alLeaf;
+		mvNodes[alLeaf].mlParent = -1;
+		return;
+	}
+
+	/////////////////////////////////////////////
+	// Walk down to the sibling that adds the least surface area to the tree
+	int lSibling = mlRoot;
+	while(mvNodes[lSibling].mlChild1 != -1)
+	{
+		const cEntityPickTreeNode& node = mvNodes[lSibling];
+		const cEntityPickTreeNode& leaf = mvNodes[alLeaf];
+
+		float fArea = GetBoxSurfaceArea(node.mvMin, node.mvMax);
+		float fCombinedArea = GetUnionSurfaceArea(node, leaf);
+
+		float fCost = 2*fCombinedArea;				//Cost of making a new parent for this node and the leaf
+		float fInheritCost = 2*(fCombinedArea - fArea);	//Cost of pushing the leaf further down
+
+		float vChildCost[2];
+		int vChild[2] = {node.mlChild1, node.mlChild2};
+		for(int i=0; i<2; ++i)
+		{
+			const cEntityPickTreeNode& child = mvNodes[vChild[i]];
+			vChildCost[i] = GetUnionSurfaceArea(child, leaf) + fInheritCost;
+			if(child.mlChild1 != -1) vChildCost[i] -= GetBoxSurfaceArea(child.mvMin, child.mvMax);
+		}
+
+		if(fCost < vChildCost[0] && fCost < vChildCost[1])
+			break;
+
+		lSibling = vChildCost[0] < vChildCost[1] ? vChild[0] : vChild[1];
+	}
+
+	/////////////////////////////////////////////
+	// Make a new parent for the sibling and leaf
+	int lOldParent = mvNodes[lSibling].mlParent;
+	int lNewParent = CreateNode();
+
+	cEntityPickTreeNode& parent = mvNodes[lNewParent];
+	parent.mlParent = lOldParent;
+	parent.mlChild1 = lSibling;
+	parent.mlChild2 = alLeaf;
+	parent.mvMin = cMath::Vector3Min(mvNodes[lSibling].mvMin, mvNodes[alLeaf].mvMin);
+	parent.mvMax = cMath::Vector3Max(mvNodes[lSibling].mvMax, mvNodes[alLeaf].mvMax);
+
+	mvNodes[lSibling].mlParent = lNewParent;
+	mvNodes[alLeaf].mlParent = lNewParent;
+
+	if(lOldParent==-1)
+	{
+		mlRoot = lNewParent;
+	}
+	else
+	{
+		if(mvNodes[lOldParent].mlChild1==lSibling)	mvNodes[lOldParent].mlChild1 = lNewParent;
+		else										mvNodes[lOldParent].mlChild2 = lNewParent;
+
+		RefitParents(lOldParent);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void cEntityPickTree::RemoveLeaf(int alLeaf)
+{
+	if(alLeaf==mlRoot)
+	{
+		mlRoot = -1;
+		return;
+	}
+
+	/////////////////////////////////////////////
+	// Replace the parent with the sibling
+	int lParent = mvNodes[alLeaf].mlParent;
+	int lGrandParent = mvNodes[lParent].mlParent;
+	int lSibling = mvNodes[lParent].mlChild1==alLeaf ? mvNodes[lParent].mlChild2 : mvNodes[lParent].mlChild1;
+
+	DestroyNode(lParent);
+	mvNodes[lSibling].mlParent = lGrandParent;
+	mvNodes[alLeaf].mlParent = -1;
+
+	if(lGrandParent==-1)
+	{
+		mlRoot = lSibling;
+	}
+	else
+	{
+		if(mvNodes[lGrandParent].mlChild1==lParent)	mvNodes[lGrandParent].mlChild1 = lSibling;
+		else										mvNodes[lGrandParent].mlChild2 = lSibling;
+
+		RefitParents(lGrandParent);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void cEntityPickTree::RefitParents(int alNode)
+{
+	for(int lNode = alNode; lNode != -1; lNode = mvNodes[lNode].mlParent)
+	{
+		cEntityPickTreeNode& node = mvNodes[lNode];
+		node.mvMin = cMath::Vector3Min(mvNodes[node.mlChild1].mvMin, mvNodes[node.mlChild2].mvMin);
+		node.mvMax = cMath::Vector3Max(mvNodes[node.mlChild1].mvMax, mvNodes[node.mlChild2].mvMax);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void cEntityPickTree::SetFatBounds(int alLeaf, const cVector3f& avMin, const cVector3f& avMax)
+{
+	cVector3f vMargin = (avMax - avMin)*0.1f + cVector3f(0.05f);
+
+	mvNodes[alLeaf].mvMin = avMin - vMargin;
+	mvNodes[alLeaf].mvMax = avMax + vMargin;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////
+// ENTITY PICKER
+//////////////////////////////////////////////////////////////////
+
 //-----------------------------------------------------------------------------
 
 cEntityPicker::cEntityPicker(iEditorWorld* apWorld)
@@ -131,25 +393,113 @@ void cEntityPicker::Update()
 
 //-----------------------------------------------------------------------------
 
+void cEntityPicker::AddEntity(iEntityWrapper* apEntity)
+{
+	if(m_mapEntityLeaves.find(apEntity)!=m_mapEntityLeaves.end())
+		return;
+
+	m_mapEntityLeaves.insert(std::pair<iEntityWrapper*, int>(apEntity, -1));
+	m_setUnboundedEntities.insert(apEntity);
+
+	UpdateEntity(apEntity);
+}
+
+//-----------------------------------------------------------------------------
+
+void cEntityPicker::RemoveEntity(iEntityWrapper* apEntity)
+{
+	std::map<iEntityWrapper*, int>::iterator it = m_mapEntityLeaves.find(apEntity);
+	if(it==m_mapEntityLeaves.end())
+		return;
+
+	if(it->second==-1)	m_setUnboundedEntities.erase(apEntity);
+	else				mTree.Remove(it->second);
+
+	m_mapEntityLeaves.erase(it);
+}
+
+//-----------------------------------------------------------------------------
+
+void cEntityPicker::UpdateEntity(iEntityWrapper* apEntity)
+{
+	std::map<iEntityWrapper*, int>::iterator it = m_mapEntityLeaves.find(apEntity);
+	if(it==m_mapEntityLeaves.end())
+		return;
+
+	int& lLeaf = it->second;
+
+	//////////////////////////////////////////
+	// Entities with a view dependent pick box are kept outside the tree
+	cVector3f vMin, vMax;
+	if(apEntity->GetPickAABB(vMin, vMax)==false)
+	{
+		if(lLeaf!=-1)
+		{
+			mTree.Remove(lLeaf);
+			lLeaf = -1;
+			m_setUnboundedEntities.insert(apEntity);
+		}
+		return;
+	}
+
+	if(lLeaf==-1)
+	{
+		lLeaf = mTree.Insert(apEntity, vMin, vMax);
+		m_setUnboundedEntities.erase(apEntity);
+	}
+	else
+	{
+		mTree.Move(lLeaf, vMin, vMax);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void cEntityPicker::ClearEntities()
+{
+	mTree.Clear();
+	m_mapEntityLeaves.clear();
+	m_setUnboundedEntities.clear();
+}
+
+//-----------------------------------------------------------------------------
+
 void cEntityPicker::Iterate()
 {
 	if(mpPickMethod==NULL)
 		return;
 
+	//////////////////////////////////////////
+	// Only try the entities in tree nodes the method can pick, and the ones outside the tree
+	if(mpPickMethod->UsesPickBounds())
+	{
+		mvCandidates.clear();
+		mTree.GetEntities(mpPickMethod, mvCandidates);
+		mvCandidates.insert(mvCandidates.end(), m_setUnboundedEntities.begin(), m_setUnboundedEntities.end());
+
+		for(size_t i=0;i<mvCandidates.size();++i)
+			PickEntity(mvCandidates[i]);
+
+		return;
+	}
+
 	tEntityWrapperMap& entities = mpWorld->GetEntities();
 	tEntityWrapperMap::const_iterator it = entities.begin();
 	for(;it!=entities.end();++it)
-	{
-		iEntityWrapper* pEnt = it->second;
-		if(mpPickFilter->Passes(pEnt)==false)
-			continue;
+		PickEntity(it->second);
+}
 
-        if(mpPickMethod->Picks(pEnt))
-			mvPicks.push_back(mpPickMethod->GetPickData());// adds pick
+//-----------------------------------------------------------------------------
 
-		mpPickMethod->PostPickCleanUp();
-	}
+void cEntityPicker::PickEntity(iEntityWrapper* apEntity)
+{
+	if(mpPickFilter->Passes(apEntity)==false)
+		return;
+
+    if(mpPickMethod->Picks(apEntity))
+		mvPicks.push_back(mpPickMethod->GetPickData());// adds pick
 
+	mpPickMethod->PostPickCleanUp();
 }
 
 //-----------------------------------------------------------------------------
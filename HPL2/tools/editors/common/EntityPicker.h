@@ -71,6 +71,66 @@ public:
 	virtual void PostPickCleanUp()=0;
 	
 	virtual cPickData GetPickData()=0;
+
+	/**
+	 * If true, the picker only tries entities in pick tree nodes where PicksBounds returns true.
+	 * PicksBounds must then return true for any world box that can contain an entity Picks returns true for.
+	 */
+	virtual bool UsesPickBounds() { return false; }
+	virtual bool PicksBounds(const cVector3f& avMin, const cVector3f& avMax) { return true; }
+};
+
+//---------------------------------------------------------------------------------
+
+class cEntityPickTreeNode
+{
+public:
+	cVector3f mvMin;
+	cVector3f mvMax;
+
+	int mlParent;
+	int mlChild1;	//-1 if leaf
+	int mlChild2;
+
+	iEntityWrapper* mpEntity;
+};
+
+//---------------------------------------------------------------------------------
+
+/**
+ * Dynamic AABB tree over the world pick boxes of entities. Leaves have a box somewhat larger than the entity
+ * so that small moves do not change the tree.
+ */
+class cEntityPickTree
+{
+public:
+	cEntityPickTree();
+
+	int Insert(iEntityWrapper* apEntity, const cVector3f& avMin, const cVector3f& avMax);
+	void Remove(int alLeaf);
+	void Move(int alLeaf, const cVector3f& avMin, const cVector3f& avMax);
+	void Clear();
+
+	void GetEntities(iPickMethod* apMethod, std::vector<iEntityWrapper*>& avEntities);
+
+	int GetLeafNum() { return mlLeafNum; }
+
+protected:
+	int CreateNode();
+	void DestroyNode(int alNode);
+
+	void InsertLeaf(int alLeaf);
+	void RemoveLeaf(int alLeaf);
+	void RefitParents(int alNode);
+
+	void SetFatBounds(int alLeaf, const cVector3f& avMin, const cVector3f& avMax);
+
+	std::vector<cEntityPickTreeNode> mvNodes;
+	tIntVec mvFreeNodes;
+	tIntVec mvStack;
+
+	int mlRoot;
+	int mlLeafNum;
 };
 
 //---------------------------------------------------------------------------------
@@ -92,16 +152,31 @@ public:
 	const tPickVec& GetPicks() { return mvPicks; }
 
 	void Update();
+
+	////////////////////////////////////////////
+	// Pick tree, kept up to date by the world and the entities
+	void AddEntity(iEntityWrapper* apEntity);
+	void RemoveEntity(iEntityWrapper* apEntity);
+	void UpdateEntity(iEntityWrapper* apEntity);
+	void ClearEntities();
+
 protected:
 	virtual void Iterate();
 	virtual void OnDraw(cRendererCallbackFunctions* apFunctions){}
 
+	void PickEntity(iEntityWrapper* apEntity);
+
 	iEditorWorld* mpWorld;
 
 	iPickFilter* mpPickFilter;
 	iPickMethod* mpPickMethod;
 
 	tPickVec mvPicks;
+
+	cEntityPickTree mTree;
+	std::map<iEntityWrapper*, int> m_mapEntityLeaves;	//-1 for entities without a fixed pick box, these are always tried.
+	std::set<iEntityWrapper*> m_setUnboundedEntities;
+	std::vector<iEntityWrapper*> mvCandidates;
 };
 
 //---------------------------------------------------------------------------------
@@ -38,6 +38,7 @@
 
 #include "EntityIcon.h"
 #include "EngineEntity.h"
+#include "EntityPicker.h"
 
 #include <algorithm>
 
@@ -1073,6 +1074,7 @@ iEntityWrapper::iEntityWrapper(iEntityWrapperData* apData)
 iEntityWrapper::~iEntityWrapper()
 {
 	GetEditorWorld()->DestroyEntityWrapperCallback(this);
+	GetEditorWorld()->GetPicker()->RemoveEntity(this);
 
 	if(mpIcon)
 		hplDelete(mpIcon);
@@ -1444,6 +1446,8 @@ void iEntityWrapper::UpdateEntity()
 		mpEngineEntity->SetMatrix(mmtxTransform);
 		mpEngineEntity->UpdateVisibility();
 	}
+
+	GetEditorWorld()->GetPicker()->UpdateEntity(this);
 }
 
 //------------------------------------------------------------------
@@ -1550,6 +1554,20 @@ cBoundingVolume* iEntityWrapper::GetPickBV(cEditorWindowViewport* apViewport)
 
 //------------------------------------------------------------------
 
+bool iEntityWrapper::GetPickAABB(cVector3f& avMin, cVector3f& avMax)
+{
+	if(mpIcon || mpEngineEntity==NULL || mpEngineEntity->HasWorldPickBV()==false)
+		return false;
+
+	cBoundingVolume* pBV = mpEngineEntity->GetPickBV(NULL);
+	avMin = pBV->GetMin();
+	avMax = pBV->GetMax();
+
+	return true;
+}
+
+//------------------------------------------------------------------
+
 bool iEntityWrapper::EntitySpecificFilterCheck(bool abPassAll, bool abPassType)
 {
 	return abPassAll || abPassType;
@@ -1735,10 +1753,12 @@ bool iEntityWrapper::CreateEngineEntity()
 			hplDelete(mpEngineEntity);		
 			mpEngineEntity = NULL;
 
+			GetEditorWorld()->GetPicker()->UpdateEntity(this);
 			return false;
 		}
 	}
 
+	GetEditorWorld()->GetPicker()->UpdateEntity(this);
 	return true;
 }
 
@@ -854,6 +854,10 @@ public:
 	// Picking helpers
 	virtual cMeshEntity* GetMeshEntity();
 	virtual cBoundingVolume* GetPickBV(cEditorWindowViewport* apViewport);
+	/**
+	 * Gets a world box that holds anything that can be picked on this entity, false if there is none that works for all viewports.
+	 */
+	virtual bool GetPickAABB(cVector3f& avMin, cVector3f& avMax);
 	virtual bool EntitySpecificFilterCheck(bool abPassAll, bool abPassType);
 
 	void SetSelected(bool abX);
@@ -1224,6 +1228,7 @@ public:
 
 	bool CheckRayIntersect(cEditorWindowViewport* apViewport, cVector3f* apPos, tVector3fVec* apTriangle, float* apT);
 	bool Check2DBoxIntersect(cEditorWindowViewport* apViewport, const cRect2l& aBox, cVector3f* apPos);
+	bool GetPickAABB(cVector3f& avMin, cVector3f& avMax) { return false; }
 
 	virtual void AddComponent(iEntityWrapper* apEntity);
 	virtual void RemoveComponent(iEntityWrapper* apEntity);
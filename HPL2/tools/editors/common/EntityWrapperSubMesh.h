@@ -48,6 +48,7 @@ public:
 				bool abIsSelected, bool abIsActive, const cColor& aHighlightCol);
 
 	cBoundingVolume* GetPickBV(cEditorWindowViewport* apViewport);
+	bool HasWorldPickBV() { return true; }
 	void UpdateVisibility(){}
 protected:
 };
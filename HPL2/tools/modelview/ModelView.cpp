@@ -2146,6 +2146,8 @@ public:
 				for(tSoundEntryListIt it = pEntryList->begin(); it != pEntryList->end();++it)
 				{
 					cSoundEntry *pEntry = *it;
+					if(pEntry->IsLoading()) continue; //No data until loaded
+
 					iSoundChannel *pSound = pEntry->GetChannel();
 					vSoundNames.push_back(pSound->GetData()->GetName());
 					vEntries.push_back(pEntry);
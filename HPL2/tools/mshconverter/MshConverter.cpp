@@ -23,6 +23,7 @@
 #include "impl/MeshLoaderCollada.h"
 #include "resources/WorldLoaderHplMap.h"
 
+#include <algorithm>
 
 using namespace hpl;
 
@@ -38,6 +39,39 @@ bool gbDirs_SubDirs = false;
 int glFileType = 0;		//0 = model, 1=anim, 2=map
 tWString gsFilePath = _W("");
 bool gbForce = false;
+bool gbOptimize = true;
+bool gbVerify = false;
+bool gbCompact = false;
+
+//Detail levels, each has glLodRatio of the triangles in the previous and is used below half the screen size.
+int glLodNum = 0;
+float gfLodRatio = 0.5f;
+float gfLodScreenSize = 0.3f;
+float gfLodMaxError = 0.02f;
+
+//Vertex cache stats for all converted sub meshes
+double gfTotalTriangles = 0;
+double gfTotalMissesBefore = 0;
+double gfTotalMissesAfter = 0;
+int glVerifyFailedNum = 0;
+
+int glFailedNum = 0; //Files that could not be loaded or converted
+
+//Compact vertex format stats
+double gfTotalVtxBytesBefore = 0;
+double gfTotalVtxBytesAfter = 0;
+float gfMaxNormalAngleError = 0;
+float gfMaxTangentError = 0;
+float gfMaxUVError = 0;
+int glCompactFailedNum = 0;
+
+//Largest allowed compact round trip errors, sub meshes above any of them are kept uncompressed
+float gfCompactMaxNormalAngle = 0.1f;	//degrees
+float gfCompactMaxTangentError = 0.001f;
+float gfCompactMaxUVError = 0.001f;
+
+//Lod stats
+double gfTotalLodTriangles = 0;
 
 //Was messy to get working, skipping:
 bool gbGenerateAIPaths=false;
@@ -151,6 +185,62 @@ void ParseCommandLine(const tString &asCommandLine)
 		{
 			gbForce = true;
 		}
+		//////////////////////////////
+		// Skip vertex cache optimization of meshes
+		else if(sArg == "-nooptimize")
+		{
+			gbOptimize = false;
+		}
+		//////////////////////////////
+		// Only check optimization on existing msh files, nothing is saved
+		else if(sArg == "-verify")
+		{
+			gbVerify = true;
+		}
+		//////////////////////////////
+		// Save normals, tangents and UVs in compact formats (lossy)
+		else if(sArg == "-compact")
+		{
+			gbCompact = true;
+		}
+		//////////////////////////////
+		// Largest allowed compact errors, normal angle in degrees
+		else if(sArg == "-maxnormalerror" && it+1 != args.end())
+		{
+			gfCompactMaxNormalAngle = cString::ToFloat((++it)->c_str(), 0.1f);
+		}
+		else if(sArg == "-maxtangenterror" && it+1 != args.end())
+		{
+			gfCompactMaxTangentError = cString::ToFloat((++it)->c_str(), 0.001f);
+		}
+		else if(sArg == "-maxuverror" && it+1 != args.end())
+		{
+			gfCompactMaxUVError = cString::ToFloat((++it)->c_str(), 0.001f);
+		}
+		//////////////////////////////
+		// Number of detail levels to create for each sub mesh
+		else if(sArg == "-lods" && it+1 != args.end())
+		{
+			glLodNum = cString::ToInt((++it)->c_str(), 0);
+		}
+		//////////////////////////////
+		// Part of the triangles kept in each level
+		else if(sArg == "-lodratio" && it+1 != args.end())
+		{
+			gfLodRatio = cString::ToFloat((++it)->c_str(), 0.5f);
+		}
+		//////////////////////////////
+		// Screen size (part of the screen height) where the first level is used
+		else if(sArg == "-lodsize" && it+1 != args.end())
+		{
+			gfLodScreenSize = cString::ToFloat((++it)->c_str(), 0.3f);
+		}
+		//////////////////////////////
+		// Largest allowed error, relative to the mesh size
+		else if(sArg == "-lodmaxerror" && it+1 != args.end())
+		{
+			gfLodMaxError = cString::ToFloat((++it)->c_str(), 0.02f);
+		}
 		/*else if(sArg == "-pathnodesetup")
 		{
 			gbGenerateAIPaths = true;
@@ -219,6 +309,252 @@ void GenerateAIPaths(cWorld *apWorld)
 
 //------------------------------------------
 
+typedef std::vector<tUIntVec> tTriangleVec;
+
+void GetSortedTriangles(const unsigned int *apIndices, int alIndexNum, tTriangleVec& avTriangles)
+{
+	avTriangles.resize(alIndexNum/3);
+	for(int i=0; i<alIndexNum/3; ++i)
+	{
+		tUIntVec& vTri = avTriangles[i];
+		vTri.assign(&apIndices[i*3], &apIndices[i*3+3]);
+
+		//Rotate so the lowest index is first, this keeps the winding
+		std::rotate(vTri.begin(), std::min_element(vTri.begin(), vTri.end()), vTri.end());
+	}
+	std::sort(avTriangles.begin(), avTriangles.end());
+}
+
+//------------------------------------------
+
+/**
+ * Optimizes the vertex cache order and checks that the triangles are unchanged.
+ * If abApply is true, the buffer and vertex-bone pairs are updated with the result.
+ */
+bool OptimizeSubMesh(cSubMesh *apSubMesh, bool abApply)
+{
+	iVertexBuffer *pVtxBuff = apSubMesh->GetVertexBuffer();
+	int lIdxNum = pVtxBuff->GetIndexNum();
+	int lVtxNum = pVtxBuff->GetVertexNum();
+	if(lIdxNum < 3) return true;
+
+	tUIntVec vIndices(pVtxBuff->GetIndices(), pVtxBuff->GetIndices() + lIdxNum);
+	float fACMRBefore = cMeshOptimizer::CalcACMR(&vIndices[0], lIdxNum, lVtxNum);
+
+	cMeshOptimizer::OptimizeVertexCache(&vIndices[0], lIdxNum, lVtxNum);
+	float fACMRAfter = cMeshOptimizer::CalcACMR(&vIndices[0], lIdxNum, lVtxNum);
+
+	////////////////////////
+	// Check that the triangle set is the same and that the remap is one to one.
+	tTriangleVec vTrisBefore, vTrisAfter;
+	GetSortedTriangles(pVtxBuff->GetIndices(), lIdxNum, vTrisBefore);
+	GetSortedTriangles(&vIndices[0], lIdxNum, vTrisAfter);
+	bool bOk = vTrisBefore == vTrisAfter;
+
+	tUIntVec vRemap;
+	cMeshOptimizer::CreateVertexFetchRemap(&vIndices[0], lIdxNum, lVtxNum, vRemap);
+	std::vector<bool> vUsed(lVtxNum, false);
+	for(int i=0; i<lVtxNum; ++i)
+	{
+		if(vRemap[i] >= (unsigned int)lVtxNum || vUsed[vRemap[i]]) bOk = false;
+		else vUsed[vRemap[i]] = true;
+	}
+
+	printf("\n  '%s': %d tris ACMR %.3f -> %.3f%s", apSubMesh->GetName().c_str(), lIdxNum/3, fACMRBefore, fACMRAfter, bOk ? "" : " TRIANGLES CHANGED!");
+
+	gfTotalTriangles += lIdxNum/3;
+	gfTotalMissesBefore += fACMRBefore * (lIdxNum/3);
+	gfTotalMissesAfter += fACMRAfter * (lIdxNum/3);
+	if(bOk==false)
+	{
+		glVerifyFailedNum++;
+		return false;
+	}
+
+	if(abApply)
+	{
+		memcpy(pVtxBuff->GetIndices(), &vIndices[0], lIdxNum*sizeof(unsigned int));
+		cMeshOptimizer::RemapVertexBuffer(pVtxBuff, vRemap);
+
+		for(int i=0; i<apSubMesh->GetVertexBonePairNum(); ++i)
+		{
+			cVertexBonePair& vtxBonePair = apSubMesh->GetVertexBonePair(i);
+			vtxBonePair.vtxIdx = vRemap[vtxBonePair.vtxIdx];
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------
+
+static int GetVertexByteSize(iVertexBuffer *apVtxBuff)
+{
+	int lSize = 0;
+	for(int i=0; i<eVertexBufferElement_LastEnum; ++i)
+	{
+		eVertexBufferElement element = (eVertexBufferElement)i;
+		if(apVtxBuff->GetElementNum(element) <= 0) continue;
+		lSize += apVtxBuff->GetElementNum(element) * GetVertexFormatByteSize(apVtxBuff->GetElementFormat(element));
+	}
+	return lSize;
+}
+
+/**
+ * Compacts a copy of the vertex buffer and prints the size saved and the largest round trip errors.
+ * If abApply is true and the errors are within the limits, the buffer is compacted as well.
+ */
+bool CompactSubMesh(cSubMesh *apSubMesh, bool abApply)
+{
+	iVertexBuffer *pVtxBuff = apSubMesh->GetVertexBuffer();
+	int lVtxNum = pVtxBuff->GetVertexNum();
+	if(lVtxNum <= 0) return true;
+
+	iVertexBuffer *pCompactBuff = pVtxBuff->CreateCopy(eVertexBufferType_Software, eVertexBufferUsageType_Static, eFlagBit_All);
+	cMeshOptimizer::CompactVertexFormat(pCompactBuff, true);
+
+	////////////////////////
+	// Compare all vertices with the source
+	float fNormalAngle = 0, fTangentError = 0, fUVError = 0;
+	for(int i=0; i<lVtxNum; ++i)
+	{
+		float vSrc[4], vDest[4];
+
+		if(pVtxBuff->GetElementNum(eVertexBufferElement_Normal) >= 3)
+		{
+			pVtxBuff->GetElementFloats(eVertexBufferElement_Normal, i, vSrc);
+			pCompactBuff->GetElementFloats(eVertexBufferElement_Normal, i, vDest);
+			cVector3f vSrcNrm = cMath::Vector3Normalize(cVector3f(vSrc[0],vSrc[1],vSrc[2]));
+			cVector3f vDestNrm = cMath::Vector3Normalize(cVector3f(vDest[0],vDest[1],vDest[2]));
+			float fDot = cMath::Clamp(cMath::Vector3Dot(vSrcNrm, vDestNrm), -1.0f, 1.0f);
+			fNormalAngle = cMath::Max(fNormalAngle, cMath::ToDeg(acosf(fDot)));
+		}
+		if(pVtxBuff->GetElementNum(eVertexBufferElement_Texture1Tangent) > 0)
+		{
+			pVtxBuff->GetElementFloats(eVertexBufferElement_Texture1Tangent, i, vSrc);
+			pCompactBuff->GetElementFloats(eVertexBufferElement_Texture1Tangent, i, vDest);
+			for(int j=0; j<pVtxBuff->GetElementNum(eVertexBufferElement_Texture1Tangent); ++j)
+				fTangentError = cMath::Max(fTangentError, cMath::Abs(vSrc[j]-vDest[j]));
+		}
+		if(pVtxBuff->GetElementNum(eVertexBufferElement_Texture0) > 0)
+		{
+			pVtxBuff->GetElementFloats(eVertexBufferElement_Texture0, i, vSrc);
+			pCompactBuff->GetElementFloats(eVertexBufferElement_Texture0, i, vDest);
+			for(int j=0; j<pVtxBuff->GetElementNum(eVertexBufferElement_Texture0); ++j)
+				fUVError = cMath::Max(fUVError, cMath::Abs(vSrc[j]-vDest[j]));
+		}
+	}
+
+	int lBytesBefore = GetVertexByteSize(pVtxBuff) * lVtxNum;
+	int lBytesAfter = GetVertexByteSize(pCompactBuff) * lVtxNum;
+	hplDelete(pCompactBuff);
+
+	bool bOk = fNormalAngle <= gfCompactMaxNormalAngle && fTangentError <= gfCompactMaxTangentError && fUVError <= gfCompactMaxUVError;
+
+	printf("\n  '%s': %d vtx %d -> %d bytes, max error normal %.3f deg tangent %.5f uv %.5f%s", apSubMesh->GetName().c_str(), lVtxNum,
+																						lBytesBefore, lBytesAfter, fNormalAngle, fTangentError, fUVError,
+																						bOk ? "" : " ERROR TOO LARGE!");
+	
+	gfTotalVtxBytesBefore += lBytesBefore;
+	gfTotalVtxBytesAfter += bOk ? lBytesAfter : lBytesBefore;
+	gfMaxNormalAngleError = cMath::Max(gfMaxNormalAngleError, fNormalAngle);
+	gfMaxTangentError = cMath::Max(gfMaxTangentError, fTangentError);
+	gfMaxUVError = cMath::Max(gfMaxUVError, fUVError);
+	if(bOk==false)
+	{
+		glCompactFailedNum++;
+		return false;
+	}
+
+	if(abApply) cMeshOptimizer::CompactVertexFormat(pVtxBuff, true);
+	return true;
+}
+
+//------------------------------------------
+
+/**
+ * Creates glLodNum detail levels with quadric simplification. Stops early when the error gets too large.
+ */
+void GenerateLods(cSubMesh *apSubMesh)
+{
+	apSubMesh->DestroyLods();
+
+	iVertexBuffer *pVtxBuff = apSubMesh->GetVertexBuffer();
+	int lIdxNum = pVtxBuff->GetIndexNum();
+	int lVtxNum = pVtxBuff->GetVertexNum();
+	if(lIdxNum < 3*8) return;
+
+	const float *pPositions = pVtxBuff->GetFloatArray(eVertexBufferElement_Position);
+	int lPosStride = pVtxBuff->GetElementNum(eVertexBufferElement_Position);
+
+	tUIntVec vSrcIndices(pVtxBuff->GetIndices(), pVtxBuff->GetIndices() + lIdxNum);
+	float fScreenSize = gfLodScreenSize;
+
+	printf("\n  '%s' lods: %d", apSubMesh->GetName().c_str(), lIdxNum/3);
+	for(int lod=0; lod<glLodNum; ++lod)
+	{
+		int lTargetIdxNum = ((int)(vSrcIndices.size() * gfLodRatio) / 3) * 3;
+
+		tUIntVec vIndices;
+		float fError = cMeshOptimizer::SimplifyMesh(&vSrcIndices[0], (int)vSrcIndices.size(), pPositions, lPosStride, lVtxNum,
+													lTargetIdxNum, gfLodMaxError, vIndices);
+		
+		//Not worth a level if it did not remove enough
+		if(vIndices.size() < 3 || vIndices.size() > vSrcIndices.size() * (gfLodRatio+1)*0.5f) break;
+
+		tUIntVec vVertexRemap, vLodIndices;
+		cMeshOptimizer::CreateLodIndices(&vIndices[0], (int)vIndices.size(), lVtxNum, vVertexRemap, vLodIndices);
+		iVertexBuffer *pLodVtxBuff = cMeshOptimizer::CreateLodVertexBuffer(	gpEngine->GetGraphics()->GetLowLevel(), pVtxBuff, vVertexRemap,
+																			&vLodIndices[0], (int)vLodIndices.size());
+		apSubMesh->AddLod(fScreenSize, pLodVtxBuff, vVertexRemap);
+
+		printf(" -> %d (err %.4f)", (int)vIndices.size()/3, fError);
+		gfTotalLodTriangles += vIndices.size()/3;
+
+		vSrcIndices = vIndices;
+		fScreenSize *= 0.5f;
+	}
+}
+
+//------------------------------------------
+
+bool VerifyFile(const tWString &asFile)
+{
+	printf(" Verifying '%s'....", cString::GetFileName(cString::To8Char(asFile)).c_str());
+
+	cMesh *pMesh = gpMeshLoaderMSH->LoadMesh(asFile,eMeshLoadFlag_NoMaterial);
+	if(pMesh==NULL)
+	{
+		printf(" failed!\n");
+		glFailedNum++;
+		return false;
+	}
+
+	bool bRet = true;
+	for(int i=0; i<pMesh->GetSubMeshNum(); ++i)
+	{
+		if(OptimizeSubMesh(pMesh->GetSubMesh(i), false)==false) bRet = false;
+		if(gbCompact && CompactSubMesh(pMesh->GetSubMesh(i), false)==false) bRet = false;
+
+		cSubMesh *pSubMesh = pMesh->GetSubMesh(i);
+		if(pSubMesh->GetLodNum() > 0)
+		{
+			printf("\n  '%s' lods: %d", pSubMesh->GetName().c_str(), pSubMesh->GetVertexBuffer()->GetIndexNum()/3);
+			for(int lod=0; lod<pSubMesh->GetLodNum(); ++lod)
+			{
+				cSubMeshLod *pLod = pSubMesh->GetLod(lod);
+				printf(" -> %d (below %.3f)", pLod->mpVtxBuffer->GetIndexNum()/3, pLod->mfMaxScreenSize);
+			}
+		}
+	}
+	hplDelete(pMesh);
+
+	printf("\n");
+	return bRet;
+}
+
+//------------------------------------------
+
 bool ConvertFile(const tWString &asFile)
 {
 	//Check so file exists
@@ -227,6 +563,8 @@ bool ConvertFile(const tWString &asFile)
 		Error("Could not find file %s\n", cString::To8Char(asFile).c_str());
 		return false;
 	}
+
+	if(gbVerify) return VerifyFile(asFile);
 	
 	//Check if cache file exists, is newer and correct version. 
 	//If so, skip it
@@ -294,14 +632,41 @@ bool ConvertFile(const tWString &asFile)
 	{
 		cMesh *pMesh = gpMeshLoaderCollada->LoadMesh(asFile,eMeshLoadFlag_NoMaterial);
 		if(pMesh)	{
+			if(gbOptimize)
+			{
+				for(int i=0; i<pMesh->GetSubMeshNum(); ++i)
+					OptimizeSubMesh(pMesh->GetSubMesh(i), true);
+				printf("\n");
+			}
+			if(gbCompact)
+			{
+				for(int i=0; i<pMesh->GetSubMeshNum(); ++i)
+					CompactSubMesh(pMesh->GetSubMesh(i), true);
+				printf("\n");
+			}
+			//Done last so the levels get the same vertex order and formats
+			if(glLodNum > 0)
+			{
+				for(int i=0; i<pMesh->GetSubMeshNum(); ++i)
+					GenerateLods(pMesh->GetSubMesh(i));
+				printf("\n");
+			}
+
 			gpMeshLoaderMSH->SaveMesh(pMesh, sMSHPath);
 			hplDelete(pMesh);
 		}
 		else		bFailed = true;
 	}
 
-	if(bFailed)	printf(" failed!\n");
-	else		printf(" done! (%lums)\n", cPlatform::GetApplicationTime()-lStartTime);
+	if(bFailed)
+	{
+		printf(" failed!\n");
+		glFailedNum++;
+	}
+	else
+	{
+		printf(" done! (%lums)\n", cPlatform::GetApplicationTime()-lStartTime);
+	}
 
 	return !bFailed;
 }
@@ -474,7 +839,29 @@ void Exit()
 	if(gbDirs)	ConvertInDirs();
 	else		ConvertFile();
 
+	if(gfTotalTriangles > 0)
+	{
+		printf("\nTotal: %.0f tris ACMR %.3f -> %.3f, %d sub meshes failed verification\n",	gfTotalTriangles, 
+																						gfTotalMissesBefore / gfTotalTriangles,
+																						gfTotalMissesAfter / gfTotalTriangles,
+																						glVerifyFailedNum);
+	}
+	if(gfTotalLodTriangles > 0)
+	{
+		printf("Lods: %.0f triangles in all levels\n", gfTotalLodTriangles);
+	}
+	if(gfTotalVtxBytesBefore > 0)
+	{
+		printf("Compact vertices: %.0f -> %.0f bytes, max error normal %.3f deg tangent %.5f uv %.5f, %d sub meshes above the limits\n",
+																									gfTotalVtxBytesBefore, gfTotalVtxBytesAfter,
+																									gfMaxNormalAngleError, gfMaxTangentError, gfMaxUVError,
+																									glCompactFailedNum);
+	}
+
 	printf("\n-------- MSH CONVERSION DONE! -----------\n");		
+
+	//Non zero if anything failed, so scripts can check -verify runs
+	int lExitCode = (glFailedNum > 0 || glVerifyFailedNum > 0 || glCompactFailedNum > 0) ? 1 : 0;
 	
 	Exit();
 	DestroyHPLEngine(gpEngine);
@@ -483,7 +870,7 @@ void Exit()
 	if(hBlackBoxLib) FreeLibrary(hBlackBoxLib);
 #endif
 	
-	return 0;
+	return lExitCode;
 }
 
 #ifdef WIN32
@@ -0,0 +1,832 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TexCompressor.h"
+
+#include <cmath>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////////
+// IMAGE
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+void cTexImage::Create(int alWidth, int alHeight)
+{
+	mlWidth = alWidth;
+	mlHeight = alHeight;
+	mvData.assign(alWidth*alHeight*4, 0);
+}
+
+//-----------------------------------------------------------------------
+
+bool cTexImage::HasAlpha() const
+{
+	for(size_t i=3; i<mvData.size(); i+=4)
+	{
+		if(mvData[i] != 255) return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// HELPERS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+static void ExpandColor565(unsigned short alColor, int *apRGB)
+{
+	int lR = (alColor>>11) & 31;
+	int lG = (alColor>>5) & 63;
+	int lB = alColor & 31;
+
+	apRGB[0] = (lR<<3) | (lR>>2);
+	apRGB[1] = (lG<<2) | (lG>>4);
+	apRGB[2] = (lB<<3) | (lB>>2);
+}
+
+static unsigned short PackColor565(const float *apRGB)
+{
+	int lR = cMath::RoundToInt(cMath::Clamp(apRGB[0], 0.0f, 255.0f) * (31.0f/255.0f));
+	int lG = cMath::RoundToInt(cMath::Clamp(apRGB[1], 0.0f, 255.0f) * (63.0f/255.0f));
+	int lB = cMath::RoundToInt(cMath::Clamp(apRGB[2], 0.0f, 255.0f) * (31.0f/255.0f));
+
+	return (unsigned short)((lR<<11) | (lG<<5) | lB);
+}
+
+//-----------------------------------------------------------------------
+
+/**
+ * Builds the 4 entry palette. abFourColors is false for the 3 color + transparent mode.
+ */
+static void BuildColorPalette(unsigned short alColor0, unsigned short alColor1, bool abFourColors, int avPalette[4][3])
+{
+	ExpandColor565(alColor0, avPalette[0]);
+	ExpandColor565(alColor1, avPalette[1]);
+
+	for(int c=0; c<3; ++c)
+	{
+		if(abFourColors)
+		{
+			avPalette[2][c] = (2*avPalette[0][c] + avPalette[1][c]) / 3;
+			avPalette[3][c] = (avPalette[0][c] + 2*avPalette[1][c]) / 3;
+		}
+		else
+		{
+			avPalette[2][c] = (avPalette[0][c] + avPalette[1][c]) / 2;
+			avPalette[3][c] = 0;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------
+
+static int ColorDistSqr(const int *apA, const unsigned char *apB)
+{
+	int lR = apA[0] - apB[0];
+	int lG = apA[1] - apB[1];
+	int lB = apA[2] - apB[2];
+	return lR*lR + lG*lG + lB*lB;
+}
+
+//-----------------------------------------------------------------------
+
+/**
+ * Finds indices for the block pixels and returns the total squared error.
+ */
+static int FindColorIndices(const unsigned char *apPixels, const bool *apTransparent, int avPalette[4][3], 
+							bool abFourColors, int *apIndices)
+{
+	int lPaletteNum = abFourColors ? 4 : 3;
+	int lTotalError =0;
+	for(int i=0; i<16; ++i)
+	{
+		if(apTransparent[i])
+		{
+			apIndices[i] = 3;
+			continue;
+		}
+
+		const unsigned char *pPixel = &apPixels[i*4];
+		int lBest = 0;
+		int lBestDist = ColorDistSqr(avPalette[0], pPixel);
+		for(int j=1; j<lPaletteNum; ++j)
+		{
+			int lDist = ColorDistSqr(avPalette[j], pPixel);
+			if(lDist < lBestDist)
+			{
+				lBestDist = lDist;
+				lBest = j;
+			}
+		}
+		apIndices[i] = lBest;
+		lTotalError += lBestDist;
+	}
+	return lTotalError;
+}
+
+//-----------------------------------------------------------------------
+
+/**
+ * Least squares fit of the end points given the current indices.
+ */
+static bool RefineEndPoints(const unsigned char *apPixels, const bool *apTransparent, const int *apIndices, bool abFourColors,
+							float *apEnd0, float *apEnd1)
+{
+	static const float vWeights4[4] = {1.0f, 0.0f, 2.0f/3.0f, 1.0f/3.0f};
+	static const float vWeights3[4] = {1.0f, 0.0f, 0.5f, 0.0f};
+	const float *pWeights = abFourColors ? vWeights4 : vWeights3;
+
+	float fAA=0, fAB=0, fBB=0;
+	float vAX[3] = {0,0,0};
+	float vBX[3] = {0,0,0};
+	for(int i=0; i<16; ++i)
+	{
+		if(apTransparent[i]) continue;
+
+		float fA = pWeights[apIndices[i]];
+		float fB = 1.0f - fA;
+		fAA += fA*fA;
+		fAB += fA*fB;
+		fBB += fB*fB;
+		for(int c=0; c<3; ++c)
+		{
+			vAX[c] += fA * (float)apPixels[i*4+c];
+			vBX[c] += fB * (float)apPixels[i*4+c];
+		}
+	}
+
+	float fDet = fAA*fBB - fAB*fAB;
+	if(std::fabs(fDet) < 0.0001f) return false;
+
+	float fInvDet = 1.0f / fDet;
+	for(int c=0; c<3; ++c)
+	{
+		apEnd0[c] = (vAX[c]*fBB - vBX[c]*fAB) * fInvDet;
+		apEnd1[c] = (vBX[c]*fAA - vAX[c]*fAB) * fInvDet;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------
+
+static void WriteColorBlock(unsigned short alColor0, unsigned short alColor1, const int *apIndices, unsigned char *apDest)
+{
+	apDest[0] = alColor0 & 0xff;
+	apDest[1] = alColor0 >> 8;
+	apDest[2] = alColor1 & 0xff;
+	apDest[3] = alColor1 >> 8;
+
+	unsigned int lBits =0;
+	for(int i=0; i<16; ++i) lBits |= ((unsigned int)apIndices[i]) << (i*2);
+	
+	for(int i=0; i<4; ++i) apDest[4+i] = (lBits >> (i*8)) & 0xff;
+}
+
+//-----------------------------------------------------------------------
+
+/**
+ * Compresses the color part of a block. abPunchThrough means DXT1 with 1 bit alpha.
+ */
+static void CompressColorBlock(const unsigned char *apPixels, bool abPunchThrough, unsigned char *apDest)
+{
+	bool vTransparent[16];
+	int lOpaqueNum =0;
+	for(int i=0; i<16; ++i)
+	{
+		vTransparent[i] = abPunchThrough && apPixels[i*4+3] < 128;
+		if(vTransparent[i]==false) lOpaqueNum++;
+	}
+	bool bFourColors = lOpaqueNum == 16 || abPunchThrough==false;
+
+	int vIndices[16];
+	if(lOpaqueNum==0)
+	{
+		for(int i=0; i<16; ++i) vIndices[i] = 3;
+		WriteColorBlock(0,0,vIndices,apDest);
+		return;
+	}
+
+	////////////////////////////
+	// Principal axis of the colors
+	float vMean[3] = {0,0,0};
+	for(int i=0; i<16; ++i)
+	{
+		if(vTransparent[i]) continue;
+		for(int c=0; c<3; ++c) vMean[c] += apPixels[i*4+c];
+	}
+	for(int c=0; c<3; ++c) vMean[c] /= (float)lOpaqueNum;
+
+	float vCov[6] = {0,0,0,0,0,0};
+	for(int i=0; i<16; ++i)
+	{
+		if(vTransparent[i]) continue;
+		float fR = apPixels[i*4+0] - vMean[0];
+		float fG = apPixels[i*4+1] - vMean[1];
+		float fB = apPixels[i*4+2] - vMean[2];
+		vCov[0] += fR*fR; vCov[1] += fR*fG; vCov[2] += fR*fB;
+		vCov[3] += fG*fG; vCov[4] += fG*fB; vCov[5] += fB*fB;
+	}
+
+	float vAxis[3] = {1,1,1};
+	for(int lIt=0; lIt<8; ++lIt)
+	{
+		float fX = vCov[0]*vAxis[0] + vCov[1]*vAxis[1] + vCov[2]*vAxis[2];
+		float fY = vCov[1]*vAxis[0] + vCov[3]*vAxis[1] + vCov[4]*vAxis[2];
+		float fZ = vCov[2]*vAxis[0] + vCov[4]*vAxis[1] + vCov[5]*vAxis[2];
+		float fMax = cMath::Max(std::fabs(fX), cMath::Max(std::fabs(fY), std::fabs(fZ)));
+		if(fMax < 0.0001f) break;
+		vAxis[0] = fX/fMax; vAxis[1] = fY/fMax; vAxis[2] = fZ/fMax;
+	}
+	float fAxisLenSqr = vAxis[0]*vAxis[0] + vAxis[1]*vAxis[1] + vAxis[2]*vAxis[2];
+
+	float fMinT = 0, fMaxT = 0;
+	for(int i=0; i<16; ++i)
+	{
+		if(vTransparent[i]) continue;
+		float fT = 0;
+		for(int c=0; c<3; ++c) fT += (apPixels[i*4+c] - vMean[c]) * vAxis[c];
+		fT /= fAxisLenSqr;
+		if(fT < fMinT) fMinT = fT;
+		if(fT > fMaxT) fMaxT = fT;
+	}
+
+	float vEnd0[3], vEnd1[3];
+	for(int c=0; c<3; ++c)
+	{
+		vEnd0[c] = vMean[c] + vAxis[c]*fMaxT;
+		vEnd1[c] = vMean[c] + vAxis[c]*fMinT;
+	}
+
+	////////////////////////////
+	// Fit, refine and keep the best
+	unsigned short lBestColor0=0, lBestColor1=0;
+	int vBestIndices[16];
+	int lBestError = -1;
+	int vPalette[4][3];
+
+	for(int lIt=0; lIt<3; ++lIt)
+	{
+		unsigned short lColor0 = PackColor565(vEnd0);
+		unsigned short lColor1 = PackColor565(vEnd1);
+
+		BuildColorPalette(lColor0, lColor1, bFourColors, vPalette);
+		int lError = FindColorIndices(apPixels, vTransparent, vPalette, bFourColors, vIndices);
+
+		if(lBestError < 0 || lError < lBestError)
+		{
+			lBestError = lError;
+			lBestColor0 = lColor0;
+			lBestColor1 = lColor1;
+			memcpy(vBestIndices, vIndices, sizeof(vIndices));
+		}
+
+		if(lError==0 || RefineEndPoints(apPixels, vTransparent, vIndices, bFourColors, vEnd0, vEnd1)==false) break;
+	}
+
+	////////////////////////////
+	// Fix end point order, color0 > color1 means four colors.
+	bool bSwap = bFourColors ? lBestColor0 < lBestColor1 : lBestColor0 > lBestColor1;
+	if(bSwap)
+	{
+		unsigned short lTemp = lBestColor0;
+		lBestColor0 = lBestColor1;
+		lBestColor1 = lTemp;
+
+		for(int i=0; i<16; ++i)
+		{
+			if(vBestIndices[i]==0)		vBestIndices[i]=1;
+			else if(vBestIndices[i]==1) vBestIndices[i]=0;
+			else if(bFourColors)		vBestIndices[i] = vBestIndices[i]==2 ? 3 : 2;
+		}
+	}
+	else if(bFourColors && lBestColor0 == lBestColor1)
+	{
+		for(int i=0; i<16; ++i) vBestIndices[i] = 0;
+	}
+
+	WriteColorBlock(lBestColor0, lBestColor1, vBestIndices, apDest);
+}
+
+//-----------------------------------------------------------------------
+
+static void CompressAlphaBlockDXT3(const unsigned char *apPixels, unsigned char *apDest)
+{
+	for(int i=0; i<8; ++i)
+	{
+		int lA0 = (apPixels[(i*2)*4+3]*15 + 127) / 255;
+		int lA1 = (apPixels[(i*2+1)*4+3]*15 + 127) / 255;
+		apDest[i] = (unsigned char)(lA0 | (lA1<<4));
+	}
+}
+
+//-----------------------------------------------------------------------
+
+static void BuildAlphaPalette(int alAlpha0, int alAlpha1, int *apPalette)
+{
+	apPalette[0] = alAlpha0;
+	apPalette[1] = alAlpha1;
+	if(alAlpha0 > alAlpha1)
+	{
+		for(int i=1; i<7; ++i) apPalette[i+1] = ((7-i)*alAlpha0 + i*alAlpha1) / 7;
+	}
+	else
+	{
+		for(int i=1; i<5; ++i) apPalette[i+1] = ((5-i)*alAlpha0 + i*alAlpha1) / 5;
+		apPalette[6] = 0;
+		apPalette[7] = 255;
+	}
+}
+
+static void CompressAlphaBlockDXT5(const unsigned char *apPixels, unsigned char *apDest)
+{
+	int lMin = 255, lMax = 0;
+	for(int i=0; i<16; ++i)
+	{
+		int lA = apPixels[i*4+3];
+		if(lA < lMin) lMin = lA;
+		if(lA > lMax) lMax = lA;
+	}
+
+	int vPalette[8];
+	BuildAlphaPalette(lMax, lMin, vPalette);
+
+	unsigned long long lBits =0;
+	for(int i=0; i<16; ++i)
+	{
+		int lA = apPixels[i*4+3];
+		int lBest =0;
+		int lBestDist = cMath::Abs(vPalette[0] - lA);
+		for(int j=1; j<8 && lMax!=lMin; ++j)
+		{
+			int lDist = cMath::Abs(vPalette[j] - lA);
+			if(lDist < lBestDist)
+			{
+				lBestDist = lDist;
+				lBest = j;
+			}
+		}
+		lBits |= ((unsigned long long)lBest) << (i*3);
+	}
+
+	apDest[0] = (unsigned char)lMax;
+	apDest[1] = (unsigned char)lMin;
+	for(int i=0; i<6; ++i) apDest[2+i] = (unsigned char)((lBits >> (i*8)) & 0xff);
+}
+
+//-----------------------------------------------------------------------
+
+static int GetBlockSize(ePixelFormat aFormat)
+{
+	return aFormat == ePixelFormat_DXT1 ? 8 : 16;
+}
+
+//-----------------------------------------------------------------------
+
+static void DecompressBlock(const unsigned char *apBlock, ePixelFormat aFormat, unsigned char *apPixels)
+{
+	const unsigned char *pColor = aFormat == ePixelFormat_DXT1 ? apBlock : apBlock+8;
+
+	////////////////////////////
+	// Color
+	unsigned short lColor0 = pColor[0] | (pColor[1]<<8);
+	unsigned short lColor1 = pColor[2] | (pColor[3]<<8);
+	bool bFourColors = aFormat != ePixelFormat_DXT1 || lColor0 > lColor1;
+	
+	int vPalette[4][3];
+	BuildColorPalette(lColor0, lColor1, bFourColors, vPalette);
+
+	unsigned int lBits = pColor[4] | (pColor[5]<<8) | (pColor[6]<<16) | ((unsigned int)pColor[7]<<24);
+	for(int i=0; i<16; ++i)
+	{
+		int lIdx = (lBits >> (i*2)) & 3;
+		for(int c=0; c<3; ++c) apPixels[i*4+c] = (unsigned char)vPalette[lIdx][c];
+		apPixels[i*4+3] = (bFourColors==false && lIdx==3) ? 0 : 255;
+	}
+
+	////////////////////////////
+	// Alpha
+	if(aFormat == ePixelFormat_DXT2 || aFormat == ePixelFormat_DXT3)
+	{
+		for(int i=0; i<16; ++i)
+		{
+			int lA = (apBlock[i/2] >> ((i&1)*4)) & 0xf;
+			apPixels[i*4+3] = (unsigned char)(lA*17);
+		}
+	}
+	else if(aFormat == ePixelFormat_DXT4 || aFormat == ePixelFormat_DXT5)
+	{
+		int vAlphaPalette[8];
+		BuildAlphaPalette(apBlock[0], apBlock[1], vAlphaPalette);
+
+		unsigned long long lAlphaBits =0;
+		for(int i=0; i<6; ++i) lAlphaBits |= ((unsigned long long)apBlock[2+i]) << (i*8);
+
+		for(int i=0; i<16; ++i)
+		{
+			apPixels[i*4+3] = (unsigned char)vAlphaPalette[(lAlphaBits >> (i*3)) & 7];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// JOBS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+class cTexCompressJob : public iJob
+{
+public:
+	cTexCompressJob(const cTexImage* apImage, ePixelFormat aFormat, int alStartRow, int alEndRow, unsigned char *apDest)
+		: mpImage(apImage), mFormat(aFormat), mlStartRow(alStartRow), mlEndRow(alEndRow), mpDest(apDest) {}
+
+	void Run()
+	{
+		cTexCompressor::CompressBlockRows(*mpImage, mFormat, mlStartRow, mlEndRow, mpDest);
+	}
+
+private:
+	const cTexImage* mpImage;
+	ePixelFormat mFormat;
+	int mlStartRow;
+	int mlEndRow;
+	unsigned char *mpDest;
+};
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+bool cTexCompressor::BitmapToImage(cBitmap *apBitmap, cTexImage& aImage)
+{
+	ePixelFormat format = apBitmap->GetPixelFormat();
+	cBitmapData *pData = apBitmap->GetData(0,0);
+	int lW = apBitmap->GetWidth();
+	int lH = apBitmap->GetHeight();
+
+	if(PixelFormatIsCompressed(format))
+	{
+		Decompress(pData->mpData, lW, lH, format, aImage);
+		return true;
+	}
+
+	int lBpp = GetBytesPerPixel(format);
+	if(PixelFormatIsFloatingPoint(format) || lBpp != apBitmap->GetBytesPerPixel() || lBpp > 4) return false;
+
+	aImage.Create(lW, lH);
+	for(int i=0; i<lW*lH; ++i)
+	{
+		const unsigned char *pSrc = &pData->mpData[i*lBpp];
+		unsigned char *pDest = &aImage.mvData[i*4];
+		switch(format)
+		{
+		case ePixelFormat_RGB:		pDest[0]=pSrc[0]; pDest[1]=pSrc[1]; pDest[2]=pSrc[2]; pDest[3]=255; break;
+		case ePixelFormat_RGBA:		pDest[0]=pSrc[0]; pDest[1]=pSrc[1]; pDest[2]=pSrc[2]; pDest[3]=pSrc[3]; break;
+		case ePixelFormat_BGR:		pDest[0]=pSrc[2]; pDest[1]=pSrc[1]; pDest[2]=pSrc[0]; pDest[3]=255; break;
+		case ePixelFormat_BGRA:		pDest[0]=pSrc[2]; pDest[1]=pSrc[1]; pDest[2]=pSrc[0]; pDest[3]=pSrc[3]; break;
+		case ePixelFormat_Luminance:		pDest[0]=pDest[1]=pDest[2]=pSrc[0]; pDest[3]=255; break;
+		case ePixelFormat_LuminanceAlpha:	pDest[0]=pDest[1]=pDest[2]=pSrc[0]; pDest[3]=pSrc[1]; break;
+		case ePixelFormat_Alpha:			pDest[0]=pDest[1]=pDest[2]=255; pDest[3]=pSrc[0]; break;
+		default: return false;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------
+
+static float Sinc(float afX)
+{
+	if(std::fabs(afX) < 0.0001f) return 1.0f;
+	float fX = afX * kPif;
+	return std::sin(fX) / fX;
+}
+
+static float BesselI0(float afX)
+{
+	float fSum = 1.0f;
+	float fTerm = 1.0f;
+	for(int i=1; i<20; ++i)
+	{
+		float fT = afX / (2.0f*(float)i);
+		fTerm *= fT*fT;
+		fSum += fTerm;
+		if(fTerm < fSum * 1e-7f) break;
+	}
+	return fSum;
+}
+
+static float FilterWeight(eTexMipFilter aFilter, float afX)
+{
+	if(aFilter == eTexMipFilter_Box)
+	{
+		return std::fabs(afX) <= 0.5f ? 1.0f : 0.0f;
+	}
+
+	//Kaiser windowed sinc, width 3 and alpha 4
+	const float fWidth = 3.0f;
+	const float fAlpha = 4.0f;
+	float fT = afX / fWidth;
+	if(std::fabs(fT) >= 1.0f) return 0;
+
+	return Sinc(afX) * BesselI0(fAlpha * std::sqrt(1.0f - fT*fT)) / BesselI0(fAlpha);
+}
+
+//-----------------------------------------------------------------------
+
+/**
+ * Resamples one dimension, alStride and alLineStride are in floats.
+ */
+static void ResampleLines(	const std::vector<float>& avSrc, int alSrcSize, std::vector<float>& avDest, int alDestSize,
+							int alLineNum, int alSrcStride, int alSrcLineStride, int alDestStride, int alDestLineStride,
+							eTexMipFilter aFilter)
+{
+	float fScale = (float)alSrcSize / (float)alDestSize;
+	float fSupport = (aFilter == eTexMipFilter_Box ? 0.5f : 3.0f) * fScale;
+
+	std::vector<float> vWeights;
+	for(int i=0; i<alDestSize; ++i)
+	{
+		float fCenter = ((float)i + 0.5f) * fScale;
+		int lStart = (int)std::floor(fCenter - fSupport);
+		int lEnd = (int)std::ceil(fCenter + fSupport);
+
+		vWeights.resize(lEnd - lStart + 1);
+		float fWeightSum = 0;
+		for(int j=lStart; j<=lEnd; ++j)
+		{
+			float fW = FilterWeight(aFilter, ((float)j + 0.5f - fCenter) / fScale);
+			vWeights[j-lStart] = fW;
+			fWeightSum += fW;
+		}
+		if(fWeightSum == 0) continue;
+		float fInvSum = 1.0f / fWeightSum;
+
+		for(int lLine=0; lLine<alLineNum; ++lLine)
+		{
+			float vSum[4] = {0,0,0,0};
+			for(int j=lStart; j<=lEnd; ++j)
+			{
+				float fW = vWeights[j-lStart];
+				if(fW == 0) continue;
+
+				int lSrc = cMath::Clamp(j, 0, alSrcSize-1);
+				const float *pSrc = &avSrc[lLine*alSrcLineStride + lSrc*alSrcStride];
+				for(int c=0; c<4; ++c) vSum[c] += pSrc[c] * fW;
+			}
+
+			float *pDest = &avDest[lLine*alDestLineStride + i*alDestStride];
+			for(int c=0; c<4; ++c) pDest[c] = vSum[c] * fInvSum;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cTexCompressor::GenerateMipMaps(const cTexImage& aImage, eTexMipFilter aFilter, tTexImageVec& avMipMaps)
+{
+	avMipMaps.clear();
+
+	//Each level is made from the previous one
+	const cTexImage *pSrcImage = &aImage;
+	while(pSrcImage->mlWidth > 1 || pSrcImage->mlHeight > 1)
+	{
+		int lSrcW = pSrcImage->mlWidth;
+		int lSrcH = pSrcImage->mlHeight;
+		int lDestW = cMath::Max(lSrcW >> 1, 1);
+		int lDestH = cMath::Max(lSrcH >> 1, 1);
+
+		std::vector<float> vSrc(pSrcImage->mvData.size());
+		for(size_t i=0; i<vSrc.size(); ++i) vSrc[i] = (float)pSrcImage->mvData[i];
+
+		//Horizontal then vertical
+		std::vector<float> vTemp(lDestW*lSrcH*4);
+		ResampleLines(vSrc, lSrcW, vTemp, lDestW, lSrcH, 4, lSrcW*4, 4, lDestW*4, aFilter);
+
+		std::vector<float> vDest(lDestW*lDestH*4);
+		ResampleLines(vTemp, lSrcH, vDest, lDestH, lDestW, lDestW*4, 4, lDestW*4, 4, aFilter);
+
+		avMipMaps.push_back(cTexImage());
+		cTexImage& mipMap = avMipMaps.back();
+		mipMap.Create(lDestW, lDestH);
+		for(size_t i=0; i<vDest.size(); ++i)
+		{
+			mipMap.mvData[i] = (unsigned char)cMath::Clamp(cMath::RoundToInt(vDest[i]), 0, 255);
+		}
+
+		pSrcImage = &avMipMaps.back();
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cTexCompressor::CompressBlockRows(const cTexImage& aImage, ePixelFormat aFormat, int alStartRow, int alEndRow, unsigned char *apDest)
+{
+	int lBlocksW = (aImage.mlWidth+3)/4;
+	int lBlockSize = GetBlockSize(aFormat);
+	unsigned char vPixels[16*4];
+
+	unsigned char *pDest = apDest + alStartRow*lBlocksW*lBlockSize;
+	for(int lBY=alStartRow; lBY<alEndRow; ++lBY)
+	for(int lBX=0; lBX<lBlocksW; ++lBX)
+	{
+		//Get pixels, clamp at edges for sizes not divisible by 4
+		for(int y=0; y<4; ++y)
+		for(int x=0; x<4; ++x)
+		{
+			int lX = cMath::Min(lBX*4+x, aImage.mlWidth-1);
+			int lY = cMath::Min(lBY*4+y, aImage.mlHeight-1);
+			memcpy(&vPixels[(y*4+x)*4], aImage.GetPixel(lX, lY), 4);
+		}
+
+		if(aFormat == ePixelFormat_DXT1)
+		{
+			CompressColorBlock(vPixels, true, pDest);
+		}
+		else if(aFormat == ePixelFormat_DXT3)
+		{
+			CompressAlphaBlockDXT3(vPixels, pDest);
+			CompressColorBlock(vPixels, false, pDest+8);
+		}
+		else
+		{
+			CompressAlphaBlockDXT5(vPixels, pDest);
+			CompressColorBlock(vPixels, false, pDest+8);
+		}
+
+		pDest += lBlockSize;
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cTexCompressor::Compress(const cTexImage& aImage, ePixelFormat aFormat, std::vector<unsigned char>& avDest, cJobPool *apJobPool)
+{
+	avDest.resize(GetCompressedSize(aImage.mlWidth, aImage.mlHeight, aFormat));
+
+	int lBlocksH = (aImage.mlHeight+3)/4;
+	
+	//Small images are not worth splitting up
+	const int lRowsPerJob = 16;
+	if(apJobPool==NULL || apJobPool->GetThreadNum()==0 || lBlocksH <= lRowsPerJob)
+	{
+		CompressBlockRows(aImage, aFormat, 0, lBlocksH, &avDest[0]);
+		return;
+	}
+
+	cJobBatch batch;
+	for(int lRow=0; lRow<lBlocksH; lRow += lRowsPerJob)
+	{
+		int lEndRow = cMath::Min(lRow + lRowsPerJob, lBlocksH);
+		apJobPool->AddJob(hplNew(cTexCompressJob, (&aImage, aFormat, lRow, lEndRow, &avDest[0]) ), &batch);
+	}
+	apJobPool->WaitForBatch(&batch);
+}
+
+//-----------------------------------------------------------------------
+
+void cTexCompressor::Decompress(const unsigned char *apData, int alWidth, int alHeight, ePixelFormat aFormat, cTexImage& aDestImage)
+{
+	aDestImage.Create(alWidth, alHeight);
+
+	int lBlocksW = (alWidth+3)/4;
+	int lBlocksH = (alHeight+3)/4;
+	int lBlockSize = GetBlockSize(aFormat);
+	unsigned char vPixels[16*4];
+
+	for(int lBY=0; lBY<lBlocksH; ++lBY)
+	for(int lBX=0; lBX<lBlocksW; ++lBX)
+	{
+		DecompressBlock(&apData[(lBY*lBlocksW + lBX)*lBlockSize], aFormat, vPixels);
+
+		for(int y=0; y<4; ++y)
+		for(int x=0; x<4; ++x)
+		{
+			int lX = lBX*4+x;
+			int lY = lBY*4+y;
+			if(lX >= alWidth || lY >= alHeight) continue;
+
+			memcpy(aDestImage.GetPixel(lX, lY), &vPixels[(y*4+x)*4], 4);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------
+
+int cTexCompressor::GetCompressedSize(int alWidth, int alHeight, ePixelFormat aFormat)
+{
+	return cMath::Max(1, (alWidth+3)/4) * cMath::Max(1, (alHeight+3)/4) * GetBlockSize(aFormat);
+}
+
+bool cTexCompressor::FormatIsSupported(ePixelFormat aFormat)
+{
+	return aFormat == ePixelFormat_DXT1 || aFormat == ePixelFormat_DXT3 || aFormat == ePixelFormat_DXT5;
+}
+
+//-----------------------------------------------------------------------
+
+static void WriteUInt32(FILE *apFile, unsigned int alX)
+{
+	unsigned char vBytes[4] = {	(unsigned char)(alX & 0xff), (unsigned char)((alX>>8) & 0xff),
+								(unsigned char)((alX>>16) & 0xff), (unsigned char)((alX>>24) & 0xff)};
+	fwrite(vBytes, 1, 4, apFile);
+}
+
+bool cTexCompressor::SaveDDS(const tWString& asFile, int alWidth, int alHeight, ePixelFormat aFormat, const std::vector< std::vector<unsigned char> >& avLevels)
+{
+	const unsigned int kDDSD_Caps = 0x1, kDDSD_Height = 0x2, kDDSD_Width = 0x4, kDDSD_PixelFormat = 0x1000;
+	const unsigned int kDDSD_MipMapCount = 0x20000, kDDSD_LinearSize = 0x80000;
+	const unsigned int kDDPF_FourCC = 0x4;
+	const unsigned int kDDSCaps_Complex = 0x8, kDDSCaps_Texture = 0x1000, kDDSCaps_MipMap = 0x400000;
+
+	FILE *pFile = cPlatform::OpenFile(asFile, _W("wb"));
+	if(pFile==NULL) return false;
+
+	bool bMipMaps = avLevels.size() > 1;
+	unsigned int lFourCC = aFormat == ePixelFormat_DXT1 ? 0x31545844 : (aFormat == ePixelFormat_DXT3 ? 0x33545844 : 0x35545844);
+
+	fwrite("DDS ", 1, 4, pFile);
+
+	//Header
+	WriteUInt32(pFile, 124);
+	WriteUInt32(pFile, kDDSD_Caps | kDDSD_Height | kDDSD_Width | kDDSD_PixelFormat | kDDSD_LinearSize | (bMipMaps ? kDDSD_MipMapCount : 0));
+	WriteUInt32(pFile, alHeight);
+	WriteUInt32(pFile, alWidth);
+	WriteUInt32(pFile, (unsigned int)avLevels[0].size());
+	WriteUInt32(pFile, 0);
+	WriteUInt32(pFile, (unsigned int)avLevels.size());
+	for(int i=0; i<11; ++i) WriteUInt32(pFile, 0);
+
+	//Pixel format
+	WriteUInt32(pFile, 32);
+	WriteUInt32(pFile, kDDPF_FourCC);
+	WriteUInt32(pFile, lFourCC);
+	for(int i=0; i<5; ++i) WriteUInt32(pFile, 0);
+
+	//Caps
+	WriteUInt32(pFile, kDDSCaps_Texture | (bMipMaps ? (kDDSCaps_Complex | kDDSCaps_MipMap) : 0));
+	for(int i=0; i<4; ++i) WriteUInt32(pFile, 0);
+
+	//Data
+	for(size_t i=0; i<avLevels.size(); ++i)
+	{
+		fwrite(&avLevels[i][0], 1, avLevels[i].size(), pFile);
+	}
+
+	bool bRet = ferror(pFile)==0;
+	fclose(pFile);
+
+	return bRet;
+}
+
+//-----------------------------------------------------------------------
+
+float cTexCompressor::CalcPSNR(const cTexImage& aImageA, const cTexImage& aImageB, bool abUseAlpha)
+{
+	double fErrorSum = 0;
+	int lCount = 0;
+	int lChannels = abUseAlpha ? 4 : 3;
+
+	for(size_t i=0; i<aImageA.mvData.size(); i+=4)
+	for(int c=0; c<lChannels; ++c)
+	{
+		double fDiff = (double)aImageA.mvData[i+c] - (double)aImageB.mvData[i+c];
+		fErrorSum += fDiff*fDiff;
+		lCount++;
+	}
+
+	if(lCount==0 || fErrorSum==0) return 99.0f;
+
+	double fMSE = fErrorSum / (double)lCount;
+	return (float)(10.0 * log10(255.0*255.0 / fMSE));
+}
+
+//-----------------------------------------------------------------------
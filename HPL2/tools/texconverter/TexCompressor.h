@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2011-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: A Machine For Pigs.
+ * 
+ * Amnesia: A Machine For Pigs is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: A Machine For Pigs is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: A Machine For Pigs.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEX_COMPRESSOR_H
+#define TEX_COMPRESSOR_H
+
+#include "hpl.h"
+
+using namespace hpl;
+
+//------------------------------------------
+
+enum eTexMipFilter
+{
+	eTexMipFilter_Box,
+	eTexMipFilter_Kaiser,
+
+	eTexMipFilter_LastEnum
+};
+
+//------------------------------------------
+
+/**
+ * Uncompressed 8 bit per channel RGBA image that all the compression work is done on.
+ */
+class cTexImage
+{
+public:
+	cTexImage() : mlWidth(0), mlHeight(0) {}
+
+	void Create(int alWidth, int alHeight);
+
+	inline unsigned char* GetPixel(int alX, int alY){ return &mvData[(alY*mlWidth + alX)*4];}
+	inline const unsigned char* GetPixel(int alX, int alY) const { return &mvData[(alY*mlWidth + alX)*4];}
+
+	bool HasAlpha() const;
+
+	int mlWidth;
+	int mlHeight;
+	std::vector<unsigned char> mvData;
+};
+
+typedef std::vector<cTexImage> tTexImageVec;
+
+//------------------------------------------
+
+class cTexCompressor
+{
+public:
+	/**
+	 * Converts the first image and mipmap of a bitmap into RGBA, decompressing it if needed.
+	 */
+	static bool BitmapToImage(cBitmap *apBitmap, cTexImage& aImage);
+
+	/**
+	 * Creates the full mip chain (not including the top level) down to 1x1.
+	 */
+	static void GenerateMipMaps(const cTexImage& aImage, eTexMipFilter aFilter, tTexImageVec& avMipMaps);
+
+	/**
+	 * Compresses an image to DXT1, DXT3 or DXT5. If a job pool is given, large images are split up into
+	 * jobs for block rows.
+	 */
+	static void Compress(const cTexImage& aImage, ePixelFormat aFormat, std::vector<unsigned char>& avDest, cJobPool *apJobPool);
+	static void Decompress(const unsigned char *apData, int alWidth, int alHeight, ePixelFormat aFormat, cTexImage& aDestImage);
+
+	static int GetCompressedSize(int alWidth, int alHeight, ePixelFormat aFormat);
+	static bool FormatIsSupported(ePixelFormat aFormat);
+
+	/**
+	 * Saves compressed data as a dds file. avLevels holds the top level followed by mipmaps.
+	 */
+	static bool SaveDDS(const tWString& asFile, int alWidth, int alHeight, ePixelFormat aFormat, const std::vector< std::vector<unsigned char> >& avLevels);
+
+	/**
+	 * Peak signal to noise ratio in dB between two equally sized images. Alpha is skipped if abUseAlpha is false.
+	 */
+	static float CalcPSNR(const cTexImage& aImageA, const cTexImage& aImageB, bool abUseAlpha);
+
+	static void CompressBlockRows(const cTexImage& aImage, ePixelFormat aFormat, int alStartRow, int alEndRow, unsigned char *apDest);
+};
+
+//------------------------------------------
+
+#endif // TEX_COMPRESSOR_H
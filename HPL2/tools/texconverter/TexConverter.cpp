@@ -18,10 +18,13 @@
  */
 
 #include "hpl.h"
+#include "TexCompressor.h"
 
 using namespace hpl;
 
+#ifdef WIN32
 extern bool RunProgram(const tWString& sPath, const tWString &sArg);
+#endif
 
 
 cEngine *gpEngine=NULL;
@@ -30,7 +33,31 @@ cEngine *gpEngine=NULL;
 
 bool gbDirs = false;
 bool gbDirs_SubDirs = false;
+bool gbUseTexConv = false;
+int glThreadNum = -1;
+eTexMipFilter gMipFilter = eTexMipFilter_Kaiser;
+ePixelFormat gForcedFormat = ePixelFormat_Unknown;
+float gfMinPSNR = 25.0f; //Below this the compression is considered broken, 0 turns the check off
 tWString gsFilePath = _W("");
+tWString gsOutDir = _W("");
+
+cJobPool *gpJobPool = NULL;
+iMutex *gpMutex = NULL; //Bitmap loading and output are not thread safe
+
+int glConvertedNum = 0;
+int glFailedNum = 0;
+
+//------------------------------------------
+
+ePixelFormat ToPixelFormat(const tString& asFormat)
+{
+	tString sLow = cString::ToLowerCase(asFormat);
+	if(sLow == "dxt1") return ePixelFormat_DXT1;
+	if(sLow == "dxt3") return ePixelFormat_DXT3;
+	if(sLow == "dxt5") return ePixelFormat_DXT5;
+	
+	return ePixelFormat_Unknown;
+}
 
 //------------------------------------------
 
@@ -42,17 +69,54 @@ void ParseCommandLine(int argc, const char* argv[])
 
 		//////////////////////////////
 		// Type of conversion wanted
-		if(i==1 && sArg == "-dir")
+		if(sArg == "-dir")
 		{
 			gbDirs = true;
 		}
 		//////////////////////////////
 		// If sub directories shall be included
-		else if(i==2 && gbDirs==true && sArg == "-subdirs")
+		else if(sArg == "-subdirs")
 		{
 			gbDirs_SubDirs = true;
 		}
 		//////////////////////////////
+		// Mip map filter, box or kaiser
+		else if(sArg == "-mipfilter" && i+1<argc)
+		{
+			tString sFilter = cString::ToLowerCase(argv[++i]);
+			gMipFilter = sFilter == "box" ? eTexMipFilter_Box : eTexMipFilter_Kaiser;
+		}
+		//////////////////////////////
+		// Number of worker threads
+		else if(sArg == "-threads" && i+1<argc)
+		{
+			glThreadNum = cString::ToInt(argv[++i], -1);
+		}
+		//////////////////////////////
+		// Output format, otherwise same as input or picked from alpha
+		else if(sArg == "-format" && i+1<argc)
+		{
+			gForcedFormat = ToPixelFormat(argv[++i]);
+		}
+		//////////////////////////////
+		// Lowest PSNR (dB) of the top level that is accepted, worse files fail and are not saved
+		else if(sArg == "-minpsnr" && i+1<argc)
+		{
+			gfMinPSNR = cString::ToFloat(argv[++i], gfMinPSNR);
+		}
+		//////////////////////////////
+		// Folder to save converted files in, sub folders of the input are kept
+		else if(sArg == "-out" && i+1<argc)
+		{
+			gsOutDir = cString::To16Char(argv[++i]);
+		}
+		//////////////////////////////
+		// Use the external texconv tool
+		else if(sArg == "-texconv")
+		{
+			gbUseTexConv = true;
+		}
+		//////////////////////////////
 		// The file path
 		else
 		{
@@ -87,50 +151,33 @@ int GetMipMapNum(int alW, int alH)
 	}
 	return lNum;
 }
- 
 
-bool ConvertFile(const tWString &asFile)
+//------------------------------------------
+
+void PrintLocked(const char* fmt, ...)
 {
-	//Check so file exists
-	if(cPlatform::FileExists(asFile)==false)
-	{
-		Error("Could not find file %s\n", cString::To8Char(asFile).c_str());
-		return false;
-	}
+	char sText[2048];
+	va_list ap;
+	va_start(ap, fmt);
+	vsnprintf(sText, 2048, fmt, ap);
+	va_end(ap);
+	sText[2047] = 0;
+
+	gpMutex->Lock();
+	printf("%s", sText);
+	gpMutex->Unlock();
+}
 
-	printf(" Converting '%s'....\n", cString::GetFileName(cString::To8Char(asFile)).c_str());
-	unsigned long lStartTime = cPlatform::GetApplicationTime();
+//------------------------------------------
 
-	//Check so file is proper
-	cBitmap* pBitMap = gpEngine->GetResources()->GetBitmapLoaderHandler()->LoadBitmap(asFile, 0);
-	if(	pBitMap==NULL)
-	{
-		printf(" Could not load bitmap!\n");
-		return false;
-	}
-	if(pBitMap->GetNumOfImages()>1)
-	{
-		printf(" Too many images (cubemap)!\n");
-		return false;	
-	}
-	if(pBitMap->GetNumOfMipMaps() > 1)
-	{
-		printf(" Already have mipmaps!!\n");
-		return false;
-	}
-	ePixelFormat pixelFormat = pBitMap->GetPixelFormat();
-	if(PixelFormatIsCompressed(pixelFormat)==false)
-	{
-		printf(" Not compressed!!\n");
-		return false;
-	}
-	
-	
+#ifdef WIN32
+bool ConvertFileTexConv(const tWString &asFile, ePixelFormat aPixelFormat)
+{
 	///////////////////////////////
 	//Get Argument
 	tWString sArg;
 
-	sArg += _W(" -f ")+ToFormat(pixelFormat);
+	sArg += _W(" -f ")+ToFormat(aPixelFormat);
 	sArg += _W(" -mf TRIANGLE");
 	//sArg += _W(" -m ")+ cString::ToStringW(GetMipMapNum(pBitMap->GetWidth(), pBitMap->GetHeight())); //<- skip so tool chooses!
 	//sArg += _W(" -sx _test_"); //Only when testing!
@@ -149,27 +196,210 @@ bool ConvertFile(const tWString &asFile)
 	}
 	printf(" - - - - - -\n");
 
-	/////////////////////////
-	//Wait for converter to be done.
-	//TODO:
+	return true;
+}
+#endif
+
+//------------------------------------------
+
+/**
+ * The input folder structure is kept below gsOutDir. Without an out folder the file is saved next to the input.
+ */
+tWString GetOutputFile(const tWString &asFile)
+{
+	tWString sFile = cString::SetFileExtW(asFile, _W("dds"));
+	if(gsOutDir == _W("")) return sFile;
+
+	//Part of the path below the input folder
+	tWString sRoot = cString::GetFilePathW(gsFilePath);
+	tWString sRelFile = cString::GetFileNameW(sFile);
+	if(sRoot != _W("") && sFile.size() > sRoot.size() && sFile.compare(0, sRoot.size(), sRoot)==0)
+	{
+		sRelFile = sFile.substr(sRoot.size());
+		while(sRelFile.empty()==false && (sRelFile[0]==_W('/') || sRelFile[0]==_W('\\'))) sRelFile = sRelFile.substr(1);
+	}
+
+	//Create the folders
+	tWString sOutFile = cString::AddSlashAtEndW(gsOutDir);
+	gpMutex->Lock();
+	if(cPlatform::FolderExists(sOutFile)==false) cPlatform::CreateFolder(sOutFile);
+	for(size_t i=0; i<sRelFile.size(); ++i)
+	{
+		if(sRelFile[i]==_W('/') || sRelFile[i]==_W('\\'))
+		{
+			tWString sFolder = sOutFile + sRelFile.substr(0, i);
+			if(cPlatform::FolderExists(sFolder)==false) cPlatform::CreateFolder(sFolder);
+		}
+	}
+	gpMutex->Unlock();
+
+	return sOutFile + sRelFile;
+}
+
+//------------------------------------------
+
+bool ConvertFileNative(const tWString &asFile, cBitmap* apBitmap)
+{
+	ePixelFormat inputFormat = apBitmap->GetPixelFormat();
+	int lW = apBitmap->GetWidth();
+	int lH = apBitmap->GetHeight();
+
+	///////////////////////////////
+	//Decode input to RGBA
+	cTexImage image;
+	if(cTexCompressor::BitmapToImage(apBitmap, image)==false)
+	{
+		PrintLocked(" '%s': Unsupported pixel format!\n", cString::To8Char(cString::GetFileNameW(asFile)).c_str());
+		return false;
+	}
+
+	///////////////////////////////
+	//Pick output format
+	ePixelFormat outputFormat = gForcedFormat;
+	if(outputFormat == ePixelFormat_Unknown)
+	{
+		if(inputFormat == ePixelFormat_DXT2)		outputFormat = ePixelFormat_DXT3;
+		else if(inputFormat == ePixelFormat_DXT4)	outputFormat = ePixelFormat_DXT5;
+		else if(cTexCompressor::FormatIsSupported(inputFormat)) outputFormat = inputFormat;
+		else outputFormat = image.HasAlpha() ? ePixelFormat_DXT5 : ePixelFormat_DXT1;
+	}
+
+	///////////////////////////////
+	//Mipmaps and compression
+	tTexImageVec vMipMaps;
+	cTexCompressor::GenerateMipMaps(image, gMipFilter, vMipMaps);
+
+	std::vector< std::vector<unsigned char> > vLevels(vMipMaps.size()+1);
+	cTexCompressor::Compress(image, outputFormat, vLevels[0], gpJobPool);
+	for(size_t i=0; i<vMipMaps.size(); ++i)
+	{
+		cTexCompressor::Compress(vMipMaps[i], outputFormat, vLevels[i+1], gpJobPool);
+	}
+
+	///////////////////////////////
+	//Quality of the top level
+	cTexImage decoded;
+	cTexCompressor::Decompress(&vLevels[0][0], lW, lH, outputFormat, decoded);
+	float fPSNR = cTexCompressor::CalcPSNR(image, decoded, outputFormat != ePixelFormat_DXT1);
+	if(fPSNR < gfMinPSNR)
+	{
+		PrintLocked(" '%s': PSNR %.2fdB is below %.2fdB, not saved!\n", cString::To8Char(cString::GetFileNameW(asFile)).c_str(),
+																		fPSNR, gfMinPSNR);
+		return false;
+	}
+
+	///////////////////////////////
+	//Save
+	tWString sOutFile = GetOutputFile(asFile);
+	if(cTexCompressor::SaveDDS(sOutFile, lW, lH, outputFormat, vLevels)==false)
+	{
+		PrintLocked(" '%s': Could not save file!\n", cString::To8Char(sOutFile).c_str());
+		return false;
+	}
 
-	printf(" done! (%dms)\n", cPlatform::GetApplicationTime()-lStartTime);
+	PrintLocked(" '%s': %s %dx%d, %d mipmaps, PSNR %.2fdB\n",	cString::To8Char(cString::GetFileNameW(sOutFile)).c_str(),
+															cString::To8Char(ToFormat(outputFormat)).c_str(), lW, lH,
+															(int)vLevels.size(), fPSNR);
 	return true;
 }
 
 //------------------------------------------
 
-void ConvertFilesInDir(const tWString &asDir, const tWString &asMask)
+bool ConvertFile(const tWString &asFile)
+{
+	//Check so file exists
+	if(cPlatform::FileExists(asFile)==false)
+	{
+		PrintLocked("Could not find file %s\n", cString::To8Char(asFile).c_str());
+		return false;
+	}
+
+	tString sFileName = cString::To8Char(cString::GetFileNameW(asFile));
+	PrintLocked(" Converting '%s'....\n", sFileName.c_str());
+	unsigned long lStartTime = cPlatform::GetApplicationTime();
+
+	//Check so file is proper
+	gpMutex->Lock();
+	cBitmap* pBitMap = gpEngine->GetResources()->GetBitmapLoaderHandler()->LoadBitmap(asFile, 0);
+	gpMutex->Unlock();
+	
+	if(	pBitMap==NULL)
+	{
+		PrintLocked(" '%s': Could not load bitmap!\n", sFileName.c_str());
+		return false;
+	}
+	
+	tString sError = "";
+	if(gbUseTexConv==false && gsOutDir==_W("") && cString::ToLowerCaseW(cString::GetFileExtW(asFile))==_W("dds"))
+		sError = "Would overwrite input, use -out to set an output folder!";
+	else if(pBitMap->GetNumOfImages()>1)			sError = "Too many images (cubemap)!";
+	else if(pBitMap->GetDepth()>1)			sError = "Volume textures not supported!";
+	else if(pBitMap->GetNumOfMipMaps() > 1)	sError = "Already have mipmaps!!";
+	
+	bool bRet = false;
+	if(sError != "")
+	{
+		PrintLocked(" '%s': %s\n", sFileName.c_str(), sError.c_str());
+	}
+	else if(gbUseTexConv)
+	{
+		#ifdef WIN32
+			if(PixelFormatIsCompressed(pBitMap->GetPixelFormat()))
+				bRet = ConvertFileTexConv(asFile, pBitMap->GetPixelFormat());
+			else
+				printf(" Not compressed!!\n");
+		#else
+			printf(" texconv is only supported on windows!\n");
+		#endif
+	}
+	else
+	{
+		bRet = ConvertFileNative(asFile, pBitMap);
+	}
+
+	hplDelete(pBitMap);
+	
+	gpMutex->Lock();
+	if(bRet)
+	{
+		glConvertedNum++;
+		printf(" '%s' done! (%dms)\n", sFileName.c_str(), cPlatform::GetApplicationTime()-lStartTime);
+	}
+	else
+	{
+		glFailedNum++;
+	}
+	gpMutex->Unlock();
+
+	return bRet;
+}
+
+//------------------------------------------
+
+class cConvertFileJob : public iJob
+{
+public:
+	cConvertFileJob(const tWString &asFile) : msFile(asFile) {}
+
+	void Run(){ ConvertFile(msFile); }
+
+private:
+	tWString msFile;
+};
+
+//------------------------------------------
+
+void ConvertFilesInDir(const tWString &asDir, const tWString &asMask, cJobBatch *apBatch)
 {
 	tWStringList lstFiles;
 	cPlatform::FindFilesInDir(lstFiles, asDir, asMask);
 
 	//////////////////////////
-	//Iterate files and convert
+	//Iterate files and add a job for each
 	if(lstFiles.empty()==false) printf("Current Dir: '%s'\n", cString::To8Char(asDir).c_str());
 	for(tWStringListIt it = lstFiles.begin(); it != lstFiles.end(); ++it)
 	{
-		ConvertFile(cString::SetFilePathW(*it, asDir) );
+		gpJobPool->AddJob(hplNew(cConvertFileJob, (cString::SetFilePathW(*it, asDir)) ), apBatch);
 	}
 	
 	if(gbDirs_SubDirs==false) return;
@@ -181,7 +411,7 @@ void ConvertFilesInDir(const tWString &asDir, const tWString &asMask)
 	for(tWStringListIt it = lstFolders.begin(); it != lstFolders.end(); ++it)
 	{
 		//printf("\n");
-		ConvertFilesInDir(cString::SetFilePathW(*it, asDir), asMask);
+		ConvertFilesInDir(cString::SetFilePathW(*it, asDir), asMask, apBatch);
 	}
 }
 
@@ -196,7 +426,9 @@ void ConvertInDirs()
 	tWString sDir = cString::GetFilePathW(gsFilePath);
 	tWString sMask = cString::GetFileNameW(gsFilePath);
 	
-	ConvertFilesInDir(sDir, sMask);
+	cJobBatch batch;
+	ConvertFilesInDir(sDir, sMask, &batch);
+	gpJobPool->WaitForBatch(&batch);
 }
 
 //------------------------------------------
@@ -216,11 +448,18 @@ void ConvertFile()
 
 void Init()
 {
+	//The main thread also runs jobs while waiting
+	if(gbUseTexConv) glThreadNum = 0;
+	if(glThreadNum < 0) glThreadNum = cMath::Max(cPlatform::GetCPUCount()-1, 0);
+
+	gpMutex = cPlatform::CreateMutEx();
+	gpJobPool = hplNew(cJobPool, (glThreadNum) );
 }
 
 void Exit()
 {
-
+	hplDelete(gpJobPool);
+	hplDelete(gpMutex);
 }
 
 //------------------------------------------
@@ -233,17 +472,19 @@ int main(int argc, const char* argv[] )
 	ParseCommandLine(argc, argv);
 	Init();
 
-	printf("-------- TEX CONVERSION STARTED! -----------\n\n");
+	printf("-------- TEX CONVERSION STARTED! (%d threads) -----------\n\n", glThreadNum+1);
+	unsigned long lStartTime = cPlatform::GetApplicationTime();
 
 	if(gbDirs)	ConvertInDirs();
 	else		ConvertFile();
 
-	printf("\n-------- TEX CONVERSION DONE! -----------\n");		
+	printf("\n-------- TEX CONVERSION DONE! %d converted, %d failed (%dms) -----------\n",	glConvertedNum, glFailedNum,
+																							cPlatform::GetApplicationTime()-lStartTime);
 	
 	Exit();
 	DestroyHPLEngine(gpEngine);
 	
-	return 0;
+	return glFailedNum > 0 ? 1 : 0;
 }
 int hplMain(const tString &asCommandline){ return -1;}
 